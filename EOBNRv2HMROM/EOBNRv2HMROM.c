@@ -42,8 +42,14 @@
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_complex.h>
 
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "constants.h"
 #include "struct.h"
+#include "profiling.h"
 #include "EOBNRv2HMROMstruct.h"
 #include "EOBNRv2HMROM.h"
 
@@ -155,6 +161,9 @@ void EOBNRHMROMdata_interp_Init(EOBNRHMROMdata_interp **data_interp) {
   (*data_interp)->Cphi_interp = NULL;
   (*data_interp)->shifttime_interp = NULL;
   (*data_interp)->shiftphase_interp = NULL;
+  (*data_interp)->q_packed = NULL;
+  (*data_interp)->y_packed = NULL;
+  (*data_interp)->d2_packed = NULL;
 }
 void EOBNRHMROMdata_coeff_Init(EOBNRHMROMdata_coeff **data_coeff) {
   if(!data_coeff) exit(1);
@@ -236,12 +245,12 @@ int Read_Data_Mode(const char dir[], const int mode[2], EOBNRHMROMdata *data) {
 }
 
 /* Function interpolating the data in matrix/vector form produces an interpolated data in the form of SplineLists */
+/* The splines are shared read-only between threads once built, so no accelerator is attached to them - see Evaluate_Spline_Data */
 int Interpolate_Spline_Data(const EOBNRHMROMdata *data, EOBNRHMROMdata_interp *data_interp) {
 
   gsl_set_error_handler(&Err_Handler);
   SplineList* splinelist;
   gsl_spline* spline;
-  gsl_interp_accel* accel;
   gsl_vector* matrixline;
   gsl_vector* vector;
   int j;
@@ -252,11 +261,10 @@ int Interpolate_Spline_Data(const EOBNRHMROMdata *data, EOBNRHMROMdata_interp *d
     matrixline = gsl_vector_alloc(nbwf);
     gsl_matrix_get_row(matrixline, data->Camp, j);
 
-    accel = gsl_interp_accel_alloc();
     spline = gsl_spline_alloc(gsl_interp_cspline, nbwf);
     gsl_spline_init(spline, gsl_vector_const_ptr(data->q, 0), gsl_vector_const_ptr(matrixline, 0), nbwf);
 
-    splinelist = SplineList_AddElementNoCopy(splinelist, spline,  accel, j);
+    splinelist = SplineList_AddElementNoCopy(splinelist, spline, NULL, j);
     gsl_vector_free(matrixline);
   }
   data_interp->Camp_interp = splinelist;
@@ -267,11 +275,10 @@ int Interpolate_Spline_Data(const EOBNRHMROMdata *data, EOBNRHMROMdata_interp *d
     matrixline = gsl_vector_alloc(nbwf);
     gsl_matrix_get_row(matrixline, data->Cphi, j);
 
-    accel = gsl_interp_accel_alloc();
     spline = gsl_spline_alloc(gsl_interp_cspline, nbwf);
     gsl_spline_init(spline, gsl_vector_const_ptr(data->q, 0), gsl_vector_const_ptr(matrixline, 0), nbwf);
 
-    splinelist = SplineList_AddElementNoCopy(splinelist, spline,  accel, j);
+    splinelist = SplineList_AddElementNoCopy(splinelist, spline, NULL, j);
     gsl_vector_free(matrixline);
   }
   data_interp->Cphi_interp = splinelist;
@@ -280,22 +287,20 @@ int Interpolate_Spline_Data(const EOBNRHMROMdata *data, EOBNRHMROMdata_interp *d
   splinelist = data_interp->shifttime_interp;
   vector = data->shifttime;
 
-  accel = gsl_interp_accel_alloc();
   spline = gsl_spline_alloc(gsl_interp_cspline, nbwf);
   gsl_spline_init(spline, gsl_vector_const_ptr(data->q, 0), gsl_vector_const_ptr(vector, 0), nbwf);
 
-  splinelist = SplineList_AddElementNoCopy(NULL, spline,  accel, 0); /* This SplineList has only 1 element */
+  splinelist = SplineList_AddElementNoCopy(NULL, spline, NULL, 0); /* This SplineList has only 1 element */
   data_interp->shifttime_interp = splinelist;
 
   /* Interpolating shiftphase */
   splinelist = data_interp->shiftphase_interp;
   vector = data->shiftphase;
 
-  accel = gsl_interp_accel_alloc();
   spline = gsl_spline_alloc(gsl_interp_cspline, nbwf);
   gsl_spline_init(spline, gsl_vector_const_ptr(data->q, 0), gsl_vector_const_ptr(vector, 0), nbwf);
 
-  splinelist = SplineList_AddElementNoCopy(NULL, spline,  accel, 0); /* This SplineList has only 1 element */
+  splinelist = SplineList_AddElementNoCopy(NULL, spline, NULL, 0); /* This SplineList has only 1 element */
   data_interp->shiftphase_interp = splinelist;
 
   return SUCCESS;
@@ -303,27 +308,167 @@ int Interpolate_Spline_Data(const EOBNRHMROMdata *data, EOBNRHMROMdata_interp *d
 
 /* Function taking as input interpolated data in the form of SplineLists
  * evaluates for a given q the projection coefficients and shifts in time and phase
+ * The accelerator is provided by the caller (one per call or per thread), so that the shared interpolated data is only read
 */
-int Evaluate_Spline_Data(const double q, const EOBNRHMROMdata_interp* data_interp, EOBNRHMROMdata_coeff* data_coeff){
+int Evaluate_Spline_Data(const double q, const EOBNRHMROMdata_interp* data_interp, gsl_interp_accel* accel, EOBNRHMROMdata_coeff* data_coeff){
+
+  /* Data loaded from a package: precomputed natural cubic splines, the interval in q being located once for all coefficients */
+  if(data_interp->q_packed) {
+    const double* x = data_interp->q_packed;
+    if(q<x[0] || q>x[nbwf-1]) GSL_ERROR("q out of the range covered by the ROM", GSL_EDOM);
+    size_t i = gsl_interp_accel_find(accel, x, nbwf, q);
+    if(i>(size_t) (nbwf-2)) i = nbwf-2;
+    double h = x[i+1] - x[i];
+    double a = (x[i+1] - q)/h;
+    double b = (q - x[i])/h;
+    double ca = (a*a*a - a)*h*h/6.;
+    double cb = (b*b*b - b)*h*h/6.;
+    for(int j=0; j<nk_amp+nk_phi+2; j++) {
+      const double* y = data_interp->y_packed + j*nbwf;
+      const double* d2 = data_interp->d2_packed + j*nbwf;
+      double val = a*y[i] + b*y[i+1] + ca*d2[i] + cb*d2[i+1];
+      if(j<nk_amp) gsl_vector_set(data_coeff->Camp_coeff, j, val);
+      else if(j<nk_amp+nk_phi) gsl_vector_set(data_coeff->Cphi_coeff, j-nk_amp, val);
+      else if(j==nk_amp+nk_phi) *(data_coeff->shifttime_coeff) = val;
+      else *(data_coeff->shiftphase_coeff) = val;
+    }
+    return SUCCESS;
+  }
 
   SplineList* splinelist;
   /* Evaluating the vector of projection coefficients for the amplitude */
   for (int j=0; j<nk_amp; j++) {
     splinelist = SplineList_GetElement(data_interp->Camp_interp, j);
-    gsl_vector_set(data_coeff->Camp_coeff, j, gsl_spline_eval(splinelist->spline, q, splinelist->accel));
+    gsl_vector_set(data_coeff->Camp_coeff, j, gsl_spline_eval(splinelist->spline, q, accel));
   }
   /* Evaluating the vector of projection coefficients for the phase */
   for (int j=0; j<nk_phi; j++) {
     splinelist = SplineList_GetElement(data_interp->Cphi_interp, j);
-    gsl_vector_set(data_coeff->Cphi_coeff, j, gsl_spline_eval(splinelist->spline, q, splinelist->accel));
+    gsl_vector_set(data_coeff->Cphi_coeff, j, gsl_spline_eval(splinelist->spline, q, accel));
   }
   /* Evaluating the shift in time */
   splinelist = SplineList_GetElement(data_interp->shifttime_interp, 0); /* This SplineList has only one element */
-  *(data_coeff->shifttime_coeff) = gsl_spline_eval(splinelist->spline, q, splinelist->accel);
+  *(data_coeff->shifttime_coeff) = gsl_spline_eval(splinelist->spline, q, accel);
   /* Evaluating the shift in phase */
   splinelist = SplineList_GetElement(data_interp->shiftphase_interp, 0); /* This SplineList has only one element */
-  *(data_coeff->shiftphase_coeff) = gsl_spline_eval(splinelist->spline, q, splinelist->accel);
+  *(data_coeff->shiftphase_coeff) = gsl_spline_eval(splinelist->spline, q, accel);
+
+  return SUCCESS;
+}
+
+/* Reference frequency in geometric units, restricted to the range covered by the ROM */
+static double EOBNRv2HMROMfRefGeom(const double fRef, const double Mtot_sec, const double Mf_ROM_max_ref) {
+  double fRef_geom = fRef * Mtot_sec;
+  /* In case the user asks for a reference frequency higher than covered by the ROM, we keep it that way as we will just 0-pad the waveform (and do it anyway for some modes) */
+  if (fRef_geom > Mf_ROM_max_ref || fRef_geom == 0)
+    fRef_geom = Mf_ROM_max_ref; /* If fRef > fhigh or 0 we reset fRef to default value of cutoff frequency for the first mode of the list (presumably the 22 mode) */
+  if (0 < fRef_geom && fRef_geom < Mf_ROM_min) {
+    printf("Reference frequency Mf_ref=%g is smaller than lowest frequency in ROM Mf=%g. Setting it to the lowest frequency in ROM.\n", fRef_geom, Mf_ROM_min);
+    fRef_geom = Mf_ROM_min;
+  }
+  return fRef_geom;
+}
 
+/*
+ * Builds the frequency series for one mode from the reconstructed amplitude and phase on the ROM frequencies.
+ * amp_f and phi_f are modified in place (they can be views on columns of a matrix).
+ * For the first mode of the list (the 22 mode), sets tpeak22estimate and phase_change_ref, used by the following modes.
+*/
+static int EOBNRv2HMROMModeFreqSeries(
+  CAmpPhaseFrequencySeries **modefreqseries,     /* Output: frequency series for the mode */
+  const int i,                                   /* Index of the mode in listmode */
+  gsl_vector* amp_f,                             /* Input/Output: unnormalized amplitude on the ROM frequencies */
+  gsl_vector* phi_f,                             /* Input/Output: unshifted phase on the ROM frequencies */
+  const gsl_vector* freq_rom,                    /* Input: ROM frequencies for the mode (rescaled for the 44 and 55) */
+  const double shifttime_rom,                    /* Input: interpolated shift in time (2pi*Deltat) */
+  const double shiftphase,                       /* Input: interpolated shift in phase */
+  const double q,
+  const double Mtot_sec,
+  const double amp0,                             /* Global amplitude prefactor */
+  const double deltatRef_geom,
+  const double phiRef,
+  const double fRef_geom,
+  const double Mf_ROM_max_ref,
+  double* tpeak22estimate,                       /* Input/Output: set when i==0 */
+  double* phase_change_ref)                      /* Input/Output: set when i==0 */
+{
+  int l = listmode[i][0];
+  int m = listmode[i][1];
+
+  /* The downsampled frequencies for the mode - we undo the rescaling of the frequency for the 44 and 55 modes */
+  gsl_vector* freq_ds = gsl_vector_alloc(nbfreq);
+  gsl_vector_memcpy(freq_ds, freq_rom);
+  if ( l==4 && m==4) gsl_vector_scale( freq_ds, 1./Scaling44(q));
+  if ( l==5 && m==5) gsl_vector_scale( freq_ds, 1./Scaling55(q));
+
+  /* Evaluating the shifts in time and phase - conditional scaling for the 44 and 55 modes */
+  /* Note: the stored values of 'shifttime' correspond actually to 2pi*Deltat */
+  double twopishifttime;
+  if( l==4 && m==4) {
+    twopishifttime = shifttime_rom * Scaling44(q);
+  }
+  else if( l==5 && m==5) {
+    twopishifttime = shifttime_rom * Scaling55(q);
+  }
+  else {
+    twopishifttime = shifttime_rom;
+  }
+
+  /* If first mode in the list, assumed to be the 22 mode, set totalshifttime and phase_change_ref */
+  if( i==0 ) {
+    if(l==2 && m==2) {
+    /* Setup 1d cubic spline for the phase of the 22 mode */
+    /* phi_f may be a strided view, the spline needs contiguous data */
+    gsl_vector* phi22 = gsl_vector_alloc(nbfreq);
+    gsl_vector_memcpy(phi22, phi_f);
+    gsl_interp_accel* accel_phi22 = gsl_interp_accel_alloc();
+    gsl_spline* spline_phi22 = gsl_spline_alloc(gsl_interp_cspline, nbfreq);
+    gsl_spline_init(spline_phi22, gsl_vector_const_ptr(freq_ds,0), gsl_vector_const_ptr(phi22,0), nbfreq);
+    /* Compute the shift in time needed to set the peak of the 22 mode roughly at deltatRef */
+    /* We use the SPA formula tf = -(1/2pi)*dPsi/df to estimate the correspondence between frequency and time */
+    /* The frequency corresponding to the 22 peak is omega22peak/2pi, with omega22peak taken from the fit to NR in Pan&al 1106 EOBNRv2HM paper */
+    double f22peak = fmin(omega22peakOfq(q)/(2*PI), Mf_ROM_max_ref); /* We ensure we evaluate the spline within its range */
+    /* Note : twopishifttime is almost 0 (order 1e-8) by construction for the 22 mode, so it does not intervene here */
+    *tpeak22estimate = -1./(2*PI) * gsl_spline_eval_deriv(spline_phi22, f22peak, accel_phi22);
+    /* Determine the change in phase (to be propagated to all modes) required to have phi22(fRef) = 2*phiRef */
+    *phase_change_ref = 2*phiRef + (gsl_spline_eval(spline_phi22, fRef_geom, accel_phi22) - (twopishifttime - 2*PI*(*tpeak22estimate) + 2*PI*deltatRef_geom) * fRef_geom - shiftphase);
+    gsl_spline_free(spline_phi22);
+    gsl_interp_accel_free(accel_phi22);
+    gsl_vector_free(phi22);
+    }
+    else {
+      printf("Error: the first mode in listmode must be the 22 mode to set the changes in phase and time \n");
+      gsl_vector_free(freq_ds);
+      return FAILURE;
+    }
+  }
+  /* Total shift in time, and total change in phase for this mode */
+  double totaltwopishifttime = twopishifttime - 2*PI*(*tpeak22estimate) + 2*PI*deltatRef_geom;
+  double constphaseshift = (double) m/listmode[0][1] * (*phase_change_ref) + shiftphase;
+
+  /* Initialize the complex series for the mode */
+  int len = (int) freq_ds->size;
+  CAmpPhaseFrequencySeries_Init(modefreqseries, len);
+
+  /* Mode-dependent complete amplitude prefactor */
+  double amp_pre = amp0 * ModeAmpFactor( l, m, q);
+
+  /* Final result for the mode */
+  /* Scale and set the amplitudes (amplitudes are real at this stage)*/
+  gsl_vector_scale(amp_f, amp_pre);
+  gsl_vector_memcpy((*modefreqseries)->amp_real, amp_f);
+  gsl_vector_set_zero((*modefreqseries)->amp_imag); /* Amplitudes are real at this stage */
+  /* Add the linear term and the constant (including the shift to phiRef), and set the phases */
+  gsl_vector_scale(phi_f, -1.); /* Change the sign of the phases: ROM convention Psi=-phase */
+  gsl_blas_daxpy(totaltwopishifttime, freq_ds, phi_f); /*Beware: here freq_ds must still be in geometric units*/
+  gsl_vector_add_constant(phi_f, constphaseshift);
+  gsl_vector_memcpy((*modefreqseries)->phase, phi_f);
+
+  /* Scale (to physical units) and set the frequencies */
+  gsl_vector_scale(freq_ds, 1./Mtot_sec);
+  gsl_vector_memcpy((*modefreqseries)->freq, freq_ds);
+
+  gsl_vector_free(freq_ds);
   return SUCCESS;
 }
 
@@ -344,7 +489,6 @@ int EOBNRv2HMROMCore(
   double distance)
 {
   int ret = SUCCESS;
-  int j;
   double tpeak22estimate = 0;
   /* Check output arrays */
   if(!listhlm) exit(1);
@@ -377,23 +521,16 @@ int EOBNRv2HMROMCore(
   ListmodesEOBNRHMROMdata* listdata_ref = ListmodesEOBNRHMROMdata_GetMode(listdata, listmode[0][0], listmode[0][1]);
   EOBNRHMROMdata* data_ref = listdata_ref->data;
   double Mf_ROM_max_ref = gsl_vector_get(data_ref->freq, nbfreq-1);
-  /* Convert to geometric units the reference time and frequency */
+  /* Convert to geometric units the reference time and frequency, enforcing the allowed range for fRef */
   double deltatRef_geom = deltatRef / Mtot_sec;
-  double fRef_geom = fRef * Mtot_sec;
-
-  /* Enforce allowed geometric frequency range for fRef */
-  /* In case the user asks for a reference frequency higher than covered by the ROM, we keep it that way as we will just 0-pad the waveform (and do it anyway for some modes) */
-  if (fRef_geom > Mf_ROM_max_ref || fRef_geom == 0)
-    fRef_geom = Mf_ROM_max_ref; /* If fRef > fhigh or 0 we reset fRef to default value of cutoff frequency for the first mode of the list (presumably the 22 mode) */
-  if (0 < fRef_geom && fRef_geom < Mf_ROM_min) {
-    printf("Reference frequency Mf_ref=%g is smaller than lowest frequency in ROM Mf=%g. Setting it to the lowest frequency in ROM.\n", fRef_geom, Mf_ROM_min);
-    fRef_geom = Mf_ROM_min;
-  }
+  double fRef_geom = EOBNRv2HMROMfRefGeom(fRef, Mtot_sec, Mf_ROM_max_ref);
 
   /* Internal storage for the projection coefficients and shifts in time and phase */
   /* Initialized only once, and reused for the different modes */
   EOBNRHMROMdata_coeff *data_coeff = NULL;
   EOBNRHMROMdata_coeff_Init(&data_coeff);
+  /* Accelerator for the splines in q, local to this call - all modes share the same q grid */
+  gsl_interp_accel* accel_q = gsl_interp_accel_alloc();
 
   /* The phase change imposed by phiref, from the phase of the first mode in the list - to be set in the first step of the loop on the modes */
   double phase_change_ref = 0;
@@ -408,7 +545,7 @@ int EOBNRv2HMROMCore(
     ListmodesEOBNRHMROMdata_interp* listdata_interp_mode = ListmodesEOBNRHMROMdata_interp_GetMode(listdata_interp, l, m);
 
     /* Evaluating the projection coefficients and shift in time and phase */
-    ret |= Evaluate_Spline_Data(q, listdata_interp_mode->data_interp, data_coeff);
+    ret |= Evaluate_Spline_Data(q, listdata_interp_mode->data_interp, accel_q, data_coeff);
 
     /* Evaluating the unnormalized amplitude and unshifted phase vectors for the mode */
     /* Notice a change in convention: B matrices are transposed with respect to the B matrices in SEOBNRROM */
@@ -416,115 +553,171 @@ int EOBNRv2HMROMCore(
     /* phi_pts = Bphi . Cphi_coeff */
     gsl_vector* amp_f = gsl_vector_alloc(nbfreq);
     gsl_vector* phi_f = gsl_vector_alloc(nbfreq);
-    //clock_t begblas = clock();
     gsl_blas_dgemv(CblasNoTrans, 1.0, listdata_mode->data->Bamp, data_coeff->Camp_coeff, 0.0, amp_f);
     gsl_blas_dgemv(CblasNoTrans, 1.0, listdata_mode->data->Bphi, data_coeff->Cphi_coeff, 0.0, phi_f);
-    //clock_t endblas = clock();
-    //printf("Mode (%d,%d) Blas time: %g s\n", l, m, (double)(endblas - begblas) / CLOCKS_PER_SEC);
-
-     /* The downsampled frequencies for the mode - we undo the rescaling of the frequency for the 44 and 55 modes */
-    gsl_vector* freq_ds = gsl_vector_alloc(nbfreq);
-    gsl_vector_memcpy(freq_ds, listdata_mode->data->freq);
-    if ( l==4 && m==4) gsl_vector_scale( freq_ds, 1./Scaling44(q));
-    if ( l==5 && m==5) gsl_vector_scale( freq_ds, 1./Scaling55(q));
-
-    /* Evaluating the shifts in time and phase - conditional scaling for the 44 and 55 modes */
-    /* Note: the stored values of 'shifttime' correspond actually to 2pi*Deltat */
-    SplineList* shifttime_splinelist = listdata_interp_mode->data_interp->shifttime_interp;
-    SplineList* shiftphase_splinelist = listdata_interp_mode->data_interp->shiftphase_interp;
-    double twopishifttime;
-    if( l==4 && m==4) {
-      twopishifttime = gsl_spline_eval(shifttime_splinelist->spline, q, shifttime_splinelist->accel) * Scaling44(q);
-    }
-    else if( l==5 && m==5) {
-      twopishifttime = gsl_spline_eval(shifttime_splinelist->spline, q, shifttime_splinelist->accel) * Scaling55(q);
-    }
-    else {
-      twopishifttime = gsl_spline_eval(shifttime_splinelist->spline, q, shifttime_splinelist->accel);
-    }
-    double shiftphase = gsl_spline_eval(shiftphase_splinelist->spline, q, shiftphase_splinelist->accel);
-
-    /* If first mode in the list, assumed to be the 22 mode, set totalshifttime and phase_change_ref */
-    if( i==0 ) {
-      if(l==2 && m==2) {
-      /* Setup 1d cubic spline for the phase of the 22 mode */
-      gsl_interp_accel* accel_phi22 = gsl_interp_accel_alloc();
-      gsl_spline* spline_phi22 = gsl_spline_alloc(gsl_interp_cspline, nbfreq);
-      gsl_spline_init(spline_phi22, gsl_vector_const_ptr(freq_ds,0), gsl_vector_const_ptr(phi_f,0), nbfreq);
-      /* Compute the shift in time needed to set the peak of the 22 mode roughly at deltatRef */
-      /* We use the SPA formula tf = -(1/2pi)*dPsi/df to estimate the correspondence between frequency and time */
-      /* The frequency corresponding to the 22 peak is omega22peak/2pi, with omega22peak taken from the fit to NR in Pan&al 1106 EOBNRv2HM paper */
-      double f22peak = fmin(omega22peakOfq(q)/(2*PI), Mf_ROM_max_ref); /* We ensure we evaluate the spline within its range */
-      /* Note : twopishifttime is almost 0 (order 1e-8) by construction for the 22 mode, so it does not intervene here */
-      tpeak22estimate = -1./(2*PI) * gsl_spline_eval_deriv(spline_phi22, f22peak, accel_phi22);
-      /* Determine the change in phase (to be propagated to all modes) required to have phi22(fRef) = 2*phiRef */
-      phase_change_ref = 2*phiRef + (gsl_spline_eval(spline_phi22, fRef_geom, accel_phi22) - (twopishifttime - 2*PI*tpeak22estimate + 2*PI*deltatRef_geom) * fRef_geom - shiftphase);
-      gsl_spline_free(spline_phi22);
-      gsl_interp_accel_free(accel_phi22);
-      }
-      else {
-	printf("Error: the first mode in listmode must be the 22 mode to set the changes in phase and time \n");
-	return FAILURE;
-      }
-    }
-    /* Total shift in time, and total change in phase for this mode */
-    double totaltwopishifttime = twopishifttime - 2*PI*tpeak22estimate + 2*PI*deltatRef_geom;
-    double constphaseshift = (double) m/listmode[0][1] * phase_change_ref + shiftphase;
-
-    //
-    //printf("deltatRef_geom: %g\n", deltatRef_geom);
-    //printf("freq_ds 0: %g\n", gsl_vector_get(freq_ds, 0));
 
-    //printf("2*PI*deltatRef_geom * gsl_vector_get(freq_ds, 0), phase_change_ref: %g, %g\n", 2*PI*deltatRef_geom * gsl_vector_get(freq_ds, 0), phase_change_ref);
-
-    /* Initialize the complex series for the mode */
+    /* Build the frequency series for the mode */
     CAmpPhaseFrequencySeries *modefreqseries = NULL;
-    int len = (int) freq_ds->size;
-    CAmpPhaseFrequencySeries_Init(&modefreqseries, len);
-
-    /* Mode-dependent complete amplitude prefactor */
-    double amp_pre = amp0 * ModeAmpFactor( l, m, q);
-
-    /* Final result for the mode */
-    /* Scale and set the amplitudes (amplitudes are real at this stage)*/
-    gsl_vector_scale(amp_f, amp_pre);
-    gsl_vector_memcpy(modefreqseries->amp_real, amp_f);
-    gsl_vector_set_zero(modefreqseries->amp_imag); /* Amplitudes are real at this stage */
-    /* Add the linear term and the constant (including the shift to phiRef), and set the phases */
-    gsl_vector_scale(phi_f, -1.); /* Change the sign of the phases: ROM convention Psi=-phase */
-    gsl_blas_daxpy(totaltwopishifttime, freq_ds, phi_f); /*Beware: here freq_ds must still be in geometric units*/
-    gsl_vector_add_constant(phi_f, constphaseshift);
-    gsl_vector_memcpy(modefreqseries->phase, phi_f);
-
-//
-//printf("first phi_f: %g\n", gsl_vector_get(phi_f, 0 ));
-//printf("last phi_f: %g\n", gsl_vector_get(phi_f, phi_f->size -1 ));
-
-    /* Scale (to physical units) and set the frequencies */
-    gsl_vector_scale(freq_ds, 1./Mtot_sec);
-    gsl_vector_memcpy(modefreqseries->freq, freq_ds);
+    if(EOBNRv2HMROMModeFreqSeries(&modefreqseries, i, amp_f, phi_f, listdata_mode->data->freq, *(data_coeff->shifttime_coeff), *(data_coeff->shiftphase_coeff), q, Mtot_sec, amp0, deltatRef_geom, phiRef, fRef_geom, Mf_ROM_max_ref, &tpeak22estimate, &phase_change_ref) == FAILURE) {
+      gsl_vector_free(amp_f);
+      gsl_vector_free(phi_f);
+      EOBNRHMROMdata_coeff_Cleanup(data_coeff);
+      gsl_interp_accel_free(accel_q);
+      return FAILURE;
+    }
 
     /* Append the computed mode to the ListmodesCAmpPhaseFrequencySeries structure */
     *listhlm = ListmodesCAmpPhaseFrequencySeries_AddModeNoCopy(*listhlm, modefreqseries, l, m);
 
-    //
-    //printf("Mode (%d,%d) generated:\n", l, m);
-    //for( int j=0; j<len; j++ ){
-    //  printf("%g %g %g %g\n", gsl_vector_get(modefreqseries->freq, j), gsl_vector_get(modefreqseries->amp_real, j), gsl_vector_get(modefreqseries->amp_imag, j), gsl_vector_get(modefreqseries->phase, j));
-    //}
-
     /* Cleanup for the mode */
-    gsl_vector_free(freq_ds);
     gsl_vector_free(amp_f);
     gsl_vector_free(phi_f);
   }
 
-  /* Cleanup of the coefficients data structure */
+  /* Cleanup of the coefficients data structure and of the local accelerator */
   EOBNRHMROMdata_coeff_Cleanup(data_coeff);
+  gsl_interp_accel_free(accel_q);
 
   return(SUCCESS);
 }
 
+/*
+ * Core function for computing a batch of ROM waveforms.
+ * For each mode, the projection coefficients of all templates are stacked as the columns of a matrix,
+ * so that the reconstruction of the amplitudes and phases is done with one matrix-matrix product per mode.
+ * The output listhlm is an array of nbtemplates lists, that must all be NULL on input.
+ * A template for which the generation fails is flagged in retcodes, its list is freed and left NULL,
+ * and the other templates are still generated.
+*/
+int EOBNRv2HMROMCoreBatch(
+  struct tagListmodesCAmpPhaseFrequencySeries **listhlm,
+  int* retcodes,
+  int nbtemplates,
+  int nbmode,
+  const double* deltatRef,
+  const double* phiRef,
+  double fRef,
+  const double* Mtot_sec,
+  const double* q,
+  const double* distance)
+{
+  int ret = SUCCESS;
+  /* Check output arrays */
+  if(!listhlm || !retcodes) exit(1);
+  for(int k=0; k<nbtemplates; k++) {
+    if(listhlm[k]) {
+      printf("Error: listhlm[%d] is supposed to be NULL, but got %p\n", k, listhlm[k]);
+      exit(1);
+    }
+  }
+  /* Check number of modes and templates */
+  if(nbmode<1 || nbmode>nbmodemax) {
+    printf("Error: incorrect number of modes: %d", nbmode);
+    exit(1);
+  }
+  if(nbtemplates<1) {
+    printf("Error: incorrect number of templates: %d", nbtemplates);
+    exit(1);
+  }
+
+  /* Check if the data has been set up */
+  if(__EOBNRv2HMROM_setup) {
+    printf("Error: the ROM data has not been set up\n");
+    exit(1);
+  }
+  /* Set the global pointers to data */
+  ListmodesEOBNRHMROMdata* listdata = *__EOBNRv2HMROM_data;
+  ListmodesEOBNRHMROMdata_interp* listdata_interp = *__EOBNRv2HMROM_interp;
+
+  /* Highest allowed geometric frequency for the first mode of listmode in the ROM - used for fRef */
+  ListmodesEOBNRHMROMdata* listdata_ref = ListmodesEOBNRHMROMdata_GetMode(listdata, listmode[0][0], listmode[0][1]);
+  double Mf_ROM_max_ref = gsl_vector_get(listdata_ref->data->freq, nbfreq-1);
+
+  /* Per-template prefactors and reference values, and the quantities set by the 22 mode */
+  double* amp0 = malloc(nbtemplates*sizeof(double));
+  double* deltatRef_geom = malloc(nbtemplates*sizeof(double));
+  double* fRef_geom = malloc(nbtemplates*sizeof(double));
+  double* tpeak22estimate = malloc(nbtemplates*sizeof(double));
+  double* phase_change_ref = malloc(nbtemplates*sizeof(double));
+  double* shifttime = malloc(nbtemplates*sizeof(double));
+  double* shiftphase = malloc(nbtemplates*sizeof(double));
+  for(int k=0; k<nbtemplates; k++) {
+    double Mtot_msol = Mtot_sec[k] / MTSUN_SI;
+    amp0[k] = (Mtot_msol/M_ROM) * Mtot_sec[k] * 1.E-16 * 1.E6 * PC_SI / distance[k];
+    deltatRef_geom[k] = deltatRef[k] / Mtot_sec[k];
+    fRef_geom[k] = EOBNRv2HMROMfRefGeom(fRef, Mtot_sec[k], Mf_ROM_max_ref);
+    tpeak22estimate[k] = 0;
+    phase_change_ref[k] = 0;
+    retcodes[k] = SUCCESS;
+  }
+
+  /* Internal storage, reused for the different modes */
+  EOBNRHMROMdata_coeff *data_coeff = NULL;
+  EOBNRHMROMdata_coeff_Init(&data_coeff);
+  gsl_interp_accel* accel_q = gsl_interp_accel_alloc();
+  gsl_matrix* Camp = gsl_matrix_alloc(nk_amp, nbtemplates);
+  gsl_matrix* Cphi = gsl_matrix_alloc(nk_phi, nbtemplates);
+  gsl_matrix* amp_f = gsl_matrix_alloc(nbfreq, nbtemplates);
+  gsl_matrix* phi_f = gsl_matrix_alloc(nbfreq, nbtemplates);
+
+  /* Main loop over the modes - the 22 mode comes first, and sets the reference values for each template */
+  for(int i=0; i<nbmode; i++ ){
+    int l = listmode[i][0];
+    int m = listmode[i][1];
+
+    /* Getting the relevant modes in the lists of data */
+    ListmodesEOBNRHMROMdata* listdata_mode = ListmodesEOBNRHMROMdata_GetMode(listdata, l, m);
+    ListmodesEOBNRHMROMdata_interp* listdata_interp_mode = ListmodesEOBNRHMROMdata_interp_GetMode(listdata_interp, l, m);
+
+    /* Evaluating the projection coefficients of all templates, stacked as columns */
+    for(int k=0; k<nbtemplates; k++) {
+      retcodes[k] |= Evaluate_Spline_Data(q[k], listdata_interp_mode->data_interp, accel_q, data_coeff);
+      gsl_matrix_set_col(Camp, k, data_coeff->Camp_coeff);
+      gsl_matrix_set_col(Cphi, k, data_coeff->Cphi_coeff);
+      shifttime[k] = *(data_coeff->shifttime_coeff);
+      shiftphase[k] = *(data_coeff->shiftphase_coeff);
+    }
+
+    /* amp_pts = Bamp . Camp, phi_pts = Bphi . Cphi, for all templates at once */
+    gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, listdata_mode->data->Bamp, Camp, 0.0, amp_f);
+    gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, listdata_mode->data->Bphi, Cphi, 0.0, phi_f);
+
+    /* Build the frequency series for the mode, for each template */
+    /* Failed templates are skipped, and the modes already generated for them discarded */
+    for(int k=0; k<nbtemplates; k++) {
+      if(retcodes[k]==SUCCESS) {
+        gsl_vector_view amp_k = gsl_matrix_column(amp_f, k);
+        gsl_vector_view phi_k = gsl_matrix_column(phi_f, k);
+        CAmpPhaseFrequencySeries *modefreqseries = NULL;
+        retcodes[k] |= EOBNRv2HMROMModeFreqSeries(&modefreqseries, i, &amp_k.vector, &phi_k.vector, listdata_mode->data->freq, shifttime[k], shiftphase[k], q[k], Mtot_sec[k], amp0[k], deltatRef_geom[k], phiRef[k], fRef_geom[k], Mf_ROM_max_ref, &tpeak22estimate[k], &phase_change_ref[k]);
+        if(retcodes[k]==SUCCESS) listhlm[k] = ListmodesCAmpPhaseFrequencySeries_AddModeNoCopy(listhlm[k], modefreqseries, l, m);
+      }
+      if(retcodes[k]==FAILURE && listhlm[k]) {
+        ListmodesCAmpPhaseFrequencySeries_Destroy(listhlm[k]);
+        listhlm[k] = NULL;
+      }
+    }
+  }
+  for(int k=0; k<nbtemplates; k++) ret |= retcodes[k];
+
+  /* Cleanup */
+  EOBNRHMROMdata_coeff_Cleanup(data_coeff);
+  gsl_interp_accel_free(accel_q);
+  gsl_matrix_free(Camp);
+  gsl_matrix_free(Cphi);
+  gsl_matrix_free(amp_f);
+  gsl_matrix_free(phi_f);
+  free(amp0);
+  free(deltatRef_geom);
+  free(fRef_geom);
+  free(tpeak22estimate);
+  free(phase_change_ref);
+  free(shifttime);
+  free(shiftphase);
+
+  return(ret);
+}
+
 /* Compute waveform in downsampled frequency-amplitude-phase format */
 int SimEOBNRv2HMROM(
   struct tagListmodesCAmpPhaseFrequencySeries **listhlm,  /* Output: list of modes in Frequency-domain amplitude and phase form */
@@ -549,19 +742,320 @@ int SimEOBNRv2HMROM(
   }
 
   /* Set up (load and build interpolation) ROM data if not setup already */
-  //clock_t beg = clock();
   EOBNRv2HMROM_Init_DATA();
-  //clock_t end = clock();
-  //printf("Initialization time: %g s\n", (double)(end - beg) / CLOCKS_PER_SEC);
 
-  //beg = clock();
+  long long t0 = ProfileStart();
   int retcode = EOBNRv2HMROMCore(listhlm, nbmode, deltatRef, phiRef, fRef, Mtot_sec, q, distance);
-  //end = clock();
-  //printf("ROM evaluation time: %g s\n", (double)(end - beg) / CLOCKS_PER_SEC);
+  ProfileStop(ProfileROM, t0);
 
   return(retcode);
 }
 
+/* Compute a batch of waveforms in downsampled frequency-amplitude-phase format */
+/* listhlm is an array of nbtemplates lists, all NULL on input; templates outside the range of the ROM are left NULL and flagged in retcodes */
+int SimEOBNRv2HMROMBatch(
+  struct tagListmodesCAmpPhaseFrequencySeries **listhlm,  /* Output: array of nbtemplates lists of modes in Frequency-domain amplitude and phase form */
+  int* retcodes,                                 /* Output: SUCCESS/FAILURE for each template (can be NULL) */
+  int nbtemplates,                               /* Number of templates in the batch */
+  int nbmode,                                    /* Number of modes to generate (starting with the 22) */
+  const double* deltatRef,                       /* Time shifts so that the peak of the 22 mode occurs at deltatRef */
+  const double* phiRef,                          /* Phases at reference frequency */
+  double fRef,                                   /* Reference frequency (Hz); 0 defaults to fLow */
+  const double* m1SI,                            /* Masses of companion 1 (kg) */
+  const double* m2SI,                            /* Masses of companion 2 (kg) */
+  const double* distance)                        /* Distances of source (m) */
+{
+  int ret = SUCCESS;
+  int nbvalid = 0;
+  /* Indices of the templates within the range of the ROM, and their parameters packed contiguously */
+  int* index = malloc(nbtemplates*sizeof(int));
+  double* q = malloc(nbtemplates*sizeof(double));
+  double* Mtot_sec = malloc(nbtemplates*sizeof(double));
+  double* deltatRef_valid = malloc(nbtemplates*sizeof(double));
+  double* phiRef_valid = malloc(nbtemplates*sizeof(double));
+  double* distance_valid = malloc(nbtemplates*sizeof(double));
+  for(int k=0; k<nbtemplates; k++) {
+    /* Get masses in terms of solar mass */
+    double mass1 = m1SI[k] / MSUN_SI;
+    double mass2 = m2SI[k] / MSUN_SI;
+    double qk = fmax(mass1/mass2, mass2/mass1);    /* Mass-ratio >1 by convention*/
+    if(retcodes) retcodes[k] = FAILURE;
+    if ( qk > q_max ) {
+      ret = FAILURE;
+      continue;
+    }
+    index[nbvalid] = k;
+    q[nbvalid] = qk;
+    Mtot_sec[nbvalid] = (mass1 + mass2) * MTSUN_SI; /* Total mass in seconds */
+    deltatRef_valid[nbvalid] = deltatRef[k];
+    phiRef_valid[nbvalid] = phiRef[k];
+    distance_valid[nbvalid] = distance[k];
+    nbvalid++;
+  }
+
+  if(nbvalid>0) {
+    /* Set up (load and build interpolation) ROM data if not setup already */
+    EOBNRv2HMROM_Init_DATA();
+
+    ListmodesCAmpPhaseFrequencySeries** listhlm_valid = calloc(nbvalid, sizeof(ListmodesCAmpPhaseFrequencySeries*));
+    int* retcodes_valid = malloc(nbvalid*sizeof(int));
+    long long t0 = ProfileStart();
+    ret |= EOBNRv2HMROMCoreBatch(listhlm_valid, retcodes_valid, nbvalid, nbmode, deltatRef_valid, phiRef_valid, fRef, Mtot_sec, q, distance_valid);
+    ProfileStop(ProfileROM, t0);
+    for(int j=0; j<nbvalid; j++) {
+      listhlm[index[j]] = listhlm_valid[j];
+      if(retcodes) retcodes[index[j]] = retcodes_valid[j];
+    }
+    free(listhlm_valid);
+    free(retcodes_valid);
+  }
+
+  free(index);
+  free(q);
+  free(Mtot_sec);
+  free(deltatRef_valid);
+  free(phiRef_valid);
+  free(distance_valid);
+  return(ret);
+}
+
+/********************* ROM package ********************/
+
+/* Header of the package file, at the beginning of a block of ROMpackageheadersize bytes */
+/* The payload follows, with for each mode in the order of listmode the doubles (row-major for matrices): */
+/* q (nbwf), values of the splines in q (Camp (nk_amp x nbwf), Cphi (nk_phi x nbwf), shifttime (nbwf), shiftphase (nbwf)), */
+/* second derivatives of the splines (same layout), freq (nbfreq), Bamp (nbfreq x nk_amp), Bphi (nbfreq x nk_phi) */
+typedef struct tagROMPackageHeader {
+  char     magic[8];              /* "FLAREROM" */
+  uint32_t version;               /* ROMpackageversion */
+  uint32_t nbmode;                /* Number of modes, nbmodemax */
+  uint32_t nbwf;                  /* Number of nodes in q */
+  uint32_t nbfreq;                /* Number of frequencies */
+  uint32_t nkamp;                 /* Number of basis functions for the amplitude */
+  uint32_t nkphi;                 /* Number of basis functions for the phase */
+  int32_t  modes[nbmodemax][2];   /* Modes (l,m) in the order of the payload */
+  uint64_t payloadsize;           /* Size of the payload in bytes */
+  uint64_t checksum;              /* FNV-1a hash of the payload */
+} ROMPackageHeader;
+/* Compile-time check that the header fits in its block */
+typedef char ROMPackageHeaderFits[(sizeof(ROMPackageHeader)<=ROMpackageheadersize) ? 1 : -1];
+
+/* Number of splines in q per mode, and size in doubles of the payload for one mode */
+#define nbsplinepacked (nk_amp+nk_phi+2)
+#define modesizepacked (nbwf + 2*nbsplinepacked*nbwf + nbfreq + nbfreq*nk_amp + nbfreq*nk_phi)
+
+/* FNV-1a 64-bit hash */
+static uint64_t ROMPackageChecksum(const unsigned char* buf, const size_t n) {
+  uint64_t hash = 14695981039346656037ULL;
+  for(size_t i=0; i<n; i++) {
+    hash ^= buf[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/* Second derivatives at the nodes of the natural cubic spline through (x,y) - same spline as gsl_interp_cspline */
+/* Tridiagonal system solved by Thomas algorithm, work has size n */
+static void NaturalSplineSecondDerivatives(const double* x, const double* y, double* d2, const int n, double* work) {
+  d2[0] = 0.;
+  d2[n-1] = 0.;
+  /* Forward elimination - work holds the modified upper diagonal, d2 the modified right-hand side */
+  work[0] = 0.;
+  for(int i=1; i<n-1; i++) {
+    double hm = x[i] - x[i-1];
+    double hp = x[i+1] - x[i];
+    double rhs = 6.*((y[i+1] - y[i])/hp - (y[i] - y[i-1])/hm);
+    double diag = 2.*(hm + hp) - hm*work[i-1];
+    work[i] = hp/diag;
+    d2[i] = (rhs - hm*d2[i-1])/diag;
+  }
+  /* Back substitution */
+  for(int i=n-2; i>0; i--) d2[i] -= work[i]*d2[i+1];
+}
+
+/* Vector and matrix structures pointing to the package - not owning their data, so that gsl_vector_free/gsl_matrix_free only free the structure */
+static gsl_vector* VectorOnPackage(const double* data, const size_t n) {
+  gsl_vector* v = malloc(sizeof(gsl_vector));
+  v->size = n;
+  v->stride = 1;
+  v->data = (double*) data;
+  v->block = NULL;
+  v->owner = 0;
+  return v;
+}
+static gsl_matrix* MatrixOnPackage(const double* data, const size_t n1, const size_t n2) {
+  gsl_matrix* m = malloc(sizeof(gsl_matrix));
+  m->size1 = n1;
+  m->size2 = n2;
+  m->tda = n2;
+  m->data = (double*) data;
+  m->block = NULL;
+  m->owner = 0;
+  return m;
+}
+
+/* Write the ROM package from the binary data files found in dir */
+int EOBNRv2HMROM_WritePackage(const char dir[], const char filename[]) {
+  size_t payloadsize = nbmodemax * modesizepacked * sizeof(double);
+  double* payload = malloc(payloadsize);
+  double* work = malloc(nbwf*sizeof(double));
+  int ret = SUCCESS;
+
+  for(int j=0; j<nbmodemax; j++) {
+    EOBNRHMROMdata* data = NULL;
+    EOBNRHMROMdata_Init(&data);
+    ret |= Read_Data_Mode(dir, listmode[j], data);
+    if(ret) {
+      EOBNRHMROMdata_Cleanup(data);
+      break;
+    }
+    double* q = payload + j*modesizepacked;
+    double* y = q + nbwf;
+    double* d2 = y + nbsplinepacked*nbwf;
+    double* freq = d2 + nbsplinepacked*nbwf;
+    double* Bamp = freq + nbfreq;
+    double* Bphi = Bamp + nbfreq*nk_amp;
+    for(int i=0; i<nbwf; i++) q[i] = gsl_vector_get(data->q, i);
+    for(int k=0; k<nk_amp; k++) for(int i=0; i<nbwf; i++) y[k*nbwf + i] = gsl_matrix_get(data->Camp, k, i);
+    for(int k=0; k<nk_phi; k++) for(int i=0; i<nbwf; i++) y[(nk_amp+k)*nbwf + i] = gsl_matrix_get(data->Cphi, k, i);
+    for(int i=0; i<nbwf; i++) y[(nk_amp+nk_phi)*nbwf + i] = gsl_vector_get(data->shifttime, i);
+    for(int i=0; i<nbwf; i++) y[(nk_amp+nk_phi+1)*nbwf + i] = gsl_vector_get(data->shiftphase, i);
+    for(int k=0; k<nbsplinepacked; k++) NaturalSplineSecondDerivatives(q, y + k*nbwf, d2 + k*nbwf, nbwf, work);
+    for(int i=0; i<nbfreq; i++) freq[i] = gsl_vector_get(data->freq, i);
+    for(int i=0; i<nbfreq; i++) for(int k=0; k<nk_amp; k++) Bamp[i*nk_amp + k] = gsl_matrix_get(data->Bamp, i, k);
+    for(int i=0; i<nbfreq; i++) for(int k=0; k<nk_phi; k++) Bphi[i*nk_phi + k] = gsl_matrix_get(data->Bphi, i, k);
+    EOBNRHMROMdata_Cleanup(data);
+  }
+
+  if(!ret) {
+    unsigned char header[ROMpackageheadersize] = {0};
+    ROMPackageHeader h;
+    memset(&h, 0, sizeof(ROMPackageHeader));
+    memcpy(h.magic, "FLAREROM", 8);
+    h.version = ROMpackageversion;
+    h.nbmode = nbmodemax;
+    h.nbwf = nbwf;
+    h.nbfreq = nbfreq;
+    h.nkamp = nk_amp;
+    h.nkphi = nk_phi;
+    for(int j=0; j<nbmodemax; j++) {
+      h.modes[j][0] = listmode[j][0];
+      h.modes[j][1] = listmode[j][1];
+    }
+    h.payloadsize = payloadsize;
+    h.checksum = ROMPackageChecksum((const unsigned char*) payload, payloadsize);
+    memcpy(header, &h, sizeof(ROMPackageHeader));
+
+    FILE* f = fopen(filename, "wb");
+    if(!f) {
+      fprintf(stderr, "Error writing data to %s\n", filename);
+      ret = FAILURE;
+    }
+    else {
+      if(fwrite(header, 1, ROMpackageheadersize, f)!=ROMpackageheadersize || fwrite(payload, 1, payloadsize, f)!=payloadsize) {
+        fprintf(stderr, "Error writing data to %s\n", filename);
+        ret = FAILURE;
+      }
+      fclose(f);
+    }
+  }
+
+  free(payload);
+  free(work);
+  return(ret);
+}
+
+/* Setup EOBNRv2HMROM model from a package in memory - the data and spline coefficients are used in place, without copy */
+int EOBNRv2HMROM_Init_Package(const void* package, const size_t size) {
+  if(!__EOBNRv2HMROM_setup) {
+    printf("Error: EOBNRHMROMdata was already set up!");
+    exit(1);
+  }
+
+  /* Check the header and the checksum of the payload */
+  ROMPackageHeader h;
+  if(!package || size<ROMpackageheadersize) {
+    fprintf(stderr, "Error: ROM package too small to contain its header.\n");
+    return(FAILURE);
+  }
+  memcpy(&h, package, sizeof(ROMPackageHeader));
+  if(memcmp(h.magic, "FLAREROM", 8)!=0 || h.version!=ROMpackageversion) {
+    fprintf(stderr, "Error: ROM package not recognized, or of unsupported version.\n");
+    return(FAILURE);
+  }
+  int ret = SUCCESS;
+  if(h.nbmode!=nbmodemax || h.nbwf!=(uint32_t) nbwf || h.nbfreq!=(uint32_t) nbfreq || h.nkamp!=nk_amp || h.nkphi!=nk_phi) ret = FAILURE;
+  for(int j=0; j<nbmodemax; j++) if(h.modes[j][0]!=listmode[j][0] || h.modes[j][1]!=listmode[j][1]) ret = FAILURE;
+  if(h.payloadsize!=nbmodemax*modesizepacked*sizeof(double) || size!=ROMpackageheadersize + h.payloadsize) ret = FAILURE;
+  if(ret) {
+    fprintf(stderr, "Error: ROM package inconsistent with the model dimensions.\n");
+    return(FAILURE);
+  }
+  const double* payload = (const double*) ((const char*) package + ROMpackageheadersize);
+  if(ROMPackageChecksum((const unsigned char*) payload, h.payloadsize)!=h.checksum) {
+    fprintf(stderr, "Error: checksum mismatch in the ROM package.\n");
+    return(FAILURE);
+  }
+
+  /* Point the data structures to the package */
+  ListmodesEOBNRHMROMdata* listdata = *__EOBNRv2HMROM_data;
+  ListmodesEOBNRHMROMdata_interp* listdata_interp = *__EOBNRv2HMROM_interp;
+  for(int j=0; j<nbmodemax; j++) {
+    const double* q = payload + j*modesizepacked;
+    const double* y = q + nbwf;
+    const double* d2 = y + nbsplinepacked*nbwf;
+    const double* freq = d2 + nbsplinepacked*nbwf;
+    const double* Bamp = freq + nbfreq;
+    const double* Bphi = Bamp + nbfreq*nk_amp;
+
+    EOBNRHMROMdata* data = malloc(sizeof(EOBNRHMROMdata));
+    data->q = VectorOnPackage(q, nbwf);
+    data->freq = VectorOnPackage(freq, nbfreq);
+    data->Camp = MatrixOnPackage(y, nk_amp, nbwf);
+    data->Cphi = MatrixOnPackage(y + nk_amp*nbwf, nk_phi, nbwf);
+    data->Bamp = MatrixOnPackage(Bamp, nbfreq, nk_amp);
+    data->Bphi = MatrixOnPackage(Bphi, nbfreq, nk_phi);
+    data->shifttime = VectorOnPackage(y + (nk_amp+nk_phi)*nbwf, nbwf);
+    data->shiftphase = VectorOnPackage(y + (nk_amp+nk_phi+1)*nbwf, nbwf);
+    listdata = ListmodesEOBNRHMROMdata_AddModeNoCopy(listdata, data, listmode[j][0], listmode[j][1]);
+
+    EOBNRHMROMdata_interp* data_interp = NULL;
+    EOBNRHMROMdata_interp_Init(&data_interp);
+    data_interp->q_packed = q;
+    data_interp->y_packed = y;
+    data_interp->d2_packed = d2;
+    listdata_interp = ListmodesEOBNRHMROMdata_interp_AddModeNoCopy(listdata_interp, data_interp, listmode[j][0], listmode[j][1]);
+  }
+
+  *__EOBNRv2HMROM_data = listdata;
+  *__EOBNRv2HMROM_interp = listdata_interp;
+  __EOBNRv2HMROM_setup = SUCCESS;
+  return(SUCCESS);
+}
+
+/* Setup EOBNRv2HMROM model from the package file in dir, if present - the file is mapped read-only and shared, so that the pages are shared by all processes on the node */
+/* Returns FAILURE without message if there is no package, so that the caller can fall back to the separate data files */
+static int EOBNRv2HMROM_Init_PackageFile(const char dir[]) {
+  char* path = malloc(strlen(dir)+64);
+  sprintf(path, "%s/%s", dir, ROMpackagefile);
+  int fd = open(path, O_RDONLY);
+  free(path);
+  if(fd<0) return(FAILURE);
+  struct stat st;
+  if(fstat(fd, &st)!=0 || st.st_size<ROMpackageheadersize) {
+    close(fd);
+    return(FAILURE);
+  }
+  size_t size = st.st_size;
+  void* map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(map==MAP_FAILED) return(FAILURE);
+  /* The mapping is kept for the lifetime of the process */
+  int ret = EOBNRv2HMROM_Init_Package(map, size);
+  if(ret) munmap(map, size);
+  return(ret);
+}
+
 /* Setup EOBNRv2HMROM model using data files installed in $ROM_DATA_PATH */
 int EOBNRv2HMROM_Init_DATA(void) {
   if (!__EOBNRv2HMROM_setup) return SUCCESS;
@@ -579,26 +1073,68 @@ int EOBNRv2HMROM_Init_DATA(void) {
 
 #pragma omp critical
   {
-    for(word=strtok_r(path,":",&brkt); word; word=strtok_r(NULL,":",&brkt))
-      {
-	ret = EOBNRv2HMROM_Init(word);
-	if(ret == SUCCESS) break;
+    /* Another thread may have completed the setup while we were waiting */
+    if(__EOBNRv2HMROM_setup) {
+      for(word=strtok_r(path,":",&brkt); word; word=strtok_r(NULL,":",&brkt))
+	{
+	  ret = EOBNRv2HMROM_Init(word);
+	  if(ret == SUCCESS) break;
+	}
+      if(ret!=SUCCESS) {
+	printf("Error: unable to find EOBNRv2HMROM data files in $ROM_DATA_PATH\n");
+	exit(FAILURE);
       }
-    if(ret!=SUCCESS) {
-      printf("Error: unable to find EOBNRv2HMROM data files in $ROM_DATA_PATH\n");
-      exit(FAILURE);
+      __EOBNRv2HMROM_setup = ret;
     }
-    __EOBNRv2HMROM_setup = ret;
+    else ret = SUCCESS;
   }
   return(ret);
 }
 
-/* Setup EOBNRv2HMROM model using data files installed in dir */
+/* Setup EOBNRv2HMROM model from the package file found in $ROM_DATA_PATH, its contents being provided by loadfile */
+/* Used to share the package between processes, e.g. with loadfile=NodeSharedReadFile - loadfile is called in turn for the path of the package in each directory */
+/* If no package can be loaded this way, falls back to EOBNRv2HMROM_Init_DATA */
+int EOBNRv2HMROM_Init_DATA_Loader(int (*loadfile)(const char path[], const void** buffer, size_t* size)) {
+  if (!__EOBNRv2HMROM_setup) return SUCCESS;
+
+  char *envpath=NULL;
+  char path[32768];
+  char *brkt,*word;
+  envpath=getenv("ROM_DATA_PATH");
+  if(!envpath) return EOBNRv2HMROM_Init_DATA();
+  strncpy(path,envpath,sizeof(path));
+
+  int ret=FAILURE;
+#pragma omp critical
+  {
+    /* Another thread may have completed the setup while we were waiting */
+    if(__EOBNRv2HMROM_setup) {
+      for(word=strtok_r(path,":",&brkt); word; word=strtok_r(NULL,":",&brkt)) {
+        char* file = malloc(strlen(word)+64);
+        sprintf(file, "%s/%s", word, ROMpackagefile);
+        const void* package = NULL;
+        size_t size = 0;
+        int retload = loadfile(file, &package, &size);
+        free(file);
+        if(retload==SUCCESS && EOBNRv2HMROM_Init_Package(package, size)==SUCCESS) {
+          ret = SUCCESS;
+          break;
+        }
+      }
+    }
+    else ret = SUCCESS;
+  }
+  if(ret==SUCCESS) return SUCCESS;
+  return EOBNRv2HMROM_Init_DATA();
+}
+
+/* Setup EOBNRv2HMROM model using data files installed in dir - the package file is used if present, otherwise the separate binary files */
 int EOBNRv2HMROM_Init(const char dir[]) {
   if(!__EOBNRv2HMROM_setup) {
     printf("Error: EOBNRHMROMdata was already set up!");
     exit(1);
   }
+  if(EOBNRv2HMROM_Init_PackageFile(dir)==SUCCESS) return(SUCCESS);
 
   int ret = SUCCESS;
   ListmodesEOBNRHMROMdata* listdata = *__EOBNRv2HMROM_data;
@@ -737,37 +1273,19 @@ static void TaylorF2nonspin(
   }
 }
 
-/*Wrapper for waveform generation with possibly a combination of EOBNRv2HMROM and TaylorF2*/
-/* Note: GenerateWaveform accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
-/* Note: the extended waveform will now a different number of frequency points for each mode */
-int SimEOBNRv2HMROMExtTF2(
-  ListmodesCAmpPhaseFrequencySeries **listhlm,   /* Output: list of modes in Frequency-domain amplitude and phase form */
-  int nbmode,                                    /* Number of modes to generate (starting with the 22) */
+/* Extend in place to lower frequencies the modes of a ROM waveform, with TaylorF2 for the 22 mode and power-laws for the other modes */
+/* Used by SimEOBNRv2HMROMExtTF2 and SimEOBNRv2HMROMExtTF2Batch */
+static void EOBNRv2HMROMExtendTF2(
+  ListmodesCAmpPhaseFrequencySeries* listROM,    /* Input/Output: list of modes generated by the ROM */
   double Mf_match,                               /* Minimum frequency using EOBNRv2HMROM in inverse total mass units*/
   double minf,                                   /* Minimum frequency required */
-  int tagexthm,                                  /* Tag to decide whether or not to extend the higher modes as well */
-  double deltatRef,                              /* Time shift so that the peak of the 22 mode occurs at deltatRef */
-  double phiRef,                                 /* Phase at reference frequency */
-  double fRef,                                   /* Reference frequency (Hz); 0 defaults to fLow */
   double m1SI,                                   /* Mass of companion 1 (kg) */
   double m2SI,                                   /* Mass of companion 2 (kg) */
   double distance)                               /* Distance of source (m) */
-{//
-  //printf("calling SimEOBNRv2HMROMExtTF2 with minf=%g\n", minf);
-  //printf("params: %d %g %g %g %g %g %g %g %g\n", nbmode, Mf_match, minf, deltatRef, phiRef, fRef, m1SI, m2SI, distance);
-
-
-  int ret,i;
-  ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
-  //int lout=-1,mout=-1;
+{
+  int i;
   int lout=-1,mout=-1;
-
-  /* Generate the waveform with the ROM */
-  ret = SimEOBNRv2HMROM(&listROM, nbmode, deltatRef, phiRef, fRef, m1SI, m2SI, distance);
-
-  /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
-  //if(ret==FAILURE)printf("SimEOBNRv2HMROMExtTF2: Generation of ROM for injection failed!\n");
-  if(ret==FAILURE) return FAILURE;
+  long long t0 = ProfileStart();
 
   /* Main loop over the modes (as linked list) to perform the extension */
   /* The 2-2 mode will be extended by TaylorF2 model with the phase and time offset
@@ -967,6 +1485,42 @@ int SimEOBNRv2HMROMExtTF2(
     //}
     listelement=listelement->next;
   }
+  ProfileStop(ProfileTF2, t0);
+}
+
+/*Wrapper for waveform generation with possibly a combination of EOBNRv2HMROM and TaylorF2*/
+/* Note: GenerateWaveform accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
+/* Note: the extended waveform will now a different number of frequency points for each mode */
+int SimEOBNRv2HMROMExtTF2(
+  ListmodesCAmpPhaseFrequencySeries **listhlm,   /* Output: list of modes in Frequency-domain amplitude and phase form */
+  int nbmode,                                    /* Number of modes to generate (starting with the 22) */
+  double Mf_match,                               /* Minimum frequency using EOBNRv2HMROM in inverse total mass units*/
+  double minf,                                   /* Minimum frequency required */
+  int tagexthm,                                  /* Tag to decide whether or not to extend the higher modes as well */
+  double deltatRef,                              /* Time shift so that the peak of the 22 mode occurs at deltatRef */
+  double phiRef,                                 /* Phase at reference frequency */
+  double fRef,                                   /* Reference frequency (Hz); 0 defaults to fLow */
+  double m1SI,                                   /* Mass of companion 1 (kg) */
+  double m2SI,                                   /* Mass of companion 2 (kg) */
+  double distance)                               /* Distance of source (m) */
+{//
+  //printf("calling SimEOBNRv2HMROMExtTF2 with minf=%g\n", minf);
+  //printf("params: %d %g %g %g %g %g %g %g %g\n", nbmode, Mf_match, minf, deltatRef, phiRef, fRef, m1SI, m2SI, distance);
+
+
+  int ret;
+  ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
+
+  /* Generate the waveform with the ROM */
+  ret = SimEOBNRv2HMROM(&listROM, nbmode, deltatRef, phiRef, fRef, m1SI, m2SI, distance);
+
+  /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
+  //if(ret==FAILURE)printf("SimEOBNRv2HMROMExtTF2: Generation of ROM for injection failed!\n");
+  if(ret==FAILURE) return FAILURE;
+
+  /* Extend the modes to lower frequencies */
+  EOBNRv2HMROMExtendTF2(listROM, Mf_match, minf, m1SI, m2SI, distance);
+
   *listhlm=listROM;
   /*
   printf("generated listROM: n=%i l=%i m=%i\n",(*listhlm)->freqseries->amp_real->size,listROM->l,listROM->m);
@@ -978,3 +1532,34 @@ int SimEOBNRv2HMROMExtTF2(
   */
   return SUCCESS;
 }
+
+/* Batched version of SimEOBNRv2HMROMExtTF2, see SimEOBNRv2HMROMBatch */
+/* Templates for which the ROM generation failed are left NULL and flagged in retcodes */
+int SimEOBNRv2HMROMExtTF2Batch(
+  ListmodesCAmpPhaseFrequencySeries **listhlm,   /* Output: array of nbtemplates lists of modes in Frequency-domain amplitude and phase form */
+  int* retcodes,                                 /* Output: SUCCESS/FAILURE for each template (can be NULL) */
+  int nbtemplates,                               /* Number of templates in the batch */
+  int nbmode,                                    /* Number of modes to generate (starting with the 22) */
+  double Mf_match,                               /* Minimum frequency using EOBNRv2HMROM in inverse total mass units*/
+  double minf,                                   /* Minimum frequency required */
+  const double* deltatRef,                       /* Time shifts so that the peak of the 22 mode occurs at deltatRef */
+  const double* phiRef,                          /* Phases at reference frequency */
+  double fRef,                                   /* Reference frequency (Hz); 0 defaults to fLow */
+  const double* m1SI,                            /* Masses of companion 1 (kg) */
+  const double* m2SI,                            /* Masses of companion 2 (kg) */
+  const double* distance)                        /* Distances of source (m) */
+{
+  int* ret = malloc(nbtemplates*sizeof(int));
+
+  /* Generate the waveforms with the ROM */
+  int retbatch = SimEOBNRv2HMROMBatch(listhlm, ret, nbtemplates, nbmode, deltatRef, phiRef, fRef, m1SI, m2SI, distance);
+
+  /* Extend the modes of each successfully generated template */
+  for(int k=0; k<nbtemplates; k++) {
+    if(ret[k]==SUCCESS) EOBNRv2HMROMExtendTF2(listhlm[k], Mf_match, minf, m1SI[k], m2SI[k], distance[k]);
+    if(retcodes) retcodes[k] = ret[k];
+  }
+
+  free(ret);
+  return retbatch;
+}
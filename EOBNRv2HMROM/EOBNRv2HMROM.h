@@ -66,10 +66,30 @@ extern const int listmode[nbmodemax][2];
 /**************************************************/
 /**************** Prototypes **********************/
 
+/********Single-file ROM package********/
+/* Name of the package file looked for in the ROM data directories, and version of its format */
+#define ROMpackagefile "EOBNRv2HMROM.pack"
+#define ROMpackageversion 1
+/* Size in bytes of the header, the payload of doubles starting at this offset */
+#define ROMpackageheadersize 128
+
 /* Functions to load, initalize and cleanup data */
 int EOBNRv2HMROM_Init_DATA(void);
 int EOBNRv2HMROM_Init(const char dir[]);
 
+/* Functions for the ROM package: all modes in a single file, with precomputed spline coefficients, mapped read-only at setup */
+/* The package is written from the binary data files found in dir - the file is native-endian */
+int EOBNRv2HMROM_WritePackage(
+  const char dir[],                         /* Input: directory of the binary ROM data files */
+  const char filename[]);                   /* Output: path of the package file to write */
+/* Setup from the package found in $ROM_DATA_PATH, read through loadfile (e.g. into memory shared between processes) - falls back to EOBNRv2HMROM_Init_DATA */
+int EOBNRv2HMROM_Init_DATA_Loader(
+  int (*loadfile)(const char path[], const void** buffer, size_t* size)); /* Input: function loading a file in memory */
+/* Setup from a package already in memory - the memory is used in place and has to stay valid and unmodified */
+int EOBNRv2HMROM_Init_Package(
+  const void* package,                      /* Input: contents of the package file */
+  const size_t size);                       /* Input: size in bytes */
+
 void EOBNRHMROMdata_Init(EOBNRHMROMdata **data);
 void EOBNRHMROMdata_interp_Init(EOBNRHMROMdata_interp **data_interp);
 void EOBNRHMROMdata_coeff_Init(EOBNRHMROMdata_coeff **data_coeff);
@@ -86,6 +106,7 @@ int Read_Data_Mode(const char dir[], const int mode[2], EOBNRHMROMdata *data);
 int Evaluate_Spline_Data(
   const double q,                           /* Input: q-value for which projection coefficients should be evaluated */
   const EOBNRHMROMdata_interp* data_interp,  /* Input: data in interpolated form */
+  gsl_interp_accel* accel,                   /* Input/Output: accelerator owned by the caller, all splines share the same q grid */
   EOBNRHMROMdata_coeff* data_coeff           /* Output: vectors of projection coefficients and shifts in time and phase */
 );
 
@@ -106,6 +127,18 @@ int EOBNRv2HMROMCore(
   double q,
   double distance);
 
+int EOBNRv2HMROMCoreBatch(
+  struct tagListmodesCAmpPhaseFrequencySeries **listhlm,
+  int* retcodes,
+  int nbtemplates,
+  int nbmode,
+  const double* deltatRef,
+  const double* phiRef,
+  double fRef,
+  const double* Mtot_sec,
+  const double* q,
+  const double* distance);
+
 int SimEOBNRv2HMROM(
   ListmodesCAmpPhaseFrequencySeries **listhlm,  /* Output: list of modes in Frequency-domain amplitude and phase form */
   int nbmode,                                    /* Number of modes to generate (starting with the 22) */
@@ -129,6 +162,34 @@ int SimEOBNRv2HMROMExtTF2(
   double m2SI,                                   /* Mass of companion 2 (kg) */
   double distance);                              /* Distance of source (m) */
 
+/* Batched versions: listhlm is an array of nbtemplates lists, all NULL on input */
+/* The projection coefficients of all templates are combined in one matrix-matrix product per mode */
+int SimEOBNRv2HMROMBatch(
+  ListmodesCAmpPhaseFrequencySeries **listhlm,  /* Output: array of nbtemplates lists of modes in Frequency-domain amplitude and phase form */
+  int* retcodes,                                 /* Output: SUCCESS/FAILURE for each template (can be NULL) */
+  int nbtemplates,                               /* Number of templates in the batch */
+  int nbmode,                                    /* Number of modes to generate (starting with the 22) */
+  const double* deltatRef,                       /* Time shifts so that the peak of the 22 mode occurs at deltatRef */
+  const double* phiRef,                          /* Phases at reference frequency */
+  double fRef,                                   /* Reference frequency (Hz); 0 defaults to fLow */
+  const double* m1SI,                            /* Masses of companion 1 (kg) */
+  const double* m2SI,                            /* Masses of companion 2 (kg) */
+  const double* distance);                       /* Distances of source (m) */
+
+int SimEOBNRv2HMROMExtTF2Batch(
+  ListmodesCAmpPhaseFrequencySeries **listhlm,   /* Output: array of nbtemplates lists of modes in Frequency-domain amplitude and phase form */
+  int* retcodes,                                 /* Output: SUCCESS/FAILURE for each template (can be NULL) */
+  int nbtemplates,                               /* Number of templates in the batch */
+  int nbmode,                                    /* Number of modes to generate (starting with the 22) */
+  double Mf_match,                               /* Minimum frequency using EOBNRv2HMROM in inverse total mass units*/
+  double minf,                                   /* Minimum frequency required */
+  const double* deltatRef,                       /* Time shifts so that the peak of the 22 mode occurs at deltatRef */
+  const double* phiRef,                          /* Phases at reference frequency */
+  double fRef,                                   /* Reference frequency (Hz); 0 defaults to fLow */
+  const double* m1SI,                            /* Masses of companion 1 (kg) */
+  const double* m2SI,                            /* Masses of companion 2 (kg) */
+  const double* distance);                       /* Distances of source (m) */
+
 #if 0
 { /* so that editors will match succeeding brace */
 #elif defined(__cplusplus)
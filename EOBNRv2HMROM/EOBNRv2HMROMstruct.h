@@ -58,7 +58,7 @@ extern "C" {
 
 typedef struct tagSplineList {
     gsl_spline*            spline; /* The gsl spline */
-    gsl_interp_accel*      accel; /* The gsl accelerator */
+    gsl_interp_accel*      accel; /* The gsl accelerator - NULL for the shared ROM splines, evaluated with caller-owned accelerators */
     int                    i; /* Index in the list  */
     struct tagSplineList*  next; /* Pointer to the next list element */
 } SplineList;
@@ -81,6 +81,9 @@ typedef struct tagEOBNRHMROMdata_interp
   SplineList* Cphi_interp; /* List of splines for the phase coefficients - SplineList, index of reduced basis */
   SplineList* shifttime_interp; /* interpolated shift in time - SplineList with one element */
   SplineList* shiftphase_interp; /* interpolated shift in phase - SplineList with one element */
+  const double* q_packed; /* Nodes in q of the precomputed splines when loaded from a ROM package - NULL otherwise, the SplineLists being used */
+  const double* y_packed; /* Values of the nk_amp+nk_phi+2 splines at the nodes, contiguous in the order Camp rows, Cphi rows, shifttime, shiftphase */
+  const double* d2_packed; /* Second derivatives of the natural cubic splines at the nodes, same layout as y_packed */
 } EOBNRHMROMdata_interp;
 
 typedef struct tagEOBNRHMROMdata_coeff
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+#include "struct.h"
+#include "EOBNRv2HMROMstruct.h"
+#include "EOBNRv2HMROM.h"
+
+/* This program packs the binary data files of EOBNRv2HMROM into a single file, with the spline coefficients in q precomputed.
+   When the package file EOBNRv2HMROM.pack is found in a directory of ROM_DATA_PATH, it is mapped read-only at setup
+   instead of reading and interpolating the separate files.
+*/
+
+static void parse_args_PackROMData(ssize_t argc, char **argv, char* indir, char* outfile)
+{
+    char help[] = "\
+PackROMData by Sylvain Marsat, John Baker, and Philip Graff\n\
+\n\
+This program writes the single-file package of the EOBNRv2HMROM data.\n\
+Arguments are as follows:\n\
+\n\
+ --indir               Directory of the binary ROM data files\n\
+ --outfile             Path of the package file (default=<indir>/EOBNRv2HMROM.pack)\n\
+\n";
+
+    ssize_t i;
+    strcpy(indir, ""); /* No default; has to be provided */
+    strcpy(outfile, "");
+
+    /* Consume command line */
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--help") == 0) {
+            fprintf(stdout,"%s", help);
+            exit(0);
+        } else if (strcmp(argv[i], "--indir") == 0) {
+            strcpy(indir, argv[++i]);
+        } else if (strcmp(argv[i], "--outfile") == 0) {
+            strcpy(outfile, argv[++i]);
+        } else {
+          printf("Error: invalid option: %s\n", argv[i]);
+          exit(1);
+        }
+    }
+    if(strlen(indir)==0) {
+      printf("Error: --indir has to be provided.\n");
+      exit(1);
+    }
+    if(strlen(outfile)==0) sprintf(outfile, "%s/%s", indir, ROMpackagefile);
+}
+
+int main(int argc, char *argv[])
+{
+  char indir[256];
+  char outfile[512];
+  parse_args_PackROMData(argc, argv, indir, outfile);
+
+  if(EOBNRv2HMROM_WritePackage(indir, outfile)==FAILURE) {
+    printf("Error: failed to write the ROM package.\n");
+    exit(1);
+  }
+
+  /* Check that the package can be loaded */
+  FILE* f = fopen(outfile, "rb");
+  fseek(f, 0, SEEK_END);
+  size_t size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  void* package = malloc(size);
+  if(fread(package, 1, size, f)!=size || EOBNRv2HMROM_Init_Package(package, size)==FAILURE) {
+    printf("Error: the ROM package written to %s could not be loaded.\n", outfile);
+    exit(1);
+  }
+  fclose(f);
+  printf("Written ROM package %s (%zu bytes)\n", outfile, size);
+  return 0;
+}
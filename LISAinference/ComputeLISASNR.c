@@ -47,11 +47,15 @@ Arguments are as follows:\n\
  --nlinesinfile        Number of lines of inputs file when loading TDI time series from file\n\
  --indir               Input directory when loading TDI time series from file\n\
  --infile              Input file name when loading TDI time series from file\n\
- --loadparamsfile      Option to load physical parameters from file and to output result to file (default false)\n\
+ --fftmeasure          When loading TDI time series from file, plan the FFTs with FFTW_MEASURE instead of FFTW_ESTIMATE (default: false)\n\
+ --fftthreads          When loading TDI time series from file, number of threads per FFT - requires FFTW threads support at compilation (default 1)\n\
+ --fftwisdom           When loading TDI time series from file, FFTW wisdom file, imported if it exists and exported at the end (default none)\n\
+ --loadparamsfile      Option to load physical parameters from file and to output result to file (default false) - lines are processed in parallel over OMP_NUM_THREADS threads\n\
  --nlinesparams        Number of lines in params file\n\
  --paramsdir           Directory for input/output file\n\
  --paramsfile          Input file with the parameters\n\
  --outputfile          Output file\n\
+ --signalcache         Number of generated signals kept in the per-thread cache, reused for repeated lines of the params file processed by the same thread (default 0, no cache)\n\
 \n";
 
   ssize_t i;
@@ -87,6 +91,10 @@ Arguments are as follows:\n\
   strcpy(params->paramsdir, "");  /* No default; has to be provided */
   strcpy(params->paramsfile, "");  /* No default; has to be provided */
   strcpy(params->outputfile, "");  /* No default; has to be provided */
+  params->nbsignalcache = 0;
+  params->fftmeasure = 0;
+  params->fftthreads = 1;
+  strcpy(params->fftwisdom, "");
 
   /* Consume command line */
   for (i = 1; i < argc; ++i) {
@@ -140,6 +148,12 @@ Arguments are as follows:\n\
       strcpy(params->indir, argv[++i]);
     } else if (strcmp(argv[i], "--infile") == 0) {
       strcpy(params->infile, argv[++i]);
+    } else if (strcmp(argv[i], "--fftmeasure") == 0) {
+      params->fftmeasure = 1;
+    } else if (strcmp(argv[i], "--fftthreads") == 0) {
+      params->fftthreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--fftwisdom") == 0) {
+      strcpy(params->fftwisdom, argv[++i]);
     } else if (strcmp(argv[i], "--loadparamsfile") == 0) {
       params->loadparamsfile = 1;
     } else if (strcmp(argv[i], "--nlinesparams") == 0) {
@@ -150,6 +164,8 @@ Arguments are as follows:\n\
       strcpy(params->paramsfile, argv[++i]);
     } else if (strcmp(argv[i], "--outputfile") == 0) {
       strcpy(params->outputfile, argv[++i]);
+    } else if (strcmp(argv[i], "--signalcache") == 0) {
+      params->nbsignalcache = atoi(argv[++i]);
     }  else {
       printf("Error: invalid option: %s\n", argv[i]);
       printf("argc-i=%i\n",argc-i);
@@ -254,9 +270,11 @@ int main(int argc, char *argv[])
       gsl_vector* times = TDI1->times;
       double twindowbeg = 0.05 * (gsl_vector_get(times, times->size - 1) - gsl_vector_get(times, 0)); /* Here hardcoded relative window lengths */
       double twindowend = 0.01 * (gsl_vector_get(times, times->size - 1) - gsl_vector_get(times, 0)); /* Here hardcoded relative window lengths */
-      FFTRealTimeSeries(&TDI1FFT, TDI1, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
-      FFTRealTimeSeries(&TDI2FFT, TDI2, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
-      FFTRealTimeSeries(&TDI3FFT, TDI3, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
+      if(strlen(params->fftwisdom)>0) FFTImportWisdom(params->fftwisdom);
+      if(params->fftmeasure) FFTSetPlanMeasure(1);
+      if(params->fftthreads>1) FFTSetThreads(params->fftthreads);
+      FFTRealTimeSeries3Chan(&TDI1FFT, &TDI2FFT, &TDI3FFT, TDI1, TDI2, TDI3, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
+      if(strlen(params->fftwisdom)>0) FFTExportWisdom(params->fftwisdom);
 
       /* Restrict FFT on frequency interval of interest - no limitation put on the upper bound */
       ReImFrequencySeries* TDI1FFTrestr = NULL;
@@ -322,6 +340,7 @@ int main(int argc, char *argv[])
       globalparams->tagint = params->tagint;
       globalparams->tagtdi = params->tagtdi;
       globalparams->nbptsoverlap = params->nbptsoverlap;
+      globalparams->nbsignalcache = params->nbsignalcache;
       /* Hardcoded */
       globalparams->variant = variant;
       globalparams->tagtRefatLISA = tagtRefatLISA;
@@ -366,59 +385,83 @@ int main(int argc, char *argv[])
         gsl_matrix* inmatrix =  gsl_matrix_alloc(nlines, 9);
         Read_Text_Matrix(params->paramsdir, params->paramsfile, inmatrix);
 
-        /* Initialize output matrix */
+        /* Output file, written line by line in the order of the input */
         /* Format (same as in the internals): m1, m2, tRef, dist, phase, inc, lambda, beta, pol, SNR */
-        gsl_matrix* outmatrix =  gsl_matrix_alloc(nlines, 10);
-
-        for(int i=0; i<nlines; i++) {
-          injectedparams->m1 = gsl_matrix_get(inmatrix, i, 0);
-          injectedparams->m2 = gsl_matrix_get(inmatrix, i, 1);
-          injectedparams->tRef = gsl_matrix_get(inmatrix, i, 2);
-          injectedparams->distance = gsl_matrix_get(inmatrix, i, 3);
-          injectedparams->phiRef = gsl_matrix_get(inmatrix, i, 4);
-          injectedparams->inclination = gsl_matrix_get(inmatrix, i, 5);
-          injectedparams->lambda = gsl_matrix_get(inmatrix, i, 6);
-          injectedparams->beta = gsl_matrix_get(inmatrix, i, 7);
-          injectedparams->polarization = gsl_matrix_get(inmatrix, i, 8);
-
-          /* Branch between the Fresnel or linear computation */
-          double SNR = 0;
-          if(params->tagint==0) {
-            LISAInjectionCAmpPhase* injCAmpPhase = NULL;
-            LISAInjectionCAmpPhase_Init(&injCAmpPhase);
-            LISAGenerateInjectionCAmpPhase(injectedparams, injCAmpPhase);
-            SNR = sqrt(injCAmpPhase->TDI123ss);
-          }
-          else if(params->tagint==1) {
-            LISAInjectionReIm* injReIm = NULL;
-            LISAInjectionReIm_Init(&injReIm);
-            LISAGenerateInjectionReIm(injectedparams, params->minf, params->nbptsoverlap, 0, injReIm); /* Hardcoded linear sampling */
-
-            double SNRA2 = FDOverlapReImvsReIm(injReIm->TDI1Signal, injReIm->TDI1Signal, injReIm->noisevalues1);
-            double SNRE2 = FDOverlapReImvsReIm(injReIm->TDI2Signal, injReIm->TDI2Signal, injReIm->noisevalues2);
-            double SNRT2 = FDOverlapReImvsReIm(injReIm->TDI3Signal, injReIm->TDI3Signal, injReIm->noisevalues3);
-            SNR = sqrt(SNRA2 + SNRE2 + SNRT2);
-          }
-          else {
-            printf("Error in ComputeLISASNR: integration tag not recognized.\n");
-            exit(1);
+        char* path = malloc(strlen(params->paramsdir) + strlen(params->outputfile) + 2);
+        sprintf(path, "%s/%s", params->paramsdir, params->outputfile);
+        FILE* fout = fopen(path, "w");
+        if(!fout) {
+          printf("Error in ComputeLISASNR: cannot open output file %s.\n", path);
+          exit(1);
+        }
+        free(path);
+
+        /* The ROM data is loaded once before the threads start, the noise tables are shared between threads */
+        EOBNRv2HMROM_Init_DATA();
+
+        /* Lines are distributed dynamically over the threads - each one generates its injection from its own copy of the parameters, the reference time being that of the line as when injectedparams is set to it */
+        /* The signal caches are per thread, their counts are summed at the end of the parallel region */
+        size_t hits = 0, misses = 0;
+        #pragma omp parallel
+        {
+          #pragma omp for schedule(dynamic) ordered
+          for(int i=0; i<nlines; i++) {
+            LISAParams lineparams = *injectedparams;
+            lineparams.m1 = gsl_matrix_get(inmatrix, i, 0);
+            lineparams.m2 = gsl_matrix_get(inmatrix, i, 1);
+            lineparams.tRef = gsl_matrix_get(inmatrix, i, 2);
+            lineparams.distance = gsl_matrix_get(inmatrix, i, 3);
+            lineparams.phiRef = gsl_matrix_get(inmatrix, i, 4);
+            lineparams.inclination = gsl_matrix_get(inmatrix, i, 5);
+            lineparams.lambda = gsl_matrix_get(inmatrix, i, 6);
+            lineparams.beta = gsl_matrix_get(inmatrix, i, 7);
+            lineparams.polarization = gsl_matrix_get(inmatrix, i, 8);
+
+            /* Branch between the Fresnel or linear computation */
+            /* For Fresnel, (h|h) of the signal is the same as (s|s) of the injection - going through the signal cache of the thread, repeated lines are not regenerated */
+            double SNR = 0;
+            if(params->tagint==0) {
+              LISASignalCAmpPhase* signalCAmpPhase = NULL;
+              LISASignalCAmpPhase_Init(&signalCAmpPhase);
+              if(LISAGenerateSignalCAmpPhaseCachedRef(&lineparams, lineparams.tRef, signalCAmpPhase)==SUCCESS) SNR = sqrt(signalCAmpPhase->TDI123hh);
+              LISASignalCAmpPhase_Cleanup(signalCAmpPhase);
+            }
+            else if(params->tagint==1) {
+              LISAInjectionReIm* injReIm = NULL;
+              LISAInjectionReIm_Init(&injReIm);
+              LISAGenerateInjectionReImRef(&lineparams, lineparams.tRef, params->minf, params->nbptsoverlap, 0, injReIm); /* Hardcoded linear sampling */
+
+              double SNRA2 = FDOverlapReImvsReIm(injReIm->TDI1Signal, injReIm->TDI1Signal, injReIm->noisevalues1);
+              double SNRE2 = FDOverlapReImvsReIm(injReIm->TDI2Signal, injReIm->TDI2Signal, injReIm->noisevalues2);
+              double SNRT2 = FDOverlapReImvsReIm(injReIm->TDI3Signal, injReIm->TDI3Signal, injReIm->noisevalues3);
+              SNR = sqrt(SNRA2 + SNRE2 + SNRT2);
+              LISAInjectionReIm_Cleanup(injReIm);
+            }
+            else {
+              printf("Error in ComputeLISASNR: integration tag not recognized.\n");
+              exit(1);
+            }
+
+            /* Write the line, in the same format as Write_Text_Matrix */
+            #pragma omp ordered
+            {
+              fprintf(fout, "%.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e \n", lineparams.m1, lineparams.m2, lineparams.tRef, lineparams.distance, lineparams.phiRef, lineparams.inclination, lineparams.lambda, lineparams.beta, lineparams.polarization, SNR);
+            }
           }
 
-          /* Set values in output matrix */
-          gsl_matrix_set(outmatrix, i, 0, injectedparams->m1);
-          gsl_matrix_set(outmatrix, i, 1, injectedparams->m2);
-          gsl_matrix_set(outmatrix, i, 2, injectedparams->tRef);
-          gsl_matrix_set(outmatrix, i, 3, injectedparams->distance);
-          gsl_matrix_set(outmatrix, i, 4, injectedparams->phiRef);
-          gsl_matrix_set(outmatrix, i, 5, injectedparams->inclination);
-          gsl_matrix_set(outmatrix, i, 6, injectedparams->lambda);
-          gsl_matrix_set(outmatrix, i, 7, injectedparams->beta);
-          gsl_matrix_set(outmatrix, i, 8, injectedparams->polarization);
-          gsl_matrix_set(outmatrix, i, 9, SNR);
+          if(params->nbsignalcache>0) {
+            size_t threadhits, threadmisses;
+            LISASignalCacheStats(&threadhits, &threadmisses);
+            #pragma omp atomic
+            hits += threadhits;
+            #pragma omp atomic
+            misses += threadmisses;
+          }
         }
+        if(params->nbsignalcache>0) printf("Signal cache: %zu hits, %zu misses\n", hits, misses);
 
-        /* Output matrix */
-        Write_Text_Matrix(params->paramsdir, params->outputfile, outmatrix);
+        fclose(fout);
+        gsl_matrix_free(inmatrix);
       }
     }
   }
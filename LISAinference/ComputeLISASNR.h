@@ -74,6 +74,10 @@ typedef struct tagComputeLISASNRparams {
   char paramsdir[256];       /* Directory for the input/output file */
   char paramsfile[256];      /* Input file with the parameters */
   char outputfile[256];      /* Output file */
+  int nbsignalcache;         /* Number of generated signals kept in the per-thread cache (default 0, no cache) */
+  int fftmeasure;            /* Tag for planning the FFTs with FFTW_MEASURE instead of FFTW_ESTIMATE (default 0) */
+  int fftthreads;            /* Number of threads per FFT (default 1) */
+  char fftwisdom[256];       /* FFTW wisdom file, imported if it exists and exported at the end (default none) */
 } ComputeLISASNRparams;
 
 
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <float.h>
+#include <stdbool.h>
+#include <gsl/gsl_linalg.h>
+
+#include "LISAinference_common.h"
+
+
+/************************************************** Main program *******************************************************/
+/* This program works compatibly with LISAinference, and computes the Fisher matrix at the injection for the 9 parameters
+   (in order m1, m2, tRef, dist, phase, inc, lambda, beta, pol) from one-sided differences of the waveforms, i.e. with 10
+   waveform generations. The matrix is printed with the resulting 1-sigma errors, and written to --outdir/--outfile if given.
+   With --loadparamsfile, the Fisher matrices are computed in turn for the --nlinesparams injection points read from
+   --indir/--infile (format: m1, m2, tRef, dist, phase, inc, lambda, beta, pol), the distance being rescaled for each point
+   if --snr is given. One line is written per point to --outdir/--outfile, with format:
+   m1, m2, tRef, dist, phase, inc, lambda, beta, pol, SNR, followed by the 81 elements of the covariance matrix (row-major).
+*/
+int noMPI=1;
+
+/* Relative step for the masses and the distance, absolute step for the time (s) and angles (rad) */
+#define fisherrelstep 1e-6
+#define fishertimestep 1e-3
+#define fisheranglestep 1e-6
+
+/* Displace parameter i of params by step */
+static void DisplaceLISAParams(LISAParams* params, const int i, const double step)
+{
+  switch(i) {
+    case 0: params->m1 += step; break;
+    case 1: params->m2 += step; break;
+    case 2: params->tRef += step; break;
+    case 3: params->distance += step; break;
+    case 4: params->phiRef += step; break;
+    case 5: params->inclination += step; break;
+    case 6: params->lambda += step; break;
+    case 7: params->beta += step; break;
+    case 8: params->polarization += step; break;
+  }
+}
+
+/* Network SNR of an injection in Re/Im form */
+static double SNRReIm(LISAInjectionReIm* injection)
+{
+  double SNR1sq = FDOverlapReImvsReIm(injection->TDI1Signal, injection->TDI1Signal, injection->noisevalues1);
+  double SNR2sq = FDOverlapReImvsReIm(injection->TDI2Signal, injection->TDI2Signal, injection->noisevalues2);
+  double SNR3sq = FDOverlapReImvsReIm(injection->TDI3Signal, injection->TDI3Signal, injection->noisevalues3);
+  return sqrt(SNR1sq + SNR2sq + SNR3sq);
+}
+
+/* Fisher matrix and covariance at the injection given by injectedparams - if rescale is set and a target SNR is given, the distance of injectedparams is first rescaled */
+static int FisherAtInjection(const int rescale, double* SNR, gsl_matrix* fisher, gsl_matrix* cov)
+{
+  const int dim = 9;
+
+  /* The injection in Re/Im form provides the frequencies and noise values, whatever the integrator */
+  LISAInjectionReIm* injectedsignalReIm = NULL;
+  LISAInjectionReIm_Init(&injectedsignalReIm);
+  LISAGenerateInjectionReIm(injectedparams, globalparams->minf, globalparams->nbptsoverlap, 1, injectedsignalReIm); /* Use here logarithmic sampling as a default */
+  *SNR = SNRReIm(injectedsignalReIm);
+  if(rescale && !isnan(priorParams->snr_target)) {
+    injectedparams->distance *= *SNR / priorParams->snr_target;
+    LISAInjectionReIm_Cleanup(injectedsignalReIm);
+    LISAInjectionReIm_Init(&injectedsignalReIm);
+    LISAGenerateInjectionReIm(injectedparams, globalparams->minf, globalparams->nbptsoverlap, 1, injectedsignalReIm);
+    *SNR = SNRReIm(injectedsignalReIm);
+  }
+
+  /* Displaced parameters */
+  LISAParams params = *injectedparams;
+  params.nbmode = globalparams->nbmodetemp;
+  LISAParams paramsplus[9];
+  double steps[9] = {fisherrelstep*params.m1, fisherrelstep*params.m2, fishertimestep, fisherrelstep*params.distance, fisheranglestep, fisheranglestep, fisheranglestep, fisheranglestep, fisheranglestep};
+  for(int i=0; i<dim; i++) {
+    paramsplus[i] = params;
+    DisplaceLISAParams(&paramsplus[i], i, steps[i]);
+  }
+
+  /* Fisher matrix */
+  int ret = LISAComputeFisherReIm(&params, dim, paramsplus, NULL, steps, injectedsignalReIm, fisher->data);
+  LISAInjectionReIm_Cleanup(injectedsignalReIm);
+  if(ret==FAILURE) return FAILURE;
+
+  /* Covariance from the inverse */
+  gsl_matrix* lu = gsl_matrix_alloc(dim, dim);
+  gsl_permutation* perm = gsl_permutation_alloc(dim);
+  int signum;
+  gsl_matrix_memcpy(lu, fisher);
+  gsl_linalg_LU_decomp(lu, perm, &signum);
+  gsl_linalg_LU_invert(lu, perm, cov);
+  gsl_matrix_free(lu);
+  gsl_permutation_free(perm);
+  return SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+  noMPI = 1; //We have to set this to avoid an MPI_Comm_rank statement in the addendum
+
+	LISARunParams runParams = {};
+	int ndim=0, nPar=0;
+	int *freeparamsmap = NULL;
+	void *context = NULL;
+	double logZtrue;
+	addendum(argc, argv, &runParams, &ndim, &nPar, &freeparamsmap, &context, &logZtrue);
+
+  const int dim = 9;
+  gsl_matrix* fisher = gsl_matrix_alloc(dim, dim);
+  gsl_matrix* cov = gsl_matrix_alloc(dim, dim);
+  double SNR = 0.;
+
+  if(!(addparams->loadparamsfile)) {
+    /* The distance of the injection has already been rescaled in the addendum */
+    if(FisherAtInjection(0, &SNR, fisher, cov)==FAILURE) {
+      printf("Error: waveform generation failed in the Fisher matrix computation.\n");
+      exit(1);
+    }
+    printf("Fisher matrix (m1, m2, tRef, dist, phase, inc, lambda, beta, pol):\n");
+    for(int i=0; i<dim; i++) {
+      for(int j=0; j<dim; j++) printf("%.8e ", gsl_matrix_get(fisher, i, j));
+      printf("\n");
+    }
+    printf("1-sigma errors:\n");
+    for(int i=0; i<dim; i++) printf("%.8e ", sqrt(gsl_matrix_get(cov, i, i)));
+    printf("\n");
+
+    if(strlen(addparams->outdir)>0 && strlen(addparams->outfile)>0) Write_Text_Matrix(addparams->outdir, addparams->outfile, fisher);
+  }
+  else {
+    int nlines = addparams->nlinesparams;
+
+    /* Load parameters file */
+    /* Format (same as in the internals): m1, m2, tRef, dist, phase, inc, lambda, beta, pol */
+    gsl_matrix* inmatrix = gsl_matrix_alloc(nlines, dim);
+    Read_Text_Matrix(addparams->indir, addparams->infile, inmatrix);
+
+    /* Initialize output matrix */
+    /* Format: m1, m2, tRef, dist, phase, inc, lambda, beta, pol, SNR, covariance (row-major) */
+    gsl_matrix* outmatrix = gsl_matrix_alloc(nlines, dim + 1 + dim*dim);
+
+    /* The points are processed in turn, as the generation is relative to the global injectedparams - each Fisher matrix is computed in parallel */
+    for(int l=0; l<nlines; l++) {
+      injectedparams->m1 = gsl_matrix_get(inmatrix, l, 0);
+      injectedparams->m2 = gsl_matrix_get(inmatrix, l, 1);
+      injectedparams->tRef = gsl_matrix_get(inmatrix, l, 2);
+      injectedparams->distance = gsl_matrix_get(inmatrix, l, 3);
+      injectedparams->phiRef = gsl_matrix_get(inmatrix, l, 4);
+      injectedparams->inclination = gsl_matrix_get(inmatrix, l, 5);
+      injectedparams->lambda = gsl_matrix_get(inmatrix, l, 6);
+      injectedparams->beta = gsl_matrix_get(inmatrix, l, 7);
+      injectedparams->polarization = gsl_matrix_get(inmatrix, l, 8);
+      if(FisherAtInjection(1, &SNR, fisher, cov)==FAILURE) {
+        printf("Warning: waveform generation failed in the Fisher matrix computation for line %d.\n", l);
+        gsl_matrix_set_all(cov, NAN);
+      }
+
+      /* Set values in output matrix */
+      gsl_matrix_set(outmatrix, l, 0, injectedparams->m1);
+      gsl_matrix_set(outmatrix, l, 1, injectedparams->m2);
+      gsl_matrix_set(outmatrix, l, 2, injectedparams->tRef);
+      gsl_matrix_set(outmatrix, l, 3, injectedparams->distance);
+      gsl_matrix_set(outmatrix, l, 4, injectedparams->phiRef);
+      gsl_matrix_set(outmatrix, l, 5, injectedparams->inclination);
+      gsl_matrix_set(outmatrix, l, 6, injectedparams->lambda);
+      gsl_matrix_set(outmatrix, l, 7, injectedparams->beta);
+      gsl_matrix_set(outmatrix, l, 8, injectedparams->polarization);
+      gsl_matrix_set(outmatrix, l, 9, SNR);
+      for(int i=0; i<dim; i++) for(int j=0; j<dim; j++) gsl_matrix_set(outmatrix, l, dim + 1 + i*dim + j, gsl_matrix_get(cov, i, j));
+    }
+
+    /* Output matrix */
+    Write_Text_Matrix(addparams->outdir, addparams->outfile, outmatrix);
+    gsl_matrix_free(inmatrix);
+    gsl_matrix_free(outmatrix);
+  }
+
+  /* Cleanup */
+  gsl_matrix_free(fisher);
+  gsl_matrix_free(cov);
+  free(injectedparams);
+  free(globalparams);
+  free(addparams);
+  free(priorParams);
+}
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <float.h>
+#include <stdbool.h>
+#include <time.h>
+#include <gsl/gsl_rng.h>
+
+#include "LISAinference_common.h"
+
+
+/************************************************** Main program *******************************************************/
+/* This program works compatibly with LISAinference: for the injection given by the same arguments, it builds the
+   quadrature rules of the ROQ likelihood from templates drawn from the prior, writes them to --roqfile, and compares
+   the ROQ likelihood to the Fresnel likelihood on a validation set. The output file is then used with --tagint 3.
+*/
+int noMPI=1;
+
+/* Number of templates of the validation set */
+#define nbvalidateroq 32
+
+/* Draw parameters uniformly in the prior box - pinned or fixed parameters are set to their values, distance and phase are irrelevant for the ROQ and set to the injection */
+static void DrawPriorParams(gsl_rng* r, LISAParams* params)
+{
+  *params = *injectedparams;
+  params->nbmode = globalparams->nbmodetemp;
+  while(1) {
+    if(priorParams->samplemassparams==Mchirpeta) {
+      double Mchirp = isnan(priorParams->fix_Mchirp) ? priorParams->Mchirp_min + (priorParams->Mchirp_max - priorParams->Mchirp_min)*gsl_rng_uniform(r) : priorParams->fix_Mchirp;
+      double eta = isnan(priorParams->fix_eta) ? priorParams->eta_min + (priorParams->eta_max - priorParams->eta_min)*gsl_rng_uniform(r) : priorParams->fix_eta;
+      params->m1 = m1ofMchirpeta(Mchirp, eta);
+      params->m2 = m2ofMchirpeta(Mchirp, eta);
+      break;
+    }
+    params->m1 = isnan(priorParams->fix_m1) ? priorParams->comp_min + (priorParams->comp_max - priorParams->comp_min)*gsl_rng_uniform(r) : priorParams->fix_m1;
+    params->m2 = isnan(priorParams->fix_m2) ? priorParams->comp_min + (priorParams->comp_max - priorParams->comp_min)*gsl_rng_uniform(r) : priorParams->fix_m2;
+    if(params->m1<params->m2) {
+      double m = params->m1; params->m1 = params->m2; params->m2 = m;
+    }
+    double mtot = params->m1 + params->m2;
+    if(mtot>=priorParams->mtot_min && mtot<=priorParams->mtot_max && params->m1/params->m2<=priorParams->qmax) break;
+  }
+  params->tRef = isnan(priorParams->fix_time) ? injectedparams->tRef + priorParams->deltaT*(2*gsl_rng_uniform(r) - 1) : priorParams->fix_time;
+  params->inclination = isnan(priorParams->fix_inc) ? priorParams->inc_min + (priorParams->inc_max - priorParams->inc_min)*gsl_rng_uniform(r) : priorParams->fix_inc;
+  params->lambda = isnan(priorParams->fix_lambda) ? priorParams->lambda_min + (priorParams->lambda_max - priorParams->lambda_min)*gsl_rng_uniform(r) : priorParams->fix_lambda;
+  params->beta = isnan(priorParams->fix_beta) ? priorParams->beta_min + (priorParams->beta_max - priorParams->beta_min)*gsl_rng_uniform(r) : priorParams->fix_beta;
+  params->polarization = isnan(priorParams->fix_pol) ? priorParams->pol_min + (priorParams->pol_max - priorParams->pol_min)*gsl_rng_uniform(r) : priorParams->fix_pol;
+}
+
+int main(int argc, char *argv[])
+{
+  noMPI = 1; //We have to set this to avoid an MPI_Comm_rank statement in the addendum
+
+	LISARunParams runParams = {};
+	int ndim=0, nPar=0;
+	int *freeparamsmap = NULL;
+	void *context = NULL;
+	double logZtrue;
+	addendum(argc, argv, &runParams, &ndim, &nPar, &freeparamsmap, &context, &logZtrue);
+  if(globalparams->tagint!=0 || globalparams->tagsimplelikelihood) {
+    printf("Error: LISAROQbuild requires the Fresnel likelihood (--tagint 0) for the injection.\n");
+    exit(1);
+  }
+  LISAInjectionCAmpPhase* injectedsignalCAmpPhase = (LISAInjectionCAmpPhase*) context;
+
+  /* Training set: the injection, then templates drawn from the prior */
+  gsl_rng* r = gsl_rng_alloc(gsl_rng_mt19937);
+  int ntrain = globalparams->nbtrainroq;
+  LISAParams* trainingparams = malloc(ntrain*sizeof(LISAParams));
+  trainingparams[0] = *injectedparams;
+  trainingparams[0].nbmode = globalparams->nbmodetemp;
+  for(int t=1; t<ntrain; t++) DrawPriorParams(r, &trainingparams[t]);
+
+  /* Build and write the quadrature rules */
+  LISAInjectionROQ* roq = NULL;
+  LISAInjectionROQ_Init(&roq);
+  clock_t tbeg = clock();
+  if(LISABuildROQ(injectedsignalCAmpPhase, trainingparams, ntrain, globalparams->nbptsroq, globalparams->tolroq, roq)==FAILURE) exit(1);
+  printf("Time to build the ROQ: %g s\n", (double) (clock()-tbeg)/CLOCKS_PER_SEC);
+  int nbnodestot = 0;
+  for(int b=0; b<roq->nbblocks; b++) nbnodestot += roq->nbnodes[b];
+  printf("ROQ: %d blocks, %d nodes in total\n", roq->nbblocks, nbnodestot);
+  if(LISAWriteROQ(globalparams->roqfile, roq)==FAILURE) exit(1);
+
+  /* Validation: accuracy and cost of the ROQ likelihood against the Fresnel likelihood */
+  double errmax = 0., timefresnel = 0., timeroq = 0.;
+  for(int i=0; i<nbvalidateroq; i++) {
+    LISAParams params;
+    DrawPriorParams(r, &params);
+    params.distance = injectedparams->distance;
+    tbeg = clock();
+    double logLfresnel = CalculateLogLCAmpPhase(&params, injectedsignalCAmpPhase);
+    timefresnel += (double) (clock()-tbeg)/CLOCKS_PER_SEC;
+    tbeg = clock();
+    double logLroq = CalculateLogLROQ(&params, roq);
+    timeroq += (double) (clock()-tbeg)/CLOCKS_PER_SEC;
+    if(logLfresnel==-DBL_MAX || logLroq==-DBL_MAX) continue;
+    errmax = fmax(errmax, fabs(logLroq - logLfresnel));
+  }
+  printf("Validation on %d templates: max |logL_ROQ - logL_Fresnel| = %g\n", nbvalidateroq, errmax);
+  printf("Mean time per likelihood: Fresnel %g s, ROQ %g s\n", timefresnel/nbvalidateroq, timeroq/nbvalidateroq);
+
+  /* Cleanup */
+  gsl_rng_free(r);
+  free(trainingparams);
+  LISAInjectionROQ_Cleanup(roq);
+  LISAInjectionCAmpPhase_Cleanup(injectedsignalCAmpPhase);
+  free(injectedparams);
+  free(globalparams);
+  free(addparams);
+  free(priorParams);
+}
@@ -0,0 +1,722 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "omp.h"
+
+#include "LISAutils.h"
+#include "benchutils.h"
+
+
+/************************************************** Benchmark program *******************************************************/
+/* Microbenchmarks of the stages of the LISA likelihood, on a grid of total masses and observation durations around the
+   injection given on the command line (all options of LISAinference are accepted, the injection being the template
+   point of the grid) - reports ns/eval and allocations/eval, and checks the overlaps and loglikelihoods against
+   reference values stored in a file (LISAbench.ref holds the values before the optimizations, for the default options -
+   written on the first run if missing, or with --writeref) - optimized and approximate paths are also cross-checked in
+   the run against the exact ones */
+
+/* Grid of total masses (solar masses, mass ratio benchq) and observation durations (years) */
+static const double benchMtot[] = {2e5, 2e6, 2e7};
+static const double benchdeltatobs[] = {0.5, 2.};
+static const double benchq = 2.;
+#define nbbenchMtot (int) (sizeof(benchMtot)/sizeof(benchMtot[0]))
+#define nbbenchdeltatobs (int) (sizeof(benchdeltatobs)/sizeof(benchdeltatobs[0]))
+
+/* Training set of the ROQ: the template, and a grid of nbbenchroqtrain x nbbenchroqtrain component masses within a relative benchroqdm of the injection */
+/* The discrete inner products use nbbenchroqfreq frequencies - the default of --nbptsroq does not resolve the products of modes of the lightest systems */
+#define nbbenchroqtrain 4
+#define nbbenchroqfreq 16384
+static const double benchroqdm = 2e-4;
+
+/* Number of sky positions for the thread scaling of the response */
+#define nbbenchsky 64
+
+/* Number of frequencies for the check of the tabulated noise */
+#define nbbenchnoise 4096
+
+/* Everything needed by the benchmarked functions for one point of the grid */
+typedef struct tagLISABenchPoint {
+  LISAParams* tparams;                         /* Template parameters, close to the injection */
+  double fstartobs;                            /* Starting frequency of the 22 mode for deltatobs */
+  double fLow;                                 /* Frequency window of the overlaps */
+  double fHigh;
+  ObjectFunction Sn[3];                        /* Noise functions of the three channels */
+  ObjectFunction Sntab[3];                     /* Same, tabulated */
+  ListmodesCAmpPhaseFrequencySeries* listROM;  /* Template modes, before the response */
+  ListmodesCAmpPhaseFrequencySeries* listTDI[3];  /* Template modes in the three channels */
+  ListmodesCAmpPhaseSpline* splinesinj[3];     /* Splines of the injection in the three channels */
+  OverlapWorkspace* ws;                        /* Workspace for the allocation-free overlap */
+  CAmpPhaseSpline* integrandspline;            /* Splines of the 22-mode integrand, for ComputeInt - NULL if empty */
+  int nwip;                                    /* Injection 22 mode in channel 1 as plain arrays, for wip_phase */
+  double* fwip;
+  double* Arwip;
+  double* Aiwip;
+  double* phwip;
+  LISAInjectionCAmpPhase* injCAmpPhase;
+  LISAInjectionReIm* injReIm;
+  LISAInjectionRelBin* injRelBin;
+  LISAInjectionROQ* injROQ;
+  LISASignalReIm* sigReIm;                     /* Template on the frequencies of injReIm */
+  int nthreads;                                /* Number of threads for the response scaling */
+  double value;                                /* Output of the last call */
+} LISABenchPoint;
+
+/* wip_phase takes a plain function for the noise - channel 1 through a static object */
+static ObjectFunction benchwipnoise;
+static double BenchWIPNoise(double f) {
+  return ObjectFunctionCall(&benchwipnoise, f);
+}
+
+/************** Benchmarked functions *****************/
+
+static void BenchROM(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  LISAParams* t = p->tparams;
+  ListmodesCAmpPhaseFrequencySeries* list = NULL;
+  SimEOBNRv2HMROM(&list, t->nbmode, t->tRef - injectedparams->tRef, t->phiRef, globalparams->fRef, t->m1*MSUN_SI, t->m2*MSUN_SI, t->distance*1e6*PC_SI);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(list);
+}
+
+static void BenchROMExtTF2(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  LISAParams* t = p->tparams;
+  ListmodesCAmpPhaseFrequencySeries* list = NULL;
+  SimEOBNRv2HMROMExtTF2(&list, t->nbmode, globalparams->Mfmatch, fmax(p->fstartobs, globalparams->minf), 0, t->tRef - injectedparams->tRef, t->phiRef, globalparams->fRef, t->m1*MSUN_SI, t->m2*MSUN_SI, t->distance*1e6*PC_SI);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(list);
+}
+
+static void BenchResponse(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  LISAParams* t = p->tparams;
+  ListmodesCAmpPhaseFrequencySeries* l1 = NULL;
+  ListmodesCAmpPhaseFrequencySeries* l2 = NULL;
+  ListmodesCAmpPhaseFrequencySeries* l3 = NULL;
+  LISASimFDResponseTDI3Chan(globalparams->tagtRefatLISA, globalparams->variant, &(p->listROM), &l1, &l2, &l3, t->tRef, t->lambda, t->beta, t->inclination, t->polarization, t->m1, t->m2, globalparams->maxf, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(l1);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(l2);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(l3);
+}
+
+/* Response for nbbenchsky sky positions, shared between p->nthreads threads */
+static void BenchResponseOMP(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  LISAParams* t = p->tparams;
+  #pragma omp parallel for num_threads(p->nthreads) schedule(dynamic)
+  for(int i=0; i<nbbenchsky; i++) {
+    double lambda = 2*PI * (i + 0.5) / nbbenchsky;
+    double beta = asin(2 * ((i*37 % nbbenchsky) + 0.5) / nbbenchsky - 1.);
+    ListmodesCAmpPhaseFrequencySeries* l1 = NULL;
+    ListmodesCAmpPhaseFrequencySeries* l2 = NULL;
+    ListmodesCAmpPhaseFrequencySeries* l3 = NULL;
+    LISASimFDResponseTDI3Chan(globalparams->tagtRefatLISA, globalparams->variant, &(p->listROM), &l1, &l2, &l3, t->tRef, lambda, beta, t->inclination, t->polarization, t->m1, t->m2, globalparams->maxf, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+    ListmodesCAmpPhaseFrequencySeries_Destroy(l1);
+    ListmodesCAmpPhaseFrequencySeries_Destroy(l2);
+    ListmodesCAmpPhaseFrequencySeries_Destroy(l3);
+  }
+}
+
+static void BenchSplines(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  for(int c=0; c<3; c++) {
+    ListmodesCAmpPhaseSpline* splines = NULL;
+    BuildListmodesCAmpPhaseSpline(&splines, p->listTDI[c]);
+    ListmodesCAmpPhaseSpline_Destroy(splines);
+  }
+}
+
+static void BenchSplines3Chan(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  ListmodesCAmpPhaseSpline* splines[3] = {NULL, NULL, NULL};
+  BuildListmodesCAmpPhaseSpline3Chan(&splines[0], &splines[1], &splines[2], p->listTDI[0], p->listTDI[1], p->listTDI[2]);
+  for(int c=0; c<3; c++) ListmodesCAmpPhaseSpline_Destroy(splines[c]);
+}
+
+static void BenchSplinesSoA(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  OverlapWorkspace_BuildSplinesSoA(p->ws, p->listTDI[0], p->listTDI[1], p->listTDI[2]);
+}
+
+/* Copy of the splines of the injection from the matrix form to the SoA form, as done by the overlaps taking the matrix form */
+static void BenchSplinesSoASet(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  ModesCAmpPhaseSpline3ChanSoA* splines = p->ws->splinessoa;
+  int k = 0;
+  for(ListmodesCAmpPhaseSpline* l = p->splinesinj[0]; l; l = l->next) {
+    ModesCAmpPhaseSpline3ChanSoA_Reserve(splines, k+1);
+    CAmpPhaseSpline3ChanSoA_Set(splines->splines[k], l->splines, ListmodesCAmpPhaseSpline_GetMode(p->splinesinj[1], l->l, l->m)->splines, ListmodesCAmpPhaseSpline_GetMode(p->splinesinj[2], l->l, l->m)->splines);
+    k++;
+  }
+}
+
+static void BenchOverlap(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = FDListmodesFresnelOverlap3Chan(p->listTDI[0], p->listTDI[1], p->listTDI[2], p->splinesinj[0], p->splinesinj[1], p->splinesinj[2], &(p->Sn[0]), &(p->Sn[1]), &(p->Sn[2]), p->fLow, p->fHigh, p->fstartobs, p->fstartobs);
+}
+
+static void BenchOverlapWS(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = FDListmodesFresnelOverlap3ChanWS(p->listTDI[0], p->listTDI[1], p->listTDI[2], p->splinesinj[0], p->splinesinj[1], p->splinesinj[2], &(p->Sn[0]), &(p->Sn[1]), &(p->Sn[2]), p->fLow, p->fHigh, p->fstartobs, p->fstartobs, p->ws);
+}
+
+static void BenchOverlapSoAWS(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = FDListmodesFresnelOverlap3ChanSoAWS(p->listTDI[0], p->listTDI[1], p->listTDI[2], p->injCAmpPhase->TDI123SplinesSoA, &(p->Sn[0]), &(p->Sn[1]), &(p->Sn[2]), p->fLow, p->fHigh, p->fstartobs, p->fstartobs, p->ws);
+}
+
+static void BenchOverlapTab(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = FDListmodesFresnelOverlap3ChanWS(p->listTDI[0], p->listTDI[1], p->listTDI[2], p->splinesinj[0], p->splinesinj[1], p->splinesinj[2], &(p->Sntab[0]), &(p->Sntab[1]), &(p->Sntab[2]), p->fLow, p->fHigh, p->fstartobs, p->fstartobs, p->ws);
+}
+
+static void BenchComputeInt(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = 4.*creal(ComputeInt(p->integrandspline->spline_amp_real, p->integrandspline->spline_amp_imag, p->integrandspline->quadspline_phase));
+}
+
+static void BenchComputeIntScalar(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = 4.*creal(ComputeIntScalar(p->integrandspline->spline_amp_real, p->integrandspline->spline_amp_imag, p->integrandspline->quadspline_phase));
+}
+
+/* Sum over the intervals of eps*|A0|, scale of the contributions to ComputeInt */
+static double BenchComputeIntScale(CAmpPhaseSpline* splines) {
+  double scale = 0.;
+  for(int j=0; j<(int) splines->quadspline_phase->size1 - 1; j++) {
+    double eps = gsl_matrix_get(splines->quadspline_phase, j+1, 0) - gsl_matrix_get(splines->quadspline_phase, j, 0);
+    scale += eps * hypot(gsl_matrix_get(splines->spline_amp_real, j, 1), gsl_matrix_get(splines->spline_amp_imag, j, 1));
+  }
+  return scale;
+}
+
+/* Largest deviation between the coefficients of two splines in SoA form, relative to the largest coefficient of each array */
+static double BenchSplinesSoADeviation(CAmpPhaseSpline3ChanSoA* s1, CAmpPhaseSpline3ChanSoA* s2) {
+  if(s1->n!=s2->n) return INFINITY;
+  int n = s1->n;
+  const double* a1[8] = {s1->freq, s1->phase[0], s1->phase[1], s1->phase[2], s1->amp[0], s1->amp[1], s1->amp[2], s1->amp[3]};
+  const double* a2[8] = {s2->freq, s2->phase[0], s2->phase[1], s2->phase[2], s2->amp[0], s2->amp[1], s2->amp[2], s2->amp[3]};
+  double dev = 0.;
+  for(int a=0; a<8; a++) {
+    int size = (a<4) ? n : 6*n;
+    double scale = 0., diff = 0.;
+    for(int i=0; i<size; i++) {
+      scale = fmax(scale, fabs(a2[a][i]));
+      diff = fmax(diff, fabs(a1[a][i] - a2[a][i]));
+    }
+    if(scale>0.) dev = fmax(dev, diff/scale);
+  }
+  return dev;
+}
+
+/* Largest deviation of the integrand of the three channels, computed from the splines in SoA form, from the sum of the single-channel integrands computed from the splines in matrix form - relative to the largest value of each of amplitude and phase */
+static double BenchIntegrandDeviation(CAmpPhaseFrequencySeries* integrand, CAmpPhaseFrequencySeries* freqseries1[3], CAmpPhaseSpline* splines2[3], ObjectFunction Sn[3], const double fLow, const double fHigh) {
+  int n = (int) integrand->freq->size;
+  double* ampreal = (double*) calloc(n, sizeof(double));
+  double* ampimag = (double*) calloc(n, sizeof(double));
+  double devfreq = 0., devphase = 0., scalephase = 0.;
+  for(int c=0; c<3; c++) {
+    CAmpPhaseFrequencySeries* integrandchan = NULL;
+    ComputeIntegrandValues(&integrandchan, freqseries1[c], splines2[c], &(Sn[c]), fLow, fHigh);
+    if((int) integrandchan->freq->size!=n) {
+      CAmpPhaseFrequencySeries_Cleanup(integrandchan);
+      free(ampreal);
+      free(ampimag);
+      return INFINITY;
+    }
+    for(int i=0; i<n; i++) {
+      ampreal[i] += gsl_vector_get(integrandchan->amp_real, i);
+      ampimag[i] += gsl_vector_get(integrandchan->amp_imag, i);
+      devfreq = fmax(devfreq, fabs(gsl_vector_get(integrandchan->freq, i) - gsl_vector_get(integrand->freq, i)) / gsl_vector_get(integrand->freq, i));
+      devphase = fmax(devphase, fabs(gsl_vector_get(integrandchan->phase, i) - gsl_vector_get(integrand->phase, i)));
+      scalephase = fmax(scalephase, fabs(gsl_vector_get(integrand->phase, i)));
+    }
+    CAmpPhaseFrequencySeries_Cleanup(integrandchan);
+  }
+  double devamp = 0., scaleamp = 0.;
+  for(int i=0; i<n; i++) {
+    devamp = fmax(devamp, hypot(gsl_vector_get(integrand->amp_real, i) - ampreal[i], gsl_vector_get(integrand->amp_imag, i) - ampimag[i]));
+    scaleamp = fmax(scaleamp, hypot(ampreal[i], ampimag[i]));
+  }
+  free(ampreal);
+  free(ampimag);
+  return fmax(devfreq, fmax(devamp/scaleamp, scalephase>0. ? devphase/scalephase : devphase));
+}
+
+/* Largest relative deviation of the tabulated noise from the exact one, on logarithmically spaced frequencies of [fLow, fHigh] falling between the nodes of the table */
+static double BenchNoiseTabDeviation(ObjectFunction* Sn, ObjectFunction* Sntab, const double fLow, const double fHigh) {
+  double dev = 0.;
+  for(int i=0; i<nbbenchnoise; i++) {
+    double f = fLow * pow(fHigh/fLow, (i+0.5)/nbbenchnoise);
+    dev = fmax(dev, fabs(ObjectFunctionCall(Sntab, f)/ObjectFunctionCall(Sn, f) - 1.));
+  }
+  return dev;
+}
+
+static void BenchWIP(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  CAmpPhaseFrequencySeries* h1 = ListmodesCAmpPhaseFrequencySeries_GetMode(p->listTDI[0], 2, 2)->freqseries;
+  p->value = 4.*creal(wip_phase(h1->freq->data, (int) h1->freq->size, p->fwip, p->nwip, h1->amp_real->data, h1->amp_imag->data, h1->phase->data, p->Arwip, p->Aiwip, p->phwip, BenchWIPNoise, 1.0, p->fLow, p->fHigh));
+}
+
+static void BenchLogLCAmpPhase(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = CalculateLogLCAmpPhase(p->tparams, p->injCAmpPhase);
+}
+
+static void BenchLogLRelBin(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = CalculateLogLRelBin(p->tparams, p->injRelBin);
+}
+
+static void BenchLogLROQ(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = CalculateLogLROQ(p->tparams, p->injROQ);
+}
+
+static void BenchLogLReIm(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = CalculateLogLReIm(p->tparams, p->injReIm);
+}
+
+static void BenchFDLogLikelihoodReIm(void* arg) {
+  LISABenchPoint* p = (LISABenchPoint*) arg;
+  p->value = FDLogLikelihoodReIm(p->injReIm->TDI1Signal, p->sigReIm->TDI1Signal, p->injReIm->noisevalues1)
+           + FDLogLikelihoodReIm(p->injReIm->TDI2Signal, p->sigReIm->TDI2Signal, p->injReIm->noisevalues2)
+           + FDLogLikelihoodReIm(p->injReIm->TDI3Signal, p->sigReIm->TDI3Signal, p->injReIm->noisevalues3);
+}
+
+/* Batched ROM generation for nbbatch templates around the template */
+typedef struct tagLISABenchBatch {
+  int nbbatch;
+  int nbmode;
+  double* deltatRef;
+  double* phiRef;
+  double* m1SI;
+  double* m2SI;
+  double* distance;
+} LISABenchBatch;
+
+static void BenchROMBatch(void* arg) {
+  LISABenchBatch* b = (LISABenchBatch*) arg;
+  ListmodesCAmpPhaseFrequencySeries** lists = (ListmodesCAmpPhaseFrequencySeries**) calloc(b->nbbatch, sizeof(ListmodesCAmpPhaseFrequencySeries*));
+  SimEOBNRv2HMROMBatch(lists, NULL, b->nbbatch, b->nbmode, b->deltatRef, b->phiRef, globalparams->fRef, b->m1SI, b->m2SI, b->distance);
+  for(int i=0; i<b->nbbatch; i++) ListmodesCAmpPhaseFrequencySeries_Destroy(lists[i]);
+  free(lists);
+}
+
+/* TD TDI from a chirping hplus, hcross sampled on a uniform grid - the time step is not a divisor of the arm delay, so that the delays are interpolated */
+typedef struct tagLISABenchTDITD {
+  LISAconstellation* variant;
+  LISAGeometricCoeffs coeffs;
+  gsl_spline* splinehp;
+  gsl_spline* splinehc;
+  gsl_interp_accel* accelhp;
+  gsl_interp_accel* accelhc;
+  gsl_vector* times;
+  int nbptmargin;
+  RealTimeSeries* TDI[3];                      /* Output of GenerateTDITD3Chanhphc */
+  double* tdisample[3];                        /* Output of the sample-by-sample evaluation */
+} LISABenchTDITD;
+
+static void BenchTDITD(void* arg) {
+  LISABenchTDITD* b = (LISABenchTDITD*) arg;
+  for(int c=0; c<3; c++) {
+    if(b->TDI[c]) RealTimeSeries_Cleanup(b->TDI[c]);
+    b->TDI[c] = NULL;
+  }
+  GenerateTDITD3Chanhphc(b->variant, &b->coeffs, &b->TDI[0], &b->TDI[1], &b->TDI[2], b->splinehp, b->splinehc, b->accelhp, b->accelhc, b->times, b->nbptmargin, TDIXYZ);
+}
+
+static void BenchTDITDSample(void* arg) {
+  LISABenchTDITD* b = (LISABenchTDITD*) arg;
+  for(int i=b->nbptmargin; i<(int) b->times->size - b->nbptmargin; i++) {
+    EvaluateTDIXYZTD(b->variant, &b->coeffs, &b->tdisample[0][i], &b->tdisample[1][i], &b->tdisample[2][i], b->splinehp, b->splinehc, b->accelhp, b->accelhc, gsl_vector_get(b->times, i));
+  }
+}
+
+/* Quadrature rules of the ROQ likelihood, for a training set around the injection including the template */
+/* The training set is far too sparse to generalize to other templates - the check against the Fresnel likelihood measures the quadrature itself */
+static int BenchBuildROQ(LISAInjectionCAmpPhase* injection, LISAParams* tparams, LISAInjectionROQ* roq) {
+  int ntrain = 1 + nbbenchroqtrain*nbbenchroqtrain;
+  LISAParams* trainingparams = (LISAParams*) malloc(ntrain*sizeof(LISAParams));
+  trainingparams[0] = *tparams;
+  for(int i=0; i<nbbenchroqtrain; i++) {
+    for(int j=0; j<nbbenchroqtrain; j++) {
+      LISAParams* t = &trainingparams[1 + i*nbbenchroqtrain + j];
+      *t = *injectedparams;
+      t->nbmode = globalparams->nbmodetemp;
+      t->m1 *= 1. + benchroqdm * (2.*i/(nbbenchroqtrain-1) - 1.);
+      t->m2 *= 1. + benchroqdm * (2.*j/(nbbenchroqtrain-1) - 1.);
+    }
+  }
+  int ret = LISABuildROQ(injection, trainingparams, ntrain, nbbenchroqfreq, globalparams->tolroq, roq);
+  free(trainingparams);
+  return ret;
+}
+
+/************** Driver *****************/
+
+/* Time fn on the point p and print the result - with check of p->value if hasvalue */
+static void BenchPoint(BenchContext* ctx, const char name[], const int index, void (*fn)(void*), LISABenchPoint* p, const int hasvalue) {
+  double nseval, allocseval;
+  BenchRun(ctx, fn, p, &nseval, &allocseval);
+  BenchReport(ctx, name, index, nseval, allocseval, hasvalue, p->value);
+}
+
+static void BenchGridPoint(BenchContext* ctx, const int index) {
+  LISABenchPoint p;
+  memset(&p, 0, sizeof(LISABenchPoint));
+
+  /* Template: injection with slightly shifted mass and phase */
+  LISAParams tparams = *injectedparams;
+  tparams.m1 *= 1. + 1e-4;
+  tparams.phiRef += 0.1;
+  tparams.nbmode = globalparams->nbmodetemp;
+  p.tparams = &tparams;
+
+  if(!(globalparams->deltatobs==0.)) p.fstartobs = Newtonianfoft(tparams.m1, tparams.m2, globalparams->deltatobs);
+  p.fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
+  p.fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
+  double tabtol = globalparams->noisetabletol>0 ? globalparams->noisetabletol : 1e-6;
+  for(int c=0; c<3; c++) {
+    p.Sn[c] = NoiseFunction(globalparams->variant, globalparams->tagtdi, c+1);
+    p.Sntab[c] = NoiseFunctionTabulated(globalparams->variant, globalparams->tagtdi, c+1, tabtol);
+  }
+  benchwipnoise = p.Sn[0];
+
+  /* Injections for the three likelihoods */
+  LISAInjectionCAmpPhase_Init(&(p.injCAmpPhase));
+  LISAInjectionReIm_Init(&(p.injReIm));
+  LISAInjectionRelBin_Init(&(p.injRelBin));
+  LISAInjectionROQ_Init(&(p.injROQ));
+  LISASignalReIm_Init(&(p.sigReIm));
+  if(LISAGenerateInjectionCAmpPhase(injectedparams, p.injCAmpPhase)==FAILURE
+     || LISAGenerateInjectionReIm(injectedparams, globalparams->minf, globalparams->nbptsoverlap, 1, p.injReIm)==FAILURE
+     || LISAGenerateInjectionRelBin(injectedparams, p.injCAmpPhase, globalparams->nbbinsrelbin, p.injRelBin)==FAILURE
+     || BenchBuildROQ(p.injCAmpPhase, &tparams, p.injROQ)==FAILURE
+     || LISAGenerateSignalReIm(&tparams, p.injReIm->freq, p.sigReIm)==FAILURE) {
+    printf("Error: generation of the injection failed for grid point %d\n", index);
+    ctx->nbfail++;
+    LISAInjectionCAmpPhase_Cleanup(p.injCAmpPhase);
+    LISAInjectionReIm_Cleanup(p.injReIm);
+    LISAInjectionRelBin_Cleanup(p.injRelBin);
+    LISAInjectionROQ_Cleanup(p.injROQ);
+    LISASignalReIm_Cleanup(p.sigReIm);
+    return;
+  }
+  for(int c=0; c<3; c++) p.splinesinj[c] = (c==0) ? p.injCAmpPhase->TDI1Splines : (c==1) ? p.injCAmpPhase->TDI2Splines : p.injCAmpPhase->TDI3Splines;
+
+  /* Template modes, before and after the response */
+  if(!(globalparams->tagextpn)) SimEOBNRv2HMROM(&(p.listROM), tparams.nbmode, tparams.tRef - injectedparams->tRef, tparams.phiRef, globalparams->fRef, tparams.m1*MSUN_SI, tparams.m2*MSUN_SI, tparams.distance*1e6*PC_SI);
+  else SimEOBNRv2HMROMExtTF2(&(p.listROM), tparams.nbmode, globalparams->Mfmatch, fmax(p.fstartobs, globalparams->minf), 0, tparams.tRef - injectedparams->tRef, tparams.phiRef, globalparams->fRef, tparams.m1*MSUN_SI, tparams.m2*MSUN_SI, tparams.distance*1e6*PC_SI);
+  LISASimFDResponseTDI3Chan(globalparams->tagtRefatLISA, globalparams->variant, &(p.listROM), &(p.listTDI[0]), &(p.listTDI[1]), &(p.listTDI[2]), tparams.tRef, tparams.lambda, tparams.beta, tparams.inclination, tparams.polarization, tparams.m1, tparams.m2, globalparams->maxf, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+
+  /* Workspace for the overlaps, sized for the longest mode */
+  int nmax = 0;
+  for(ListmodesCAmpPhaseFrequencySeries* l = p.listTDI[0]; l; l = l->next) nmax = max(nmax, (int) l->freqseries->freq->size);
+  OverlapWorkspace_Init(&(p.ws), nmax);
+
+  /* Injection 22 mode in channel 1 for wip_phase - the first column of the splines holds the frequencies, the second the values */
+  CAmpPhaseSpline* splinesinj22 = ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[0], 2, 2)->splines;
+  p.nwip = (int) splinesinj22->spline_amp_real->size1;
+  p.fwip = (double*) malloc(p.nwip*sizeof(double));
+  p.Arwip = (double*) malloc(p.nwip*sizeof(double));
+  p.Aiwip = (double*) malloc(p.nwip*sizeof(double));
+  p.phwip = (double*) malloc(p.nwip*sizeof(double));
+  for(int i=0; i<p.nwip; i++) {
+    p.fwip[i] = gsl_matrix_get(splinesinj22->spline_amp_real, i, 0);
+    p.Arwip[i] = gsl_matrix_get(splinesinj22->spline_amp_real, i, 1);
+    p.Aiwip[i] = gsl_matrix_get(splinesinj22->spline_amp_imag, i, 1);
+    p.phwip[i] = gsl_matrix_get(splinesinj22->quadspline_phase, i, 1);
+  }
+
+  /* Splines of the integrand of the 22 mode, rescaled as in the overlaps */
+  CAmpPhaseFrequencySeries* integrand = NULL;
+  int retintegrand = ComputeIntegrandValues3Chan(&integrand, ListmodesCAmpPhaseFrequencySeries_GetMode(p.listTDI[0], 2, 2)->freqseries, ListmodesCAmpPhaseFrequencySeries_GetMode(p.listTDI[1], 2, 2)->freqseries, ListmodesCAmpPhaseFrequencySeries_GetMode(p.listTDI[2], 2, 2)->freqseries, ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[0], 2, 2)->splines, ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[1], 2, 2)->splines, ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[2], 2, 2)->splines, &(p.Sn[0]), &(p.Sn[1]), &(p.Sn[2]), p.fLow, p.fHigh);
+  double devintegrand = 0.;
+  if(retintegrand>=0) {
+    CAmpPhaseFrequencySeries* freqseries1[3];
+    CAmpPhaseSpline* splines2[3];
+    for(int c=0; c<3; c++) {
+      freqseries1[c] = ListmodesCAmpPhaseFrequencySeries_GetMode(p.listTDI[c], 2, 2)->freqseries;
+      splines2[c] = ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[c], 2, 2)->splines;
+    }
+    devintegrand = BenchIntegrandDeviation(integrand, freqseries1, splines2, p.Sn, p.fLow, p.fHigh);
+    double scaling = 10./gsl_vector_get(integrand->freq, integrand->freq->size-1);
+    gsl_vector_scale(integrand->freq, scaling);
+    gsl_vector_scale(integrand->amp_real, 1./scaling);
+    gsl_vector_scale(integrand->amp_imag, 1./scaling);
+    BuildSplineCoeffs(&(p.integrandspline), integrand);
+  }
+
+  printf("# Grid point %d: m1=%g m2=%g deltatobs=%g - %d frequencies in the 22 mode\n", index, injectedparams->m1, injectedparams->m2, globalparams->deltatobs, (int) ListmodesCAmpPhaseFrequencySeries_GetMode(p.listTDI[0], 2, 2)->freqseries->freq->size);
+  BenchPoint(ctx, "SimEOBNRv2HMROM", index, BenchROM, &p, 0);
+  BenchPoint(ctx, "SimEOBNRv2HMROMExtTF2", index, BenchROMExtTF2, &p, 0);
+  BenchPoint(ctx, "LISASimFDResponseTDI3Chan", index, BenchResponse, &p, 0);
+  BenchPoint(ctx, "BuildListmodesCAmpPhaseSpline", index, BenchSplines, &p, 0);
+  BenchPoint(ctx, "BuildListmodesCAmpPhaseSpline3Chan", index, BenchSplines3Chan, &p, 0);
+  BenchPoint(ctx, "CAmpPhaseSpline3ChanSoA_Set", index, BenchSplinesSoASet, &p, 0);
+  BenchPoint(ctx, "OverlapWorkspace_BuildSplinesSoA", index, BenchSplinesSoA, &p, 0);
+  /* Splines of the injection built directly in SoA form against the copy of the matrix form */
+  ModesCAmpPhaseSpline3ChanSoA* splinesinjsoa = p.injCAmpPhase->TDI123SplinesSoA;
+  CAmpPhaseSpline3ChanSoA* splinesset = NULL;
+  CAmpPhaseSpline3ChanSoA_Init(&splinesset, 0);
+  double devsoa = 0.;
+  for(int k=0; k<splinesinjsoa->nbmode; k++) {
+    int l = splinesinjsoa->l[k], m = splinesinjsoa->m[k];
+    CAmpPhaseSpline3ChanSoA_Set(splinesset, ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[0], l, m)->splines, ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[1], l, m)->splines, ListmodesCAmpPhaseSpline_GetMode(p.splinesinj[2], l, m)->splines);
+    devsoa = fmax(devsoa, BenchSplinesSoADeviation(splinesinjsoa->splines[k], splinesset));
+  }
+  CAmpPhaseSpline3ChanSoA_Cleanup(splinesset);
+  BenchCheck(ctx, "BuildModesCAmpPhaseSpline3ChanSoA/Set", index, devsoa, 0., 1., 1e-15);
+  BenchPoint(ctx, "FDListmodesFresnelOverlap3Chan", index, BenchOverlap, &p, 1);
+  double overlapnows = p.value;
+  BenchPoint(ctx, "FDListmodesFresnelOverlap3ChanWS", index, BenchOverlapWS, &p, 1);
+  BenchCheck(ctx, "FDListmodesFresnelOverlap3ChanWS/3Chan", index, p.value, overlapnows, 0., 1e-12);
+  BenchPoint(ctx, "FDListmodesFresnelOverlap3ChanSoAWS", index, BenchOverlapSoAWS, &p, 1);
+  BenchCheck(ctx, "FDListmodesFresnelOverlap3ChanSoAWS/3Chan", index, p.value, overlapnows, 0., 1e-12);
+  BenchPoint(ctx, "FDListmodesFresnelOverlap3ChanTab", index, BenchOverlapTab, &p, 1);
+  /* Tabulated noise against the exact noise functions, with relative accuracy tabtol - the overlap inherits the accuracy of 1/Sn */
+  double devnoisetab = 0.;
+  for(int c=0; c<3; c++) devnoisetab = fmax(devnoisetab, BenchNoiseTabDeviation(&(p.Sn[c]), &(p.Sntab[c]), p.fLow, p.fHigh));
+  BenchCheck(ctx, "NoiseFunctionTabulated/NoiseFunction", index, devnoisetab, 0., 1., tabtol);
+  BenchCheck(ctx, "FDListmodesFresnelOverlap3ChanTab/3Chan", index, p.value, overlapnows, 0., 2*tabtol);
+  if(p.integrandspline) {
+    BenchPoint(ctx, "ComputeInt", index, BenchComputeInt, &p, 1);
+    BenchPoint(ctx, "ComputeIntScalar", index, BenchComputeIntScalar, &p, 1);
+    /* Batched kernels against the interval-by-interval reference, normalized by the sum of the moduli of the contributions */
+    double complex integral = ComputeInt(p.integrandspline->spline_amp_real, p.integrandspline->spline_amp_imag, p.integrandspline->quadspline_phase);
+    double complex integralscalar = ComputeIntScalar(p.integrandspline->spline_amp_real, p.integrandspline->spline_amp_imag, p.integrandspline->quadspline_phase);
+    double integralscale = BenchComputeIntScale(p.integrandspline);
+    BenchCheck(ctx, "ComputeInt/ComputeIntScalar:re", index, creal(integral), creal(integralscalar), integralscale, 1e-12);
+    BenchCheck(ctx, "ComputeInt/ComputeIntScalar:im", index, cimag(integral), cimag(integralscalar), integralscale, 1e-12);
+    /* Integrand from the splines in SoA form against the sum of the single-channel integrands from the splines in matrix form */
+    BenchCheck(ctx, "ComputeIntegrandValues3Chan/ComputeIntegrandValues", index, devintegrand, 0., 1., 1e-12);
+  }
+  BenchPoint(ctx, "wip_phase", index, BenchWIP, &p, 1);
+  BenchPoint(ctx, "CalculateLogLCAmpPhase", index, BenchLogLCAmpPhase, &p, 1);
+  double logLCAmpPhase = p.value;
+  BenchPoint(ctx, "CalculateLogLRelBin", index, BenchLogLRelBin, &p, 1);
+  /* Relative binning against the full likelihood for the template close to the fiducial, normalized by (s|s) */
+  BenchCheck(ctx, "CalculateLogLRelBin/CalculateLogLCAmpPhase", index, p.value, logLCAmpPhase, p.injRelBin->TDI123ss, 1e-4);
+  BenchPoint(ctx, "CalculateLogLROQ", index, BenchLogLROQ, &p, 1);
+  /* Same for the ROQ, the template being in the training set */
+  BenchCheck(ctx, "CalculateLogLROQ/CalculateLogLCAmpPhase", index, p.value, logLCAmpPhase, p.injROQ->TDI123ss, 1e-4);
+  BenchPoint(ctx, "CalculateLogLReIm", index, BenchLogLReIm, &p, 1);
+  BenchPoint(ctx, "FDLogLikelihoodReIm", index, BenchFDLogLikelihoodReIm, &p, 1);
+
+  /* Thread scaling of the response, on the grid point with the middle mass only */
+  if(index==(nbbenchMtot/2)*nbbenchdeltatobs) {
+    int maxthreads = omp_get_max_threads();
+    for(int nthreads=1; nthreads<=maxthreads; nthreads*=2) {
+      double nseval, allocseval;
+      p.nthreads = nthreads;
+      BenchRun(ctx, BenchResponseOMP, &p, &nseval, &allocseval);
+      BenchReport(ctx, "LISASimFDResponseTDI3ChanOMP", nthreads, nseval/nbbenchsky, allocseval/nbbenchsky, 0, 0.);
+    }
+  }
+
+  /* Clean up */
+  if(integrand) CAmpPhaseFrequencySeries_Cleanup(integrand);
+  if(p.integrandspline) CAmpPhaseSpline_Cleanup(p.integrandspline);
+  free(p.fwip);
+  free(p.Arwip);
+  free(p.Aiwip);
+  free(p.phwip);
+  OverlapWorkspace_Cleanup(p.ws);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(p.listROM);
+  for(int c=0; c<3; c++) ListmodesCAmpPhaseFrequencySeries_Destroy(p.listTDI[c]);
+  LISAInjectionCAmpPhase_Cleanup(p.injCAmpPhase);
+  LISAInjectionReIm_Cleanup(p.injReIm);
+  LISAInjectionRelBin_Cleanup(p.injRelBin);
+  LISAInjectionROQ_Cleanup(p.injROQ);
+  LISASignalReIm_Cleanup(p.sigReIm);
+}
+
+/* Batched ROM generation, reported per template - to compare with SimEOBNRv2HMROM */
+static void BenchROMBatches(BenchContext* ctx) {
+  static const int nbbatches[] = {1, 4, 16, 64};
+  for(int k=0; k<(int) (sizeof(nbbatches)/sizeof(nbbatches[0])); k++) {
+    LISABenchBatch b;
+    b.nbbatch = nbbatches[k];
+    b.nbmode = globalparams->nbmodetemp;
+    b.deltatRef = (double*) malloc(b.nbbatch*sizeof(double));
+    b.phiRef = (double*) malloc(b.nbbatch*sizeof(double));
+    b.m1SI = (double*) malloc(b.nbbatch*sizeof(double));
+    b.m2SI = (double*) malloc(b.nbbatch*sizeof(double));
+    b.distance = (double*) malloc(b.nbbatch*sizeof(double));
+    for(int i=0; i<b.nbbatch; i++) {
+      b.deltatRef[i] = 0.;
+      b.phiRef[i] = injectedparams->phiRef + 0.01*i;
+      b.m1SI[i] = injectedparams->m1 * (1. + 1e-3*i) * MSUN_SI;
+      b.m2SI[i] = injectedparams->m2 * MSUN_SI;
+      b.distance[i] = injectedparams->distance * 1e6*PC_SI;
+    }
+    double nseval, allocseval;
+    BenchRun(ctx, BenchROMBatch, &b, &nseval, &allocseval);
+    BenchReport(ctx, "SimEOBNRv2HMROMBatch", b.nbbatch, nseval/b.nbbatch, allocseval/b.nbbatch, 0, 0.);
+    free(b.deltatRef);
+    free(b.phiRef);
+    free(b.m1SI);
+    free(b.m2SI);
+    free(b.distance);
+  }
+}
+
+/* TD TDI with the delays applied to the yAB precomputed on the grid, against the sample-by-sample evaluation of the delayed yAB */
+/* The 4-point Lagrange interpolation of the delays has an error O((2pi f deltat)^4) relative to the signal - at most 1e-5 for the highest frequency here */
+static void BenchTDITDGrid(BenchContext* ctx) {
+  static const int nbpt = 32768;
+  static const double deltat = 2.;
+  static const double fchirpmin = 1e-3;
+  static const double fchirpmax = 1e-2;
+  LISABenchTDITD b;
+  memset(&b, 0, sizeof(LISABenchTDITD));
+  b.variant = globalparams->variant;
+  SetCoeffsG(&b.coeffs, injectedparams->lambda, injectedparams->beta, injectedparams->polarization);
+  /* Margin of twice the maximal orbital delay R/c, as in GenerateTDITD */
+  b.nbptmargin = 2 * (int) (b.variant->OrbitR/C_SI/deltat);
+
+  /* Linear chirp from fchirpmin to fchirpmax, circularly polarized */
+  b.times = gsl_vector_alloc(nbpt);
+  double* hp = (double*) malloc(nbpt*sizeof(double));
+  double* hc = (double*) malloc(nbpt*sizeof(double));
+  double T = (nbpt-1)*deltat;
+  for(int i=0; i<nbpt; i++) {
+    double t = i*deltat;
+    double phase = 2*PI*(fchirpmin*t + 0.5*(fchirpmax-fchirpmin)/T*t*t);
+    gsl_vector_set(b.times, i, t);
+    hp[i] = cos(phase);
+    hc[i] = sin(phase);
+  }
+  b.splinehp = gsl_spline_alloc(gsl_interp_cspline, nbpt);
+  b.splinehc = gsl_spline_alloc(gsl_interp_cspline, nbpt);
+  gsl_spline_init(b.splinehp, b.times->data, hp, nbpt);
+  gsl_spline_init(b.splinehc, b.times->data, hc, nbpt);
+  b.accelhp = gsl_interp_accel_alloc();
+  b.accelhc = gsl_interp_accel_alloc();
+  for(int c=0; c<3; c++) b.tdisample[c] = (double*) calloc(nbpt, sizeof(double));
+
+  double nseval, allocseval;
+  BenchRun(ctx, BenchTDITD, &b, &nseval, &allocseval);
+  BenchReport(ctx, "GenerateTDITD3Chanhphc", 0, nseval/nbpt, allocseval/nbpt, 0, 0.);
+  BenchRun(ctx, BenchTDITDSample, &b, &nseval, &allocseval);
+  BenchReport(ctx, "EvaluateTDIXYZTD", 0, nseval/nbpt, allocseval/nbpt, 0, 0.);
+
+  /* Maximal deviation in each channel, normalized by the maximal modulus of the channel */
+  static const char* checknames[3] = {"GenerateTDITD3Chanhphc/EvaluateTDIXYZTD:X", "GenerateTDITD3Chanhphc/EvaluateTDIXYZTD:Y", "GenerateTDITD3Chanhphc/EvaluateTDIXYZTD:Z"};
+  for(int c=0; c<3; c++) {
+    double dev = 0., norm = 0.;
+    for(int i=b.nbptmargin; i<nbpt-b.nbptmargin; i++) {
+      dev = fmax(dev, fabs(gsl_vector_get(b.TDI[c]->h, i) - b.tdisample[c][i]));
+      norm = fmax(norm, fabs(b.tdisample[c][i]));
+    }
+    BenchCheck(ctx, checknames[c], 0, dev/norm, 0., 1., 1e-5);
+  }
+
+  for(int c=0; c<3; c++) {
+    RealTimeSeries_Cleanup(b.TDI[c]);
+    free(b.tdisample[c]);
+  }
+  gsl_spline_free(b.splinehp);
+  gsl_spline_free(b.splinehc);
+  gsl_interp_accel_free(b.accelhp);
+  gsl_interp_accel_free(b.accelhc);
+  gsl_vector_free(b.times);
+  free(hp);
+  free(hc);
+}
+
+static const char* benchusage = "\
+LISAbench: microbenchmarks of the LISA likelihood, on a grid of masses and durations around the injection\n\
+Options specific to LISAbench - all other options are passed to the LISAinference parser:\n\
+ --nrep                Number of evaluations per timing (default 10)\n\
+ --nround              Number of timings, the fastest being reported (default 3)\n\
+ --reffile             File of reference values (default LISAbench.ref)\n\
+ --writeref            Write the values of this run to the reference file (done anyway when the file does not exist)\n\
+ --reftol              Tolerance on the deviation |value-ref|/max(|ref|,1) from the reference values (default 1e-8)\n\
+\n";
+
+int main(int argc, char *argv[])
+{
+  BenchContext ctx;
+  memset(&ctx, 0, sizeof(BenchContext));
+  ctx.nbrep = 10;
+  ctx.nbround = 3;
+  ctx.reftol = 1e-8;
+  char reffile[256] = "LISAbench.ref";
+  int writeref = 0;
+
+  /* Extract the options of the benchmark, pass the others to the LISAinference parser */
+  char** argvLISA = (char**) malloc((argc+1)*sizeof(char*));
+  int argcLISA = 0;
+  argvLISA[argcLISA++] = argv[0];
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "--nrep")==0 && i+1<argc) ctx.nbrep = atoi(argv[++i]);
+    else if(strcmp(argv[i], "--nround")==0 && i+1<argc) ctx.nbround = atoi(argv[++i]);
+    else if(strcmp(argv[i], "--reffile")==0 && i+1<argc) strncpy(reffile, argv[++i], 255);
+    else if(strcmp(argv[i], "--writeref")==0) writeref = 1;
+    else if(strcmp(argv[i], "--reftol")==0 && i+1<argc) ctx.reftol = atof(argv[++i]);
+    else {
+      if(strcmp(argv[i], "--help")==0) printf("%s", benchusage);
+      argvLISA[argcLISA++] = argv[i];
+    }
+  }
+  argvLISA[argcLISA] = NULL;
+  if(ctx.nbrep<1 || ctx.nbround<1) {
+    printf("Error: --nrep and --nround must be positive\n");
+    exit(1);
+  }
+
+  injectedparams = (LISAParams*) malloc(sizeof(LISAParams));
+  memset(injectedparams, 0, sizeof(LISAParams));
+  globalparams = (LISAGlobalParams*) malloc(sizeof(LISAGlobalParams));
+  memset(globalparams, 0, sizeof(LISAGlobalParams));
+  priorParams = (LISAPrior*) malloc(sizeof(LISAPrior));
+  memset(priorParams, 0, sizeof(LISAPrior));
+  addparams = (LISAAddParams*) malloc(sizeof(LISAAddParams));
+  memset(addparams, 0, sizeof(LISAAddParams));
+  LISARunParams runParams;
+  memset(&runParams, 0, sizeof(LISARunParams));
+  parse_args_LISA(argcLISA, argvLISA, injectedparams, globalparams, priorParams, &runParams, addparams);
+  injectedparams->nbmode = globalparams->nbmodeinj;
+
+  /* Reference values */
+  BenchReference_Init(&ctx.ref);
+  BenchReference_Init(&ctx.out);
+  if(BenchReference_Read(ctx.ref, reffile)==FAILURE) {
+    printf("# No reference values in %s - they will be written at the end of this run\n", reffile);
+    writeref = 1;
+  }
+  printf("# %d evaluations per timing, best of %d - allocations %s\n", ctx.nbrep, ctx.nbround, BenchAllocations()>=0 ? "counted" : "not counted on this platform");
+
+  /* Grid of masses and durations */
+  for(int im=0; im<nbbenchMtot; im++) {
+    for(int id=0; id<nbbenchdeltatobs; id++) {
+      injectedparams->m1 = benchMtot[im] * benchq/(1.+benchq);
+      injectedparams->m2 = benchMtot[im] / (1.+benchq);
+      globalparams->deltatobs = benchdeltatobs[id];
+      BenchGridPoint(&ctx, im*nbbenchdeltatobs + id);
+    }
+  }
+
+  /* Batched ROM generation on the middle mass */
+  injectedparams->m1 = benchMtot[nbbenchMtot/2] * benchq/(1.+benchq);
+  injectedparams->m2 = benchMtot[nbbenchMtot/2] / (1.+benchq);
+  BenchROMBatches(&ctx);
+
+  /* TD TDI on a uniform grid */
+  BenchTDITDGrid(&ctx);
+
+  printf("# %d values checked against the reference and %d cross-checks, %d failed, %d without reference\n", ctx.out->n - ctx.nbmissing, ctx.nbcheck, ctx.nbfail, ctx.nbmissing);
+  if(writeref) {
+    if(BenchReference_Write(ctx.out, reffile)==SUCCESS) printf("# Reference values written to %s\n", reffile);
+  }
+
+  BenchReference_Cleanup(ctx.ref);
+  BenchReference_Cleanup(ctx.out);
+  free(argvLISA);
+  return ctx.nbfail>0 ? 1 : 0;
+}
@@ -251,7 +251,10 @@ void getLogLike(double *Cube, int *ndim, int *npars, double *lnew, void *context
   templateparams.nbmode = globalparams->nbmodetemp; /* Using the global parameter for the number of modes in templates */
 
   /* Note: context points to a LISAContext structure containing a LISASignal* */
-  if((globalparams->tagint==0) && (!globalparams->tagsimplelikelihood)) {
+  if(globalparams->margdist || globalparams->margphase) {
+    *lnew = CalculateLogLMarginalized(&templateparams, context);
+  }
+  else if((globalparams->tagint==0) && (!globalparams->tagsimplelikelihood)) {
     LISAInjectionCAmpPhase* injection = ((LISAInjectionCAmpPhase*) context);
 
     //TESTING
@@ -273,10 +276,22 @@ void getLogLike(double *Cube, int *ndim, int *npars, double *lnew, void *context
     //printf("time Likelihood: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
     //
   }
-  else if(globalparams->tagsimplelikelihood) {
+  else if((globalparams->tagint==2) && (!globalparams->tagsimplelikelihood)) {
+    LISAInjectionRelBin* injection = ((LISAInjectionRelBin*) context);
+    *lnew = CalculateLogLRelBin(&templateparams, injection);
+  }
+  else if((globalparams->tagint==3) && (!globalparams->tagsimplelikelihood)) {
+    LISAInjectionROQ* injection = ((LISAInjectionROQ*) context);
+    *lnew = CalculateLogLROQ(&templateparams, injection);
+  }
+  else if(globalparams->tagsimplelikelihood==1) {
     SimpleLikelihoodPrecomputedValues* injection = ((SimpleLikelihoodPrecomputedValues*) context);
     *lnew = CalculateLogLSimpleLikelihood(injection, &templateparams);
   }
+  else if(globalparams->tagsimplelikelihood==2) {
+    GramLikelihoodPrecomputedValues* injection = ((GramLikelihoodPrecomputedValues*) context);
+    *lnew = CalculateLogLGramLikelihood(injection, &templateparams);
+  }
 }
 
 
@@ -508,10 +523,29 @@ int main(int argc, char *argv[])
 
 	BAMBIrun(mmodal, ceff, nlive, tol, efr, ndim, nPar, nClsPar, maxModes, updInt, Ztol, root, seed, pWrap, fb, resume, outfile, initMPI, logZero, maxiter, LogLikeFctn, dumper, BAMBIfctn, context);
 
+  /* Post-processing: draw the marginalized distance and/or phase for the equally weighted posterior samples */
+  if(myid==0 && (globalparams->margdist || globalparams->margphase)) {
+    char* pathpost = malloc(strlen(runParams.outroot)+64);
+    char* pathreconstructed = malloc(strlen(runParams.outroot)+64);
+    sprintf(pathpost, "%s%s", runParams.outroot, "post_equal_weights.dat");
+    sprintf(pathreconstructed, "%s%s", runParams.outroot, "post_equal_weights_reconstructed.dat");
+    LISAReconstructMarginalizedPosterior(pathpost, pathreconstructed, context);
+    free(pathpost);
+    free(pathreconstructed);
+  }
+
+  print_profile_to_file_LISA(&runParams, myid);
+  if(globalparams->nbintrinsiccache>0) {
+    size_t hits, misses;
+    LISAIntrinsicCacheStats(&hits, &misses);
+    printf("Intrinsic cache (process %d): %zu hits, %zu misses\n", myid, hits, misses);
+  }
+
   free(injectedparams);
   free(priorParams);
 
 #ifdef PARALLEL
+ 	NodeSharedCleanup();
  	MPI_Finalize();
 #endif
 }
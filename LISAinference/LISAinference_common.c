@@ -27,10 +27,15 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
   /* This structure is used only for storing precomputed values for the simple likelihood */
   simplelikelihoodinjvals = (SimpleLikelihoodPrecomputedValues*) malloc(sizeof(SimpleLikelihoodPrecomputedValues));
   memset(simplelikelihoodinjvals, 0, sizeof(SimpleLikelihoodPrecomputedValues));
+  gramlikelihoodinjvals = (GramLikelihoodPrecomputedValues*) malloc(sizeof(GramLikelihoodPrecomputedValues));
+  memset(gramlikelihoodinjvals, 0, sizeof(GramLikelihoodPrecomputedValues));
 
   /* Parse commandline to read parameters of injection - copy the number of modes demanded for the injection */
   parse_args_LISA(argc, argv, injectedparams, globalparams, priorParams, runParams, addparams);
   injectedparams->nbmode = globalparams->nbmodeinj;
+  ProfileEnable(runParams->profile);
+  /* Quadrature for the marginalization over the distance, with the overlaps computed at dist_min */
+  if(globalparams->margdist) DistanceMarginalization_Init(&distmarginalization, priorParams->dist_min, priorParams->dist_max, priorParams->dist_min, priorParams->flat_distprior, 64);
   //int notLISAlike=strstr(argv[0],"LISAlike")==0;
   if(myid == 0 && runParams->writeparams /*&& notLISAlike*/) print_parameters_to_file_LISA(injectedparams, globalparams, priorParams, runParams);
   if(myid == 0) {
@@ -38,18 +43,23 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
     report_LISAParams(injectedparams);
   }
 
+  /* With MPI, the ROM data is loaded once per node in memory shared by the processes of the node */
+  if(noMPI==0 && NodeSharedEnabled()) EOBNRv2HMROM_Init_DATA_Loader(NodeSharedReadFile);
+
   /* Initialize the data structure for the injection */
   LISAInjectionCAmpPhase* injectedsignalCAmpPhase = NULL;
   LISAInjectionReIm* injectedsignalReIm = NULL;
-  if(globalparams->tagint==0) {
+  LISAInjectionRelBin* injectedsignalRelBin = NULL;
+  LISAInjectionROQ* injectedsignalROQ = NULL;
+  if(globalparams->tagint==0 || globalparams->tagint==2 || globalparams->tagint==3) {
     LISAInjectionCAmpPhase_Init(&injectedsignalCAmpPhase);
   }
   else if(globalparams->tagint==1) {
     LISAInjectionReIm_Init(&injectedsignalReIm);
   }
 
-  /* Generate the injection */
-  if(globalparams->tagint==0) {
+  /* Generate the injection - for the relative binning and the ROQ, the summary data is set after the optional rescaling of the distance */
+  if(globalparams->tagint==0 || globalparams->tagint==2 || globalparams->tagint==3) {
     LISAGenerateInjectionCAmpPhase(injectedparams, injectedsignalCAmpPhase);
   }
   else if(globalparams->tagint==1) {
@@ -58,7 +68,7 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
 
   /* Compute SNR */
   double SNR123, SNR1, SNR2, SNR3;
-  if(globalparams->tagint==0) {
+  if(globalparams->tagint==0 || globalparams->tagint==2 || globalparams->tagint==3) {
     SNR123 = sqrt(injectedsignalCAmpPhase->TDI123ss);
   }
   else if(globalparams->tagint==1) {
@@ -81,7 +91,7 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
       if (myid == 0) printf("Distance prior (dist_min, dist_max) = (%g, %g) Mpc\n", priorParams->dist_min, priorParams->dist_max);
     }
     if (myid == 0 && runParams->writeparams /*&& notLISAlike*/) print_rescaleddist_to_file_LISA(injectedparams, globalparams, priorParams, runParams);
-    if(globalparams->tagint==0) {
+    if(globalparams->tagint==0 || globalparams->tagint==2 || globalparams->tagint==3) {
       LISAGenerateInjectionCAmpPhase(injectedparams, injectedsignalCAmpPhase);
       SNR123 = sqrt(injectedsignalCAmpPhase->TDI123ss);
     }
@@ -98,26 +108,71 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
     }
   }
 
+  /* Relative binning: summary data around the injection */
+  if(globalparams->tagint==2) {
+    LISAInjectionRelBin_Init(&injectedsignalRelBin);
+    if(LISAGenerateInjectionRelBin(injectedparams, injectedsignalCAmpPhase, globalparams->nbbinsrelbin, injectedsignalRelBin)==FAILURE) exit(1);
+  }
+
+  /* ROQ: quadrature rules built by LISAROQbuild against the same injection */
+  if(globalparams->tagint==3) {
+    LISAInjectionROQ_Init(&injectedsignalROQ);
+    if(LISAReadROQ(globalparams->roqfile, injectedsignalROQ)==FAILURE) exit(1);
+    injectedsignalROQ->TDI123ss = injectedsignalCAmpPhase->TDI123ss;
+  }
+
   /* If using simple likelihood, initialize precomputed values - note that the other initializations for the injection are done anyway, but will be ignored */
   /* Note: the optional distance adjustment to a given snr is done above using the response as given by responseapprox, not the simplified response */
-  if(globalparams->tagsimplelikelihood) {
+  if(globalparams->tagsimplelikelihood==1) {
     LISAComputeSimpleLikelihoodPrecomputedValues(simplelikelihoodinjvals, injectedparams);
   }
+  else if(globalparams->tagsimplelikelihood==2) {
+    if(LISAComputeGramLikelihoodPrecomputedValues(gramlikelihoodinjvals, injectedparams)==FAILURE) exit(1);
+  }
 
   /* Print SNR */
   if (myid == 0) {
     printf("Total SNR: %g\n", SNR123);
   }
 
+  /* Set the context pointer */
+  if((globalparams->tagint==0) && (!globalparams->tagsimplelikelihood)) {
+    *contextp = injectedsignalCAmpPhase;
+  }
+  else if((globalparams->tagint==1) && (!globalparams->tagsimplelikelihood)) {
+    *contextp = injectedsignalReIm;
+  }
+  else if((globalparams->tagint==2) && (!globalparams->tagsimplelikelihood)) {
+    *contextp = injectedsignalRelBin;
+  }
+  else if((globalparams->tagint==3) && (!globalparams->tagsimplelikelihood)) {
+    *contextp = injectedsignalROQ;
+  }
+  else if(globalparams->tagsimplelikelihood==1) {
+    *contextp = simplelikelihoodinjvals;
+  }
+  else if(globalparams->tagsimplelikelihood==2) {
+    *contextp = gramlikelihoodinjvals;
+  }
+
   /* Calculate logL of data */
   *logZtrue = 0.;
   logZdata = 0.; /* TODO: not used */
-  if(globalparams->tagint==0) {
+  if(globalparams->margdist || globalparams->margphase) {
+    *logZtrue = CalculateLogLMarginalized(injectedparams, *contextp);
+  }
+  else if(globalparams->tagint==0) {
     *logZtrue = CalculateLogLCAmpPhase(injectedparams, injectedsignalCAmpPhase);
   }
   else if(globalparams->tagint==1) {
     *logZtrue = CalculateLogLReIm(injectedparams, injectedsignalReIm);
   }
+  else if(globalparams->tagint==2) {
+    *logZtrue = CalculateLogLRelBin(injectedparams, injectedsignalRelBin);
+  }
+  else if(globalparams->tagint==3) {
+    *logZtrue = CalculateLogLROQ(injectedparams, injectedsignalROQ);
+  }
   /* printf("Compared params\n");
   report_LISAParams(injectedparams); */
   if(myid == 0) printf("logZtrue = %lf\n", *logZtrue);
@@ -125,17 +180,6 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
   /* Write to file the SNR and logZ of the injection */
   if (myid == 0 && runParams->writeparams /*&& notLISAlike*/) print_snrlogZ_to_file_LISA(runParams, SNR123, *logZtrue);
 
-  /* Set the context pointer */
-  if((globalparams->tagint==0) && (!globalparams->tagsimplelikelihood)) {
-    *contextp = injectedsignalCAmpPhase;
-  }
-  else if((globalparams->tagint==1) && (!globalparams->tagsimplelikelihood)) {
-    *contextp = injectedsignalReIm;
-  }
-  else if(globalparams->tagsimplelikelihood) {
-    *contextp = simplelikelihoodinjvals;
-  }
-
   *nPar = 9;	  /* Total no. of parameters including free & derived parameters */
   *ndim = 9;  /* No. of free parameters - to be changed later if some parameters are fixed */
 
@@ -210,18 +254,29 @@ void addendum(int argc, char *argv[],LISARunParams *runParams, int *ndim, int *n
     templateparams.nbmode = globalparams->nbmodetemp; /* Using the global parameter for the number of modes in templates */
 
     double logL = 0.;
-    if(globalparams->tagint==0) {
+    if(globalparams->margdist || globalparams->margphase) {
+      logL = CalculateLogLMarginalized(&templateparams, *contextp);
+    }
+    else if(globalparams->tagint==0) {
       logL = CalculateLogLCAmpPhase(&templateparams, injectedsignalCAmpPhase);
     }
     else if(globalparams->tagint==1) {
       logL = CalculateLogLReIm(&templateparams, injectedsignalReIm);
     }
+    else if(globalparams->tagint==2) {
+      logL = CalculateLogLRelBin(&templateparams, injectedsignalRelBin);
+    }
+    else if(globalparams->tagint==3) {
+      logL = CalculateLogLROQ(&templateparams, injectedsignalROQ);
+    }
     printf("logL = %lf\n", logL);
+    print_profile_to_file_LISA(runParams, myid);
 
     free(injectedparams);
     free(priorParams);
 
 #ifdef PARALLEL
+    NodeSharedCleanup();
     MPI_Finalize();
 #endif
 
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 
 #include "LISAutils.h"
+#include "nodeshared.h"
 
 #ifdef PARALLEL
 #include "mpi.h"
@@ -71,7 +71,10 @@ public:
 	return -INFINITY;
       }
     /* Note: context points to a LISAContext structure containing a LISASignal* */
-    if(globalparams->tagint==0) {
+    if(globalparams->margdist||globalparams->margphase) {
+      result = CalculateLogLMarginalized(&templateparams, context) - logZdata;
+    }
+    else if(globalparams->tagint==0) {
       LISAInjectionCAmpPhase injection = *((LISAInjectionCAmpPhase*) context);
       double like;
       like = CalculateLogLCAmpPhase(&templateparams, &injection);
@@ -81,6 +84,14 @@ public:
       LISAInjectionReIm* injection = ((LISAInjectionReIm*) context);
       result = CalculateLogLReIm(&templateparams, injection) - logZdata;
     }
+    else if(globalparams->tagint==2) {
+      LISAInjectionRelBin* injection = ((LISAInjectionRelBin*) context);
+      result = CalculateLogLRelBin(&templateparams, injection) - logZdata;
+    }
+    else if(globalparams->tagint==3) {
+      LISAInjectionROQ* injection = ((LISAInjectionROQ*) context);
+      result = CalculateLogLROQ(&templateparams, injection) - logZdata;
+    }
 
     //cout <<"like="<<result<<endl;
     double post=result;
@@ -138,19 +149,26 @@ public:
   //virtual void write(ostream &out,state &st){cout<<"flare_likelihood::write: No write routine defined!"<<endl;};
   //virtual void writeFine(ostream &out,state &st,int ns=-1, double ts=0, double te=0){cout<<"flare_likelihood::writeFine: No write routine defined!"<<endl;};
   //virtual void getFineGrid(int & nfine, double &tstart, double &tend)const{cout<<"flare_likelihood::getFineGrid: No routine defined!"<<endl;};
-  void print_info(){cout<<" mean = "<<total_eval_time/count<<" through "<<count<<" total evals"<<endl; };
+  void print_info(){
+    cout<<" mean = "<<total_eval_time/count<<" through "<<count<<" total evals"<<endl;
+    if(globalparams->nbintrinsiccache>0){
+      size_t hits,misses;
+      LISAIntrinsicCacheStats(&hits,&misses);
+      cout<<" intrinsic cache: "<<hits<<" hits, "<<misses<<" misses, hit rate "<<(hits+misses>0?(double)hits/(hits+misses):0.)<<endl;
+    }
+  };
   double getFisher(const state &s0, vector<vector<double> >&fisher_matrix)override{
     //First we must set the injection context
     /* Initialize the data structure for the injection */
+    /* With tagint==0 the overlaps use the Fresnel integration of the CAmpPhase signals; otherwise the Fisher matrix is computed from */
+    /* the derivatives of the waveforms in Re/Im form - the injection then only provides the frequencies and noise values */
     LISAInjectionCAmpPhase* injectedsignalCAmpPhase = NULL;
     LISAInjectionReIm* injectedsignalReIm = NULL;
     if(globalparams->tagint==0) {
       LISAInjectionCAmpPhase_Init(&injectedsignalCAmpPhase);
       LISAGenerateInjectionCAmpPhase(injectedparams, injectedsignalCAmpPhase);
-      //cout<<"Fisher matrix computation not yet implemented for AmpPhase polar wf representation (try --tagint==1)"<<endl;
-      //exit(-1);
     }
-    else if(globalparams->tagint==1) {
+    else {
       LISAInjectionReIm_Init(&injectedsignalReIm);
       LISAGenerateInjectionReIm(injectedparams, globalparams->minf, globalparams->nbptsoverlap, 1, injectedsignalReIm); /* Use here logarithmic sampling as a default */
     }
@@ -174,41 +192,64 @@ public:
     while(not done){
       cout<<"\ncount="<<count<<"\nscales = ";for(int i=0;i<dim;i++)cout<<scales[i]<<"\t";cout<<endl;
       cout<<"minscales = ";for(int i=0;i<dim;i++)cout<<minscales[i]<<"\t";cout<<endl;
-      for(int i=0;i<dim;i++){
-	//cout<<"finish="<<finish<<", j lim="<<(finish?dim:i+1)<<endl;
-	double hi=scales[i]*deltafactor;
-	state sPlusi=s0;
-	sPlusi.set_param(i,s0.get_param(i)+hi);
-	state sMinusi=s0;
-	sMinusi.set_param(i,s0.get_param(i)-hi);
-
-	for(int j=i;j<(finish?dim:i+1);j++){//don't bother with offdiagonals at first for rough-in, then include while finishing
-	  //compute j derivative of model
-	  double hj=scales[j]*deltafactor;
-	  state sPlusj=s0;
-	  sPlusj.set_param(j,s0.get_param(j)+hj);
-	  state sMinusj=s0;
-	  sMinusj.set_param(j,s0.get_param(j)-hj);
-	  //for(int k=0;k<N;k++)dmudj[k]=(modelPlus[k]-modelMinus[k])/h/2.0;
-	  //Compute fisher matrix element
-	  cout<<"Fisher i,j="<<i<<","<<j<<endl;
-	  //cout<<"            hi,hj="<<hi<<","<<hj<<endl;
-	  if(globalparams->tagint==1) {
-	    fisher_matrix[i][j]
-	      = CalculateOverlapReIm(state2LISAParams( sPlusi), state2LISAParams( sPlusj), injectedsignalReIm)
-	      - CalculateOverlapReIm(state2LISAParams( sPlusi), state2LISAParams(sMinusj), injectedsignalReIm)
-	      - CalculateOverlapReIm(state2LISAParams(sMinusi), state2LISAParams( sPlusj), injectedsignalReIm)
-	      + CalculateOverlapReIm(state2LISAParams(sMinusi), state2LISAParams(sMinusj), injectedsignalReIm);
-	  } else {
-	    fisher_matrix[i][j]
-	      = CalculateOverlapCAmpPhase(state2LISAParams( sPlusi), state2LISAParams( sPlusj), injectedsignalCAmpPhase)
-	      - CalculateOverlapCAmpPhase(state2LISAParams( sPlusi), state2LISAParams(sMinusj), injectedsignalCAmpPhase)
-	      - CalculateOverlapCAmpPhase(state2LISAParams(sMinusi), state2LISAParams( sPlusj), injectedsignalCAmpPhase)
-	      + CalculateOverlapCAmpPhase(state2LISAParams(sMinusi), state2LISAParams(sMinusj), injectedsignalCAmpPhase);
+      if(globalparams->tagint==0) {
+	//elements (i,j) with j>=i - only the diagonal for rough-in, then include offdiagonals while finishing
+	//each element needs 4 overlaps at the corners (+-hi,+-hj); they are computed as independent OpenMP tasks into
+	//a buffer, then combined serially in a fixed order so that the result does not depend on the scheduling
+	vector<int> elemi,elemj;
+	for(int i=0;i<dim;i++)for(int j=i;j<(finish?dim:i+1);j++){elemi.push_back(i);elemj.push_back(j);}
+	int nelem=elemi.size();
+	vector<LISAParams> paramsplus(dim),paramsminus(dim);
+	vector<double> steps(dim);
+	for(int i=0;i<dim;i++){
+	  steps[i]=scales[i]*deltafactor;
+	  state sPlusi=s0;
+	  sPlusi.set_param(i,s0.get_param(i)+steps[i]);
+	  state sMinusi=s0;
+	  sMinusi.set_param(i,s0.get_param(i)-steps[i]);
+	  paramsplus[i]=state2LISAParams(sPlusi);
+	  paramsminus[i]=state2LISAParams(sMinusi);
+	}
+	vector<double> overlaps(4*nelem);
+#pragma omp parallel
+#pragma omp single
+	{
+	  for(int k=0;k<4*nelem;k++){
+#pragma omp task firstprivate(k)
+	    {
+	      int i=elemi[k/4],j=elemj[k/4],corner=k%4;
+	      LISAParams& pi=(corner<2)?paramsplus[i]:paramsminus[i];
+	      LISAParams& pj=(corner%2==0)?paramsplus[j]:paramsminus[j];
+	      overlaps[k]=CalculateOverlapCAmpPhase(pi,pj,injectedsignalCAmpPhase);
+	    }
 	  }
-	  fisher_matrix[i][j]/=4*hi*hj;
+	}
+	for(int k=0;k<nelem;k++){
+	  int i=elemi[k],j=elemj[k];
+	  cout<<"Fisher i,j="<<i<<","<<j<<endl;
+	  fisher_matrix[i][j] = overlaps[4*k] - overlaps[4*k+1] - overlaps[4*k+2] + overlaps[4*k+3];
+	  fisher_matrix[i][j]/=4*steps[i]*steps[j];
 	  fisher_matrix[j][i] = fisher_matrix[i][j];
 	}
+      } else {
+	//centered derivatives of the waveform in all directions at once: 2*dim waveforms per iteration
+	LISAParams params0=state2LISAParams(s0);
+	vector<LISAParams> paramsplus(dim),paramsminus(dim);
+	vector<double> steps(dim),fisher(dim*dim);
+	for(int i=0;i<dim;i++){
+	  steps[i]=scales[i]*deltafactor;
+	  state sPlusi=s0;
+	  sPlusi.set_param(i,s0.get_param(i)+steps[i]);
+	  state sMinusi=s0;
+	  sMinusi.set_param(i,s0.get_param(i)-steps[i]);
+	  paramsplus[i]=state2LISAParams(sPlusi);
+	  paramsminus[i]=state2LISAParams(sMinusi);
+	}
+	if(LISAComputeFisherReIm(&params0, dim, paramsplus.data(), paramsminus.data(), steps.data(), injectedsignalReIm, fisher.data())==FAILURE){
+	  for(int i=0;i<dim*dim;i++)fisher[i]=NAN;
+	}
+	//as above, only the diagonal is updated for rough-in, the offdiagonals while finishing
+	for(int i=0;i<dim;i++)for(int j=(finish?0:i);j<(finish?dim:i+1);j++)fisher_matrix[i][j]=fisher[i*dim+j];
       }
 
       //estimate error
@@ -260,6 +301,8 @@ public:
       }
     }
     err=sqrt(err);
+    if(injectedsignalCAmpPhase) LISAInjectionCAmpPhase_Cleanup(injectedsignalCAmpPhase);
+    if(injectedsignalReIm) LISAInjectionReIm_Cleanup(injectedsignalReIm);
 
     //cout<<"err="<<err<<endl;
     //cout<<"tol="<<tol<<endl;
@@ -334,9 +377,7 @@ public:
       ListmodesCAmpPhaseSpline* listsplinesgen1 = NULL;
       ListmodesCAmpPhaseSpline* listsplinesgen2 = NULL;
       ListmodesCAmpPhaseSpline* listsplinesgen3 = NULL;
-      BuildListmodesCAmpPhaseSpline(&listsplinesgen1, signal1->TDI1Signal);
-      BuildListmodesCAmpPhaseSpline(&listsplinesgen2, signal1->TDI2Signal);
-      BuildListmodesCAmpPhaseSpline(&listsplinesgen3, signal1->TDI3Signal);
+      BuildListmodesCAmpPhaseSpline3Chan(&listsplinesgen1, &listsplinesgen2, &listsplinesgen3, signal1->TDI1Signal, signal1->TDI2Signal, signal1->TDI3Signal);
 
       //loop over modes
       ListmodesCAmpPhaseFrequencySeries* mode = signal1->TDI1Signal;
@@ -568,10 +609,12 @@ int main(int argc, char*argv[]){
   if (!std::isnan(priorParams->fix_lambda))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
   if (!std::isnan(priorParams->fix_beta))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
   if (!std::isnan(priorParams->fix_time))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
-  if (!std::isnan(priorParams->fix_phase))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
+  if (!std::isnan(priorParams->fix_phase)&&!globalparams->margphase)cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
   if (!std::isnan(priorParams->fix_inc))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
   if (!std::isnan(priorParams->fix_pol))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
-  if (!std::isnan(priorParams->fix_dist))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
+  if (!std::isnan(priorParams->fix_dist)&&!globalparams->margdist)cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
+  //With marginalization the likelihood does not depend on distance and/or phase, which then follow their prior in the chains - draw them in post-processing with LISAlikelihood --loadparamsfile
+  if(globalparams->margdist||globalparams->margphase)cout<<" ** Marginalized parameters follow their prior in the chains - use LISAlikelihood --loadparamsfile to draw them in post-processing **"<<endl;
   if (!std::isnan(priorParams->fix_m1))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
   if (!std::isnan(priorParams->fix_m2))cout<<" ** Parameter fixing not supported.  Ignoring request! **"<<endl;
   if(priorParams->logflat_massprior){
@@ -895,4 +938,5 @@ int main(int argc, char*argv[]){
   //Dump summary info
   cout<<"best_post "<<like->bestPost()<<", state="<<like->bestState().get_string()<<endl;
   fl.print_info();
+  print_profile_to_file_LISA(&runParams, myid);
 }
@@ -29,6 +29,8 @@ int main(int argc, char *argv[])
 
   LISAInjectionCAmpPhase* injectedsignalCAmpPhase = NULL;
   LISAInjectionReIm* injectedsignalReIm = NULL;
+  LISAInjectionRelBin* injectedsignalRelBin = NULL;
+  LISAInjectionROQ* injectedsignalROQ = NULL;
   double logL = 0;
 
   LISAParams* params = NULL;
@@ -52,7 +54,10 @@ int main(int argc, char *argv[])
     report_LISAParams(params);
 
     /* Calculate logL of template */
-    if(globalparams->tagint==0) {
+    if(globalparams->margdist || globalparams->margphase) {
+      logL = CalculateLogLMarginalized(params, context);
+    }
+    else if(globalparams->tagint==0) {
       injectedsignalCAmpPhase = (LISAInjectionCAmpPhase*) context;
       logL = CalculateLogLCAmpPhase(params, injectedsignalCAmpPhase);
     }
@@ -60,6 +65,14 @@ int main(int argc, char *argv[])
       injectedsignalReIm = (LISAInjectionReIm*) context;
       logL = CalculateLogLReIm(params, injectedsignalReIm);
     }
+    else if(globalparams->tagint==2) {
+      injectedsignalRelBin = (LISAInjectionRelBin*) context;
+      logL = CalculateLogLRelBin(params, injectedsignalRelBin);
+    }
+    else if(globalparams->tagint==3) {
+      injectedsignalROQ = (LISAInjectionROQ*) context;
+      logL = CalculateLogLROQ(params, injectedsignalROQ);
+    }
     printf("logL template = %.16e\n", logL);
   }
   else {
@@ -82,6 +95,15 @@ int main(int argc, char *argv[])
     else if(globalparams->tagint==1) {
       injectedsignalReIm = ((LISAInjectionReIm*) context);
     }
+    else if(globalparams->tagint==2) {
+      injectedsignalRelBin = ((LISAInjectionRelBin*) context);
+    }
+    else if(globalparams->tagint==3) {
+      injectedsignalROQ = ((LISAInjectionROQ*) context);
+    }
+    /* With marginalization, distance and/or phase are replaced by draws from their conditional posterior - post-processing of the samples of LISAinference or LISAinference_ptmcmc */
+    gsl_rng* r = NULL;
+    if(globalparams->margdist || globalparams->margphase) r = gsl_rng_alloc(gsl_rng_mt19937);
     double logL = 0;
     for(int i=0; i<nlines; i++) {
       //
@@ -98,12 +120,21 @@ int main(int argc, char *argv[])
       params->polarization = gsl_matrix_get(inmatrix, i, 8);
       params->nbmode = globalparams->nbmodetemp; /* Note : read from global parameters */
 
-      if(globalparams->tagint==0) {
+      if(globalparams->margdist || globalparams->margphase) {
+        LISADrawMarginalizedParams(params, context, r, &logL);
+      }
+      else if(globalparams->tagint==0) {
         logL = CalculateLogLCAmpPhase(params, injectedsignalCAmpPhase);
       }
       else if(globalparams->tagint==1) {
         logL = CalculateLogLReIm(params, injectedsignalReIm);
       }
+      else if(globalparams->tagint==2) {
+        logL = CalculateLogLRelBin(params, injectedsignalRelBin);
+      }
+      else if(globalparams->tagint==3) {
+        logL = CalculateLogLROQ(params, injectedsignalROQ);
+      }
 
       /* Set values in output matrix */
       gsl_matrix_set(outmatrix, i, 0, params->m1);
@@ -117,13 +148,28 @@ int main(int argc, char *argv[])
       gsl_matrix_set(outmatrix, i, 8, params->polarization);
       gsl_matrix_set(outmatrix, i, 9, logL);
     }
+    if(globalparams->tagint==0) printf("Overlap workspace regrowths for %d likelihood evaluations: %zu\n", nlines, LISAOverlapWorkspaceRegrowths());
+    if(globalparams->nbsignalcache>0) {
+      size_t hits, misses;
+      LISASignalCacheStats(&hits, &misses);
+      printf("Signal cache: %zu hits, %zu misses\n", hits, misses);
+    }
+    if(globalparams->nbintrinsiccache>0) {
+      size_t hits, misses;
+      LISAIntrinsicCacheStats(&hits, &misses);
+      printf("Intrinsic cache: %zu hits, %zu misses\n", hits, misses);
+    }
+
     /* Output matrix */
     Write_Text_Matrix(addparams->outdir, addparams->outfile, outmatrix);
 
     /* Cleanup */
+    if(r) gsl_rng_free(r);
     free(params);
   }
 
+  print_profile_to_file_LISA(&runParams, myid);
+
   /* Cleanup */
   free(injectedparams);
   free(globalparams);
@@ -9,6 +9,12 @@ LISAPrior* priorParams = NULL;
 LISAAddParams* addparams = NULL;
 double logZdata = 0.;
 SimpleLikelihoodPrecomputedValues* simplelikelihoodinjvals = NULL;
+GramLikelihoodPrecomputedValues* gramlikelihoodinjvals = NULL;
+DistanceMarginalization* distmarginalization = NULL;
+
+/* Workspace for the Fresnel overlaps, one per thread, reused across likelihood evaluations */
+static OverlapWorkspace* __LISAOverlapWorkspace = NULL;
+#pragma omp threadprivate(__LISAOverlapWorkspace)
 
 /***************** Pasring string to choose what masses set to sample for *****************/
 
@@ -61,6 +67,7 @@ void LISAInjectionCAmpPhase_Cleanup(LISAInjectionCAmpPhase* signal) {
   if(signal->TDI1Splines) ListmodesCAmpPhaseSpline_Destroy(signal->TDI1Splines);
   if(signal->TDI2Splines) ListmodesCAmpPhaseSpline_Destroy(signal->TDI2Splines);
   if(signal->TDI3Splines) ListmodesCAmpPhaseSpline_Destroy(signal->TDI3Splines);
+  if(signal->TDI123SplinesSoA) ModesCAmpPhaseSpline3ChanSoA_Cleanup(signal->TDI123SplinesSoA);
   free(signal);
 }
 
@@ -75,6 +82,7 @@ void LISAInjectionCAmpPhase_Init(LISAInjectionCAmpPhase** signal) {
   (*signal)->TDI1Splines = NULL;
   (*signal)->TDI2Splines = NULL;
   (*signal)->TDI3Splines = NULL;
+  (*signal)->TDI123SplinesSoA = NULL;
 }
 
 void LISASignalReIm_Cleanup(LISASignalReIm* signal) {
@@ -125,6 +133,36 @@ void LISAInjectionReIm_Init(LISAInjectionReIm** signal) {
   (*signal)->noisevalues3 = NULL;
 }
 
+void LISAInjectionRelBin_Cleanup(LISAInjectionRelBin* relbin) {
+  if(relbin->fbins) free(relbin->fbins);
+  if(relbin->lmode) free(relbin->lmode);
+  if(relbin->mmode) free(relbin->mmode);
+  if(relbin->fidvalues) free(relbin->fidvalues);
+  if(relbin->A) free(relbin->A);
+  if(relbin->B) free(relbin->B);
+  free(relbin);
+}
+
+void LISAInjectionRelBin_Init(LISAInjectionRelBin** relbin) {
+  if(!relbin) exit(1);
+  /* Create storage for structures */
+  if(!*relbin) *relbin = malloc(sizeof(LISAInjectionRelBin));
+  else
+  {
+    LISAInjectionRelBin_Cleanup(*relbin);
+    *relbin = malloc(sizeof(LISAInjectionRelBin));
+  }
+  (*relbin)->nbbins = 0;
+  (*relbin)->fbins = NULL;
+  (*relbin)->nbmode = 0;
+  (*relbin)->lmode = NULL;
+  (*relbin)->mmode = NULL;
+  (*relbin)->fidvalues = NULL;
+  (*relbin)->A = NULL;
+  (*relbin)->B = NULL;
+  (*relbin)->TDI123ss = 0.;
+}
+
 
 /************ Parsing arguments function ************/
 
@@ -170,7 +208,12 @@ Arguments are as follows:\n\
  --Mfmatch             When PN extension allowed, geometric matching frequency: will use ROM above this value. If <=0, use ROM down to the lowest covered frequency (default=0.)\n\
  --nbmodeinj           Number of modes of radiation to use for the injection (1-5, default=5)\n\
  --nbmodetemp          Number of modes of radiation to use for the templates (1-5, default=5)\n\
- --tagint              Tag choosing the integrator: 0 for Fresnel (default), 1 for linear integration\n\
+ --tagint              Tag choosing the integrator: 0 for Fresnel (default), 1 for linear integration, 2 for relative binning around the injection, 3 for reduced order quadrature\n\
+ --nbbinsrelbin        Number of frequency bins for the relative binning likelihood (--tagint 2) (default 64)\n\
+ --roqfile             File for the reduced order quadrature rules - written by LISAROQbuild, read with --tagint 3 (default roq.txt)\n\
+ --nbtrainroq          Number of training templates drawn from the prior by LISAROQbuild (default 256)\n\
+ --nbptsroq            Number of log-spaced frequencies of the inner products discretized by LISAROQbuild (default 2048)\n\
+ --tolroq              Tolerance of the greedy reduced bases built by LISAROQbuild (default 1e-10)\n\
  --tagtdi              Tag choosing the set of TDI variables to use (default TDIAETXYZ)\n\
  --nbptsoverlap        Number of points to use for linear integration (default 32768)\n\
  --variant             String representing the variant of LISA to be applied (default LISAProposal)\n\
@@ -178,6 +221,12 @@ Arguments are as follows:\n\
  --frozenLISA          Freeze the orbital configuration to the time of peak of the injection (default 0)\n\
  --responseapprox      Approximation in the GAB and orb response - choices are full (full response, default), lowfL (keep orbital delay frequency-dependence but simplify constellation response) and lowf (simplify constellation and orbital response) - WARNING : at the moment noises are not consistent, and TDI combinations from the GAB are unchanged\n\
  --simplelikelihood    Tag to use simplified, frozen-LISA and lowf likelihood where mode overlaps are precomputed - can only be used when the masses and time (tL) are pinned to injection values (Note: when using --snr, distance adjustment done using responseapprox, not the simple response)\n\
+ --gramlikelihood      Same as --simplelikelihood, but for all modes: the Gram matrix of the modes is precomputed and the likelihood over distance, phiRef, inclination, lambda, beta, polarization costs O(nbmode^2) - same restrictions as --simplelikelihood\n\
+ --signalcache         Capacity of the per-thread LRU cache of generated signals, keyed by the exact parameters - 0 to disable (default 0)\n\
+ --intrinsiccache      Capacity of the per-thread LRU cache of intrinsic waveforms (ROM modes for m1, m2, tRef) - templates differing only by distance, phiRef, inclination, lambda, beta, polarization then skip the ROM - 0 to disable (default 0)\n\
+ --margdist            Marginalize the likelihood over the distance, for the prior set by dist-min, dist-max and flat-distprior - the distance is pinned, and drawn in post-processing (default 0)\n\
+ --margphase           Marginalize the likelihood over the phase, exact for templates with the 22 mode only - the phase is pinned, and drawn in post-processing (default 0)\n\
+ --noisetabletol       Relative accuracy of the tabulated noise functions used in the overlaps, e.g. 1e-6 - 0 to evaluate the exact noise functions (default 0)\n\
 \n\
 --------------------------------------------------\n\
 ----- Prior Boundary Settings --------------------\n\
@@ -239,14 +288,15 @@ Syntax: --PARAM-min\n\
  --nclspar             Number of parameters to use for multimodal decomposition - in the order of the cube (default 1)\n\
  --ztol                In multimodal decomposition, modes with lnZ lower than ztol are ignored (default -1e90)\n\
  --seed                Seed the inference by setting one of the live points to the injection (no option, default off)\n\
+ --profile             Time the stages of the likelihood (ROM, TF2 extension, response, resampling, splines, integrand, Fresnel/WIP integration, noise) and write the profile to [outroot]profile_[rank].dat at the end of the run (no option, default off)\n\
 -----------------------------------------------------------------\n\
 ----- Additional Parameters -------------------------------------\n\
 -----------------------------------------------------------------\n\
  --addparams           To be followed by the value of parameters: m1 m2 tRef distance phiRef inclination lambda beta polarization. Used to compute a likelihood for these parameters in LISAlikelihood. Not used in LISAinference.\n\
- --loadparamsfile      Option to load a list of template parameters from file and to output results to file (default false).\n\
+ --loadparamsfile      Option to load a list of template parameters (LISAlikelihood) or injection points (LISAFisher) from file and to output results to file (default false).\n\
  --nlinesparams        Number of lines in input params file.\n\
- --indir               Input directory when loading input parameters file from file for LISAlikelihood.\n\
- --infile              Input file name when loading input parameters file from file for LISAlikelihood.\n\
+ --indir               Input directory when loading input parameters file from file for LISAlikelihood and LISAFisher.\n\
+ --infile              Input file name when loading input parameters file from file for LISAlikelihood and LISAFisher.\n\
  --outdir              Directory for input/output file.\n\
  --outfile             Input file with the parameters.\n\
 \n";
@@ -276,6 +326,11 @@ Syntax: --PARAM-min\n\
     globalparams->nbmodeinj = 5;
     globalparams->nbmodetemp = 5;
     globalparams->tagint = 0;
+    globalparams->nbbinsrelbin = 64;
+    strcpy(globalparams->roqfile, "roq.txt");
+    globalparams->nbtrainroq = 256;
+    globalparams->nbptsroq = 2048;
+    globalparams->tolroq = 1e-10;
     globalparams->tagtdi = TDIAETXYZ;
     globalparams->nbptsoverlap = 32768;
     globalparams->variant = &LISAProposal;
@@ -283,6 +338,11 @@ Syntax: --PARAM-min\n\
     globalparams->frozenLISA = 0;
     globalparams->responseapprox = full;
     globalparams->tagsimplelikelihood = 0;
+    globalparams->noisetabletol = 0.;
+    globalparams->nbsignalcache = 0;
+    globalparams->nbintrinsiccache = 0;
+    globalparams->margdist = 0;
+    globalparams->margphase = 0;
 
     /* set default values for the prior limits */
     prior->samplemassparams = m1m2;
@@ -352,6 +412,7 @@ Syntax: --PARAM-min\n\
     run->nclspar = 1;
     run->ztol = -1e90;
     run->seed = 0;
+    run->profile = 0;
 
     /* set default values for the additional params */
     addparams->tRef = 0.;
@@ -414,6 +475,20 @@ Syntax: --PARAM-min\n\
             globalparams->nbmodetemp = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--tagint") == 0) {
             globalparams->tagint = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--nbbinsrelbin") == 0) {
+            globalparams->nbbinsrelbin = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--roqfile") == 0) {
+            if(strlen(argv[++i]) >= sizeof(globalparams->roqfile)) {
+                printf("Error: --roqfile path longer than %d characters: %s\n", (int) sizeof(globalparams->roqfile) - 1, argv[i]);
+                exit(1);
+            }
+            strcpy(globalparams->roqfile, argv[i]);
+        } else if (strcmp(argv[i], "--nbtrainroq") == 0) {
+            globalparams->nbtrainroq = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--nbptsroq") == 0) {
+            globalparams->nbptsroq = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tolroq") == 0) {
+            globalparams->tolroq = atof(argv[++i]);
         } else if (strcmp(argv[i], "--tagtdi") == 0) {
             globalparams->tagtdi = ParseTDItag(argv[++i]);
         } else if (strcmp(argv[i], "--nbptsoverlap") == 0) {
@@ -426,6 +501,18 @@ Syntax: --PARAM-min\n\
             globalparams->responseapprox = ParseResponseApproxtag(argv[++i]);
         } else if (strcmp(argv[i], "--simplelikelihood") == 0) {
             globalparams->tagsimplelikelihood = 1;
+        } else if (strcmp(argv[i], "--gramlikelihood") == 0) {
+            globalparams->tagsimplelikelihood = 2;
+        } else if (strcmp(argv[i], "--signalcache") == 0) {
+            globalparams->nbsignalcache = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--intrinsiccache") == 0) {
+            globalparams->nbintrinsiccache = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--margdist") == 0) {
+            globalparams->margdist = 1;
+        } else if (strcmp(argv[i], "--margphase") == 0) {
+            globalparams->margphase = 1;
+        } else if (strcmp(argv[i], "--noisetabletol") == 0) {
+            globalparams->noisetabletol = atof(argv[++i]);
         } else if (strcmp(argv[i], "--samplemassparams") == 0) {
             prior->samplemassparams = ParseSampleMassParamstag(argv[++i]);
         } else if (strcmp(argv[i], "--sampletimeparam") == 0) {
@@ -556,6 +643,8 @@ Syntax: --PARAM-min\n\
             run->ztol = atof(argv[++i]);
         } else if (strcmp(argv[i], "--seed") == 0) {
             run->seed = 1;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            run->profile = 1;
         } else if (strcmp(argv[i], "--variant") == 0) {
 	  i++;
 	  if (strcmp(argv[i], "LISAProposal") == 0) globalparams->variant = &LISAProposal;
@@ -614,6 +703,22 @@ Syntax: --PARAM-min\n\
         exit(1);
       }
     }
+    /* If marginalizing over distance or phase, these are pinned - the value is ignored by the likelihood and drawn in post-processing */
+    if(globalparams->margdist || globalparams->margphase) {
+      if(globalparams->tagsimplelikelihood) {
+        printf("Error in parse_args_LISA: marginalization is not supported with the simplified likelihood.");
+        exit(1);
+      }
+      if(globalparams->margphase && !(prior->phase_min==0. && prior->phase_max==2*PI)) {
+        printf("Error in parse_args_LISA: marginalization over the phase requires the full range of phase [0, 2pi].");
+        exit(1);
+      }
+      if(globalparams->margphase && globalparams->nbmodetemp>1) {
+        printf("Warning in parse_args_LISA: marginalization over the phase is exact only for templates with the 22 mode - with nbmodetemp=%d, higher modes are treated as if their phase scaled like the 22 one.\n", globalparams->nbmodetemp);
+      }
+      if(globalparams->margdist) prior->pin_dist = 1;
+      if(globalparams->margphase) prior->pin_phase = 1;
+    }
 
     return;
 }
@@ -680,12 +785,19 @@ int print_parameters_to_file_LISA(
   fprintf(f, "nbmodeinj:      %d\n", globalparams->nbmodeinj);
   fprintf(f, "nbmodetemp:     %d\n", globalparams->nbmodetemp);
   fprintf(f, "tagint:         %d\n", globalparams->tagint);
+  fprintf(f, "nbbinsrelbin:   %d\n", globalparams->nbbinsrelbin);
+  fprintf(f, "roqfile:        %s\n", globalparams->roqfile);
   fprintf(f, "tagtdi:         %d\n", globalparams->tagtdi); //Translation back from enum to string not implemented yet
   fprintf(f, "nbptsoverlap:   %d\n", globalparams->nbptsoverlap);
   fprintf(f, "zerolikelihood: %d\n", globalparams->zerolikelihood);
   fprintf(f, "frozenLISA:     %d\n", globalparams->frozenLISA);
   fprintf(f, "responseapprox: %d\n", globalparams->responseapprox);
   fprintf(f, "simplelikelihood: %d\n", globalparams->tagsimplelikelihood);
+  fprintf(f, "noisetabletol:  %.16e\n", globalparams->noisetabletol);
+  fprintf(f, "signalcache:    %d\n", globalparams->nbsignalcache);
+  fprintf(f, "intrinsiccache: %d\n", globalparams->nbintrinsiccache);
+  fprintf(f, "margdist:       %d\n", globalparams->margdist);
+  fprintf(f, "margphase:      %d\n", globalparams->margphase);
   fprintf(f, "-----------------------------------------------\n");
   fprintf(f, "\n");
 
@@ -762,6 +874,7 @@ int print_parameters_to_file_LISA(
   fprintf(f, "nclspar:        %d\n", run->nclspar);
   fprintf(f, "ztol:           %g\n", run->ztol);
   fprintf(f, "seed:           %d\n", run->seed);
+  fprintf(f, "profile:        %d\n", run->profile);
   fprintf(f, "-----------------------------------------------\n");
 
   /* Close output file */
@@ -822,6 +935,18 @@ int print_snrlogZ_to_file_LISA(LISARunParams* run, double SNR, double logZ)
   return SUCCESS;
 }
 
+/* Function writing the profile of the stages of the likelihood, if enabled by --profile - one file per MPI process */
+int print_profile_to_file_LISA(LISARunParams* run, int rank)
+{
+  if(!run->profile) return SUCCESS;
+  char *path=malloc(strlen(run->outroot)+64);
+  sprintf(path,"%sprofile_%d.dat", run->outroot, rank);
+  int ret = ProfileWrite(path);
+  if(ret==SUCCESS) printf("Profile of the likelihood written to %s\n", path);
+  free(path);
+  return ret;
+}
+
 /******** Trim modes that are out of range ********/
 int listmodesCAmpPhaseTrim(ListmodesCAmpPhaseFrequencySeries* listSeries){
   //return SUCCESS;
@@ -859,10 +984,179 @@ int listmodesCAmpPhaseTrim(ListmodesCAmpPhaseFrequencySeries* listSeries){
 
 /************************* Functions to generate signals and compute likelihoods **************************/
 
+/* Get the overlap workspace of the calling thread, with capacity for the longest mode in listh */
+/* Capacity only grows, so that once sized from the first evaluations no further allocation occurs */
+static OverlapWorkspace* LISAGetOverlapWorkspace(ListmodesCAmpPhaseFrequencySeries* listh)
+{
+  int nmax = 0;
+  ListmodesCAmpPhaseFrequencySeries* listelement = listh;
+  while(listelement) {
+    nmax = max(nmax, (int) listelement->freqseries->freq->size);
+    listelement = listelement->next;
+  }
+  if(!__LISAOverlapWorkspace) OverlapWorkspace_Init(&__LISAOverlapWorkspace, nmax);
+  else OverlapWorkspace_Reserve(__LISAOverlapWorkspace, nmax);
+  return __LISAOverlapWorkspace;
+}
+
+/* Number of times the overlap workspace of the calling thread has been grown - constant in steady state */
+/* This is not a count of heap allocations: the ROM and the response still allocate at each evaluation */
+size_t LISAOverlapWorkspaceRegrowths(void)
+{
+  if(!__LISAOverlapWorkspace) return 0;
+  return __LISAOverlapWorkspace->nbregrow;
+}
+
+/* Noise function for a channel - tabulated when a tolerance noisetabletol is given, the table being built on first use */
+static ObjectFunction LISANoiseFunction(LISAGlobalParams* params, const int nchan)
+{
+  if(params->noisetabletol>0) return NoiseFunctionTabulated(params->variant, params->tagtdi, nchan, params->noisetabletol);
+  else return NoiseFunction(params->variant, params->tagtdi, nchan);
+}
+
+/****************** Cache of intrinsic waveforms *****************/
+
+/* The ROM modes depend on distance and phiRef only through a global factor 1/distance on the amplitudes and a constant
+   m*phiRef on the phase of the mode (l,m), also for the TaylorF2 extension which is matched to the ROM. The modes are
+   generated and cached for distance 1Mpc and phiRef 0, keyed by the intrinsic parameters m1, m2, tRef, and the extrinsic
+   parameters are applied to a copy - the response is always recomputed */
+typedef struct tagLISAIntrinsicCacheEntry {
+  double m1;                  /* Mass of companion 1 (solar masses) */
+  double m2;                  /* Mass of companion 2 (solar masses) */
+  double deltatRef;           /* Time of the signal relative to the injection, tRef - tRefinj (s) */
+  int nbmode;                 /* Number of modes */
+  int ret;                    /* Return value of the generation - failures are cached too */
+  ListmodesCAmpPhaseFrequencySeries* listROM;  /* Cached modes, for distance 1Mpc and phiRef 0 */
+  size_t lastuse;             /* Time of last use, for the LRU eviction */
+} LISAIntrinsicCacheEntry;
+
+typedef struct tagLISAIntrinsicCache {
+  int size;                   /* Capacity */
+  int nbentries;              /* Number of entries in use */
+  size_t clock;               /* Counter of accesses */
+  LISAIntrinsicCacheEntry* entries;
+} LISAIntrinsicCache;
+
+static LISAIntrinsicCache* __LISAIntrinsicCache = NULL;
+#pragma omp threadprivate(__LISAIntrinsicCache)
+/* Hits and misses summed over the threads */
+static size_t __LISAIntrinsicCacheHits = 0;
+static size_t __LISAIntrinsicCacheMisses = 0;
+
+static ListmodesCAmpPhaseFrequencySeries* LISACopyListmodesCAmpPhase(ListmodesCAmpPhaseFrequencySeries* list);
+
+/* Generate the ROM modes, with the TaylorF2 extension if tagextpn - deltatRef is the time relative to the injection */
+static int LISAGenerateROM(
+  ListmodesCAmpPhaseFrequencySeries** listROM,     /* Output: list of modes */
+  LISAParams* params,                              /* Input: set of LISA parameters of the signal */
+  const double deltatRef,                          /* Input: time of the signal relative to the injection */
+  const double phiRef,                             /* Input: phase at the reference frequency */
+  const double distance)                           /* Input: distance (Mpc) */
+{
+  /* Starting frequency corresponding to duration of observation deltatobs */
+  double fstartobs = 0.;
+  if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(params->m1, params->m2, globalparams->deltatobs);
+
+  /* NOTE: SimEOBNRv2HMROM accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
+  /* NOTE: minf and deltatobs are taken into account if extension is allowed, but not maxf - restriction to the relevant frequency interval will occur in both the response prcessing and overlap computation */
+  /* If extending, taking into account both fstartobs and minf */
+  if(!(globalparams->tagextpn)) {
+    return SimEOBNRv2HMROM(listROM, params->nbmode, deltatRef, phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, distance*1e6*PC_SI);
+  } else {
+    return SimEOBNRv2HMROMExtTF2(listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, deltatRef, phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, distance*1e6*PC_SI);
+  }
+}
+
+/* Generate the ROM modes of a template, going through the intrinsic cache of the calling thread when globalparams->nbintrinsiccache>0 - the output is owned by the caller */
+static int LISAGenerateROMCached(
+  ListmodesCAmpPhaseFrequencySeries** listROM,     /* Output: list of modes */
+  LISAParams* params,                              /* Input: set of LISA parameters of the signal */
+  const double tRefinj)                            /* Input: reference time of the injection */
+{
+  double deltatRef = params->tRef - tRefinj;
+  if(globalparams->nbintrinsiccache<=0) return LISAGenerateROM(listROM, params, deltatRef, params->phiRef, params->distance);
+
+  if(!__LISAIntrinsicCache) {
+    __LISAIntrinsicCache = malloc(sizeof(LISAIntrinsicCache));
+    __LISAIntrinsicCache->size = globalparams->nbintrinsiccache;
+    __LISAIntrinsicCache->nbentries = 0;
+    __LISAIntrinsicCache->clock = 0;
+    __LISAIntrinsicCache->entries = malloc(__LISAIntrinsicCache->size*sizeof(LISAIntrinsicCacheEntry));
+  }
+  LISAIntrinsicCache* cache = __LISAIntrinsicCache;
+  cache->clock++;
+
+  /* Look up the intrinsic parameters, or generate in a free or least recently used slot */
+  LISAIntrinsicCacheEntry* entry = NULL;
+  for(int i=0; i<cache->nbentries; i++) {
+    LISAIntrinsicCacheEntry* e = &cache->entries[i];
+    if(e->m1==params->m1 && e->m2==params->m2 && e->deltatRef==deltatRef && e->nbmode==params->nbmode) {
+      entry = e;
+      break;
+    }
+  }
+  if(entry) __atomic_fetch_add(&__LISAIntrinsicCacheHits, 1, __ATOMIC_RELAXED);
+  else {
+    __atomic_fetch_add(&__LISAIntrinsicCacheMisses, 1, __ATOMIC_RELAXED);
+    int i;
+    if(cache->nbentries<cache->size) i = cache->nbentries++;
+    else {
+      i = 0;
+      for(int j=1; j<cache->nbentries; j++) if(cache->entries[j].lastuse<cache->entries[i].lastuse) i = j;
+      if(cache->entries[i].listROM) ListmodesCAmpPhaseFrequencySeries_Destroy(cache->entries[i].listROM);
+    }
+    entry = &cache->entries[i];
+    entry->m1 = params->m1;
+    entry->m2 = params->m2;
+    entry->deltatRef = deltatRef;
+    entry->nbmode = params->nbmode;
+    entry->listROM = NULL;
+    entry->ret = LISAGenerateROM(&entry->listROM, params, deltatRef, 0., 1.);
+    if(entry->ret==FAILURE && entry->listROM) {
+      ListmodesCAmpPhaseFrequencySeries_Destroy(entry->listROM);
+      entry->listROM = NULL;
+    }
+  }
+  entry->lastuse = cache->clock;
+  if(entry->ret==FAILURE) return FAILURE;
+
+  /* Apply the extrinsic parameters to a copy: amplitudes scaled by 1/distance, phases shifted by m*phiRef */
+  *listROM = LISACopyListmodesCAmpPhase(entry->listROM);
+  ListmodesCAmpPhaseFrequencySeries* listelement = *listROM;
+  while(listelement) {
+    gsl_vector_scale(listelement->freqseries->amp_real, 1./params->distance);
+    gsl_vector_scale(listelement->freqseries->amp_imag, 1./params->distance);
+    gsl_vector_add_constant(listelement->freqseries->phase, listelement->m * params->phiRef);
+    listelement = listelement->next;
+  }
+  return SUCCESS;
+}
+
+/* Hit and miss counts of the intrinsic caches, summed over the threads */
+void LISAIntrinsicCacheStats(size_t* hits, size_t* misses)
+{
+  *hits = __atomic_load_n(&__LISAIntrinsicCacheHits, __ATOMIC_RELAXED);
+  *misses = __atomic_load_n(&__LISAIntrinsicCacheMisses, __ATOMIC_RELAXED);
+}
+
 /* Function generating a LISA signal as a list of modes in CAmp/Phase form, from LISA parameters */
 int LISAGenerateSignalCAmpPhase(
   struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
   struct tagLISASignalCAmpPhase* signal)   /* Output: structure for the generated signal */
+{
+  /* Checking that the global injectedparams has been set up */
+  if (!injectedparams) {
+    printf("Error: when calling LISAGenerateSignal, injectedparams points to NULL.\n");
+    exit(1);
+  }
+  return LISAGenerateSignalCAmpPhaseRef(params, injectedparams->tRef, signal);
+}
+
+/* Same as LISAGenerateSignalCAmpPhase, with the reference time given explicitly instead of read from injectedparams - does not touch the global injection, so that signals for different injections can be generated concurrently */
+int LISAGenerateSignalCAmpPhaseRef(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  double tRefinj,                          /* Input: reference time of the injection, replacing injectedparams->tRef */
+  struct tagLISASignalCAmpPhase* signal)   /* Output: structure for the generated signal */
 {
   //
   //printf("in LISAGenerateSignalCAmpPhase: tRef= %g\n", params->tRef);
@@ -873,27 +1167,12 @@ int LISAGenerateSignalCAmpPhase(
   ListmodesCAmpPhaseFrequencySeries* listTDI2 = NULL;
   ListmodesCAmpPhaseFrequencySeries* listTDI3 = NULL;
 
-  /* Checking that the global injectedparams has been set up */
-  if (!injectedparams) {
-    printf("Error: when calling LISAGenerateSignal, injectedparams points to NULL.\n");
-    exit(1);
-  }
-
   /* Starting frequency corresponding to duration of observation deltatobs */
   double fstartobs = 0.;
   if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(params->m1, params->m2, globalparams->deltatobs);
 
-  /* Generate the waveform with the ROM */
-  /* NOTE: SimEOBNRv2HMROM accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
-  /* NOTE: minf and deltatobs are taken into account if extension is allowed, but not maxf - restriction to the relevant frequency interval will occur in both the response prcessing and overlap computation */
-  /* If extending, taking into account both fstartobs and minf */
-  if(!(globalparams->tagextpn)) {
-    //printf("Not Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
-  } else {
-    //printf("Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
-  }
+  /* Generate the waveform with the ROM - through the intrinsic cache if enabled */
+  ret = LISAGenerateROMCached(&listROM, params, tRefinj);
   if(ret==FAILURE){
     //printf("LISAGenerateSignalCAmpPhase: Generation of ROM for injection failed!\n");
     return FAILURE;
@@ -941,23 +1220,18 @@ int LISAGenerateSignalCAmpPhase(
   //exit(0);
   //
 
-  /* Pre-interpolate the injection, building the spline matrices */
-  ListmodesCAmpPhaseSpline* listsplinesgen1 = NULL;
-  ListmodesCAmpPhaseSpline* listsplinesgen2 = NULL;
-  ListmodesCAmpPhaseSpline* listsplinesgen3 = NULL;
-  BuildListmodesCAmpPhaseSpline(&listsplinesgen1, listTDI1);
-  BuildListmodesCAmpPhaseSpline(&listsplinesgen2, listTDI2);
-  BuildListmodesCAmpPhaseSpline(&listsplinesgen3, listTDI3);
-
   /* Precompute the inner product (h|h) - takes into account the length of the observation with deltatobs */
   double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
   double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
-  ObjectFunction NoiseSn1 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 1);
-  ObjectFunction NoiseSn2 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 2);
-  ObjectFunction NoiseSn3 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 3);
+  ObjectFunction NoiseSn1 = LISANoiseFunction(globalparams, 1);
+  ObjectFunction NoiseSn2 = LISANoiseFunction(globalparams, 2);
+  ObjectFunction NoiseSn3 = LISANoiseFunction(globalparams, 3);
   //TESTING
   //tbeg = clock();
-  double TDI123hh = FDListmodesFresnelOverlap3Chan(listTDI1, listTDI2, listTDI3, listsplinesgen1, listsplinesgen2, listsplinesgen3, &NoiseSn1, &NoiseSn2, &NoiseSn3, fLow, fHigh, fstartobs, fstartobs);
+  /* The splines of the signal are built directly in SoA form in the workspace */
+  OverlapWorkspace* ws = LISAGetOverlapWorkspace(listTDI1);
+  ModesCAmpPhaseSpline3ChanSoA* splinesgen = OverlapWorkspace_BuildSplinesSoA(ws, listTDI1, listTDI2, listTDI3);
+  double TDI123hh = FDListmodesFresnelOverlap3ChanSoAWS(listTDI1, listTDI2, listTDI3, splinesgen, &NoiseSn1, &NoiseSn2, &NoiseSn3, fLow, fHigh, fstartobs, fstartobs, ws);
   //tend = clock();
   //printf("time SNRs: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
   //exit(0);
@@ -970,9 +1244,6 @@ int LISAGenerateSignalCAmpPhase(
   signal->TDI123hh = TDI123hh;
 
   ListmodesCAmpPhaseFrequencySeries_Destroy(listROM);
-  ListmodesCAmpPhaseSpline_Destroy(listsplinesgen1);
-  ListmodesCAmpPhaseSpline_Destroy(listsplinesgen2);
-  ListmodesCAmpPhaseSpline_Destroy(listsplinesgen3);
   return SUCCESS;
 }
 
@@ -980,6 +1251,15 @@ int LISAGenerateSignalCAmpPhase(
 int LISAGenerateInjectionCAmpPhase(
   struct tagLISAParams* params,       /* Input: set of LISA parameters of the signal */
   struct tagLISAInjectionCAmpPhase* signal)   /* Output: structure for the injected signal */
+{
+  return LISAGenerateInjectionCAmpPhaseRef(params, injectedparams->tRef, signal);
+}
+
+/* Same as LISAGenerateInjectionCAmpPhase, with the reference time given explicitly instead of read from injectedparams - does not touch the global injection, so that different injections can be generated concurrently */
+int LISAGenerateInjectionCAmpPhaseRef(
+  struct tagLISAParams* params,       /* Input: set of LISA parameters of the signal */
+  double tRefinj,                     /* Input: reference time of the injection, replacing injectedparams->tRef */
+  struct tagLISAInjectionCAmpPhase* signal)   /* Output: structure for the injected signal */
 {
   int ret;
   ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
@@ -997,10 +1277,10 @@ int LISAGenerateInjectionCAmpPhase(
   /* If extending, taking into account both fstartobs and minf */
   if(!(globalparams->tagextpn)) {
     //printf("Not Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
+    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - tRefinj, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
   } else {
     //printf("Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
+    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - tRefinj, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
   }
   /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
   if(ret==FAILURE){
@@ -1032,7 +1312,7 @@ int LISAGenerateInjectionCAmpPhase(
   //TESTING
   //clock_t tbeg, tend;
   //tbeg = clock();
-  LISASimFDResponseTDI3Chan(globalparams->tagtRefatLISA, globalparams->variant, &listROM, &listTDI1, &listTDI2, &listTDI3, injectedparams->tRef, params->lambda, params->beta, params->inclination, params->polarization, params->m1, params->m2, globalparams->maxf, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+  LISASimFDResponseTDI3Chan(globalparams->tagtRefatLISA, globalparams->variant, &listROM, &listTDI1, &listTDI2, &listTDI3, tRefinj, params->lambda, params->beta, params->inclination, params->polarization, params->m1, params->m2, globalparams->maxf, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
   //tend = clock();
   //printf("time LISASimFDResponse: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
   //
@@ -1041,16 +1321,18 @@ int LISAGenerateInjectionCAmpPhase(
   ListmodesCAmpPhaseSpline* listsplinesinj1 = NULL;
   ListmodesCAmpPhaseSpline* listsplinesinj2 = NULL;
   ListmodesCAmpPhaseSpline* listsplinesinj3 = NULL;
-  BuildListmodesCAmpPhaseSpline(&listsplinesinj1, listTDI1);
-  BuildListmodesCAmpPhaseSpline(&listsplinesinj2, listTDI2);
-  BuildListmodesCAmpPhaseSpline(&listsplinesinj3, listTDI3);
+  BuildListmodesCAmpPhaseSpline3Chan(&listsplinesinj1, &listsplinesinj2, &listsplinesinj3, listTDI1, listTDI2, listTDI3);
+  /* Same splines in SoA form for the overlaps with templates, built once for all */
+  ModesCAmpPhaseSpline3ChanSoA* splinesinjsoa = NULL;
+  ModesCAmpPhaseSpline3ChanSoA_Init(&splinesinjsoa, 0);
+  BuildModesCAmpPhaseSpline3ChanSoA(splinesinjsoa, listTDI1, listTDI2, listTDI3, NULL);
 
   /* Precompute the inner product (h|h) - takes into account the length of the observation with deltatobs */
   double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
   double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
-  ObjectFunction NoiseSn1 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 1);
-  ObjectFunction NoiseSn2 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 2);
-  ObjectFunction NoiseSn3 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 3);
+  ObjectFunction NoiseSn1 = LISANoiseFunction(globalparams, 1);
+  ObjectFunction NoiseSn2 = LISANoiseFunction(globalparams, 2);
+  ObjectFunction NoiseSn3 = LISANoiseFunction(globalparams, 3);
   //TESTING
   //tbeg = clock();
   double TDI123ss = FDListmodesFresnelOverlap3Chan(listTDI1, listTDI2, listTDI3, listsplinesinj1, listsplinesinj2, listsplinesinj3, &NoiseSn1, &NoiseSn2, &NoiseSn3, fLow, fHigh, fstartobs, fstartobs);
@@ -1062,6 +1344,7 @@ int LISAGenerateInjectionCAmpPhase(
   signal->TDI1Splines = listsplinesinj1;
   signal->TDI2Splines = listsplinesinj2;
   signal->TDI3Splines = listsplinesinj3;
+  signal->TDI123SplinesSoA = splinesinjsoa;
   signal->TDI123ss = TDI123ss;
 
   ListmodesCAmpPhaseFrequencySeries_Destroy(listROM);
@@ -1094,17 +1377,8 @@ int LISAGenerateSignalReIm(
   double fstartobs = 0.;
   if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(params->m1, params->m2, globalparams->deltatobs);
 
-  /* Generate the waveform with the ROM */
-  /* NOTE: SimEOBNRv2HMROM accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
-  /* NOTE: minf and deltatobs are taken into account if extension is allowed, but not maxf - restriction to the relevant frequency interval will occur in both the response prcessing and overlap computation */
-  /* If extending, taking into account both fstartobs and minf */
-  if(!(globalparams->tagextpn)) {
-    //printf("Not Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
-  } else {
-    //printf("Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
-  }
+  /* Generate the waveform with the ROM - through the intrinsic cache if enabled */
+  ret = LISAGenerateROMCached(&listROM, params, injectedparams->tRef);
 
   /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
   if(ret==FAILURE) return FAILURE;
@@ -1161,6 +1435,18 @@ int LISAGenerateInjectionReIm(
   int nbpts,                                 /* Input: number of frequency samples */
   int tagsampling,                           /* Input: tag for using linear (0) or logarithmic (1) sampling */
   struct tagLISAInjectionReIm* injection)    /* Output: structure for the generated signal */
+{
+  return LISAGenerateInjectionReImRef(params, injectedparams->tRef, fLow, nbpts, tagsampling, injection);
+}
+
+/* Same as LISAGenerateInjectionReIm, with the reference time given explicitly instead of read from injectedparams - does not touch the global injection, so that different injections can be generated concurrently */
+int LISAGenerateInjectionReImRef(
+  struct tagLISAParams* params,              /* Input: set of LISA parameters of the template */
+  double tRefinj,                            /* Input: reference time of the injection, replacing injectedparams->tRef */
+  double fLow,                               /* Input: additional lower frequency limit (argument minf) */
+  int nbpts,                                 /* Input: number of frequency samples */
+  int tagsampling,                           /* Input: tag for using linear (0) or logarithmic (1) sampling */
+  struct tagLISAInjectionReIm* injection)    /* Output: structure for the generated signal */
 {
   int ret;
   ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
@@ -1178,10 +1464,10 @@ int LISAGenerateInjectionReIm(
   /* If extending, taking into account both fstartobs and minf */
   if(!(globalparams->tagextpn)) {
     //printf("Not Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
+    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - tRefinj, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
   } else {
     //printf("Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
+    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - tRefinj, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
   }
 
   /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
@@ -1227,9 +1513,9 @@ int LISAGenerateInjectionReIm(
   //
 
   /* Compute the noise values */
-  ObjectFunction NoiseSn1 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 1);
-  ObjectFunction NoiseSn2 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 2);
-  ObjectFunction NoiseSn3 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 3);
+  ObjectFunction NoiseSn1 = LISANoiseFunction(globalparams, 1);
+  ObjectFunction NoiseSn2 = LISANoiseFunction(globalparams, 2);
+  ObjectFunction NoiseSn3 = LISANoiseFunction(globalparams, 3);
   gsl_vector* noisevalues1 = gsl_vector_alloc(nbpts);
   gsl_vector* noisevalues2 = gsl_vector_alloc(nbpts);
   gsl_vector* noisevalues3 = gsl_vector_alloc(nbpts);
@@ -1254,6 +1540,221 @@ int LISAGenerateInjectionReIm(
   return SUCCESS;
 }
 
+/****************** Cache of generated signals *****************/
+
+/* Bounded LRU caches of the generated signals, one per thread, keyed by the exact parameters - the signals are copied in and out, so that eviction never invalidates a signal held by the caller */
+typedef struct tagLISASignalCacheEntry {
+  LISAParams params;          /* Parameters of the signal */
+  double tRefinj;             /* Time of the injection, the signals being generated relative to it */
+  gsl_vector* freq;           /* Frequencies of a Re/Im signal (not owned), NULL for CAmpPhase signals */
+  int ret;                    /* Return value of the generation - failures are cached too */
+  void* signal;               /* Cached signal, LISASignalCAmpPhase or LISASignalReIm */
+  size_t lastuse;             /* Time of last use, for the LRU eviction */
+} LISASignalCacheEntry;
+
+typedef struct tagLISASignalCache {
+  int size;                   /* Capacity */
+  int nbentries;              /* Number of entries in use */
+  size_t clock;               /* Counter of accesses */
+  size_t hits;                /* Number of hits */
+  size_t misses;              /* Number of misses */
+  LISASignalCacheEntry* entries;
+} LISASignalCache;
+
+static LISASignalCache* __LISASignalCacheCAmpPhase = NULL;
+static LISASignalCache* __LISASignalCacheReIm = NULL;
+#pragma omp threadprivate(__LISASignalCacheCAmpPhase, __LISASignalCacheReIm)
+
+static LISASignalCache* LISASignalCacheGet(LISASignalCache** cache)
+{
+  if(!*cache) {
+    *cache = malloc(sizeof(LISASignalCache));
+    (*cache)->size = globalparams->nbsignalcache;
+    (*cache)->nbentries = 0;
+    (*cache)->clock = 0;
+    (*cache)->hits = 0;
+    (*cache)->misses = 0;
+    (*cache)->entries = malloc((*cache)->size*sizeof(LISASignalCacheEntry));
+  }
+  return *cache;
+}
+
+/* Find an entry, returns its index or -1 - the frequencies of Re/Im signals are compared by address, size and end values */
+static int LISASignalCacheFind(LISASignalCache* cache, const LISAParams* params, const double tRefinj, gsl_vector* freq)
+{
+  cache->clock++;
+  for(int i=0; i<cache->nbentries; i++) {
+    LISASignalCacheEntry* entry = &cache->entries[i];
+    const LISAParams* p = &entry->params;
+    if(p->tRef==params->tRef && p->phiRef==params->phiRef && p->m1==params->m1 && p->m2==params->m2 && p->distance==params->distance && p->lambda==params->lambda && p->beta==params->beta && p->inclination==params->inclination && p->polarization==params->polarization && p->nbmode==params->nbmode && entry->tRefinj==tRefinj && entry->freq==freq) {
+      if(freq && !(entry->freq->size==freq->size && gsl_vector_get(entry->freq, 0)==gsl_vector_get(freq, 0) && gsl_vector_get(entry->freq, freq->size-1)==gsl_vector_get(freq, freq->size-1))) continue;
+      entry->lastuse = cache->clock;
+      cache->hits++;
+      return i;
+    }
+  }
+  cache->misses++;
+  return -1;
+}
+
+/* Slot for a new entry - a free one, or the least recently used one after cleaning up its signal */
+static LISASignalCacheEntry* LISASignalCacheSlot(LISASignalCache* cache, void (*cleanup)(void*))
+{
+  int i;
+  if(cache->nbentries<cache->size) i = cache->nbentries++;
+  else {
+    i = 0;
+    for(int j=1; j<cache->nbentries; j++) if(cache->entries[j].lastuse<cache->entries[i].lastuse) i = j;
+    if(cache->entries[i].signal) cleanup(cache->entries[i].signal);
+  }
+  return &cache->entries[i];
+}
+
+static ListmodesCAmpPhaseFrequencySeries* LISACopyListmodesCAmpPhase(ListmodesCAmpPhaseFrequencySeries* list)
+{
+  /* The modes are prepended, so that we copy them in reverse order to keep the order of the list */
+  int nbmode = 0;
+  ListmodesCAmpPhaseFrequencySeries* listelement = list;
+  while(listelement) {
+    nbmode++;
+    listelement = listelement->next;
+  }
+  ListmodesCAmpPhaseFrequencySeries** elements = malloc(nbmode*sizeof(ListmodesCAmpPhaseFrequencySeries*));
+  listelement = list;
+  for(int i=0; i<nbmode; i++) {
+    elements[i] = listelement;
+    listelement = listelement->next;
+  }
+  ListmodesCAmpPhaseFrequencySeries* copy = NULL;
+  for(int i=nbmode-1; i>=0; i--) {
+    CAmpPhaseFrequencySeries* freqseries = elements[i]->freqseries;
+    CAmpPhaseFrequencySeries* freqseriescopy = NULL;
+    CAmpPhaseFrequencySeries_Init(&freqseriescopy, freqseries->freq->size);
+    gsl_vector_memcpy(freqseriescopy->freq, freqseries->freq);
+    gsl_vector_memcpy(freqseriescopy->amp_real, freqseries->amp_real);
+    gsl_vector_memcpy(freqseriescopy->amp_imag, freqseries->amp_imag);
+    gsl_vector_memcpy(freqseriescopy->phase, freqseries->phase);
+    copy = ListmodesCAmpPhaseFrequencySeries_AddModeNoCopy(copy, freqseriescopy, elements[i]->l, elements[i]->m);
+  }
+  free(elements);
+  return copy;
+}
+
+static ReImFrequencySeries* LISACopyReIm(ReImFrequencySeries* freqseries)
+{
+  ReImFrequencySeries* copy = NULL;
+  ReImFrequencySeries_Init(&copy, freqseries->freq->size);
+  gsl_vector_memcpy(copy->freq, freqseries->freq);
+  gsl_vector_memcpy(copy->h_real, freqseries->h_real);
+  gsl_vector_memcpy(copy->h_imag, freqseries->h_imag);
+  return copy;
+}
+
+static void LISACopySignalCAmpPhase(LISASignalCAmpPhase* dst, LISASignalCAmpPhase* src)
+{
+  dst->TDI1Signal = LISACopyListmodesCAmpPhase(src->TDI1Signal);
+  dst->TDI2Signal = LISACopyListmodesCAmpPhase(src->TDI2Signal);
+  dst->TDI3Signal = LISACopyListmodesCAmpPhase(src->TDI3Signal);
+  dst->TDI123hh = src->TDI123hh;
+}
+
+static void LISACopySignalReIm(LISASignalReIm* dst, LISASignalReIm* src)
+{
+  dst->TDI1Signal = LISACopyReIm(src->TDI1Signal);
+  dst->TDI2Signal = LISACopyReIm(src->TDI2Signal);
+  dst->TDI3Signal = LISACopyReIm(src->TDI3Signal);
+}
+
+static void LISASignalCAmpPhaseCleanupVoid(void* signal) { LISASignalCAmpPhase_Cleanup((LISASignalCAmpPhase*) signal); }
+static void LISASignalReImCleanupVoid(void* signal) { LISASignalReIm_Cleanup((LISASignalReIm*) signal); }
+
+/* Same as LISAGenerateSignalCAmpPhase, going through the cache of the calling thread when globalparams->nbsignalcache>0 */
+int LISAGenerateSignalCAmpPhaseCached(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  struct tagLISASignalCAmpPhase* signal)   /* Output: structure for the generated signal (initialized, copy of the cached signal) */
+{
+  return LISAGenerateSignalCAmpPhaseCachedRef(params, injectedparams->tRef, signal);
+}
+
+/* Same as LISAGenerateSignalCAmpPhaseRef, going through the cache of the calling thread when globalparams->nbsignalcache>0 - the reference time of the injection is part of the key */
+int LISAGenerateSignalCAmpPhaseCachedRef(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  double tRefinj,                          /* Input: reference time of the injection, replacing injectedparams->tRef */
+  struct tagLISASignalCAmpPhase* signal)   /* Output: structure for the generated signal (initialized, copy of the cached signal) */
+{
+  if(globalparams->nbsignalcache<=0) return LISAGenerateSignalCAmpPhaseRef(params, tRefinj, signal);
+  LISASignalCache* cache = LISASignalCacheGet(&__LISASignalCacheCAmpPhase);
+  int i = LISASignalCacheFind(cache, params, tRefinj, NULL);
+  if(i>=0) {
+    LISASignalCacheEntry* entry = &cache->entries[i];
+    if(entry->ret==SUCCESS) LISACopySignalCAmpPhase(signal, (LISASignalCAmpPhase*) entry->signal);
+    return entry->ret;
+  }
+  LISASignalCAmpPhase* generated = NULL;
+  LISASignalCAmpPhase_Init(&generated);
+  int ret = LISAGenerateSignalCAmpPhaseRef(params, tRefinj, generated);
+  if(ret==SUCCESS) LISACopySignalCAmpPhase(signal, generated);
+  else {
+    LISASignalCAmpPhase_Cleanup(generated);
+    generated = NULL;
+  }
+  LISASignalCacheEntry* entry = LISASignalCacheSlot(cache, LISASignalCAmpPhaseCleanupVoid);
+  entry->params = *params;
+  entry->tRefinj = tRefinj;
+  entry->freq = NULL;
+  entry->ret = ret;
+  entry->signal = generated;
+  entry->lastuse = cache->clock;
+  return ret;
+}
+
+/* Same as LISAGenerateSignalReIm, going through the cache of the calling thread when globalparams->nbsignalcache>0 */
+int LISAGenerateSignalReImCached(
+  struct tagLISAParams* params,       /* Input: set of LISA parameters of the template */
+  gsl_vector* freq,                   /* Input: frequencies on which evaluating the waveform (from the injection) */
+  struct tagLISASignalReIm* signal)   /* Output: structure for the generated signal (initialized, copy of the cached signal) */
+{
+  if(globalparams->nbsignalcache<=0) return LISAGenerateSignalReIm(params, freq, signal);
+  LISASignalCache* cache = LISASignalCacheGet(&__LISASignalCacheReIm);
+  int i = LISASignalCacheFind(cache, params, injectedparams->tRef, freq);
+  if(i>=0) {
+    LISASignalCacheEntry* entry = &cache->entries[i];
+    if(entry->ret==SUCCESS) LISACopySignalReIm(signal, (LISASignalReIm*) entry->signal);
+    return entry->ret;
+  }
+  LISASignalReIm* generated = NULL;
+  LISASignalReIm_Init(&generated);
+  int ret = LISAGenerateSignalReIm(params, freq, generated);
+  if(ret==SUCCESS) LISACopySignalReIm(signal, generated);
+  else {
+    LISASignalReIm_Cleanup(generated);
+    generated = NULL;
+  }
+  LISASignalCacheEntry* entry = LISASignalCacheSlot(cache, LISASignalReImCleanupVoid);
+  entry->params = *params;
+  entry->tRefinj = injectedparams->tRef;
+  entry->freq = freq;
+  entry->ret = ret;
+  entry->signal = generated;
+  entry->lastuse = cache->clock;
+  return ret;
+}
+
+/* Hit and miss counts of the signal caches of the calling thread, CAmpPhase and Re/Im combined */
+void LISASignalCacheStats(size_t* hits, size_t* misses)
+{
+  *hits = 0;
+  *misses = 0;
+  if(__LISASignalCacheCAmpPhase) {
+    *hits += __LISASignalCacheCAmpPhase->hits;
+    *misses += __LISASignalCacheCAmpPhase->misses;
+  }
+  if(__LISASignalCacheReIm) {
+    *hits += __LISASignalCacheReIm->hits;
+    *misses += __LISASignalCacheReIm->misses;
+  }
+}
+
 /* Log-Likelihood function */
 
 // Routines for simplified likelihood 22 mode, frozen LISA, lowf
@@ -1313,9 +1814,72 @@ double CalculateLogLSimpleLikelihood(SimpleLikelihoodPrecomputedValues* simpleli
   return simplelogL;
 }
 
-double CalculateLogLCAmpPhase(LISAParams *params, LISAInjectionCAmpPhase* injection)
+/* Coefficients of the modes in the channels a, e for the Gram-matrix likelihood, frozen LISA, lowf - generalizes funcsa, funcse to all modes */
+/* Modes beyond nbmode (in the order of listmode) get a zero coefficient */
+static void funcgramcoeffs(double complex* ca, double complex* ce, GramLikelihoodPrecomputedValues* gramlikelihoodvals, LISAParams* params, int nbmode)
+{
+  double phiL = funcphiL(params);
+  double lambdL = funclambdaL(params);
+  double betaL = funcbetaL(params);
+  double psiL = funcpsiL(params);
+  double inc = params->inclination;
+  double d = params->distance; /* Modes are precomputed at 1Mpc */
+  /* Pattern functions in the polarization basis, rotated by psiL */
+  double complex Daplus = I*3./4 * (3 - cos(2*betaL)) * cos(2*lambdL - PI/3);
+  double complex Dacross = I*3*sin(betaL) * sin(2*lambdL - PI/3);
+  double complex Deplus = -I*3./4 * (3 - cos(2*betaL)) * sin(2*lambdL - PI/3);
+  double complex Decross = I*3*sin(betaL) * cos(2*lambdL - PI/3);
+  double c2psi = cos(2*psiL);
+  double s2psi = sin(2*psiL);
+  double complex Faplus = c2psi*Daplus + s2psi*Dacross;
+  double complex Facross = -s2psi*Daplus + c2psi*Dacross;
+  double complex Feplus = c2psi*Deplus + s2psi*Decross;
+  double complex Fecross = -s2psi*Deplus + c2psi*Decross;
+  for(int k=0; k<gramlikelihoodvals->nbmode; k++) {
+    if(k>=nbmode) {
+      ca[k] = 0.;
+      ce[k] = 0.;
+      continue;
+    }
+    int l = gramlikelihoodvals->l[k];
+    int m = gramlikelihoodvals->m[k];
+    /* Ylm combined factors for plus and cross, as in the full response */
+    double complex Ylm = SpinWeightedSphericalHarmonic(inc, 0., -2, l, m);
+    double complex Ylminusm = conj(SpinWeightedSphericalHarmonic(inc, 0., -2, l, -m));
+    double complex Yfactorplus = (l%2) ? 1./2 * (Ylm - Ylminusm) : 1./2 * (Ylm + Ylminusm);
+    double complex Yfactorcross = (l%2) ? I/2 * (Ylm + Ylminusm) : I/2 * (Ylm - Ylminusm);
+    double complex factor = 1./d * cexp(-I*m*phiL);
+    ca[k] = factor * (Yfactorplus*Faplus + Yfactorcross*Facross);
+    ce[k] = factor * (Yfactorplus*Feplus + Yfactorcross*Fecross);
+  }
+}
+
+double CalculateLogLGramLikelihood(GramLikelihoodPrecomputedValues* gramlikelihoodvals, LISAParams* params)
+{
+  /* Simple likelihood generalized to all modes, frozen LISA, lowf */
+  /* Only applicable for masses and time pinned to injection values */
+  /* The Gram matrix and the coefficients of the injection must have been precomputed */
+  /* With a = sum_lm ca_lm h_lm (same for e), the likelihood is a quadratic form in the differences of coefficients */
+  int nbmode = gramlikelihoodvals->nbmode;
+  double complex ca[nbmodemax];
+  double complex ce[nbmodemax];
+  funcgramcoeffs(ca, ce, gramlikelihoodvals, params, params->nbmode);
+  for(int k=0; k<nbmode; k++) {
+    ca[k] -= gramlikelihoodvals->cainj[k];
+    ce[k] -= gramlikelihoodvals->ceinj[k];
+  }
+  double chi2 = 0.;
+  for(int k=0; k<nbmode; k++) {
+    for(int kp=0; kp<nbmode; kp++) {
+      chi2 += creal((ca[k]*conj(ca[kp]) + ce[k]*conj(ce[kp])) * gramlikelihoodvals->gram[k][kp]);
+    }
+  }
+  return -1./2 * chi2;
+}
+
+/* Overlaps (d|h) and (h|h) of a template with the injection, in CAmp/Phase form - FAILURE if the generation failed */
+static int LISAOverlapsCAmpPhase(LISAParams *params, LISAInjectionCAmpPhase* injection, double* dh, double* hh)
 {
-  double logL = -DBL_MAX;
   int ret;
 
   /* Generating the signal in the three detectors for the input parameters */
@@ -1324,7 +1888,7 @@ double CalculateLogLCAmpPhase(LISAParams *params, LISAInjectionCAmpPhase* inject
   //TESTING
   //clock_t tbeg, tend;
   //tbeg = clock();
-  ret = LISAGenerateSignalCAmpPhase(params, generatedsignal);
+  ret = LISAGenerateSignalCAmpPhaseCached(params, generatedsignal);
   //tend = clock();
   //printf("time GenerateSignal: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
   //
@@ -1332,41 +1896,52 @@ double CalculateLogLCAmpPhase(LISAParams *params, LISAInjectionCAmpPhase* inject
   //
   //printf("in CalculateLogLCAmpPhase: tRef= %g\n", params->tRef);
 
-  /* If LISAGenerateSignal failed (e.g. parameters out of bound), silently return -Infinity logL */
-  if(ret==FAILURE) {
-    logL = -DBL_MAX;
-  }
-  else if(ret==SUCCESS) {
-    /* Computing the likelihood for each TDI channel - fstartobs is the max between the fstartobs of the injected and generated signals */
+  if(ret==SUCCESS) {
+    /* Computing the overlaps for each TDI channel - fstartobs is the max between the fstartobs of the injected and generated signals */
     double fstartobsinjected = Newtonianfoft(injectedparams->m1, injectedparams->m2, globalparams->deltatobs);
     double fstartobsgenerated = Newtonianfoft(params->m1, params->m2, globalparams->deltatobs);
     double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
     double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
-    ObjectFunction NoiseSn1 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 1);
-    ObjectFunction NoiseSn2 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 2);
-    ObjectFunction NoiseSn3 = NoiseFunction(globalparams->variant,globalparams->tagtdi, 3);
+    ObjectFunction NoiseSn1 = LISANoiseFunction(globalparams, 1);
+    ObjectFunction NoiseSn2 = LISANoiseFunction(globalparams, 2);
+    ObjectFunction NoiseSn3 = LISANoiseFunction(globalparams, 3);
     //TESTING
     //tbeg = clock();
 
     //
     //printf("fLow, fHigh, fstartobsinjected, fstartobsgenerated = %g, %g, %g, %g\n", fLow, fHigh, fstartobsinjected, fstartobsgenerated);
 
-    double overlapTDI123 = FDListmodesFresnelOverlap3Chan(generatedsignal->TDI1Signal, generatedsignal->TDI2Signal, generatedsignal->TDI3Signal, injection->TDI1Splines, injection->TDI2Splines, injection->TDI3Splines, &NoiseSn1, &NoiseSn2, &NoiseSn3, fLow, fHigh, fstartobsinjected, fstartobsgenerated);
+    OverlapWorkspace* ws = LISAGetOverlapWorkspace(generatedsignal->TDI1Signal);
+    double overlapTDI123 = FDListmodesFresnelOverlap3ChanSoAWS(generatedsignal->TDI1Signal, generatedsignal->TDI2Signal, generatedsignal->TDI3Signal, injection->TDI123SplinesSoA, &NoiseSn1, &NoiseSn2, &NoiseSn3, fLow, fHigh, fstartobsinjected, fstartobsgenerated, ws);
     //tend = clock();
     //printf("time Overlaps: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
     //
 
-    /* Output: value of the loglikelihood for the combined signals, assuming noise independence */
-    logL = overlapTDI123 - 1./2*(injection->TDI123ss) - 1./2*(generatedsignal->TDI123hh);
-    if(logL>0){
-      printf("logL=%g\n",logL);
-      printf("overlapTDI123=%g, injection->TDI123ss=%g, generatedsignal->TDI123hh=%g\n", overlapTDI123, injection->TDI123ss, generatedsignal->TDI123hh);
-      report_LISAParams(params);
-    }
+    /* Output: overlaps for the combined signals, assuming noise independence */
+    *dh = overlapTDI123;
+    *hh = generatedsignal->TDI123hh;
   }
   /* Clean up */
   LISASignalCAmpPhase_Cleanup(generatedsignal);
 
+  return ret;
+}
+
+double CalculateLogLCAmpPhase(LISAParams *params, LISAInjectionCAmpPhase* injection)
+{
+  double overlapTDI123, TDI123hh;
+
+  /* If LISAGenerateSignal failed (e.g. parameters out of bound), silently return -Infinity logL */
+  if(LISAOverlapsCAmpPhase(params, injection, &overlapTDI123, &TDI123hh)==FAILURE) return -DBL_MAX;
+
+  /* Output: value of the loglikelihood for the combined signals, assuming noise independence */
+  double logL = overlapTDI123 - 1./2*(injection->TDI123ss) - 1./2*TDI123hh;
+  if(logL>0){
+    printf("logL=%g\n",logL);
+    printf("overlapTDI123=%g, injection->TDI123ss=%g, generatedsignal->TDI123hh=%g\n", overlapTDI123, injection->TDI123ss, TDI123hh);
+    report_LISAParams(params);
+  }
+
   return logL;
 }
 
@@ -1384,7 +1959,7 @@ double CalculateLogLReIm(LISAParams *params, LISAInjectionReIm* injection)
   //TESTING
   //clock_t tbeg, tend;
   //tbeg = clock();
-  ret = LISAGenerateSignalReIm(params, freq, generatedsignal);
+  ret = LISAGenerateSignalReImCached(params, freq, generatedsignal);
   //tend = clock();
   //printf("time GenerateSignal: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
   //
@@ -1423,57 +1998,1192 @@ double CalculateLogLReIm(LISAParams *params, LISAInjectionReIm* injection)
   return logL;
 }
 
-/****************** Functions precomputing relevant values when using simplified likelihood *****************/
+/****************** Relative binning likelihood *****************/
 
-/* For now, 22-mode only */
-int LISAComputeSimpleLikelihoodPrecomputedValues(SimpleLikelihoodPrecomputedValues* simplelikelihoodvals, LISAParams* params)
+/* Function generating the TDI modes in CAmp/Phase form of a LISA signal, without any overlap computation */
+static int LISAGenerateTDIModesCAmpPhase(
+  LISAParams* params,                               /* Input: set of LISA parameters of the signal */
+  ListmodesCAmpPhaseFrequencySeries** listTDI1,     /* Output: list of modes for TDI channel 1 */
+  ListmodesCAmpPhaseFrequencySeries** listTDI2,     /* Output: list of modes for TDI channel 2 */
+  ListmodesCAmpPhaseFrequencySeries** listTDI3)     /* Output: list of modes for TDI channel 3 */
 {
-  /* Check pointer for output */
-  if(simplelikelihoodvals==NULL) {
-    printf("Error in LISAComputeSimpleLikelihoodPrecomputedValues: called with NULL pointer for SimpleLikelihoodPrecomputedValues.\n");
-    exit(1);
-  }
-
   int ret;
-  double normalization = 0.;
-  double complex sa = 0.;
-  double complex se = 0.;
+  ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
 
-  /* Convert parameters to L-frame */
-  double phiL = funcphiL(params);
-  double lambdL = funclambdaL(params);
-  double betaL = funcbetaL(params);
-  double psiL = funcpsiL(params);
-  double inc = params->inclination;
-  double d = params->distance / injectedparams->distance; /* Should be 1., since params should be injectedparams */
+  /* Generate the waveform with the ROM - same as in LISAGenerateSignalCAmpPhase */
+  ret = LISAGenerateROMCached(&listROM, params, injectedparams->tRef);
+  if(ret==FAILURE) return FAILURE;
 
-  /* Precompute sa, se */
-  sa = funcsa(d, phiL, inc, lambdL, betaL, psiL);
-  se = funcse(d, phiL, inc, lambdL, betaL, psiL);
+  /* Process the waveform through the LISA response */
+  LISASimFDResponseTDI3Chan(globalparams->tagtRefatLISA, globalparams->variant, &listROM, listTDI1, listTDI2, listTDI3, params->tRef, params->lambda, params->beta, params->inclination, params->polarization, params->m1, params->m2, globalparams->maxf, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
 
-  /* Generate 22 mode for the fixed mass and time parameters - same fstartobs and PN extension as in the GenerateInjectionCAmpPhase function */
+  ListmodesCAmpPhaseFrequencySeries_Destroy(listROM);
+  return SUCCESS;
+}
+
+/* Function evaluating the TDI modes of a LISA signal directly at a set of frequencies - the ROM is generated on its own grid, the response is only evaluated at the frequencies */
+static int LISAGenerateTDIModesAtFrequencies(
+  LISAParams* params,                               /* Input: set of LISA parameters of the signal */
+  const int nbmode,                                 /* Input: number of modes to evaluate */
+  const int* lmode,                                 /* Input: indices l of the modes */
+  const int* mmode,                                 /* Input: indices m of the modes */
+  const double* freq,                               /* Input: frequencies, increasing */
+  const int nbfreq,                                 /* Input: number of frequencies */
+  double complex* values)                           /* Output: values of the modes - index (c*nbmode + i)*nbfreq + b for channel c, mode i, frequency b - 0 for modes absent from the signal */
+{
   ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
-  /* Starting frequency corresponding to duration of observation deltatobs */
-  double fstartobs = 0.;
-  if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(params->m1, params->m2, globalparams->deltatobs);
-  /* Generate the waveform with the ROM */
-  /* NOTE: SimEOBNRv2HMROM accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
-  /* NOTE: minf and deltatobs are taken into account if extension is allowed, but not maxf - restriction to the relevant frequency interval will occur in both the response prcessing and overlap computation */
-  /* If extending, taking into account both fstartobs and minf */
-  if(!(globalparams->tagextpn)) {
-    //printf("Not Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
-  } else {
-    //printf("Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
-    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
-  }
-  /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
-  if(ret==FAILURE){
-    printf("Failed to generate injection ROM\n");
-    return FAILURE;
+
+  /* Generate the waveform with the ROM - same as in LISAGenerateSignalCAmpPhase */
+  if(LISAGenerateROMCached(&listROM, params, injectedparams->tRef)==FAILURE) return FAILURE;
+
+  for(int i=0; i<nbmode; i++) {
+    double complex* values1 = &values[(0*nbmode + i)*nbfreq];
+    double complex* values2 = &values[(1*nbmode + i)*nbfreq];
+    double complex* values3 = &values[(2*nbmode + i)*nbfreq];
+    ListmodesCAmpPhaseFrequencySeries* mode = ListmodesCAmpPhaseFrequencySeries_GetMode(listROM, lmode[i], mmode[i]);
+    if(mode) LISASimFDResponseTDI3ChanAtFrequencies(globalparams->tagtRefatLISA, globalparams->variant, mode->freqseries, lmode[i], mmode[i], freq, nbfreq, values1, values2, values3, params->tRef, params->lambda, params->beta, params->inclination, params->polarization, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+    else for(int b=0; b<nbfreq; b++) values1[b] = values2[b] = values3[b] = 0.;
   }
 
-  /* Multiply the h22 amplitude by pi f L/c */
+  ListmodesCAmpPhaseFrequencySeries_Destroy(listROM);
+  return SUCCESS;
+}
+
+/* Evaluate a mode h = A e^{i phi} from its splines on a set of increasing frequencies - set to 0 outside the range of the knots */
+static void LISAEvalModeSpline(
+  CAmpPhaseSpline* splines,     /* Input: splines of the mode */
+  const double* freq,           /* Input: frequencies, increasing */
+  const int nbfreq,             /* Input: number of frequencies */
+  double complex* values)       /* Output: values of the mode */
+{
+  gsl_matrix* knots = splines->quadspline_phase;
+  double fknotmin = gsl_matrix_get(knots, 0, 0);
+  double fknotmax = gsl_matrix_get(knots, knots->size1-1, 0);
+  int ibeg = 0, iend = nbfreq;
+  while(ibeg<nbfreq && freq[ibeg]<fknotmin) ibeg++;
+  while(iend>ibeg && freq[iend-1]>fknotmax) iend--;
+  for(int i=0; i<nbfreq; i++) values[i] = 0.;
+  if(iend==ibeg) return;
+
+  CAmpPhaseFrequencySeries* freqseries = NULL;
+  CAmpPhaseFrequencySeries_Init(&freqseries, iend-ibeg);
+  for(int i=ibeg; i<iend; i++) gsl_vector_set(freqseries->freq, i-ibeg, freq[i]);
+  EvalCAmpPhaseSpline(splines, freqseries);
+  for(int i=ibeg; i<iend; i++) {
+    double complex amp = gsl_vector_get(freqseries->amp_real, i-ibeg) + I*gsl_vector_get(freqseries->amp_imag, i-ibeg);
+    values[i] = amp * cexp(I*gsl_vector_get(freqseries->phase, i-ibeg));
+  }
+  CAmpPhaseFrequencySeries_Cleanup(freqseries);
+}
+
+/* Function precomputing the summary data for the relative binning likelihood */
+/* The templates are written h = r h0 mode by mode, with the ratio r linear in each bin - (h|d) and (h|h) then only require the moments of the fiducial modes h0 against the data and against themselves */
+/* NOTE: the lower cut fstartobs of the pairs of modes is frozen to its value for the injection */
+int LISAGenerateInjectionRelBin(
+  struct tagLISAParams* injectedparams,       /* Input: set of LISA parameters of the injection */
+  struct tagLISAInjectionCAmpPhase* injection, /* Input: injection as generated by LISAGenerateInjectionCAmpPhase */
+  int nbbins,                                 /* Input: number of frequency bins */
+  struct tagLISAInjectionRelBin* relbin)      /* Output: structure for the summary data */
+{
+  /* Fiducial waveform: the injection with the modes of the templates */
+  LISAParams fidparams = *injectedparams;
+  fidparams.nbmode = globalparams->nbmodetemp;
+  ListmodesCAmpPhaseFrequencySeries* listfid[3] = {NULL, NULL, NULL};
+  if(LISAGenerateTDIModesCAmpPhase(&fidparams, &listfid[0], &listfid[1], &listfid[2])==FAILURE) {
+    printf("Error: failed to generate the fiducial waveform for the relative binning.\n");
+    return FAILURE;
+  }
+  ListmodesCAmpPhaseSpline* listsplinesfid[3] = {NULL, NULL, NULL};
+  BuildListmodesCAmpPhaseSpline3Chan(&listsplinesfid[0], &listsplinesfid[1], &listsplinesfid[2], listfid[0], listfid[1], listfid[2]);
+  ListmodesCAmpPhaseSpline* listsplinesdata[3] = {injection->TDI1Splines, injection->TDI2Splines, injection->TDI3Splines};
+
+  /* Frequency range and modes of the fiducial waveform */
+  double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
+  double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
+  double fstartobs = 0.;
+  if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(injectedparams->m1, injectedparams->m2, globalparams->deltatobs);
+  int nbmode = 0;
+  double fbinmin = DBL_MAX, fbinmax = 0.;
+  ListmodesCAmpPhaseFrequencySeries* listelement = listfid[0];
+  while(listelement) {
+    gsl_vector* freq = listelement->freqseries->freq;
+    fbinmin = fmin(fbinmin, fmax(gsl_vector_get(freq, 0), ((double) max(2, listelement->m))/2. * fstartobs));
+    fbinmax = fmax(fbinmax, gsl_vector_get(freq, freq->size-1));
+    nbmode++;
+    listelement = listelement->next;
+  }
+  fbinmin = fmax(fbinmin, fLow);
+  fbinmax = fmin(fbinmax, fHigh);
+  if(nbmode==0 || nbbins<1 || fbinmin>=fbinmax) {
+    printf("Error: empty frequency range for the relative binning.\n");
+    return FAILURE;
+  }
+
+  /* Bins with logarithmic spacing */
+  int nbedges = nbbins + 1;
+  relbin->nbbins = nbbins;
+  relbin->nbmode = nbmode;
+  relbin->fbins = malloc(nbedges*sizeof(double));
+  relbin->lmode = malloc(nbmode*sizeof(int));
+  relbin->mmode = malloc(nbmode*sizeof(int));
+  relbin->fidvalues = calloc(3*nbmode*nbedges, sizeof(double complex));
+  relbin->A = calloc(3*nbmode*2*nbbins, sizeof(double complex));
+  relbin->B = calloc(3*nbmode*nbmode*3*nbbins, sizeof(double complex));
+  relbin->TDI123ss = injection->TDI123ss;
+  for(int b=0; b<nbedges; b++) relbin->fbins[b] = fbinmin * exp(log(fbinmax/fbinmin) * b/nbbins);
+  relbin->fbins[nbbins] = fbinmax;
+  listelement = listfid[0];
+  for(int i=0; i<nbmode; i++) {
+    relbin->lmode[i] = listelement->l;
+    relbin->mmode[i] = listelement->m;
+    listelement = listelement->next;
+  }
+
+  /* Fiducial modes at the edges, evaluated as the templates are in LISAOverlapsRelBin */
+  if(LISAGenerateTDIModesAtFrequencies(&fidparams, nbmode, relbin->lmode, relbin->mmode, relbin->fbins, nbedges, relbin->fidvalues)==FAILURE) {
+    printf("Error: failed to evaluate the fiducial waveform for the relative binning.\n");
+    return FAILURE;
+  }
+
+  /* Moments of the fiducial modes against the data and against themselves */
+  double complex* moments = malloc(3*nbbins*sizeof(double complex));
+  for(int c=0; c<3; c++) {
+    ObjectFunction Snoise = LISANoiseFunction(globalparams, c+1);
+    for(int i=0; i<nbmode; i++) {
+      ListmodesCAmpPhaseSpline* fidi = ListmodesCAmpPhaseSpline_GetMode(listsplinesfid[c], relbin->lmode[i], relbin->mmode[i]);
+      if(!fidi) continue;
+      int mmaxi = max(2, relbin->mmode[i]);
+
+      double complex* A = &relbin->A[(c*nbmode + i)*2*nbbins];
+      ListmodesCAmpPhaseSpline* listelementdata = listsplinesdata[c];
+      while(listelementdata) {
+        int mmaxd = max(2, listelementdata->m);
+        double fcutLow = fmax(fLow, ((double) max(mmaxi, mmaxd))/2. * fstartobs);
+        FDSinglemodeBinnedOverlapMoments(moments, 2, relbin->fbins, nbbins, fidi->splines, listelementdata->splines, &Snoise, fcutLow, fHigh);
+        for(int k=0; k<2*nbbins; k++) A[k] += moments[k];
+        listelementdata = listelementdata->next;
+      }
+
+      /* (h0i|h0j) is hermitian in i,j - only j>=i is computed */
+      for(int j=i; j<nbmode; j++) {
+        ListmodesCAmpPhaseSpline* fidj = ListmodesCAmpPhaseSpline_GetMode(listsplinesfid[c], relbin->lmode[j], relbin->mmode[j]);
+        if(!fidj) continue;
+        double fcutLow = fmax(fLow, ((double) max(mmaxi, max(2, relbin->mmode[j])))/2. * fstartobs);
+        FDSinglemodeBinnedOverlapMoments(moments, 3, relbin->fbins, nbbins, fidi->splines, fidj->splines, &Snoise, fcutLow, fHigh);
+        double complex* Bij = &relbin->B[((c*nbmode + i)*nbmode + j)*3*nbbins];
+        double complex* Bji = &relbin->B[((c*nbmode + j)*nbmode + i)*3*nbbins];
+        for(int k=0; k<3*nbbins; k++) {
+          Bij[k] = moments[k];
+          Bji[k] = conj(moments[k]);
+        }
+      }
+    }
+  }
+
+  /* Clean up */
+  free(moments);
+  for(int c=0; c<3; c++) {
+    ListmodesCAmpPhaseFrequencySeries_Destroy(listfid[c]);
+    ListmodesCAmpPhaseSpline_Destroy(listsplinesfid[c]);
+  }
+  return SUCCESS;
+}
+
+/* Relative binning log-likelihood - the templates are only evaluated at the edges of the bins */
+/* Overlaps (d|h) and (h|h) of a template with the injection, from the summary data - FAILURE if the generation failed */
+static int LISAOverlapsRelBin(LISAParams *params, LISAInjectionRelBin* relbin, double* dh, double* hhout)
+{
+  int nbbins = relbin->nbbins;
+  int nbmode = relbin->nbmode;
+  int nbedges = nbbins + 1;
+
+  /* Template modes at the edges only - no full frequency series and no splines */
+  double complex* values = malloc(3*nbmode*nbedges*sizeof(double complex));
+  if(LISAGenerateTDIModesAtFrequencies(params, nbmode, relbin->lmode, relbin->mmode, relbin->fbins, nbedges, values)==FAILURE) {
+    free(values);
+    return FAILURE;
+  }
+
+  double complex* r0 = malloc(nbmode*nbbins*sizeof(double complex));
+  double complex* r1 = malloc(nbmode*nbbins*sizeof(double complex));
+  double overlap = 0., hh = 0.;
+  for(int c=0; c<3; c++) {
+    /* Ratios r = h/h0 at the edges, linear in each bin: r = r0 + r1 (f-fb) - modes absent from the template have r=0 */
+    for(int i=0; i<nbmode; i++) {
+      double complex* h = &values[(c*nbmode + i)*nbedges];
+      double complex* fidvalues = &relbin->fidvalues[(c*nbmode + i)*nbedges];
+      for(int b=0; b<nbedges; b++) h[b] = (cabs(fidvalues[b])>0.) ? h[b]/fidvalues[b] : 0.;
+      for(int b=0; b<nbbins; b++) {
+        r0[i*nbbins + b] = h[b];
+        r1[i*nbbins + b] = (h[b+1] - h[b]) / (relbin->fbins[b+1] - relbin->fbins[b]);
+      }
+    }
+
+    /* Combine with the summary data */
+    for(int i=0; i<nbmode; i++) {
+      double complex* A = &relbin->A[(c*nbmode + i)*2*nbbins];
+      for(int b=0; b<nbbins; b++) overlap += creal(r0[i*nbbins + b]*A[b] + r1[i*nbbins + b]*A[nbbins + b]);
+      for(int j=0; j<nbmode; j++) {
+        double complex* B = &relbin->B[((c*nbmode + i)*nbmode + j)*3*nbbins];
+        for(int b=0; b<nbbins; b++) {
+          double complex r0i = r0[i*nbbins + b], r1i = r1[i*nbbins + b];
+          double complex r0j = conj(r0[j*nbbins + b]), r1j = conj(r1[j*nbbins + b]);
+          hh += creal(r0i*r0j*B[b] + (r0i*r1j + r1i*r0j)*B[nbbins + b] + r1i*r1j*B[2*nbbins + b]);
+        }
+      }
+    }
+  }
+
+  /* Clean up */
+  free(values);
+  free(r0);
+  free(r1);
+
+  /* Output: overlaps for the combined signals, assuming noise independence */
+  *dh = overlap;
+  *hhout = hh;
+  return SUCCESS;
+}
+
+double CalculateLogLRelBin(LISAParams *params, LISAInjectionRelBin* relbin)
+{
+  double overlap, hh;
+
+  /* If the generation failed (e.g. parameters out of bound), silently return -Infinity logL */
+  if(LISAOverlapsRelBin(params, relbin, &overlap, &hh)==FAILURE) return -DBL_MAX;
+
+  /* Output: value of the loglikelihood for the combined signals, assuming noise independence */
+  return overlap - 1./2*(relbin->TDI123ss) - 1./2*hh;
+}
+
+/****************** Reduced order quadrature likelihood *****************/
+
+/* Solve in place the complex linear system M x = rhs by Gaussian elimination with partial pivoting - M (n*n, row-major) is overwritten */
+static int LISAROQSolve(double complex* M, double complex* rhs, const int n)
+{
+  for(int k=0; k<n; k++) {
+    int p = k;
+    for(int i=k+1; i<n; i++) if(cabs(M[i*n + k])>cabs(M[p*n + k])) p = i;
+    if(cabs(M[p*n + k])==0.) return FAILURE;
+    if(p!=k) {
+      for(int j=0; j<n; j++) {
+        double complex tmp = M[k*n + j]; M[k*n + j] = M[p*n + j]; M[p*n + j] = tmp;
+      }
+      double complex tmp = rhs[k]; rhs[k] = rhs[p]; rhs[p] = tmp;
+    }
+    for(int i=k+1; i<n; i++) {
+      double complex factor = M[i*n + k] / M[k*n + k];
+      for(int j=k; j<n; j++) M[i*n + j] -= factor * M[k*n + j];
+      rhs[i] -= factor * rhs[k];
+    }
+  }
+  for(int k=n-1; k>=0; k--) {
+    for(int j=k+1; j<n; j++) rhs[k] -= M[k*n + j] * rhs[j];
+    rhs[k] /= M[k*n + k];
+  }
+  return SUCCESS;
+}
+
+/* Build one block of the quadrature: greedy reduced basis of the training set, empirical interpolation nodes, and weights such that Re sum_f g(f) h(f) = Re sum_j w_j h(F_j) */
+/* Returns the number of nodes - the training set is overwritten */
+static int LISAROQBuildBlock(
+  double complex* train,        /* Input/Output: training set, ntrain rows of nbfreq values */
+  const int ntrain,             /* Input: number of training waveforms */
+  const int nbfreq,             /* Input: number of frequencies */
+  const double* wf,             /* Input: weights of the discrete inner product 4 df/Sn used for the greedy basis */
+  const double complex* g,      /* Input: function integrated against the waveforms, including the weights of the quadrature */
+  const double tol,             /* Input: tolerance on the squared relative projection error of the training set */
+  int* nodes,                   /* Output: indices of the nodes, increasing (size at least ntrain) */
+  double complex* weights)      /* Output: weights at the nodes (size at least ntrain) */
+{
+  /* Normalize the training set */
+  double* err = malloc(ntrain*sizeof(double));
+  for(int t=0; t<ntrain; t++) {
+    double complex* row = &train[t*nbfreq];
+    double norm = 0.;
+    for(int f=0; f<nbfreq; f++) norm += wf[f] * creal(row[f]*conj(row[f]));
+    err[t] = (norm>0.) ? 1. : 0.;
+    if(norm>0.) for(int f=0; f<nbfreq; f++) row[f] /= sqrt(norm);
+  }
+
+  /* Greedy reduced basis, orthonormal for the weighted inner product */
+  double complex* basis = malloc(ntrain*nbfreq*sizeof(double complex));
+  int n = 0;
+  while(n<ntrain) {
+    int tmax = 0;
+    for(int t=1; t<ntrain; t++) if(err[t]>err[tmax]) tmax = t;
+    if(err[tmax]<=tol) break;
+    double complex* e = &basis[n*nbfreq];
+    for(int f=0; f<nbfreq; f++) e[f] = train[tmax*nbfreq + f];
+    for(int pass=0; pass<2; pass++) { /* Iterated Gram-Schmidt */
+      for(int k=0; k<n; k++) {
+        double complex* ek = &basis[k*nbfreq];
+        double complex c = 0.;
+        for(int f=0; f<nbfreq; f++) c += wf[f] * e[f] * conj(ek[f]);
+        for(int f=0; f<nbfreq; f++) e[f] -= c * ek[f];
+      }
+    }
+    double norm = 0.;
+    for(int f=0; f<nbfreq; f++) norm += wf[f] * creal(e[f]*conj(e[f]));
+    if(!(norm>0.)) break;
+    for(int f=0; f<nbfreq; f++) e[f] /= sqrt(norm);
+    for(int t=0; t<ntrain; t++) {
+      double complex c = 0.;
+      for(int f=0; f<nbfreq; f++) c += wf[f] * train[t*nbfreq + f] * conj(e[f]);
+      err[t] -= creal(c*conj(c));
+    }
+    err[tmax] = 0.;
+    n++;
+  }
+  free(err);
+  if(n==0) {
+    free(basis);
+    return 0;
+  }
+
+  /* Empirical interpolation nodes */
+  double complex* V = malloc(n*n*sizeof(double complex));
+  double complex* coeffs = malloc(n*sizeof(double complex));
+  int fmaxabs = 0;
+  for(int f=1; f<nbfreq; f++) if(cabs(basis[f])>cabs(basis[fmaxabs])) fmaxabs = f;
+  nodes[0] = fmaxabs;
+  for(int k=1; k<n; k++) {
+    double complex* ek = &basis[k*nbfreq];
+    for(int i=0; i<k; i++) {
+      for(int j=0; j<k; j++) V[i*k + j] = basis[j*nbfreq + nodes[i]];
+      coeffs[i] = ek[nodes[i]];
+    }
+    /* A singular interpolation matrix means the nodes cannot resolve the basis further - keep the first k elements */
+    if(LISAROQSolve(V, coeffs, k)==FAILURE) {
+      n = k;
+      break;
+    }
+    double rmax = -1.;
+    for(int f=0; f<nbfreq; f++) {
+      double complex r = ek[f];
+      for(int j=0; j<k; j++) r -= coeffs[j] * basis[j*nbfreq + f];
+      if(cabs(r)>rmax) {
+        rmax = cabs(r);
+        nodes[k] = f;
+      }
+    }
+  }
+
+  /* Weights: with V_ij = e_j(F_i) and u_k = sum_f g(f) e_k(f), solve V^T w = u */
+  for(int k=0; k<n; k++) {
+    weights[k] = 0.;
+    for(int f=0; f<nbfreq; f++) weights[k] += g[f] * basis[k*nbfreq + f];
+    for(int i=0; i<n; i++) V[k*n + i] = basis[k*nbfreq + nodes[i]];
+  }
+  int ret = LISAROQSolve(V, weights, n);
+
+  /* Sort the nodes by increasing frequency */
+  for(int i=1; i<n; i++) {
+    int node = nodes[i];
+    double complex w = weights[i];
+    int j = i;
+    while(j>0 && nodes[j-1]>node) {
+      nodes[j] = nodes[j-1];
+      weights[j] = weights[j-1];
+      j--;
+    }
+    nodes[j] = node;
+    weights[j] = w;
+  }
+
+  free(V);
+  free(coeffs);
+  free(basis);
+  return (ret==SUCCESS) ? n : 0;
+}
+
+/* Free the arrays of the quadrature rules, leaving the structure empty */
+static void LISAInjectionROQ_Free(LISAInjectionROQ* roq) {
+  for(int b=0; b<roq->nbblocks; b++) {
+    free(roq->nodes[b]);
+    free(roq->weights[b]);
+    if(roq->index1) free(roq->index1[b]);
+    if(roq->index2) free(roq->index2[b]);
+  }
+  for(int i=0; i<roq->nbmode; i++) free(roq->nodesmode[i]);
+  if(roq->type) free(roq->type);
+  if(roq->chan) free(roq->chan);
+  if(roq->l1) free(roq->l1);
+  if(roq->m1) free(roq->m1);
+  if(roq->l2) free(roq->l2);
+  if(roq->m2) free(roq->m2);
+  if(roq->nbnodes) free(roq->nbnodes);
+  if(roq->nodes) free(roq->nodes);
+  if(roq->weights) free(roq->weights);
+  if(roq->lmode) free(roq->lmode);
+  if(roq->mmode) free(roq->mmode);
+  if(roq->nbnodesmode) free(roq->nbnodesmode);
+  if(roq->nodesmode) free(roq->nodesmode);
+  if(roq->imode1) free(roq->imode1);
+  if(roq->imode2) free(roq->imode2);
+  if(roq->index1) free(roq->index1);
+  if(roq->index2) free(roq->index2);
+  roq->nbblocks = 0;
+  roq->type = NULL;
+  roq->chan = NULL;
+  roq->l1 = NULL;
+  roq->m1 = NULL;
+  roq->l2 = NULL;
+  roq->m2 = NULL;
+  roq->nbnodes = NULL;
+  roq->nodes = NULL;
+  roq->weights = NULL;
+  roq->nbmode = 0;
+  roq->lmode = NULL;
+  roq->mmode = NULL;
+  roq->nbnodesmode = NULL;
+  roq->nodesmode = NULL;
+  roq->imode1 = NULL;
+  roq->imode2 = NULL;
+  roq->index1 = NULL;
+  roq->index2 = NULL;
+}
+
+void LISAInjectionROQ_Cleanup(LISAInjectionROQ* roq) {
+  LISAInjectionROQ_Free(roq);
+  free(roq);
+}
+
+void LISAInjectionROQ_Init(LISAInjectionROQ** roq) {
+  if(!roq) exit(1);
+  /* Create storage for structures */
+  if(!*roq) *roq = malloc(sizeof(LISAInjectionROQ));
+  else
+  {
+    LISAInjectionROQ_Cleanup(*roq);
+    *roq = malloc(sizeof(LISAInjectionROQ));
+  }
+  (*roq)->nbblocks = 0;
+  (*roq)->type = NULL;
+  (*roq)->chan = NULL;
+  (*roq)->l1 = NULL;
+  (*roq)->m1 = NULL;
+  (*roq)->l2 = NULL;
+  (*roq)->m2 = NULL;
+  (*roq)->nbnodes = NULL;
+  (*roq)->nodes = NULL;
+  (*roq)->weights = NULL;
+  (*roq)->nbmode = 0;
+  (*roq)->lmode = NULL;
+  (*roq)->mmode = NULL;
+  (*roq)->nbnodesmode = NULL;
+  (*roq)->nodesmode = NULL;
+  (*roq)->imode1 = NULL;
+  (*roq)->imode2 = NULL;
+  (*roq)->index1 = NULL;
+  (*roq)->index2 = NULL;
+  (*roq)->TDI123ss = 0.;
+}
+
+/* Allocate the arrays for nbblocks blocks, the nodes and weights of each block being allocated separately */
+static void LISAInjectionROQ_Alloc(LISAInjectionROQ* roq, const int nbblocks)
+{
+  roq->nbblocks = nbblocks;
+  roq->type = calloc(nbblocks, sizeof(int));
+  roq->chan = calloc(nbblocks, sizeof(int));
+  roq->l1 = calloc(nbblocks, sizeof(int));
+  roq->m1 = calloc(nbblocks, sizeof(int));
+  roq->l2 = calloc(nbblocks, sizeof(int));
+  roq->m2 = calloc(nbblocks, sizeof(int));
+  roq->nbnodes = calloc(nbblocks, sizeof(int));
+  roq->nodes = calloc(nbblocks, sizeof(double*));
+  roq->weights = calloc(nbblocks, sizeof(double complex*));
+}
+
+static int LISAROQCompareDouble(const void* a, const void* b)
+{
+  double x = *((const double*) a), y = *((const double*) b);
+  return (x>y) - (x<y);
+}
+
+/* Index of a mode in the modes of the quadrature rules, added if absent */
+static int LISAROQModeIndex(LISAInjectionROQ* roq, const int l, const int m)
+{
+  for(int i=0; i<roq->nbmode; i++) if(roq->lmode[i]==l && roq->mmode[i]==m) return i;
+  roq->lmode[roq->nbmode] = l;
+  roq->mmode[roq->nbmode] = m;
+  return roq->nbmode++;
+}
+
+/* Merge the nodes of the blocks mode by mode, over the channels, so that each mode of a template is evaluated once per node */
+/* The nodes of all blocks are taken from the same discrete frequencies, so that equal nodes are detected exactly */
+static void LISAROQMergeNodes(LISAInjectionROQ* roq)
+{
+  int nbblocks = roq->nbblocks;
+  roq->nbmode = 0;
+  roq->lmode = malloc(2*nbblocks*sizeof(int));
+  roq->mmode = malloc(2*nbblocks*sizeof(int));
+  roq->imode1 = malloc(nbblocks*sizeof(int));
+  roq->imode2 = malloc(nbblocks*sizeof(int));
+  for(int b=0; b<nbblocks; b++) {
+    roq->imode1[b] = LISAROQModeIndex(roq, roq->l1[b], roq->m1[b]);
+    roq->imode2[b] = (roq->type[b]==1) ? LISAROQModeIndex(roq, roq->l2[b], roq->m2[b]) : -1;
+  }
+
+  /* Sorted union of the nodes of the blocks involving each mode */
+  roq->nbnodesmode = calloc(roq->nbmode, sizeof(int));
+  roq->nodesmode = calloc(roq->nbmode, sizeof(double*));
+  for(int i=0; i<roq->nbmode; i++) {
+    int n = 0;
+    for(int b=0; b<nbblocks; b++) n += ((roq->imode1[b]==i) + (roq->imode2[b]==i)) * roq->nbnodes[b];
+    double* nodes = malloc(n*sizeof(double));
+    n = 0;
+    for(int b=0; b<nbblocks; b++) {
+      if(roq->imode1[b]!=i && roq->imode2[b]!=i) continue;
+      memcpy(&nodes[n], roq->nodes[b], roq->nbnodes[b]*sizeof(double));
+      n += roq->nbnodes[b];
+    }
+    qsort(nodes, n, sizeof(double), LISAROQCompareDouble);
+    int nunique = 0;
+    for(int k=0; k<n; k++) if(nunique==0 || nodes[k]!=nodes[nunique-1]) nodes[nunique++] = nodes[k];
+    roq->nbnodesmode[i] = nunique;
+    roq->nodesmode[i] = nodes;
+  }
+
+  /* Position of the nodes of each block in the nodes of its modes */
+  roq->index1 = calloc(nbblocks, sizeof(int*));
+  roq->index2 = calloc(nbblocks, sizeof(int*));
+  for(int b=0; b<nbblocks; b++) {
+    for(int pass=0; pass<2; pass++) {
+      int i = (pass==0) ? roq->imode1[b] : roq->imode2[b];
+      if(i<0) continue;
+      int* index = malloc(roq->nbnodes[b]*sizeof(int));
+      int k = 0;
+      for(int j=0; j<roq->nbnodes[b]; j++) {
+        while(roq->nodesmode[i][k]<roq->nodes[b][j]) k++;
+        index[j] = k;
+      }
+      if(pass==0) roq->index1[b] = index;
+      else roq->index2[b] = index;
+    }
+  }
+}
+
+/* Function building the quadrature rules of the ROQ likelihood from a training set of templates */
+/* For each channel, one block (h|d) per mode of the templates and one block (h|h) per pair of modes - the blocks are built on nbfreq log-spaced frequencies covering the training set */
+/* The training templates are evaluated on these frequencies as the templates are at the nodes in LISAOverlapsROQ */
+/* NOTE: the lower cut fstartobs of the modes is frozen to its value for the injection */
+int LISABuildROQ(
+  struct tagLISAInjectionCAmpPhase* injection, /* Input: injection as generated by LISAGenerateInjectionCAmpPhase */
+  struct tagLISAParams* trainingparams,       /* Input: parameters of the training templates, with the number of modes of the templates */
+  int ntrain,                                 /* Input: number of training templates */
+  int nbfreq,                                 /* Input: number of frequencies for the discrete inner products */
+  double tol,                                 /* Input: tolerance of the greedy reduced bases */
+  struct tagLISAInjectionROQ* roq)            /* Output: structure for the quadrature rules */
+{
+  double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
+  double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
+  double fstartobs = 0.;
+  if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(injectedparams->m1, injectedparams->m2, globalparams->deltatobs);
+
+  /* Generate the ROM modes of the training set, and its range of frequencies - failed templates are dropped */
+  ListmodesCAmpPhaseFrequencySeries** listtrain = calloc(ntrain, sizeof(ListmodesCAmpPhaseFrequencySeries*));
+  int* itrain = malloc(ntrain*sizeof(int));
+  int ngood = 0;
+  double ftrainmin = DBL_MAX, ftrainmax = 0.;
+  for(int t=0; t<ntrain; t++) {
+    if(LISAGenerateROMCached(&listtrain[ngood], &trainingparams[t], injectedparams->tRef)==FAILURE) continue;
+    itrain[ngood] = t;
+    ListmodesCAmpPhaseFrequencySeries* listelement = listtrain[ngood];
+    while(listelement) {
+      gsl_vector* freq = listelement->freqseries->freq;
+      ftrainmin = fmin(ftrainmin, gsl_vector_get(freq, 0));
+      ftrainmax = fmax(ftrainmax, gsl_vector_get(freq, freq->size-1));
+      listelement = listelement->next;
+    }
+    ngood++;
+  }
+  ftrainmin = fmax(ftrainmin, fLow);
+  ftrainmax = fmin(ftrainmax, fHigh);
+  if(ngood==0 || ftrainmin>=ftrainmax) {
+    printf("Error: empty training set for the ROQ.\n");
+    for(int t=0; t<ngood; t++) ListmodesCAmpPhaseFrequencySeries_Destroy(listtrain[t]);
+    free(listtrain);
+    free(itrain);
+    return FAILURE;
+  }
+
+  /* Modes of the templates */
+  int nbmode = 0;
+  ListmodesCAmpPhaseFrequencySeries* listelement = listtrain[0];
+  while(listelement) {
+    nbmode++;
+    listelement = listelement->next;
+  }
+  int* lmode = malloc(nbmode*sizeof(int));
+  int* mmode = malloc(nbmode*sizeof(int));
+  listelement = listtrain[0];
+  for(int i=0; i<nbmode; i++) {
+    lmode[i] = listelement->l;
+    mmode[i] = listelement->m;
+    listelement = listelement->next;
+  }
+
+  /* Frequencies, log-spaced, and trapezoidal weights */
+  double* freq = malloc(nbfreq*sizeof(double));
+  double* df = malloc(nbfreq*sizeof(double));
+  double* wf = malloc(nbfreq*sizeof(double));
+  for(int f=0; f<nbfreq; f++) freq[f] = ftrainmin * exp(log(ftrainmax/ftrainmin) * f/(nbfreq-1));
+  freq[nbfreq-1] = ftrainmax;
+  for(int f=0; f<nbfreq; f++) df[f] = (freq[(f<nbfreq-1) ? f+1 : f] - freq[(f>0) ? f-1 : f]) / 2.;
+
+  /* Blocks: for each channel, nbmode linear blocks then nbmode(nbmode+1)/2 quadratic blocks */
+  int nbblockschan = nbmode + nbmode*(nbmode+1)/2;
+  LISAInjectionROQ_Alloc(roq, 3*nbblockschan);
+  roq->TDI123ss = injection->TDI123ss;
+  ListmodesCAmpPhaseSpline* listsplinesdata[3] = {injection->TDI1Splines, injection->TDI2Splines, injection->TDI3Splines};
+  double complex* htrain = malloc(nbmode*ngood*nbfreq*sizeof(double complex));
+  double complex* block = malloc(ngood*nbfreq*sizeof(double complex));
+  double complex* values = malloc(3*nbfreq*sizeof(double complex));
+  double complex* data = malloc(nbfreq*sizeof(double complex));
+  double complex* g = malloc(nbfreq*sizeof(double complex));
+  int* nodes = malloc(ngood*sizeof(int));
+  double complex* weights = malloc(ngood*sizeof(double complex));
+  int ret = SUCCESS;
+  for(int c=0; c<3 && ret==SUCCESS; c++) {
+    ObjectFunction Snoise = LISANoiseFunction(globalparams, c+1);
+    for(int f=0; f<nbfreq; f++) wf[f] = 4. * df[f] / ObjectFunctionCall(&Snoise, freq[f]);
+
+    /* Modes of the training templates and data on the frequencies, with the cut fstartobs of each mode */
+    for(int i=0; i<nbmode; i++) {
+      double fcut = ((double) max(2, mmode[i]))/2. * fstartobs;
+      for(int t=0; t<ngood; t++) {
+        double complex* h = &htrain[(i*ngood + t)*nbfreq];
+        LISAParams* params = &trainingparams[itrain[t]];
+        ListmodesCAmpPhaseFrequencySeries* mode = ListmodesCAmpPhaseFrequencySeries_GetMode(listtrain[t], lmode[i], mmode[i]);
+        for(int f=0; f<nbfreq; f++) h[f] = 0.;
+        if(!mode) continue;
+        LISASimFDResponseTDI3ChanAtFrequencies(globalparams->tagtRefatLISA, globalparams->variant, mode->freqseries, lmode[i], mmode[i], freq, nbfreq, &values[0], &values[nbfreq], &values[2*nbfreq], params->tRef, params->lambda, params->beta, params->inclination, params->polarization, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+        memcpy(h, &values[c*nbfreq], nbfreq*sizeof(double complex));
+        for(int f=0; f<nbfreq && freq[f]<fcut; f++) h[f] = 0.;
+      }
+    }
+    for(int f=0; f<nbfreq; f++) data[f] = 0.;
+    ListmodesCAmpPhaseSpline* listelementdata = listsplinesdata[c];
+    while(listelementdata) {
+      double fcut = ((double) max(2, listelementdata->m))/2. * fstartobs;
+      LISAEvalModeSpline(listelementdata->splines, freq, nbfreq, values);
+      for(int f=0; f<nbfreq; f++) if(freq[f]>=fcut) data[f] += values[f];
+      listelementdata = listelementdata->next;
+    }
+
+    /* Linear blocks (h_i|d), then quadratic blocks (h_i|h_j) for j>=i, counted twice for j>i */
+    int b = c*nbblockschan;
+    for(int i=0; i<nbmode && ret==SUCCESS; i++) {
+      for(int j=(i-1); j<nbmode && ret==SUCCESS; j++) {
+        int linear = (j==i-1);
+        if(linear) {
+          memcpy(block, &htrain[i*ngood*nbfreq], ngood*nbfreq*sizeof(double complex));
+          for(int f=0; f<nbfreq; f++) g[f] = wf[f] * conj(data[f]);
+        }
+        else {
+          for(int t=0; t<ngood; t++) {
+            double complex* hi = &htrain[(i*ngood + t)*nbfreq];
+            double complex* hj = &htrain[(j*ngood + t)*nbfreq];
+            for(int f=0; f<nbfreq; f++) block[t*nbfreq + f] = hi[f] * conj(hj[f]);
+          }
+          for(int f=0; f<nbfreq; f++) g[f] = ((j>i) ? 2. : 1.) * wf[f];
+        }
+        int n = LISAROQBuildBlock(block, ngood, nbfreq, wf, g, tol, nodes, weights);
+        if(n==0) {
+          printf("Error: failed to build the ROQ block for channel %d, modes (%d,%d), (%d,%d).\n", c+1, lmode[i], mmode[i], lmode[(linear) ? i : j], mmode[(linear) ? i : j]);
+          ret = FAILURE;
+          break;
+        }
+        roq->type[b] = linear ? 0 : 1;
+        roq->chan[b] = c;
+        roq->l1[b] = lmode[i];
+        roq->m1[b] = mmode[i];
+        roq->l2[b] = linear ? 0 : lmode[j];
+        roq->m2[b] = linear ? 0 : mmode[j];
+        roq->nbnodes[b] = n;
+        roq->nodes[b] = malloc(n*sizeof(double));
+        roq->weights[b] = malloc(n*sizeof(double complex));
+        for(int k=0; k<n; k++) {
+          roq->nodes[b][k] = freq[nodes[k]];
+          roq->weights[b][k] = weights[k];
+        }
+        b++;
+      }
+    }
+  }
+
+  if(ret==SUCCESS) LISAROQMergeNodes(roq);
+
+  /* Clean up */
+  for(int t=0; t<ngood; t++) ListmodesCAmpPhaseFrequencySeries_Destroy(listtrain[t]);
+  free(listtrain);
+  free(itrain);
+  free(lmode);
+  free(mmode);
+  free(freq);
+  free(df);
+  free(wf);
+  free(htrain);
+  free(block);
+  free(values);
+  free(data);
+  free(g);
+  free(nodes);
+  free(weights);
+  return ret;
+}
+
+/* Values identifying the setup the quadrature rules are built for: the injection, the numbers of modes of the injection and templates, */
+/* the frequency band - fLow, fHigh, and the duration of observation that sets the lower cut of the modes - and the reference frequency */
+#define nbheaderroq 15
+static void LISAROQHeader(double* header)
+{
+  header[0] = injectedparams->m1;
+  header[1] = injectedparams->m2;
+  header[2] = injectedparams->tRef;
+  header[3] = injectedparams->distance;
+  header[4] = injectedparams->phiRef;
+  header[5] = injectedparams->inclination;
+  header[6] = injectedparams->lambda;
+  header[7] = injectedparams->beta;
+  header[8] = injectedparams->polarization;
+  header[9] = injectedparams->nbmode;
+  header[10] = globalparams->nbmodetemp;
+  header[11] = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
+  header[12] = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
+  header[13] = globalparams->deltatobs;
+  header[14] = globalparams->fRef;
+}
+
+/* Write the quadrature rules of the ROQ likelihood to a text file */
+/* Format: a line with the nbheaderroq values of LISAROQHeader, a line nbblocks, then for each block a line type chan l1 m1 l2 m2 nbnodes followed by nbnodes lines f Re(w) Im(w) */
+int LISAWriteROQ(const char* filename, LISAInjectionROQ* roq)
+{
+  FILE* f = fopen(filename, "w");
+  if(!f) {
+    printf("Error: failed to open file %s\n", filename);
+    return FAILURE;
+  }
+  double header[nbheaderroq];
+  LISAROQHeader(header);
+  int ret = 0;
+  for(int i=0; i<nbheaderroq; i++) ret |= (fprintf(f, (i<nbheaderroq-1) ? "%.16e " : "%.16e\n", header[i]) < 0);
+  ret |= (fprintf(f, "%d\n", roq->nbblocks) < 0);
+  for(int b=0; b<roq->nbblocks; b++) {
+    ret |= (fprintf(f, "%d %d %d %d %d %d %d\n", roq->type[b], roq->chan[b], roq->l1[b], roq->m1[b], roq->l2[b], roq->m2[b], roq->nbnodes[b]) < 0);
+    for(int k=0; k<roq->nbnodes[b]; k++) ret |= (fprintf(f, "%.16e %.16e %.16e\n", roq->nodes[b][k], creal(roq->weights[b][k]), cimag(roq->weights[b][k])) < 0);
+  }
+  fclose(f);
+  if(ret) {
+    printf("Error writing data to %s\n", filename);
+    return FAILURE;
+  }
+  return SUCCESS;
+}
+
+/* Read the quadrature rules of the ROQ likelihood from a text file written by LISAWriteROQ - TDI123ss is not stored and is left to the caller */
+/* Fails if the file was built for another injection, other numbers of modes or another frequency band - on failure, roq is left empty */
+int LISAReadROQ(const char* filename, LISAInjectionROQ* roq)
+{
+  FILE* f = fopen(filename, "r");
+  if(!f) {
+    printf("Error: failed to open file %s\n", filename);
+    return FAILURE;
+  }
+  double header[nbheaderroq], headerfile[nbheaderroq];
+  LISAROQHeader(header);
+  for(int i=0; i<nbheaderroq; i++) {
+    if(fscanf(f, "%lf", &headerfile[i])!=1) {
+      printf("Error reading data from %s\n", filename);
+      fclose(f);
+      return FAILURE;
+    }
+  }
+  for(int i=0; i<nbheaderroq; i++) {
+    if(fabs(headerfile[i] - header[i]) > 1e-12*fabs(header[i])) {
+      printf("Error: the ROQ in %s was built for another injection, number of modes or frequency band - rebuild it with LISAROQbuild\n", filename);
+      fclose(f);
+      return FAILURE;
+    }
+  }
+  int nbblocks = 0;
+  if(fscanf(f, "%d", &nbblocks)!=1 || nbblocks<=0) {
+    printf("Error reading data from %s\n", filename);
+    fclose(f);
+    return FAILURE;
+  }
+  LISAInjectionROQ_Alloc(roq, nbblocks);
+  int ret = SUCCESS;
+  for(int b=0; b<nbblocks && ret==SUCCESS; b++) {
+    if(fscanf(f, "%d %d %d %d %d %d %d", &roq->type[b], &roq->chan[b], &roq->l1[b], &roq->m1[b], &roq->l2[b], &roq->m2[b], &roq->nbnodes[b])!=7 || roq->nbnodes[b]<=0) {
+      ret = FAILURE;
+      break;
+    }
+    roq->nodes[b] = malloc(roq->nbnodes[b]*sizeof(double));
+    roq->weights[b] = malloc(roq->nbnodes[b]*sizeof(double complex));
+    for(int k=0; k<roq->nbnodes[b]; k++) {
+      double wre, wim;
+      if(fscanf(f, "%lf %lf %lf", &roq->nodes[b][k], &wre, &wim)!=3) {
+        ret = FAILURE;
+        break;
+      }
+      roq->weights[b][k] = wre + I*wim;
+    }
+  }
+  fclose(f);
+  if(ret==FAILURE) {
+    printf("Error reading data from %s\n", filename);
+    LISAInjectionROQ_Free(roq);
+  }
+  else LISAROQMergeNodes(roq);
+  return ret;
+}
+
+/* ROQ log-likelihood - the templates are only evaluated at the nodes of the quadrature rules */
+/* Overlaps (d|h) and (h|h) of a template with the injection, from the quadrature rules - FAILURE if the generation failed */
+static int LISAOverlapsROQ(LISAParams *params, LISAInjectionROQ* roq, double* dh, double* hhout)
+{
+  ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
+
+  /* Generate the waveform with the ROM - same as in LISAGenerateSignalCAmpPhase */
+  if(LISAGenerateROMCached(&listROM, params, injectedparams->tRef)==FAILURE) return FAILURE;
+  double fstartobs = 0.;
+  if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(injectedparams->m1, injectedparams->m2, globalparams->deltatobs);
+
+  /* Modes in the three channels at their nodes only - no full frequency series and no splines */
+  /* Channel c of mode i at &values[3*offset[i] + c*nbnodesmode[i]] */
+  int* offset = malloc(roq->nbmode*sizeof(int));
+  int nbnodestot = 0;
+  for(int i=0; i<roq->nbmode; i++) {
+    offset[i] = nbnodestot;
+    nbnodestot += roq->nbnodesmode[i];
+  }
+  double complex* values = malloc(3*nbnodestot*sizeof(double complex));
+  for(int i=0; i<roq->nbmode; i++) {
+    int n = roq->nbnodesmode[i];
+    const double* nodes = roq->nodesmode[i];
+    double complex* h = &values[3*offset[i]];
+    ListmodesCAmpPhaseFrequencySeries* mode = ListmodesCAmpPhaseFrequencySeries_GetMode(listROM, roq->lmode[i], roq->mmode[i]);
+    if(mode) LISASimFDResponseTDI3ChanAtFrequencies(globalparams->tagtRefatLISA, globalparams->variant, mode->freqseries, roq->lmode[i], roq->mmode[i], nodes, n, &h[0], &h[n], &h[2*n], params->tRef, params->lambda, params->beta, params->inclination, params->polarization, globalparams->tagtdi, globalparams->frozenLISA, globalparams->responseapprox);
+    else for(int k=0; k<3*n; k++) h[k] = 0.;
+    double fcut = ((double) max(2, roq->mmode[i]))/2. * fstartobs;
+    for(int k=0; k<n && nodes[k]<fcut; k++) h[k] = h[n + k] = h[2*n + k] = 0.;
+  }
+
+  double overlap = 0., hh = 0.;
+  for(int b=0; b<roq->nbblocks; b++) {
+    int n = roq->nbnodes[b];
+    const double complex* weights = roq->weights[b];
+    int i1 = roq->imode1[b];
+    const double complex* h1 = &values[3*offset[i1] + roq->chan[b]*roq->nbnodesmode[i1]];
+    const int* index1 = roq->index1[b];
+    if(roq->type[b]==0) {
+      for(int k=0; k<n; k++) overlap += creal(weights[k] * h1[index1[k]]);
+    }
+    else {
+      int i2 = roq->imode2[b];
+      const double complex* h2 = &values[3*offset[i2] + roq->chan[b]*roq->nbnodesmode[i2]];
+      const int* index2 = roq->index2[b];
+      for(int k=0; k<n; k++) hh += creal(weights[k] * h1[index1[k]] * conj(h2[index2[k]]));
+    }
+  }
+
+  /* Clean up */
+  free(offset);
+  free(values);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(listROM);
+
+  /* Output: overlaps for the combined signals, assuming noise independence */
+  *dh = overlap;
+  *hhout = hh;
+  return SUCCESS;
+}
+
+double CalculateLogLROQ(LISAParams *params, LISAInjectionROQ* roq)
+{
+  double overlap, hh;
+
+  /* If the generation failed (e.g. parameters out of bound), silently return -Infinity logL */
+  if(LISAOverlapsROQ(params, roq, &overlap, &hh)==FAILURE) return -DBL_MAX;
+
+  /* Output: value of the loglikelihood for the combined signals, assuming noise independence */
+  return overlap - 1./2*(roq->TDI123ss) - 1./2*hh;
+}
+
+/****************** Likelihood marginalized over distance and phase *****************/
+
+/* Overlaps (d|h), (h|h) and (d|d) of a template with the injection, for the likelihood set by tagint - FAILURE if the generation failed */
+static int LISAOverlaps(LISAParams* params, void* injection, double* dh, double* hh, double* ss)
+{
+  if(globalparams->tagint==0) {
+    *ss = ((LISAInjectionCAmpPhase*) injection)->TDI123ss;
+    return LISAOverlapsCAmpPhase(params, (LISAInjectionCAmpPhase*) injection, dh, hh);
+  }
+  else if(globalparams->tagint==1) {
+    /* The Re/Im injection does not store (d|d), recomputed here */
+    LISAInjectionReIm* injectionReIm = (LISAInjectionReIm*) injection;
+    LISASignalReIm* generatedsignal = NULL;
+    LISASignalReIm_Init(&generatedsignal);
+    int ret = LISAGenerateSignalReImCached(params, injectionReIm->freq, generatedsignal);
+    if(ret==SUCCESS) {
+      *dh = FDOverlapReImvsReIm(injectionReIm->TDI1Signal, generatedsignal->TDI1Signal, injectionReIm->noisevalues1)
+        + FDOverlapReImvsReIm(injectionReIm->TDI2Signal, generatedsignal->TDI2Signal, injectionReIm->noisevalues2)
+        + FDOverlapReImvsReIm(injectionReIm->TDI3Signal, generatedsignal->TDI3Signal, injectionReIm->noisevalues3);
+      *hh = FDOverlapReImvsReIm(generatedsignal->TDI1Signal, generatedsignal->TDI1Signal, injectionReIm->noisevalues1)
+        + FDOverlapReImvsReIm(generatedsignal->TDI2Signal, generatedsignal->TDI2Signal, injectionReIm->noisevalues2)
+        + FDOverlapReImvsReIm(generatedsignal->TDI3Signal, generatedsignal->TDI3Signal, injectionReIm->noisevalues3);
+      *ss = FDOverlapReImvsReIm(injectionReIm->TDI1Signal, injectionReIm->TDI1Signal, injectionReIm->noisevalues1)
+        + FDOverlapReImvsReIm(injectionReIm->TDI2Signal, injectionReIm->TDI2Signal, injectionReIm->noisevalues2)
+        + FDOverlapReImvsReIm(injectionReIm->TDI3Signal, injectionReIm->TDI3Signal, injectionReIm->noisevalues3);
+    }
+    LISASignalReIm_Cleanup(generatedsignal);
+    return ret;
+  }
+  else if(globalparams->tagint==2) {
+    *ss = ((LISAInjectionRelBin*) injection)->TDI123ss;
+    return LISAOverlapsRelBin(params, (LISAInjectionRelBin*) injection, dh, hh);
+  }
+  else if(globalparams->tagint==3) {
+    *ss = ((LISAInjectionROQ*) injection)->TDI123ss;
+    return LISAOverlapsROQ(params, (LISAInjectionROQ*) injection, dh, hh);
+  }
+  return FAILURE;
+}
+
+/* Overlaps at the reference distance if marginalizing over the distance, and at zero phase if marginalizing over the phase */
+/* For the phase, dh gets (d|i h) as imaginary part: for the 22 mode, shifting phiRef by pi/4 multiplies the template by i */
+static int LISAMarginalizedOverlaps(LISAParams* params, void* injection, double complex* dh, double* hh, double* ss)
+{
+  LISAParams refparams = *params;
+  double dhreal = 0., dhimag = 0., hhimag, ssimag;
+  if(globalparams->margdist) refparams.distance = distmarginalization->dist_ref;
+  if(globalparams->margphase) refparams.phiRef = 0.;
+  if(LISAOverlaps(&refparams, injection, &dhreal, hh, ss)==FAILURE) return FAILURE;
+  if(globalparams->margphase) {
+    refparams.phiRef = PI/4;
+    if(LISAOverlaps(&refparams, injection, &dhimag, &hhimag, &ssimag)==FAILURE) return FAILURE;
+  }
+  *dh = dhreal + I*dhimag;
+  return SUCCESS;
+}
+
+double CalculateLogLMarginalized(LISAParams* params, void* injection)
+{
+  double complex dh;
+  double hh, ss;
+
+  /* If the generation failed (e.g. parameters out of bound), silently return -Infinity logL */
+  if(LISAMarginalizedOverlaps(params, injection, &dh, &hh, &ss)==FAILURE) return -DBL_MAX;
+
+  return MarginalizedLogLikelihood(globalparams->margdist ? distmarginalization : NULL, dh, hh, globalparams->margphase) - 1./2*ss;
+}
+
+int LISADrawMarginalizedParams(LISAParams* params, void* injection, gsl_rng* r, double* logL)
+{
+  double complex dh;
+  double hh, ss;
+  if(LISAMarginalizedOverlaps(params, injection, &dh, &hh, &ss)==FAILURE) {
+    if(logL) *logL = -DBL_MAX;
+    return FAILURE;
+  }
+  /* The marginalized likelihood comes from the same overlaps, before the draw overwrites distance and/or phase */
+  if(logL) *logL = MarginalizedLogLikelihood(globalparams->margdist ? distmarginalization : NULL, dh, hh, globalparams->margphase) - 1./2*ss;
+  MarginalizedDraw(globalparams->margdist ? distmarginalization : NULL, dh, hh, globalparams->margphase, r, &params->distance, &params->phiRef);
+  return SUCCESS;
+}
+
+int LISAReconstructMarginalizedPosterior(const char inpath[], const char outpath[], void* injection)
+{
+  FILE* fin = fopen(inpath, "r");
+  if(!fin) {
+    printf("Error: cannot open %s for the reconstruction of the marginalized parameters\n", inpath);
+    return FAILURE;
+  }
+  FILE* fout = fopen(outpath, "w");
+  if(!fout) {
+    printf("Error: cannot open %s for writing the reconstructed posterior\n", outpath);
+    fclose(fin);
+    return FAILURE;
+  }
+
+  /* Format (same as in the internals): m1, m2, tRef, dist, phase, inc, lambda, beta, pol, loglike - one draw per sample, with a fixed seed */
+  gsl_rng* r = gsl_rng_alloc(gsl_rng_mt19937);
+  LISAParams params;
+  double loglike;
+  char line[4096];
+  int nbsamples = 0;
+  while(fgets(line, sizeof(line), fin)) {
+    if(sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf", &params.m1, &params.m2, &params.tRef, &params.distance, &params.phiRef, &params.inclination, &params.lambda, &params.beta, &params.polarization, &loglike)!=10) continue;
+    params.nbmode = globalparams->nbmodetemp;
+    if(LISADrawMarginalizedParams(&params, injection, r, NULL)==FAILURE) continue;
+    fprintf(fout, "%.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e\n", params.m1, params.m2, params.tRef, params.distance, params.phiRef, params.inclination, params.lambda, params.beta, params.polarization, loglike);
+    nbsamples++;
+  }
+  printf("Reconstructed the marginalized parameters for %d samples in %s\n", nbsamples, outpath);
+
+  gsl_rng_free(r);
+  fclose(fin);
+  fclose(fout);
+  return SUCCESS;
+}
+
+/****************** Fisher matrix *****************/
+
+/* Derivative of the signal in the direction i for the three channels, computed by LISAComputeFisherReIm in its own task */
+static int LISAFisherDerivative(
+  LISAParams* paramsplus,          /* Input: parameters displaced by +step */
+  LISAParams* paramsminus,         /* Input: parameters displaced by -step, NULL for one-sided differences */
+  LISASignalReIm* signal0,         /* Input: signal at the reference parameters, for one-sided differences */
+  double step,                     /* Input: step */
+  gsl_vector* freq,                /* Input: frequencies of the injection */
+  ReImFrequencySeries** derivs)    /* Output: derivatives for the three channels */
+{
+  int n = (int) freq->size;
+  LISASignalReIm* signalplus = NULL;
+  LISASignalReIm* signalminus = NULL;
+  LISASignalReIm_Init(&signalplus);
+  int ret = LISAGenerateSignalReImCached(paramsplus, freq, signalplus);
+  if(ret==SUCCESS && paramsminus) {
+    LISASignalReIm_Init(&signalminus);
+    ret = LISAGenerateSignalReImCached(paramsminus, freq, signalminus);
+  }
+  if(ret==SUCCESS) {
+    LISASignalReIm* signalref = paramsminus ? signalminus : signal0;
+    double invstep = paramsminus ? 1./(2*step) : 1./step;
+    ReImFrequencySeries* plus[3] = {signalplus->TDI1Signal, signalplus->TDI2Signal, signalplus->TDI3Signal};
+    ReImFrequencySeries* ref[3] = {signalref->TDI1Signal, signalref->TDI2Signal, signalref->TDI3Signal};
+    for(int c=0; c<3; c++) {
+      ReImFrequencySeries_Init(&derivs[c], n);
+      ReImFrequencySeries* deriv = derivs[c];
+      gsl_vector_memcpy(deriv->freq, freq);
+      for(int k=0; k<n; k++) {
+        gsl_vector_set(deriv->h_real, k, (gsl_vector_get(plus[c]->h_real, k) - gsl_vector_get(ref[c]->h_real, k)) * invstep);
+        gsl_vector_set(deriv->h_imag, k, (gsl_vector_get(plus[c]->h_imag, k) - gsl_vector_get(ref[c]->h_imag, k)) * invstep);
+      }
+    }
+  }
+  LISASignalReIm_Cleanup(signalplus);
+  if(signalminus) LISASignalReIm_Cleanup(signalminus);
+  return ret;
+}
+
+/* Fisher matrix F_ij = (dh/di|dh/dj) from finite differences of the waveform rather than of the overlaps - requires dim+1 waveforms for one-sided differences, 2*dim for centered differences */
+/* The derivatives, then the matrix elements, are computed as independent OpenMP tasks - each element is summed over the channels in a fixed order by a single task, so that the result does not depend on the scheduling */
+int LISAComputeFisherReIm(
+  struct tagLISAParams* params,               /* Input: parameters at which the Fisher matrix is computed - used only for one-sided differences */
+  int dim,                                    /* Input: number of parameters */
+  struct tagLISAParams* paramsplus,           /* Input: parameters displaced by +steps[i] in the direction i, size dim */
+  struct tagLISAParams* paramsminus,          /* Input: parameters displaced by -steps[i] in the direction i, size dim - NULL for one-sided differences */
+  double* steps,                              /* Input: steps in each direction, size dim */
+  struct tagLISAInjectionReIm* injection,     /* Input: injection providing the frequencies and noise values */
+  double* fisher)                             /* Output: Fisher matrix, size dim*dim (row-major, already allocated) */
+{
+  gsl_vector* freq = injection->freq;
+  gsl_vector* noisevalues[3] = {injection->noisevalues1, injection->noisevalues2, injection->noisevalues3};
+  int ret = SUCCESS;
+
+  /* Reference signal, for one-sided differences */
+  LISASignalReIm* signal0 = NULL;
+  if(!paramsminus) {
+    LISASignalReIm_Init(&signal0);
+    ret = LISAGenerateSignalReImCached(params, freq, signal0);
+  }
+
+  /* Derivatives of the signal in each direction and channel, one task per direction */
+  ReImFrequencySeries** derivs = calloc(3*dim, sizeof(ReImFrequencySeries*));
+  int* rets = malloc(dim*sizeof(int));
+  for(int i=0; i<dim; i++) rets[i] = FAILURE;
+  if(ret==SUCCESS) {
+    #pragma omp parallel
+    #pragma omp single
+    {
+      for(int i=0; i<dim; i++) {
+        #pragma omp task firstprivate(i)
+        rets[i] = LISAFisherDerivative(&paramsplus[i], paramsminus ? &paramsminus[i] : NULL, signal0, steps[i], freq, &derivs[3*i]);
+      }
+    }
+    for(int i=0; i<dim; i++) if(rets[i]==FAILURE) ret = FAILURE;
+  }
+
+  /* Fisher matrix, summed over the channels assuming noise independence - one task per element of the upper triangle */
+  if(ret==SUCCESS) {
+    #pragma omp parallel
+    #pragma omp single
+    {
+      for(int i=0; i<dim; i++) {
+        for(int j=i; j<dim; j++) {
+          #pragma omp task firstprivate(i, j)
+          {
+            double fij = 0.;
+            for(int c=0; c<3; c++) fij += FDOverlapReImvsReIm(derivs[3*i + c], derivs[3*j + c], noisevalues[c]);
+            fisher[i*dim + j] = fij;
+            fisher[j*dim + i] = fij;
+          }
+        }
+      }
+    }
+  }
+
+  /* Clean up */
+  for(int i=0; i<3*dim; i++) if(derivs[i]) ReImFrequencySeries_Cleanup(derivs[i]);
+  free(derivs);
+  free(rets);
+  if(signal0) LISASignalReIm_Cleanup(signal0);
+  return ret;
+}
+
+/****************** Functions precomputing relevant values when using simplified likelihood *****************/
+
+/* For now, 22-mode only */
+int LISAComputeSimpleLikelihoodPrecomputedValues(SimpleLikelihoodPrecomputedValues* simplelikelihoodvals, LISAParams* params)
+{
+  /* Check pointer for output */
+  if(simplelikelihoodvals==NULL) {
+    printf("Error in LISAComputeSimpleLikelihoodPrecomputedValues: called with NULL pointer for SimpleLikelihoodPrecomputedValues.\n");
+    exit(1);
+  }
+
+  int ret;
+  double normalization = 0.;
+  double complex sa = 0.;
+  double complex se = 0.;
+
+  /* Convert parameters to L-frame */
+  double phiL = funcphiL(params);
+  double lambdL = funclambdaL(params);
+  double betaL = funcbetaL(params);
+  double psiL = funcpsiL(params);
+  double inc = params->inclination;
+  double d = params->distance / injectedparams->distance; /* Should be 1., since params should be injectedparams */
+
+  /* Precompute sa, se */
+  sa = funcsa(d, phiL, inc, lambdL, betaL, psiL);
+  se = funcse(d, phiL, inc, lambdL, betaL, psiL);
+
+  /* Generate 22 mode for the fixed mass and time parameters - same fstartobs and PN extension as in the GenerateInjectionCAmpPhase function */
+  ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
+  /* Starting frequency corresponding to duration of observation deltatobs */
+  double fstartobs = 0.;
+  if(!(globalparams->deltatobs==0.)) fstartobs = Newtonianfoft(params->m1, params->m2, globalparams->deltatobs);
+  /* Generate the waveform with the ROM */
+  /* NOTE: SimEOBNRv2HMROM accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
+  /* NOTE: minf and deltatobs are taken into account if extension is allowed, but not maxf - restriction to the relevant frequency interval will occur in both the response prcessing and overlap computation */
+  /* If extending, taking into account both fstartobs and minf */
+  if(!(globalparams->tagextpn)) {
+    //printf("Not Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
+    ret = SimEOBNRv2HMROM(&listROM, params->nbmode, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
+  } else {
+    //printf("Extending signal waveform.  Mfmatch=%g\n",globalparams->Mfmatch);
+    ret = SimEOBNRv2HMROMExtTF2(&listROM, params->nbmode, globalparams->Mfmatch, fmax(fstartobs, globalparams->minf), 0, params->tRef - injectedparams->tRef, params->phiRef, globalparams->fRef, (params->m1)*MSUN_SI, (params->m2)*MSUN_SI, (params->distance)*1e6*PC_SI);
+  }
+  /* If the ROM waveform generation failed (e.g. parameters were out of bounds) return FAILURE */
+  if(ret==FAILURE){
+    printf("Failed to generate injection ROM\n");
+    return FAILURE;
+  }
+
+  /* Multiply the h22 amplitude by pi f L/c */
   /* NOTE: here acts ONLY on the 22 mode - should be generalized if one extends this function to higher modes */
   double L = globalparams->variant->ConstL;
   CAmpPhaseFrequencySeries* h22 = ListmodesCAmpPhaseFrequencySeries_GetMode(listROM, 2, 2)->freqseries;
@@ -1493,7 +3203,7 @@ int LISAComputeSimpleLikelihoodPrecomputedValues(SimpleLikelihoodPrecomputedValu
   /* Precompute the inner product (h|h) - takes into account the length of the observation with deltatobs */
   double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
   double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
-  ObjectFunction NoiseSn = NoiseFunction(globalparams->variant, globalparams->tagtdi, 1); /* We use the first noise function - will be A and E, in this approximation at low-f we simply ignore the T channel - NOTE: we could add some checking that the tagtdi selector as well as LISA variant make sense */
+  ObjectFunction NoiseSn = LISANoiseFunction(globalparams, 1); /* We use the first noise function - will be A and E, in this approximation at low-f we simply ignore the T channel - NOTE: we could add some checking that the tagtdi selector as well as LISA variant make sense */
   /* Compute overlap itself */
   CAmpPhaseSpline* splineh22 = ListmodesCAmpPhaseSpline_GetMode(listsplines, 2, 2)->splines;
   normalization = FDSinglemodeFresnelOverlap(h22, splineh22, &NoiseSn, fLow, fHigh);
@@ -1514,6 +3224,79 @@ int LISAComputeSimpleLikelihoodPrecomputedValues(SimpleLikelihoodPrecomputedValu
   return(SUCCESS);
 }
 
+/* Generalization to all modes: Gram matrix of the modes for the fixed mass and time parameters */
+int LISAComputeGramLikelihoodPrecomputedValues(GramLikelihoodPrecomputedValues* gramlikelihoodvals, LISAParams* params)
+{
+  /* Check pointer for output */
+  if(gramlikelihoodvals==NULL) {
+    printf("Error in LISAComputeGramLikelihoodPrecomputedValues: called with NULL pointer for GramLikelihoodPrecomputedValues.\n");
+    exit(1);
+  }
+
+  /* Generate the modes needed by both the injection and the templates, at phiRef=0 and 1Mpc - same fstartobs and PN extension as in the GenerateInjectionCAmpPhase function */
+  LISAParams modeparams = *params;
+  modeparams.nbmode = (params->nbmode > globalparams->nbmodetemp) ? params->nbmode : globalparams->nbmodetemp;
+  ListmodesCAmpPhaseFrequencySeries* listROM = NULL;
+  if(LISAGenerateROM(&listROM, &modeparams, params->tRef - injectedparams->tRef, 0., 1.)==FAILURE) {
+    printf("Failed to generate injection ROM\n");
+    return FAILURE;
+  }
+
+  /* Multiply the amplitudes by pi f L/c */
+  double L = globalparams->variant->ConstL;
+  int nbmode = modeparams.nbmode;
+  CAmpPhaseFrequencySeries* modes[nbmodemax];
+  for(int k=0; k<nbmode; k++) {
+    gramlikelihoodvals->l[k] = listmode[k][0];
+    gramlikelihoodvals->m[k] = listmode[k][1];
+    modes[k] = ListmodesCAmpPhaseFrequencySeries_GetMode(listROM, listmode[k][0], listmode[k][1])->freqseries;
+    double* freq = modes[k]->freq->data;
+    double* areal = modes[k]->amp_real->data;
+    double* aimag = modes[k]->amp_imag->data;
+    for(size_t i=0; i<modes[k]->freq->size; i++) {
+      areal[i] *= PI*L/C_SI*freq[i];
+      aimag[i] *= PI*L/C_SI*freq[i];
+    }
+  }
+  gramlikelihoodvals->nbmode = nbmode;
+
+  /* Precompute the overlaps of the modes - takes into account the length of the observation with deltatobs */
+  ListmodesCAmpPhaseSpline* listsplines = NULL;
+  BuildListmodesCAmpPhaseSpline(&listsplines, listROM);
+  double fLow = fmax(__LISASimFD_Noise_fLow, globalparams->minf);
+  double fHigh = fmin(__LISASimFD_Noise_fHigh, globalparams->maxf);
+  ObjectFunction NoiseSn = LISANoiseFunction(globalparams, 1); /* As for the 22 mode, A and E share the first noise function and T is ignored */
+  /* FDSinglemodeFresnelOverlap gives the real part - the imaginary part is the overlap of -i h_lm with h_l'm' */
+  CAmpPhaseFrequencySeries* rotated = NULL;
+  for(int k=0; k<nbmode; k++) {
+    int n = (int) modes[k]->freq->size;
+    CAmpPhaseFrequencySeries_Init(&rotated, n);
+    gsl_vector_memcpy(rotated->freq, modes[k]->freq);
+    gsl_vector_memcpy(rotated->amp_real, modes[k]->amp_imag);
+    gsl_vector_memcpy(rotated->amp_imag, modes[k]->amp_real);
+    gsl_vector_scale(rotated->amp_imag, -1.);
+    gsl_vector_memcpy(rotated->phase, modes[k]->phase);
+    for(int kp=k; kp<nbmode; kp++) {
+      CAmpPhaseSpline* splinekp = ListmodesCAmpPhaseSpline_GetMode(listsplines, listmode[kp][0], listmode[kp][1])->splines;
+      double re = FDSinglemodeFresnelOverlap(modes[k], splinekp, &NoiseSn, fLow, fHigh);
+      double im = (kp==k) ? 0. : FDSinglemodeFresnelOverlap(rotated, splinekp, &NoiseSn, fLow, fHigh);
+      gramlikelihoodvals->gram[k][kp] = re + I*im;
+      gramlikelihoodvals->gram[kp][k] = re - I*im;
+    }
+    CAmpPhaseFrequencySeries_Cleanup(rotated);
+    rotated = NULL;
+  }
+
+  /* Coefficients of the injection, restricted to its own modes */
+  funcgramcoeffs(gramlikelihoodvals->cainj, gramlikelihoodvals->ceinj, gramlikelihoodvals, params, params->nbmode);
+
+  /* NOTE Cleanup */
+  ListmodesCAmpPhaseFrequencySeries_Destroy(listROM);
+  ListmodesCAmpPhaseSpline_Destroy(listsplines);
+
+  return(SUCCESS);
+}
+
 /***************************** Functions handling the prior ******************************/
 
 /* Functions to check that returned parameter values fit in prior boundaries */
@@ -16,6 +16,8 @@
 #include "splinecoeffs.h"
 #include "fresnel.h"
 #include "likelihood.h"
+#include "profiling.h"
+#include "marginalization.h"
 #include "LISAFDresponse.h"
 #include "LISAnoise.h"
 
@@ -69,14 +71,24 @@ typedef struct tagLISAGlobalParams {
   double Mfmatch;            /* When PN extension allowed, geometric matching frequency: will use ROM above this value. If <=0, use ROM down to the lowest covered frequency */
   int nbmodeinj;             /* number of modes to include in the injection (starting with 22) - defaults to 5 (all modes) */
   int nbmodetemp;            /* number of modes to include in the templates (starting with 22) - defaults to 5 (all modes) */
-  int tagint;                /* Tag choosing the integrator: 0 for wip (default), 1 for linear integration */
+  int tagint;                /* Tag choosing the integrator: 0 for wip (default), 1 for linear integration, 2 for relative binning around the injection, 3 for reduced order quadrature */
+  int nbbinsrelbin;          /* Number of frequency bins for the relative binning likelihood (tagint 2, default 64) */
+  char roqfile[256];         /* File for the reduced order quadrature rules (tagint 3, default roq.txt) */
+  int nbtrainroq;            /* Number of training templates for building the reduced order quadrature (default 256) */
+  int nbptsroq;              /* Number of frequencies for building the reduced order quadrature (default 2048) */
+  double tolroq;             /* Tolerance of the greedy reduced bases for building the reduced order quadrature (default 1e-10) */
   TDItag tagtdi;             /* Tag choosing the TDI variables to use */
   int nbptsoverlap;          /* Number of points to use in loglinear overlaps (default 32768) */
   LISAconstellation *variant;  /* A structure defining the LISA constellation features */
   int zerolikelihood;        /* Tag to zero out the likelihood, to sample from the prior for testing purposes (default 0) */
   int frozenLISA;            /* Freeze the orbital configuration to the time of peak of the injection (default 0) */
   ResponseApproxtag responseapprox;    /* Approximation in the GAB and orb response - choices are full (full response, default), lowfL (keep orbital delay frequency-dependence but simplify constellation response) and lowf (simplify constellation and orbital response) - WARNING : at the moment noises are not consistent, and TDI combinations from the GAB are unchanged */
-  int tagsimplelikelihood;   /* Tag to use simplified, frozen-LISA and lowf likelihood where mode overlaps are precomputed - can only be used when the masses and time (tL) are pinned to injection values (Note: when using --snr, distance adjustment done using responseapprox, not the simple response) */
+  int tagsimplelikelihood;   /* Tag to use simplified, frozen-LISA and lowf likelihood where mode overlaps are precomputed - 1 for the 22 mode only, 2 for all modes through their Gram matrix - can only be used when the masses and time (tL) are pinned to injection values (Note: when using --snr, distance adjustment done using responseapprox, not the simple response) */
+  double noisetabletol;      /* Relative accuracy of the tabulated noise functions used in the overlaps - 0 to evaluate the exact noise functions (default 0) */
+  int nbsignalcache;         /* Capacity of the per-thread LRU cache of generated signals - 0 to disable (default 0) */
+  int nbintrinsiccache;      /* Capacity of the per-thread LRU cache of intrinsic waveforms (ROM modes for m1, m2, tRef) - 0 to disable (default 0) */
+  int margdist;              /* Tag to marginalize the likelihood over the distance, for the distance prior - distance then pinned and drawn in post-processing (default 0) */
+  int margphase;             /* Tag to marginalize the likelihood over the phase, exact for the 22 mode only - phase then pinned and drawn in post-processing (default 0) */
 } LISAGlobalParams;
 
 typedef struct tagLISASignalCAmpPhase
@@ -92,6 +104,7 @@ typedef struct tagLISAInjectionCAmpPhase
   struct tagListmodesCAmpPhaseSpline* TDI1Splines;   /* Signal in the TDI channel 1, in the form of a list of splines for the contribution of each mode */
   struct tagListmodesCAmpPhaseSpline* TDI2Splines;   /* Signal in the TDI channel 2, in the form of a list of splines for the contribution of each mode */
   struct tagListmodesCAmpPhaseSpline* TDI3Splines;   /* Signal in the TDI channel 3, in the form of a list of splines for the contribution of each mode */
+  struct tagModesCAmpPhaseSpline3ChanSoA* TDI123SplinesSoA; /* Same splines for the three TDI channels, in SoA form for the overlaps */
   double TDI123ss;                                   /* Combined Inner product (s|s) for TDI channels 123 */
 } LISAInjectionCAmpPhase;
 
@@ -113,6 +126,43 @@ typedef struct tagLISAInjectionReIm /* Storing the vectors of frequencies and no
   gsl_vector* noisevalues3;                    /* Vector of noise values on freq for TDI channel 3 */
 } LISAInjectionReIm;
 
+typedef struct tagLISAInjectionRelBin /* Summary data for the relative binning likelihood - templates are expanded around a fiducial waveform, here the injection with the modes of the templates */
+{
+  int nbbins;                 /* Number of frequency bins */
+  double* fbins;              /* Edges of the bins, size nbbins+1 */
+  int nbmode;                 /* Number of modes of the fiducial waveform */
+  int* lmode;                 /* Indices l of the modes of the fiducial waveform */
+  int* mmode;                 /* Indices m of the modes of the fiducial waveform */
+  double complex* fidvalues;  /* Fiducial modes h0 at the edges - index (c*nbmode + i)*(nbbins+1) + b for channel c, mode i, edge b */
+  double complex* A;          /* Moments k=0,1 of (h0|d) in each bin - index ((c*nbmode + i)*2 + k)*nbbins + b */
+  double complex* B;          /* Moments k=0,1,2 of (h0|h0) in each bin - index (((c*nbmode + i)*nbmode + j)*3 + k)*nbbins + b */
+  double TDI123ss;            /* Combined Inner product (s|s) for TDI channels 123 */
+} LISAInjectionRelBin;
+
+typedef struct tagLISAInjectionROQ /* Quadrature rules for the ROQ likelihood - a block per channel for each mode (h_lm|d) and each pair of modes (h_lm|h_l'm') */
+{
+  int nbblocks;               /* Number of blocks */
+  int* type;                  /* Type of each block: 0 for (h_l1m1|d), 1 for (h_l1m1|h_l2m2) */
+  int* chan;                  /* TDI channel of each block, 0,1,2 */
+  int* l1;                    /* Index l of the first mode */
+  int* m1;                    /* Index m of the first mode */
+  int* l2;                    /* Index l of the second mode - for quadratic blocks */
+  int* m2;                    /* Index m of the second mode - for quadratic blocks */
+  int* nbnodes;               /* Number of nodes of each block */
+  double** nodes;             /* Frequencies of the nodes, increasing */
+  double complex** weights;   /* Weights, the block contributing Re sum_k w_k h1(F_k) (linear) or Re sum_k w_k h1(F_k) conj(h2(F_k)) (quadratic) */
+  int nbmode;                 /* Number of modes appearing in the blocks */
+  int* lmode;                 /* Indices l of the modes */
+  int* mmode;                 /* Indices m of the modes */
+  int* nbnodesmode;           /* Number of nodes of each mode - union over the blocks and channels involving the mode */
+  double** nodesmode;         /* Nodes of each mode, increasing */
+  int* imode1;                /* Index of the first mode of each block in lmode, mmode */
+  int* imode2;                /* Index of the second mode of each block - -1 for linear blocks */
+  int** index1;               /* Position of the nodes of each block in the nodes of its first mode */
+  int** index2;               /* Position of the nodes of each block in the nodes of its second mode - NULL for linear blocks */
+  double TDI123ss;            /* Combined Inner product (s|s) for TDI channels 123 */
+} LISAInjectionROQ;
+
 typedef struct tagLISAPrior {
   SampleMassParamstag samplemassparams;   /* Choose the set of mass params to sample from - options are m1m2 and Mchirpeta (default m1m2) */
   SampleTimeParamtag sampletimeparam;     /* Choose the time param to sample from - options are tSSB and tL (default tSSB) */
@@ -182,6 +232,7 @@ typedef struct tagLISARunParams {
   int    nclspar;            /* number of parameters to use for multimodal decomposition - in the order of the cube */
   double ztol;               /* in multimodal decomposition, modes with lnZ lower than Ztol are ignored */
   int    seed;               /* seed the inference by setting one of the live points to the injection ? */
+  int    profile;            /* time the stages of the likelihood and write the profile at the end of the run ? (default 0) */
 } LISARunParams;
 
 /* Parameters for the generation of a LISA waveform (in the form of a list of modes) */
@@ -210,6 +261,17 @@ typedef struct tagSimpleLikelihoodPrecomputedValues {
   double complex se;
 } SimpleLikelihoodPrecomputedValues;
 
+/* Saved precomputed values for the injection, when using the Gram-matrix generalization of the simplified frozenLISA lowf likelihood to higher modes */
+/* The modes are generated for the pinned masses and time at phiRef=0 and 1Mpc, with the lowf factor pi f L/c - channels a and e then are linear combinations of the modes */
+typedef struct tagGramLikelihoodPrecomputedValues {
+  int nbmode;                                /* Number of modes, in the order of listmode - max of nbmodeinj and nbmodetemp */
+  int l[nbmodemax];                          /* Mode indices l */
+  int m[nbmodemax];                          /* Mode indices m */
+  double complex gram[nbmodemax][nbmodemax]; /* Gram matrix of the modes 4 int h_lm conj(h_l'm')/Sn, hermitian */
+  double complex cainj[nbmodemax];           /* Coefficients of the modes in channel a for the injection */
+  double complex ceinj[nbmodemax];           /* Coefficients of the modes in channel e for the injection */
+} GramLikelihoodPrecomputedValues;
+
 /************ Functions for LISA parameters, injection, likelihood, prior ************/
 
 /* Parse command line to initialize LISAParams, LISAGlobalParams, LISAPrior, and LISARunParams objects */
@@ -233,6 +295,8 @@ int print_rescaleddist_to_file_LISA(
   LISAPrior* prior,
   LISARunParams* run);
 int print_snrlogZ_to_file_LISA(LISARunParams* run, double SNR, double logZ);
+/* Function writing the profile of the likelihood stages to [outroot]profile_[rank].dat, if enabled by --profile */
+int print_profile_to_file_LISA(LISARunParams* run, int rank);
 /* Function printing injection/signal parameters to stdout */
 void report_LISAParams(LISAParams* params);
 
@@ -245,6 +309,10 @@ void LISASignalReIm_Cleanup(LISASignalReIm* signal);
 void LISASignalReIm_Init(LISASignalReIm** signal);
 void LISAInjectionReIm_Cleanup(LISAInjectionReIm* signal);
 void LISAInjectionReIm_Init(LISAInjectionReIm** signal);
+void LISAInjectionRelBin_Cleanup(LISAInjectionRelBin* relbin);
+void LISAInjectionRelBin_Init(LISAInjectionRelBin** relbin);
+void LISAInjectionROQ_Cleanup(LISAInjectionROQ* roq);
+void LISAInjectionROQ_Init(LISAInjectionROQ** roq);
 
 //Function to restrict range of the signal/injection to within desired limits.
 int listmodesCAmpPhaseTrim(ListmodesCAmpPhaseFrequencySeries* listSeries);
@@ -253,10 +321,20 @@ int listmodesCAmpPhaseTrim(ListmodesCAmpPhaseFrequencySeries* listSeries);
 int LISAGenerateSignalCAmpPhase(
   struct tagLISAParams* params,                 /* Input: set of LISA parameters of the signal */
   struct tagLISASignalCAmpPhase* signal);  /* Output: structure for the generated signal */
+/* Same as LISAGenerateSignalCAmpPhase, with the reference time given explicitly instead of read from injectedparams, for concurrent generation against different injections */
+int LISAGenerateSignalCAmpPhaseRef(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  double tRefinj,                          /* Input: reference time of the injection, replacing injectedparams->tRef */
+  struct tagLISASignalCAmpPhase* signal);  /* Output: structure for the generated signal */
 /* Function generating a LISA injection as a list of modes, given as preinterpolated splines, from LISA parameters */
 int LISAGenerateInjectionCAmpPhase(
   struct tagLISAParams* injectedparams,    /* Input: set of LISA parameters of the signal */
   struct tagLISAInjectionCAmpPhase* signal);  /* Output: structure for the generated signal */
+/* Same as LISAGenerateInjectionCAmpPhase, with the reference time given explicitly instead of read from injectedparams, for concurrent generation of different injections */
+int LISAGenerateInjectionCAmpPhaseRef(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  double tRefinj,                          /* Input: reference time of the injection, replacing injectedparams->tRef */
+  struct tagLISAInjectionCAmpPhase* signal);  /* Output: structure for the generated signal */
 /* Function generating a LISA signal as a frequency series in Re/Im form where the modes have been summed, from LISA parameters - takes as argument the frequencies on which to evaluate */
 int LISAGenerateSignalReIm(
   struct tagLISAParams* params,       /* Input: set of LISA parameters of the template */
@@ -269,6 +347,48 @@ int LISAGenerateInjectionReIm(
   int nbpts,                                  /* Input: number of frequency samples */
   int tagsampling,                            /* Input: tag for using linear (0) or logarithmic (1) sampling */
   struct tagLISAInjectionReIm* signal);       /* Output: structure for the generated signal */
+/* Same as LISAGenerateInjectionReIm, with the reference time given explicitly instead of read from injectedparams, for concurrent generation of different injections */
+int LISAGenerateInjectionReImRef(
+  struct tagLISAParams* params,               /* Input: set of LISA parameters of the injection */
+  double tRefinj,                             /* Input: reference time of the injection, replacing injectedparams->tRef */
+  double fLow,                                /* Input: starting frequency */
+  int nbpts,                                  /* Input: number of frequency samples */
+  int tagsampling,                            /* Input: tag for using linear (0) or logarithmic (1) sampling */
+  struct tagLISAInjectionReIm* signal);       /* Output: structure for the generated signal */
+/* Function precomputing the summary data for the relative binning likelihood - the fiducial waveform is the injection with globalparams->nbmodetemp modes */
+int LISAGenerateInjectionRelBin(
+  struct tagLISAParams* injectedparams,       /* Input: set of LISA parameters of the injection */
+  struct tagLISAInjectionCAmpPhase* injection, /* Input: injection as generated by LISAGenerateInjectionCAmpPhase */
+  int nbbins,                                 /* Input: number of frequency bins */
+  struct tagLISAInjectionRelBin* relbin);     /* Output: structure for the summary data */
+/* Function building the quadrature rules of the ROQ likelihood from a training set of templates, against the data of the injection */
+int LISABuildROQ(
+  struct tagLISAInjectionCAmpPhase* injection, /* Input: injection as generated by LISAGenerateInjectionCAmpPhase */
+  struct tagLISAParams* trainingparams,       /* Input: parameters of the training templates, with the number of modes of the templates */
+  int ntrain,                                 /* Input: number of training templates */
+  int nbfreq,                                 /* Input: number of frequencies for the discrete inner products */
+  double tol,                                 /* Input: tolerance of the greedy reduced bases */
+  struct tagLISAInjectionROQ* roq);           /* Output: structure for the quadrature rules */
+/* Writing and reading the quadrature rules of the ROQ likelihood */
+int LISAWriteROQ(const char* filename, LISAInjectionROQ* roq);
+int LISAReadROQ(const char* filename, LISAInjectionROQ* roq);
+
+/* Same as LISAGenerateSignalCAmpPhase and LISAGenerateSignalReIm, going through a per-thread LRU cache keyed by the exact parameters when globalparams->nbsignalcache>0 - the output is a copy, owned by the caller */
+int LISAGenerateSignalCAmpPhaseCached(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  struct tagLISASignalCAmpPhase* signal);  /* Output: structure for the generated signal */
+int LISAGenerateSignalCAmpPhaseCachedRef(
+  struct tagLISAParams* params,            /* Input: set of LISA parameters of the signal */
+  double tRefinj,                          /* Input: reference time of the injection, replacing injectedparams->tRef */
+  struct tagLISASignalCAmpPhase* signal);  /* Output: structure for the generated signal */
+int LISAGenerateSignalReImCached(
+  struct tagLISAParams* params,       /* Input: set of LISA parameters of the template */
+  gsl_vector* freq,                   /* Input: frequencies on which evaluating the waveform (from the injection) */
+  struct tagLISASignalReIm* signal);  /* Output: structure for the generated signal */
+/* Hit and miss counts of the signal caches of the calling thread */
+void LISASignalCacheStats(size_t* hits, size_t* misses);
+/* Hit and miss counts of the intrinsic caches (globalparams->nbintrinsiccache>0), summed over the threads */
+void LISAIntrinsicCacheStats(size_t* hits, size_t* misses);
 
 /*Wrapper for waveform generation with possibly a combination of EOBNRv2HMROM and TaylorF2*/
 /* Note: GenerateWaveform accepts masses and distances in SI units, whereas LISA params is in solar masses and Mpc */
@@ -323,11 +443,35 @@ double CosPriorToCube(double y, double x1, double x2);
 
 /* log-Likelihood functions */
 double CalculateLogLCAmpPhase(LISAParams *params, LISAInjectionCAmpPhase* injection);
+/* Number of times the per-thread overlap workspace used by CalculateLogLCAmpPhase has been grown - constant in steady state */
+/* Covers the overlap stage only, the ROM and the response allocating at each evaluation */
+size_t LISAOverlapWorkspaceRegrowths(void);
 double CalculateLogLReIm(LISAParams *params, LISAInjectionReIm* injection);
+double CalculateLogLRelBin(LISAParams *params, LISAInjectionRelBin* relbin);
+double CalculateLogLROQ(LISAParams *params, LISAInjectionROQ* roq);
+
+/* Fisher matrix from finite differences of the waveforms - dim+1 waveforms for one-sided differences (paramsminus NULL), 2*dim for centered differences, generated in parallel as OpenMP tasks */
+int LISAComputeFisherReIm(
+  struct tagLISAParams* params,               /* Input: parameters at which the Fisher matrix is computed - used only for one-sided differences */
+  int dim,                                    /* Input: number of parameters */
+  struct tagLISAParams* paramsplus,           /* Input: parameters displaced by +steps[i] in the direction i, size dim */
+  struct tagLISAParams* paramsminus,          /* Input: parameters displaced by -steps[i] in the direction i, size dim - NULL for one-sided differences */
+  double* steps,                              /* Input: steps in each direction, size dim */
+  struct tagLISAInjectionReIm* injection,     /* Input: injection providing the frequencies and noise values */
+  double* fisher);                            /* Output: Fisher matrix, size dim*dim (row-major, already allocated) */
 
 /* Functions for simplified likelihood using precomputing relevant values */
 int LISAComputeSimpleLikelihoodPrecomputedValues(SimpleLikelihoodPrecomputedValues* simplelikelihoodvals, LISAParams* params);
 double CalculateLogLSimpleLikelihood(SimpleLikelihoodPrecomputedValues* simplelikelihoodvals, LISAParams* params);
+int LISAComputeGramLikelihoodPrecomputedValues(GramLikelihoodPrecomputedValues* gramlikelihoodvals, LISAParams* params);
+double CalculateLogLGramLikelihood(GramLikelihoodPrecomputedValues* gramlikelihoodvals, LISAParams* params);
+
+/* Functions for the likelihood marginalized over distance and/or phase - injection is the context for the likelihood set by tagint */
+double CalculateLogLMarginalized(LISAParams* params, void* injection);
+/* Draw distance and/or phase in params from their posterior conditional on the other parameters - logL, if not NULL, gets the marginalized log-likelihood computed from the same overlaps */
+int LISADrawMarginalizedParams(LISAParams* params, void* injection, gsl_rng* r, double* logL);
+/* Replace distance and/or phase by draws in a file of posterior samples (m1, m2, tRef, dist, phase, inc, lambda, beta, pol, loglike) */
+int LISAReconstructMarginalizedPosterior(const char inpath[], const char outpath[], void* injection);
 
 /************ Global Parameters ************/
 
@@ -337,6 +481,8 @@ extern LISAPrior* priorParams;
 extern LISAAddParams* addparams;
 extern double logZdata; /* TODO: not used */
 extern SimpleLikelihoodPrecomputedValues* simplelikelihoodinjvals;
+extern GramLikelihoodPrecomputedValues* gramlikelihoodinjvals;
+extern DistanceMarginalization* distmarginalization;
 
 #if 0
 { /* so that editors will match succeeding brace */
@@ -71,6 +71,9 @@ Arguments are as follows:\n\
  --infile              Input file name when loading TDI time series from file\n\
  --outdir              Output directory\n\
  --outfileprefix       Output file name prefix, will output one file for each TDI channel with a built-in postfix\n\
+ --fftmeasure          When loading time series and FFTing, plan the FFTs with FFTW_MEASURE instead of FFTW_ESTIMATE (default: false)\n\
+ --fftthreads          When loading time series and FFTing, number of threads per FFT - requires FFTW threads support at compilation (default 1)\n\
+ --fftwisdom           When loading time series and FFTing, FFTW wisdom file, imported if it exists and exported at the end (default none)\n\
 \n";
 
     ssize_t i;
@@ -110,6 +113,9 @@ Arguments are as follows:\n\
     strcpy(params->infile, "");  /* No default; has to be provided */
     strcpy(params->outdir, ".");
     strcpy(params->outfileprefix, "generated_tdiFD");
+    params->fftmeasure = 0;
+    params->fftthreads = 1;
+    strcpy(params->fftwisdom, "");
 
     /* Consume command line */
     for (i = 1; i < argc; ++i) {
@@ -184,6 +190,12 @@ Arguments are as follows:\n\
             strcpy(params->outdir, argv[++i]);
         } else if (strcmp(argv[i], "--outfileprefix") == 0) {
             strcpy(params->outfileprefix, argv[++i]);
+        } else if (strcmp(argv[i], "--fftmeasure") == 0) {
+            params->fftmeasure = 1;
+        } else if (strcmp(argv[i], "--fftthreads") == 0) {
+            params->fftthreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fftwisdom") == 0) {
+            strcpy(params->fftwisdom, argv[++i]);
         } else {
 	  printf("Error: invalid option: %s\n", argv[i]);
 	  goto fail;
@@ -369,6 +381,11 @@ int main(int argc, char *argv[])
 
   if(params->FFTfromtdfile) {
 
+    /* FFT planning - the plans are cached, and the wisdom saved for later runs */
+    if(strlen(params->fftwisdom)>0) FFTImportWisdom(params->fftwisdom);
+    if(params->fftmeasure) FFTSetPlanMeasure(1);
+    if(params->fftthreads>1) FFTSetThreads(params->fftthreads);
+
     if(params->taggenwave==TDIFFT) {
       /* Load TD TDI from file */
       RealTimeSeries* TDI1 = NULL;
@@ -394,9 +411,7 @@ int main(int argc, char *argv[])
       else {
         twindowend = params->twindowend;
       }
-      FFTRealTimeSeries(&TDI1FFT, TDI1, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
-      FFTRealTimeSeries(&TDI2FFT, TDI2, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
-      FFTRealTimeSeries(&TDI3FFT, TDI3, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
+      FFTRealTimeSeries3Chan(&TDI1FFT, &TDI2FFT, &TDI3FFT, TDI1, TDI2, TDI3, twindowbeg, twindowend, 2); /* Here hardcoded 0-padding */
 
       /* Output */
       char *outfileTDI1 = malloc(256);
@@ -414,6 +429,7 @@ int main(int argc, char *argv[])
       free(outfileTDI2);
       free(outfileTDI3);
 
+      if(strlen(params->fftwisdom)>0) FFTExportWisdom(params->fftwisdom);
       exit(0);
     }
     else if(params->taggenwave==h22FFT) {
@@ -476,12 +492,11 @@ int main(int argc, char *argv[])
       /* Output */
       Write_ReImFrequencySeries(params->outdir, params->outfileprefix, yslrFFT, params->binaryout);
     }
+
+    if(strlen(params->fftwisdom)>0) FFTExportWisdom(params->fftwisdom);
   }
 
   else {
-    /* Set geometric coefficients */
-    SetCoeffsG(params->lambda, params->beta, params->polarization);
-
     /* Generate waveform hlm FD, downsampled in amp/phase form */
     double fLowhlm = 0.;
     double fHighhlm = 0.;
@@ -88,6 +88,9 @@ typedef struct tagGenTDIFDparams {
   char infile[256];          /* Path for the input file */
   char outdir[256];          /* Path for the output directory */
   char outfileprefix[256];   /* Path for the output file */
+  int fftmeasure;            /* Tag for planning the FFTs with FFTW_MEASURE instead of FFTW_ESTIMATE (default false) */
+  int fftthreads;            /* Number of threads per FFT (default 1) */
+  char fftwisdom[256];       /* FFTW wisdom file, imported if it exists and exported at the end (default none) */
 } GenTDIFDparams;
 
 
@@ -160,7 +160,8 @@ int main(int argc, char *argv[])
   parse_args_GenerateTDITD(argc, argv, params);
 
   /* Set geometric coefficients */
-  SetCoeffsG(params->lambda, params->beta, params->polarization);
+  LISAGeometricCoeffs coeffs;
+  SetCoeffsG(&coeffs, params->lambda, params->beta, params->polarization);
 
   /* Set aside the cases of the orbital delay and constellation response - written with TD amp/phase */
   /* If not using those tags, use the old processing that uses TD hplus, hcross interpolated */
@@ -192,7 +193,7 @@ int main(int argc, char *argv[])
     RealTimeSeries* TDI1 = NULL;
     RealTimeSeries* TDI2 = NULL;
     RealTimeSeries* TDI3 = NULL;
-    GenerateTDITD3Chanhphc(variant, &TDI1, &TDI2, &TDI3, spline_hp, spline_hc, accel_hp, accel_hc, times, nptmargin, params->tagtdi);
+    GenerateTDITD3Chanhphc(variant, &coeffs, &TDI1, &TDI2, &TDI3, spline_hp, spline_hc, accel_hp, accel_hc, times, nptmargin, params->tagtdi);
 
     /* Output */
     Write_TDITD(params->outdir, params->outfile, TDI1, TDI2, TDI3, params->binaryout);
@@ -224,7 +225,7 @@ int main(int argc, char *argv[])
     if(params->tagtdi==delayO) {
       /* Evaluate orbital-delayed signal */
       AmpPhaseTimeSeries* h22tdO = NULL;
-      Generateh22TDO(variant, &h22tdO, spline_amp, spline_phase, accel_amp, accel_phase, times, nptmargin);
+      Generateh22TDO(variant, &coeffs, &h22tdO, spline_amp, spline_phase, accel_amp, accel_phase, times, nptmargin);
 
       /* Output */
       Write_AmpPhaseTimeSeries(params->outdir, params->outfile, h22tdO, params->binaryout);
@@ -233,7 +234,7 @@ int main(int argc, char *argv[])
     else if(params->tagtdi==y12L) {
       /* Evaluate y12 signal - constellation response only, input assumed to be h22tdO already */
       RealTimeSeries* y12td = NULL;
-      Generatey12LTD(variant, &y12td, spline_amp, spline_phase, accel_amp, accel_phase, times, params->inclination, params->phiRef, nptmargin);
+      Generatey12LTD(variant, &coeffs, &y12td, spline_amp, spline_phase, accel_amp, accel_phase, times, params->inclination, params->phiRef, nptmargin);
 
       /* Output */
       Write_RealTimeSeries(params->outdir, params->outfile, y12td, params->binaryout);
@@ -242,7 +243,7 @@ int main(int argc, char *argv[])
     else if(params->tagtdi==y12) {
       /* Evaluate y12 signal - constellation response only, input assumed to be h22tdO already */
       RealTimeSeries* y12td = NULL;
-      Generatey12TD(variant, &y12td, spline_amp, spline_phase, accel_amp, accel_phase, times, params->inclination, params->phiRef, nptmargin);
+      Generatey12TD(variant, &coeffs, &y12td, spline_amp, spline_phase, accel_amp, accel_phase, times, params->inclination, params->phiRef, nptmargin);
 
       /* Output */
       Write_RealTimeSeries(params->outdir, params->outfile, y12td, params->binaryout);
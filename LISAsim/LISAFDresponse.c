@@ -33,6 +33,7 @@
 
 #include "constants.h"
 #include "struct.h"
+#include "profiling.h"
 #include "EOBNRv2HMROMstruct.h"
 #include "LISAgeometry.h"
 #include "LISAFDresponse.h"
@@ -41,6 +42,36 @@
 /***************************************/
 /********* Core functions **************/
 
+/* Phase term due to the R-delay (orbital delay), including correction to first order */
+static double PhaseRdelay(
+  int tagtRefatLISA,                 /* 0 to measure Tref from SSB arrival, 1 at LISA guiding center */
+  LISAconstellation *variant,        /* Provides specifics on the variant of LISA */
+  const double f,                    /* Frequency */
+  const double tforb,                /* Orbital time t(f) */
+  const double torb,                 /* Reference orbital time */
+  const double lambda,               /* First angle for the position in the sky */
+  const double beta,                 /* Second angle for the position in the sky */
+  const ResponseApproxtag responseapprox) /* Tag to select possible low-f approximation level in FD response */
+{
+  double phase=variant->OrbitOmega*tforb + variant->OrbitPhi0 - lambda;
+  double OrbitRoC=variant->OrbitR/C_SI;
+  //double phaseRdelay = -2*PI*R_SI/C_SI*f*cos(beta)*cos(Omega_SI*tf - lambda) * (1 + R_SI/C_SI*cos(beta)*Omega_SI*sin(Omega_SI*tf - lambda));
+  double phaseRdelay;
+  if(tagtRefatLISA==0){//delay so that tinj=torb refers to arrival time at SSB
+    phaseRdelay = -2*PI*OrbitRoC*f*cos(beta)*cos(phase) * (1 + cos(beta)*OrbitRoC*variant->OrbitOmega*sin(phase));
+  } else {
+    //In this version we delay so that tinj=torb is relative to LISAcenter arrival time, so there is no orbital delay when tf = tinj
+    //If the original delay realized td=t+d(t), now we want td=t+d(t)-d(t0), that we we change d(t) -> d(t) + d(t0)
+    //Then with the approximation d(td)=d(t)(1-ddot(t)),
+    double phase0 = variant->OrbitOmega*torb + variant->OrbitPhi0 - lambda;
+    phaseRdelay = -2*PI*OrbitRoC*f*cos(beta)*( cos(phase)-cos(phase0) ) * (1 + cos(beta)*OrbitRoC*variant->OrbitOmega*sin(phase));
+  }
+  if(responseapprox==lowf) { /* In the full low-f approximation, ignore this delay term */
+    phaseRdelay = 0.;
+  }
+  return phaseRdelay;
+}
+
 /* Core function processing a signal (in the form of a list of modes) through the Fourier-domain LISA response, for given values of the inclination, position in the sky and polarization angle - here simplified version for just the y_21 observable */
 /* Older version of th FD response: two stages, first for the orbital delay (Bessel phase) and second for the constellation delay/modulation */
 int LISASimFDResponse21(
@@ -53,7 +84,8 @@ int LISASimFDResponse21(
 {
   /* Computing the complicated trigonometric coefficients */
   //clock_t begsetcoeffs = clock();
-  SetCoeffsG(lambda, beta, psi);
+  LISAGeometricCoeffs coeffs;
+  SetCoeffsG(&coeffs, lambda, beta, psi);
   //clock_t endsetcoeffs = clock();
   //printf("Set Coeffs time: %g s\n", (double)(endsetcoeffs - begsetcoeffs) / CLOCKS_PER_SEC);
 
@@ -114,7 +146,7 @@ int LISASimFDResponse21(
     for(int j=0; j<len; j++) {
       f = gsl_vector_get(freq, j);
       tf =  (gsl_spline_eval_deriv(spline_phi, f, accel_phi) + gsl_spline_eval_deriv(spline_besselphi, f, accel_besselphi))/(2*PI);
-      camp = G21mode(variant, f, tf, Yfactorplus, Yfactorcross) * (gsl_vector_get(amp_real, j) + I * gsl_vector_get(amp_imag, j));
+      camp = G21mode(variant, &coeffs, f, tf, Yfactorplus, Yfactorcross) * (gsl_vector_get(amp_real, j) + I * gsl_vector_get(amp_imag, j));
       /**/
       gsl_vector_set(amp_real, j, creal(camp));
       gsl_vector_set(amp_imag, j, cimag(camp));
@@ -149,7 +181,8 @@ int LISASimFDResponsey12(
 {
   /* Computing the complicated trigonometric coefficients */
   //clock_t begsetcoeffs = clock();
-  SetCoeffsG(lambda, beta, psi);
+  LISAGeometricCoeffs coeffs;
+  SetCoeffsG(&coeffs, lambda, beta, psi);
   //clock_t endsetcoeffs = clock();
   //printf("Set Coeffs time: %g s\n", (double)(endsetcoeffs - begsetcoeffs) / CLOCKS_PER_SEC);
 
@@ -214,7 +247,7 @@ int LISASimFDResponsey12(
         tforb = torb;
       }
       //clock_t tbegGAB = clock();
-	  EvaluateGABmode(variant, &g12mode, &g21mode, &g23mode, &g32mode, &g31mode, &g13mode, f, tforb, Yfactorplus, Yfactorcross, 1, responseapprox); /* does include the R-delay term */
+	  EvaluateGABmode(variant, &coeffs, &g12mode, &g21mode, &g23mode, &g32mode, &g31mode, &g13mode, f, tforb, Yfactorplus, Yfactorcross, 1, responseapprox); /* does include the R-delay term */
       //clock_t tendGAB = clock();
       //timingcumulativeGABmode += (double) (tendGAB-tbegGAB) /CLOCKS_PER_SEC;
       /**/
@@ -266,11 +299,11 @@ int LISASimFDResponseTDI3Chan(
   const int tagfrozenLISA,                                 /* Tag to treat LISA as frozen at its torb configuration  */
   const ResponseApproxtag responseapprox)                  /* Tag to select possible low-f approximation level in FD response */
 {
+  long long t0 = ProfileStart();
+
   /* Computing the complicated trigonometric coefficients */
-  //clock_t begsetcoeffs = clock();
-  SetCoeffsG(lambda, beta, psi);
-  //clock_t endsetcoeffs = clock();
-  //printf("Set Coeffs time: %g s\n", (double)(endsetcoeffs - begsetcoeffs) / CLOCKS_PER_SEC);
+  LISAGeometricCoeffs coeffs;
+  SetCoeffsG(&coeffs, lambda, beta, psi);
 
   /* Chirp mass for resampling */
   double mchirp = Mchirpofm1m2(m1, m2);
@@ -331,6 +364,7 @@ int LISASimFDResponseTDI3Chan(
     /* Resampling at high f to achieve a deltaf of at most 0.002 Hz */
     /* Resample linearly at this deltaf when this threshold is reached */
     /* NOTE: Assumes input frequencies are logarithmic (except maybe first interval) to evaluate when to resample */
+    long long t0resample = ProfileStart();
     gsl_vector* freqrhigh = NULL;
     SetMaxdeltafResampledFrequencies(&freqrhigh, freq, maxf, 0.002); /* Use 0.002Hz as a default maximal deltaf */
 
@@ -345,6 +379,7 @@ int LISASimFDResponseTDI3Chan(
     /* Evaluate resampled waveform */
     CAmpPhaseFrequencySeries* freqseriesr = NULL;
     CAmpPhaseFrequencySeries_Resample(&freqseriesr, freqseries, freqr);
+    ProfileStop(ProfileResample, t0resample);
     gsl_vector* freq_resample = freqseriesr->freq;
     gsl_vector* amp_real_resample = freqseriesr->amp_real;
     gsl_vector* amp_imag_resample = freqseriesr->amp_imag;
@@ -462,7 +497,7 @@ int LISASimFDResponseTDI3Chan(
         tforb = torb;
       }
       //clock_t tbegGAB = clock();
-      EvaluateGABmode(variant, &g12mode, &g21mode, &g23mode, &g32mode, &g31mode, &g13mode, f, tforb, Yfactorplus, Yfactorcross, 0, responseapprox); /* does not include the R-delay term */
+      EvaluateGABmode(variant, &coeffs, &g12mode, &g21mode, &g23mode, &g32mode, &g31mode, &g13mode, f, tforb, Yfactorplus, Yfactorcross, 0, responseapprox); /* does not include the R-delay term */
       //clock_t tendGAB = clock();
       //timingcumulativeGABmode += (double) (tendGAB-tbegGAB) /CLOCKS_PER_SEC;
       /**/
@@ -472,22 +507,7 @@ int LISASimFDResponseTDI3Chan(
       camp2 = factor2 * amphtilde;
       camp3 = factor3 * amphtilde;
       /* Phase term due to the R-delay, including correction to first order */
-      double phase=variant->OrbitOmega*tforb + variant->OrbitPhi0 - lambda;
-      double OrbitRoC=variant->OrbitR/C_SI;
-      //double phaseRdelay = -2*PI*R_SI/C_SI*f*cos(beta)*cos(Omega_SI*tf - lambda) * (1 + R_SI/C_SI*cos(beta)*Omega_SI*sin(Omega_SI*tf - lambda));
-      double phaseRdelay;
-      if(tagtRefatLISA==0){//delay so that tinj=torb refers to arrival time at SSB
-        phaseRdelay = -2*PI*OrbitRoC*f*cos(beta)*cos(phase) * (1 + cos(beta)*OrbitRoC*variant->OrbitOmega*sin(phase));
-      } else {
-        //In this version we delay so that tinj=torb is relative to LISAcenter arrival time, so there is no orbital delay when tf = tinj
-        //If the original delay realized td=t+d(t), now we want td=t+d(t)-d(t0), that we we change d(t) -> d(t) + d(t0)
-        //Then with the approximation d(td)=d(t)(1-ddot(t)),
-        double phase0 = variant->OrbitOmega*torb + variant->OrbitPhi0 - lambda;
-        phaseRdelay = -2*PI*OrbitRoC*f*cos(beta)*( cos(phase)-cos(phase0) ) * (1 + cos(beta)*OrbitRoC*variant->OrbitOmega*sin(phase));
-      }
-      if(responseapprox==lowf) { /* In the full low-f approximation, ignore this delay term */
-        phaseRdelay = 0.;
-      }
+      double phaseRdelay = PhaseRdelay(tagtRefatLISA, variant, f, tforb, torb, lambda, beta, responseapprox);
       double phasewithRdelay = gsl_vector_get(phase_resample, j) + phaseRdelay;
 
       /**/
@@ -534,5 +554,107 @@ int LISASimFDResponseTDI3Chan(
     // }
   }
 
+  ProfileStop(ProfileResponse, t0);
+  return SUCCESS;
+}
+
+/* Evaluate the contribution of a single mode to the three TDI channels directly at a set of frequencies, as complex values h = A e^{i phi} including the R-delay phase */
+/* The amplitude, phase and t(f) of the mode are interpolated at the requested frequencies only - no resampling and no output frequency series, for likelihoods that only need the template at a few frequencies */
+/* Values are set to 0 outside the frequency range of the mode */
+int LISASimFDResponseTDI3ChanAtFrequencies(
+  int tagtRefatLISA,                                       /* 0 to measure Tref from SSB arrival, 1 at LISA guiding center */
+  LISAconstellation *variant,                              /* Provides specifics on the variant of LISA */
+  struct tagCAmpPhaseFrequencySeries *freqseries,          /* Input: mode in Frequency-domain amplitude and phase form as produced by the ROM */
+  const int l,                                             /* Index l of the mode */
+  const int m,                                             /* Index m of the mode */
+  const double* freq,                                      /* Input: frequencies, increasing */
+  const int nbfreq,                                        /* Input: number of frequencies */
+  double complex* values1,                                 /* Output: values of the mode in the TDI channel 1, size nbfreq */
+  double complex* values2,                                 /* Output: values of the mode in the TDI channel 2, size nbfreq */
+  double complex* values3,                                 /* Output: values of the mode in the TDI channel 3, size nbfreq */
+  const double torb,                                       /* Reference orbital time - tf as read from the hlm gives t-tinj, this arg allows to pass tinj to the response */
+  const double lambda,                                     /* First angle for the position in the sky */
+  const double beta,                                       /* Second angle for the position in the sky */
+  const double inclination,                                /* Inclination of the source */
+  const double psi,                                        /* Polarization angle */
+  const TDItag tditag,                                     /* Selector for the set of TDI observables */
+  const int tagfrozenLISA,                                 /* Tag to treat LISA as frozen at its torb configuration  */
+  const ResponseApproxtag responseapprox)                  /* Tag to select possible low-f approximation level in FD response */
+{
+  long long t0 = ProfileStart();
+
+  /* Computing the complicated trigonometric coefficients */
+  LISAGeometricCoeffs coeffs;
+  SetCoeffsG(&coeffs, lambda, beta, psi);
+
+  /* Range of the requested frequencies covered by the mode */
+  int len = (int) freqseries->freq->size;
+  const double* fmode = gsl_vector_const_ptr(freqseries->freq, 0);
+  int ibeg = 0, iend = nbfreq;
+  while(ibeg<nbfreq && freq[ibeg]<fmode[0]) ibeg++;
+  while(iend>ibeg && freq[iend-1]>fmode[len-1]) iend--;
+  for(int j=0; j<nbfreq; j++) {
+    values1[j] = 0.;
+    values2[j] = 0.;
+    values3[j] = 0.;
+  }
+  if(iend==ibeg) {
+    ProfileStop(ProfileResponse, t0);
+    return SUCCESS;
+  }
+
+  /* Computing the Ylm combined factors for plus and cross for this mode */
+  /* Capital Phi is set to 0 by convention */
+  double complex Yfactorplus;
+  double complex Yfactorcross;
+  if (!(l%2)) {
+    Yfactorplus = 1./2 * (SpinWeightedSphericalHarmonic(inclination, 0., -2, l, m) + conj(SpinWeightedSphericalHarmonic(inclination, 0., -2, l, -m)));
+    Yfactorcross = I/2 * (SpinWeightedSphericalHarmonic(inclination, 0., -2, l, m) - conj(SpinWeightedSphericalHarmonic(inclination, 0., -2, l, -m)));
+  }
+  else {
+    Yfactorplus = 1./2 * (SpinWeightedSphericalHarmonic(inclination, 0., -2, l, m) - conj(SpinWeightedSphericalHarmonic(inclination, 0., -2, l, -m)));
+    Yfactorcross = I/2 * (SpinWeightedSphericalHarmonic(inclination, 0., -2, l, m) + conj(SpinWeightedSphericalHarmonic(inclination, 0., -2, l, -m)));
+  }
+
+  /* Interpolation of the mode, same as in the resampling of LISASimFDResponseTDI3Chan - the phase spline also gives tf */
+  gsl_spline* spline_amp_real = gsl_spline_alloc(gsl_interp_cspline, len);
+  gsl_spline* spline_amp_imag = gsl_spline_alloc(gsl_interp_cspline, len);
+  gsl_spline* spline_phi = gsl_spline_alloc(gsl_interp_cspline, len);
+  gsl_interp_accel* accel = gsl_interp_accel_alloc();
+  gsl_spline_init(spline_amp_real, fmode, gsl_vector_const_ptr(freqseries->amp_real, 0), len);
+  gsl_spline_init(spline_amp_imag, fmode, gsl_vector_const_ptr(freqseries->amp_imag, 0), len);
+  gsl_spline_init(spline_phi, fmode, gsl_vector_const_ptr(freqseries->phase, 0), len);
+
+  double complex g21mode = 0.;
+  double complex g12mode = 0.;
+  double complex g32mode = 0.;
+  double complex g23mode = 0.;
+  double complex g13mode = 0.;
+  double complex g31mode = 0.;
+  double complex factor1 = 0.;
+  double complex factor2 = 0.;
+  double complex factor3 = 0.;
+  for(int j=ibeg; j<iend; j++) {
+    double f = freq[j];
+    double tf = (gsl_spline_eval_deriv(spline_phi, f, accel))/(2*PI);
+    /* tf read from hlm is t-tinj - here convert to orbital time using torb - ignore tf if orbit is frozen */
+    double tforb = tagfrozenLISA ? torb : tf + torb;
+    EvaluateGABmode(variant, &coeffs, &g12mode, &g21mode, &g23mode, &g32mode, &g31mode, &g13mode, f, tforb, Yfactorplus, Yfactorcross, 0, responseapprox); /* does not include the R-delay term */
+    EvaluateTDIfactor3Chan(variant, &factor1, &factor2, &factor3, g12mode, g21mode, g23mode, g32mode, g31mode, g13mode, f, tditag, responseapprox);
+    double complex amphtilde = gsl_spline_eval(spline_amp_real, f, accel) + I * gsl_spline_eval(spline_amp_imag, f, accel);
+    double phasewithRdelay = gsl_spline_eval(spline_phi, f, accel) + PhaseRdelay(tagtRefatLISA, variant, f, tforb, torb, lambda, beta, responseapprox);
+    double complex expphase = cexp(I*phasewithRdelay);
+    values1[j] = factor1 * amphtilde * expphase;
+    values2[j] = factor2 * amphtilde * expphase;
+    values3[j] = factor3 * amphtilde * expphase;
+  }
+
+  /* Clean up */
+  gsl_spline_free(spline_amp_real);
+  gsl_spline_free(spline_amp_imag);
+  gsl_spline_free(spline_phi);
+  gsl_interp_accel_free(accel);
+
+  ProfileStop(ProfileResponse, t0);
   return SUCCESS;
 }
@@ -93,6 +93,27 @@ int LISASimFDResponseTDI3Chan(
   const int tagfrozenLISA,                                    /* Tag to treat LISA as frozen at its torb configuration  */
   const ResponseApproxtag responseapprox);                    /* Tag to select possible low-f approximation level in FD response */
 
+/* Contribution of a single mode to the three TDI channels, evaluated directly at a set of frequencies as complex values - 0 outside the frequency range of the mode */
+int LISASimFDResponseTDI3ChanAtFrequencies(
+  int tagtRefatLISA,                                       /* 0 to measure Tref from SSB arrival, 1 at LISA guiding center */
+  LISAconstellation *variant,                              /* Provides specifics on the variant of LISA */
+  struct tagCAmpPhaseFrequencySeries *freqseries,          /* Input: mode in Frequency-domain amplitude and phase form as produced by the ROM */
+  const int l,                                             /* Index l of the mode */
+  const int m,                                             /* Index m of the mode */
+  const double* freq,                                      /* Input: frequencies, increasing */
+  const int nbfreq,                                        /* Input: number of frequencies */
+  double complex* values1,                                 /* Output: values of the mode in the TDI channel 1, size nbfreq */
+  double complex* values2,                                 /* Output: values of the mode in the TDI channel 2, size nbfreq */
+  double complex* values3,                                 /* Output: values of the mode in the TDI channel 3, size nbfreq */
+  const double torb,                                       /* Reference orbital time - tf as read from the hlm gives t-tinj, this arg allows to pass tinj to the response */
+  const double lambda,                                     /* First angle for the position in the sky */
+  const double beta,                                       /* Second angle for the position in the sky */
+  const double inclination,                                /* Inclination of the source */
+  const double psi,                                        /* Polarization angle */
+  const TDItag tditag,                                     /* Selector for the set of TDI observables */
+  const int tagfrozenLISA,                                 /* Tag to treat LISA as frozen at its torb configuration  */
+  const ResponseApproxtag responseapprox);                 /* Tag to select possible low-f approximation level in FD response */
+
 // int LISASimFDResponseTDI1Chan(
 //   struct tagListmodesCAmpPhaseFrequencySeries **list,      /* Input: list of modes in Frequency-domain amplitude and phase form as produced by the ROM */
 //   struct tagListmodesCAmpPhaseFrequencySeries **listTDI,   /* Output: list of contribution of each mode in Frequency-domain amplitude and phase form, in the TDI channel 1 */
@@ -120,54 +120,6 @@ LISAconstellation bigOrbitLISA = {
 /****************************************************************/
 /********* Coefficients for the geometric response **************/
 
-/* External storage for cos, sin and coefficients */
-static double coeffn1Hn1crossconst, coeffn1Hn1plusconst, coeffn2Hn2crossconst, coeffn2Hn2plusconst, coeffn3Hn3crossconst, coeffn3Hn3plusconst;
-static double coeffn1Hn1pluscos[4];
-static double coeffn1Hn1plussin[4];
-static double coeffn2Hn2pluscos[4];
-static double coeffn2Hn2plussin[4];
-static double coeffn3Hn3pluscos[4];
-static double coeffn3Hn3plussin[4];
-static double coeffn1Hn1crosscos[4];
-static double coeffn1Hn1crosssin[4];
-static double coeffn2Hn2crosscos[4];
-static double coeffn2Hn2crosssin[4];
-static double coeffn3Hn3crosscos[4];
-static double coeffn3Hn3crosssin[4];
-static double coeffkn1const, coeffkn2const, coeffkn3const, coeffkp1plusp2const, coeffkp2plusp3const, coeffkp3plusp1const, coeffkp1const, coeffkp2const, coeffkp3const, coeffkRconst;
-static double coeffkn1cos[2];
-static double coeffkn1sin[2];
-static double coeffkn2cos[2];
-static double coeffkn2sin[2];
-static double coeffkn3cos[2];
-static double coeffkn3sin[2];
-static double coeffkp1plusp2cos[2];
-static double coeffkp1plusp2sin[2];
-static double coeffkp2plusp3cos[2];
-static double coeffkp2plusp3sin[2];
-static double coeffkp3plusp1cos[2];
-static double coeffkp3plusp1sin[2];
-static double coeffkp1cos[2];
-static double coeffkp1sin[2];
-static double coeffkp2cos[2];
-static double coeffkp2sin[2];
-static double coeffkp3cos[2];
-static double coeffkp3sin[2];
-static double coeffkRcos[2];
-static double coeffkRsin[2];
-
-static double cosarray[4];
-static double sinarray[4];
-
-#pragma omp threadprivate(coeffn1Hn1crossconst, coeffn1Hn1plusconst, coeffn2Hn2crossconst, coeffn2Hn2plusconst, coeffn3Hn3crossconst, coeffn3Hn3plusconst)
-#pragma omp threadprivate(coeffn1Hn1pluscos,coeffn1Hn1plussin,coeffn2Hn2pluscos,coeffn2Hn2plussin,coeffn3Hn3pluscos,coeffn3Hn3plussin)
-#pragma omp threadprivate(coeffn1Hn1crosscos,coeffn1Hn1crosssin,coeffn2Hn2crosscos,coeffn2Hn2crosssin,coeffn3Hn3crosscos,coeffn3Hn3crosssin)
-#pragma omp threadprivate(coeffkn1const, coeffkn2const, coeffkn3const, coeffkp1plusp2const, coeffkp2plusp3const, coeffkp3plusp1const, coeffkp1const, coeffkp2const, coeffkp3const, coeffkRconst)
-#pragma omp threadprivate(coeffkn1cos,coeffkn1sin,coeffkn2cos,coeffkn2sin,coeffkn3cos,coeffkn3sin)
-#pragma omp threadprivate(coeffkp1cos,coeffkp1sin,coeffkp2cos,coeffkp2sin,coeffkp3cos,coeffkp3sin)
-#pragma omp threadprivate(coeffkp1plusp2cos,coeffkp1plusp2sin,coeffkp2plusp3cos,coeffkp2plusp3sin,coeffkp3plusp1cos,coeffkp3plusp1sin)
-#pragma omp threadprivate(coeffkRcos,coeffkRsin,cosarray,sinarray)
-
 /*************************************************************/
 /********* Functions for the geometric response **************/
 
@@ -229,7 +181,7 @@ double sinc(const double x) {
 }
 
 /* Function to compute, given a value of a sky position and polarization, all the complicated time-independent trigonometric coefficients entering the response */
-void SetCoeffsG(const double lambda, const double beta, const double psi) {
+void SetCoeffsG(LISAGeometricCoeffs* coeffs, const double lambda, const double beta, const double psi) {
   /* Precomputing cosines and sines */
   double coslambda = cos(lambda);
   double sinlambda = sin(lambda);
@@ -240,239 +192,239 @@ void SetCoeffsG(const double lambda, const double beta, const double psi) {
 
   /* Projection coefficients for hplus in n3.H.n3 */
   /**/
-  coeffn3Hn3plusconst = 1./128 * (-4*cospsi*cospsi + 4*sinpsi*sinpsi -27*coslambda*coslambda*cospsi*cospsi -27*sinlambda*sinlambda*sinpsi*sinpsi -4*cosbeta*cosbeta*cospsi*cospsi -4*sinbeta*sinbeta*sinpsi*sinpsi + 4*cosbeta*cosbeta*sinpsi*sinpsi + 4*cospsi*cospsi*sinbeta*sinbeta + 27*coslambda*coslambda*sinpsi*sinpsi + 27*cospsi*cospsi*sinlambda*sinlambda -9*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -9*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -9*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -9*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 9*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 9*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -54*sqrt3*coslambda*sinlambda*sinpsi*sinpsi + 54*sqrt3*coslambda*cospsi*cospsi*sinlambda -144*coslambda*cospsi*sinbeta*sinlambda*sinpsi -72*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi -18*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 18*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + 18*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 72*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3plusconst = 1./128 * (-4*cospsi*cospsi + 4*sinpsi*sinpsi -27*coslambda*coslambda*cospsi*cospsi -27*sinlambda*sinlambda*sinpsi*sinpsi -4*cosbeta*cosbeta*cospsi*cospsi -4*sinbeta*sinbeta*sinpsi*sinpsi + 4*cosbeta*cosbeta*sinpsi*sinpsi + 4*cospsi*cospsi*sinbeta*sinbeta + 27*coslambda*coslambda*sinpsi*sinpsi + 27*cospsi*cospsi*sinlambda*sinlambda -9*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -9*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -9*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -9*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 9*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 9*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -54*sqrt3*coslambda*sinlambda*sinpsi*sinpsi + 54*sqrt3*coslambda*cospsi*cospsi*sinlambda -144*coslambda*cospsi*sinbeta*sinlambda*sinpsi -72*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi -18*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 18*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + 18*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 72*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3pluscos[0] = 1./16*cosbeta * (-9*cospsi*cospsi*sinbeta*sinlambda + 9*sinbeta*sinlambda*sinpsi*sinpsi + 18*coslambda*cospsi*sinpsi -7*sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 7*sqrt3*coslambda*cospsi*cospsi*sinbeta + 14*sqrt3*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3pluscos[0] = 1./16*cosbeta * (-9*cospsi*cospsi*sinbeta*sinlambda + 9*sinbeta*sinlambda*sinpsi*sinpsi + 18*coslambda*cospsi*sinpsi -7*sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 7*sqrt3*coslambda*cospsi*cospsi*sinbeta + 14*sqrt3*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3pluscos[1] = -3./64 * (-3*sinpsi*sinpsi + 3*cospsi*cospsi -6*coslambda*coslambda*cospsi*cospsi -6*sinlambda*sinlambda*sinpsi*sinpsi -3*cosbeta*cosbeta*sinpsi*sinpsi -3*cospsi*cospsi*sinbeta*sinbeta + 3*cosbeta*cosbeta*cospsi*cospsi + 3*sinbeta*sinbeta*sinpsi*sinpsi + 6*coslambda*coslambda*sinpsi*sinpsi + 6*cospsi*cospsi*sinlambda*sinlambda -2*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -2*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -2*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -2*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 2*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 2*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -32*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3pluscos[1] = -3./64 * (-3*sinpsi*sinpsi + 3*cospsi*cospsi -6*coslambda*coslambda*cospsi*cospsi -6*sinlambda*sinlambda*sinpsi*sinpsi -3*cosbeta*cosbeta*sinpsi*sinpsi -3*cospsi*cospsi*sinbeta*sinbeta + 3*cosbeta*cosbeta*cospsi*cospsi + 3*sinbeta*sinbeta*sinpsi*sinpsi + 6*coslambda*coslambda*sinpsi*sinpsi + 6*cospsi*cospsi*sinlambda*sinlambda -2*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -2*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -2*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -2*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 2*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 2*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -32*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3pluscos[2] = -1./16*cosbeta * (-6*coslambda*cospsi*sinpsi -3*sinbeta*sinlambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinbeta*sinlambda + sqrt3*coslambda*cospsi*cospsi*sinbeta -sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 2*sqrt3*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3pluscos[2] = -1./16*cosbeta * (-6*coslambda*cospsi*sinpsi -3*sinbeta*sinlambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinbeta*sinlambda + sqrt3*coslambda*cospsi*cospsi*sinbeta -sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 2*sqrt3*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3pluscos[3] = 1./128 * (-3*coslambda*coslambda*cospsi*cospsi -3*sinlambda*sinlambda*sinpsi*sinpsi + 3*coslambda*coslambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinlambda*sinlambda + cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -6*sqrt3*coslambda*cospsi*cospsi*sinlambda + 6*sqrt3*coslambda*sinlambda*sinpsi*sinpsi -16*coslambda*cospsi*sinbeta*sinlambda*sinpsi -8*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -2*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -2*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 2*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 8*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn3Hn3pluscos[3] = 1./128 * (-3*coslambda*coslambda*cospsi*cospsi -3*sinlambda*sinlambda*sinpsi*sinpsi + 3*coslambda*coslambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinlambda*sinlambda + cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -6*sqrt3*coslambda*cospsi*cospsi*sinlambda + 6*sqrt3*coslambda*sinlambda*sinpsi*sinpsi -16*coslambda*cospsi*sinbeta*sinlambda*sinpsi -8*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -2*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -2*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 2*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 8*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn3Hn3plussin[0] = -1./16*cosbeta * (-9*coslambda*sinbeta*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi*sinbeta + 18*cospsi*sinlambda*sinpsi + sqrt3*sinbeta*sinlambda*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinbeta*sinlambda + 2*sqrt3*coslambda*cospsi*sinpsi);
+  coeffs->coeffn3Hn3plussin[0] = -1./16*cosbeta * (-9*coslambda*sinbeta*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi*sinbeta + 18*cospsi*sinlambda*sinpsi + sqrt3*sinbeta*sinlambda*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinbeta*sinlambda + 2*sqrt3*coslambda*cospsi*sinpsi);
   /**/
-  coeffn3Hn3plussin[1] = 3./64 * (-3*sqrt3*sinpsi*sinpsi + 3*sqrt3*cospsi*cospsi -12*coslambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cosbeta*cosbeta*sinpsi*sinpsi -3*sqrt3*cospsi*cospsi*sinbeta*sinbeta + 3*sqrt3*cosbeta*cosbeta*cospsi*cospsi + 3*sqrt3*sinbeta*sinbeta*sinpsi*sinpsi + 12*coslambda*cospsi*cospsi*sinlambda -16*coslambda*coslambda*cospsi*sinbeta*sinpsi -4*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -4*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 4*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + 4*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 16*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3plussin[1] = 3./64 * (-3*sqrt3*sinpsi*sinpsi + 3*sqrt3*cospsi*cospsi -12*coslambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cosbeta*cosbeta*sinpsi*sinpsi -3*sqrt3*cospsi*cospsi*sinbeta*sinbeta + 3*sqrt3*cosbeta*cosbeta*cospsi*cospsi + 3*sqrt3*sinbeta*sinbeta*sinpsi*sinpsi + 12*coslambda*cospsi*cospsi*sinlambda -16*coslambda*coslambda*cospsi*sinbeta*sinpsi -4*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -4*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 4*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + 4*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 16*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3plussin[2] = 1./16*cosbeta * (-3*coslambda*sinbeta*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi*sinbeta + 6*cospsi*sinlambda*sinpsi + sqrt3*sinbeta*sinlambda*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinbeta*sinlambda + 2*sqrt3*coslambda*cospsi*sinpsi);
+  coeffs->coeffn3Hn3plussin[2] = 1./16*cosbeta * (-3*coslambda*sinbeta*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi*sinbeta + 6*cospsi*sinlambda*sinpsi + sqrt3*sinbeta*sinlambda*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinbeta*sinlambda + 2*sqrt3*coslambda*cospsi*sinpsi);
   /**/
-  coeffn3Hn3plussin[3] = 1./128 * (-6*coslambda*cospsi*cospsi*sinlambda -3*sqrt3*coslambda*coslambda*sinpsi*sinpsi -3*sqrt3*cospsi*cospsi*sinlambda*sinlambda + 3*sqrt3*coslambda*coslambda*cospsi*cospsi + 3*sqrt3*sinlambda*sinlambda*sinpsi*sinpsi + 6*coslambda*sinlambda*sinpsi*sinpsi + sqrt3*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi + sqrt3*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda + sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta + sqrt3*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -8*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -2*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -2*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi -sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi -sqrt3*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi -sqrt3*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda + 2*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 8*coslambda*coslambda*cospsi*sinbeta*sinpsi + 16*sqrt3*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3plussin[3] = 1./128 * (-6*coslambda*cospsi*cospsi*sinlambda -3*sqrt3*coslambda*coslambda*sinpsi*sinpsi -3*sqrt3*cospsi*cospsi*sinlambda*sinlambda + 3*sqrt3*coslambda*coslambda*cospsi*cospsi + 3*sqrt3*sinlambda*sinlambda*sinpsi*sinpsi + 6*coslambda*sinlambda*sinpsi*sinpsi + sqrt3*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi + sqrt3*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda + sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta + sqrt3*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -8*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -2*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -2*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi -sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi -sqrt3*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi -sqrt3*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda + 2*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 8*coslambda*coslambda*cospsi*sinbeta*sinpsi + 16*sqrt3*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
 
   /* Projection coefficients for hcross in n3.H.n3 */
   /**/
-  coeffn3Hn3crossconst = 1./64 * (4*cospsi*sinpsi -27*cospsi*sinlambda*sinlambda*sinpsi -4*cospsi*sinbeta*sinbeta*sinpsi + 4*cosbeta*cosbeta*cospsi*sinpsi + 27*coslambda*coslambda*cospsi*sinpsi -36*coslambda*cospsi*cospsi*sinbeta*sinlambda -18*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta -18*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -9*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -9*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 9*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 9*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 18*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi + 18*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 36*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -54*sqrt3*coslambda*cospsi*sinlambda*sinpsi -18*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3crossconst = 1./64 * (4*cospsi*sinpsi -27*cospsi*sinlambda*sinlambda*sinpsi -4*cospsi*sinbeta*sinbeta*sinpsi + 4*cosbeta*cosbeta*cospsi*sinpsi + 27*coslambda*coslambda*cospsi*sinpsi -36*coslambda*cospsi*cospsi*sinbeta*sinlambda -18*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta -18*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -9*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -9*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 9*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 9*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 18*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi + 18*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 36*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -54*sqrt3*coslambda*cospsi*sinlambda*sinpsi -18*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3crosscos[0] = 1./16*cosbeta * (-9*coslambda*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi -7*sqrt3*sinlambda*sinpsi*sinpsi + 7*sqrt3*cospsi*cospsi*sinlambda + 18*cospsi*sinbeta*sinlambda*sinpsi -14*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn3Hn3crosscos[0] = 1./16*cosbeta * (-9*coslambda*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi -7*sqrt3*sinlambda*sinpsi*sinpsi + 7*sqrt3*cospsi*cospsi*sinlambda + 18*cospsi*sinbeta*sinlambda*sinpsi -14*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn3Hn3crosscos[1] = -3./32 * (-3*cospsi*sinpsi -6*cospsi*sinlambda*sinlambda*sinpsi -3*cosbeta*cosbeta*cospsi*sinpsi + 3*cospsi*sinbeta*sinbeta*sinpsi + 6*coslambda*coslambda*cospsi*sinpsi -8*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -2*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 2*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 8*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn3Hn3crosscos[1] = -3./32 * (-3*cospsi*sinpsi -6*cospsi*sinlambda*sinlambda*sinpsi -3*cosbeta*cosbeta*cospsi*sinpsi + 3*cospsi*sinbeta*sinbeta*sinpsi + 6*coslambda*coslambda*cospsi*sinpsi -8*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -2*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 2*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 8*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn3Hn3crosscos[2] = 1./16*cosbeta * (-3*coslambda*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi + sqrt3*sinlambda*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinlambda + 6*cospsi*sinbeta*sinlambda*sinpsi + 2*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn3Hn3crosscos[2] = 1./16*cosbeta * (-3*coslambda*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi + sqrt3*sinlambda*sinpsi*sinpsi -sqrt3*cospsi*cospsi*sinlambda + 6*cospsi*sinbeta*sinlambda*sinpsi + 2*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn3Hn3crosscos[3] = 1./64 * (-3*cospsi*sinlambda*sinlambda*sinpsi + 3*coslambda*coslambda*cospsi*sinpsi + cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi -2*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda -cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta + 2*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi + 6*sqrt3*coslambda*cospsi*sinlambda*sinpsi -2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 2*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3crosscos[3] = 1./64 * (-3*cospsi*sinlambda*sinlambda*sinpsi + 3*coslambda*coslambda*cospsi*sinpsi + cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi -2*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda -cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta + 2*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi + 6*sqrt3*coslambda*cospsi*sinlambda*sinpsi -2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 2*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3crosssin[0] = -1./16*cosbeta * (-9*sinlambda*sinpsi*sinpsi + 9*cospsi*cospsi*sinlambda + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi -18*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3crosssin[0] = -1./16*cosbeta * (-9*sinlambda*sinpsi*sinpsi + 9*cospsi*cospsi*sinlambda + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi -18*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3crosssin[1] = -3./32 * (-4*coslambda*coslambda*sinbeta*sinpsi*sinpsi -4*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 3*sqrt3*cospsi*sinpsi + 4*coslambda*coslambda*cospsi*cospsi*sinbeta + 4*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cospsi*sinbeta*sinbeta*sinpsi + 3*sqrt3*cosbeta*cosbeta*cospsi*sinpsi + 12*coslambda*cospsi*sinlambda*sinpsi -4*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 4*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3crosssin[1] = -3./32 * (-4*coslambda*coslambda*sinbeta*sinpsi*sinpsi -4*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 3*sqrt3*cospsi*sinpsi + 4*coslambda*coslambda*cospsi*cospsi*sinbeta + 4*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cospsi*sinbeta*sinbeta*sinpsi + 3*sqrt3*cosbeta*cosbeta*cospsi*sinpsi + 12*coslambda*cospsi*sinlambda*sinpsi -4*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 4*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3crosssin[2] = 1./16*cosbeta * (-3*sinlambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinlambda + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi -6*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn3Hn3crosssin[2] = 1./16*cosbeta * (-3*sinlambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinlambda + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi -6*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn3Hn3crosssin[3] = 1./64 * (-2*coslambda*coslambda*sinbeta*sinpsi*sinpsi -2*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 2*coslambda*coslambda*cospsi*cospsi*sinbeta + 2*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*coslambda*coslambda*cospsi*sinpsi + 3*sqrt3*cospsi*sinlambda*sinlambda*sinpsi + 6*coslambda*cospsi*sinlambda*sinpsi + sqrt3*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi + sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi -4*sqrt3*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -2*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi -sqrt3*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi -sqrt3*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 2*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 4*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinlambda);
+  coeffs->coeffn3Hn3crosssin[3] = 1./64 * (-2*coslambda*coslambda*sinbeta*sinpsi*sinpsi -2*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 2*coslambda*coslambda*cospsi*cospsi*sinbeta + 2*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*coslambda*coslambda*cospsi*sinpsi + 3*sqrt3*cospsi*sinlambda*sinlambda*sinpsi + 6*coslambda*cospsi*sinlambda*sinpsi + sqrt3*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi + sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi -4*sqrt3*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -2*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi -sqrt3*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi -sqrt3*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 2*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 4*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinlambda);
 
   /* Projection coefficients for hplus in n2.H.n2 */
   /**/
-  coeffn2Hn2plusconst = 1./128 * (-4*cospsi*cospsi + 4*sinpsi*sinpsi -27*coslambda*coslambda*cospsi*cospsi -27*sinlambda*sinlambda*sinpsi*sinpsi -4*cosbeta*cosbeta*cospsi*cospsi -4*sinbeta*sinbeta*sinpsi*sinpsi + 4*cosbeta*cosbeta*sinpsi*sinpsi + 4*cospsi*cospsi*sinbeta*sinbeta + 27*coslambda*coslambda*sinpsi*sinpsi + 27*cospsi*cospsi*sinlambda*sinlambda -9*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -9*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -9*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -9*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 9*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 9*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -54*sqrt3*coslambda*cospsi*cospsi*sinlambda + 54*sqrt3*coslambda*sinlambda*sinpsi*sinpsi -144*coslambda*cospsi*sinbeta*sinlambda*sinpsi -72*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -18*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -18*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 18*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 72*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn2Hn2plusconst = 1./128 * (-4*cospsi*cospsi + 4*sinpsi*sinpsi -27*coslambda*coslambda*cospsi*cospsi -27*sinlambda*sinlambda*sinpsi*sinpsi -4*cosbeta*cosbeta*cospsi*cospsi -4*sinbeta*sinbeta*sinpsi*sinpsi + 4*cosbeta*cosbeta*sinpsi*sinpsi + 4*cospsi*cospsi*sinbeta*sinbeta + 27*coslambda*coslambda*sinpsi*sinpsi + 27*cospsi*cospsi*sinlambda*sinlambda -9*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -9*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -9*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -9*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 9*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 9*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 9*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -54*sqrt3*coslambda*cospsi*cospsi*sinlambda + 54*sqrt3*coslambda*sinlambda*sinpsi*sinpsi -144*coslambda*cospsi*sinbeta*sinlambda*sinpsi -72*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -18*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -18*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 18*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 72*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn2Hn2pluscos[0] = 1./16*cosbeta * (-18*coslambda*cospsi*sinpsi -9*sinbeta*sinlambda*sinpsi*sinpsi + 9*cospsi*cospsi*sinbeta*sinlambda -7*sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 7*sqrt3*coslambda*cospsi*cospsi*sinbeta + 14*sqrt3*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2pluscos[0] = 1./16*cosbeta * (-18*coslambda*cospsi*sinpsi -9*sinbeta*sinlambda*sinpsi*sinpsi + 9*cospsi*cospsi*sinbeta*sinlambda -7*sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 7*sqrt3*coslambda*cospsi*cospsi*sinbeta + 14*sqrt3*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2pluscos[1] = -3./64 * (-3*sinpsi*sinpsi + 3*cospsi*cospsi -6*coslambda*coslambda*cospsi*cospsi -6*sinlambda*sinlambda*sinpsi*sinpsi -3*cosbeta*cosbeta*sinpsi*sinpsi -3*cospsi*cospsi*sinbeta*sinbeta + 3*cosbeta*cosbeta*cospsi*cospsi + 3*sinbeta*sinbeta*sinpsi*sinpsi + 6*coslambda*coslambda*sinpsi*sinpsi + 6*cospsi*cospsi*sinlambda*sinlambda -2*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -2*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -2*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -2*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 2*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 2*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -32*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2pluscos[1] = -3./64 * (-3*sinpsi*sinpsi + 3*cospsi*cospsi -6*coslambda*coslambda*cospsi*cospsi -6*sinlambda*sinlambda*sinpsi*sinpsi -3*cosbeta*cosbeta*sinpsi*sinpsi -3*cospsi*cospsi*sinbeta*sinbeta + 3*cosbeta*cosbeta*cospsi*cospsi + 3*sinbeta*sinbeta*sinpsi*sinpsi + 6*coslambda*coslambda*sinpsi*sinpsi + 6*cospsi*cospsi*sinlambda*sinlambda -2*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -2*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -2*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -2*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + 2*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + 2*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -32*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2pluscos[2] = -1./16*cosbeta * (-3*cospsi*cospsi*sinbeta*sinlambda + 3*sinbeta*sinlambda*sinpsi*sinpsi + 6*coslambda*cospsi*sinpsi + sqrt3*coslambda*cospsi*cospsi*sinbeta -sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 2*sqrt3*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2pluscos[2] = -1./16*cosbeta * (-3*cospsi*cospsi*sinbeta*sinlambda + 3*sinbeta*sinlambda*sinpsi*sinpsi + 6*coslambda*cospsi*sinpsi + sqrt3*coslambda*cospsi*cospsi*sinbeta -sqrt3*coslambda*sinbeta*sinpsi*sinpsi + 2*sqrt3*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2pluscos[3] = 1./128 * (-3*coslambda*coslambda*cospsi*cospsi -3*sinlambda*sinlambda*sinpsi*sinpsi + 3*coslambda*coslambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinlambda*sinlambda + cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -6*sqrt3*coslambda*sinlambda*sinpsi*sinpsi + 6*sqrt3*coslambda*cospsi*cospsi*sinlambda -16*coslambda*cospsi*sinbeta*sinlambda*sinpsi -8*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi -2*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 2*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + 2*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 8*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2pluscos[3] = 1./128 * (-3*coslambda*coslambda*cospsi*cospsi -3*sinlambda*sinlambda*sinpsi*sinpsi + 3*coslambda*coslambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinlambda*sinlambda + cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -6*sqrt3*coslambda*sinlambda*sinpsi*sinpsi + 6*sqrt3*coslambda*cospsi*cospsi*sinlambda -16*coslambda*cospsi*sinbeta*sinlambda*sinpsi -8*sqrt3*coslambda*coslambda*cospsi*sinbeta*sinpsi -2*sqrt3*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 2*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + 2*sqrt3*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 8*sqrt3*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2plussin[0] = 1./16*cosbeta * (-9*coslambda*sinbeta*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi*sinbeta + 18*cospsi*sinlambda*sinpsi + sqrt3*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*cospsi*sinpsi -sqrt3*sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn2Hn2plussin[0] = 1./16*cosbeta * (-9*coslambda*sinbeta*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi*sinbeta + 18*cospsi*sinlambda*sinpsi + sqrt3*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*cospsi*sinpsi -sqrt3*sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn2Hn2plussin[1] = -3./64 * (-3*sqrt3*sinpsi*sinpsi + 3*sqrt3*cospsi*cospsi -12*coslambda*cospsi*cospsi*sinlambda -3*sqrt3*cosbeta*cosbeta*sinpsi*sinpsi -3*sqrt3*cospsi*cospsi*sinbeta*sinbeta + 3*sqrt3*cosbeta*cosbeta*cospsi*cospsi + 3*sqrt3*sinbeta*sinbeta*sinpsi*sinpsi + 12*coslambda*sinlambda*sinpsi*sinpsi -16*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -4*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 4*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 4*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 16*coslambda*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn2Hn2plussin[1] = -3./64 * (-3*sqrt3*sinpsi*sinpsi + 3*sqrt3*cospsi*cospsi -12*coslambda*cospsi*cospsi*sinlambda -3*sqrt3*cosbeta*cosbeta*sinpsi*sinpsi -3*sqrt3*cospsi*cospsi*sinbeta*sinbeta + 3*sqrt3*cosbeta*cosbeta*cospsi*cospsi + 3*sqrt3*sinbeta*sinbeta*sinpsi*sinpsi + 12*coslambda*sinlambda*sinpsi*sinpsi -16*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -4*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 4*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 4*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 16*coslambda*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn2Hn2plussin[2] = -1./16*cosbeta * (-3*coslambda*sinbeta*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi*sinbeta + 6*cospsi*sinlambda*sinpsi + sqrt3*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*cospsi*sinpsi -sqrt3*sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn2Hn2plussin[2] = -1./16*cosbeta * (-3*coslambda*sinbeta*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi*sinbeta + 6*cospsi*sinlambda*sinpsi + sqrt3*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*cospsi*sinpsi -sqrt3*sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn2Hn2plussin[3] = 1./128 * (-6*coslambda*cospsi*cospsi*sinlambda -3*sqrt3*coslambda*coslambda*cospsi*cospsi -3*sqrt3*sinlambda*sinlambda*sinpsi*sinpsi + 3*sqrt3*coslambda*coslambda*sinpsi*sinpsi + 3*sqrt3*cospsi*cospsi*sinlambda*sinlambda + 6*coslambda*sinlambda*sinpsi*sinpsi + sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + sqrt3*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + sqrt3*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + sqrt3*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -8*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -2*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -2*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi -sqrt3*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -sqrt3*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sqrt3*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 8*coslambda*coslambda*cospsi*sinbeta*sinpsi -16*sqrt3*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2plussin[3] = 1./128 * (-6*coslambda*cospsi*cospsi*sinlambda -3*sqrt3*coslambda*coslambda*cospsi*cospsi -3*sqrt3*sinlambda*sinlambda*sinpsi*sinpsi + 3*sqrt3*coslambda*coslambda*sinpsi*sinpsi + 3*sqrt3*cospsi*cospsi*sinlambda*sinlambda + 6*coslambda*sinlambda*sinpsi*sinpsi + sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + sqrt3*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + sqrt3*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + sqrt3*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -8*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -2*coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -2*cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi -sqrt3*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -sqrt3*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sqrt3*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 2*coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + 2*cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 8*coslambda*coslambda*cospsi*sinbeta*sinpsi -16*sqrt3*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
 
   /* Projection coefficients for hcross in n2.H.n2 */
   /**/
-  coeffn2Hn2crossconst = 1./64 * (4*cospsi*sinpsi -27*cospsi*sinlambda*sinlambda*sinpsi -4*cospsi*sinbeta*sinbeta*sinpsi + 4*cosbeta*cosbeta*cospsi*sinpsi + 27*coslambda*coslambda*cospsi*sinpsi -36*coslambda*cospsi*cospsi*sinbeta*sinlambda -18*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi -18*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda -9*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -9*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 9*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 9*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 18*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta + 18*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 36*coslambda*sinbeta*sinlambda*sinpsi*sinpsi + 54*sqrt3*coslambda*cospsi*sinlambda*sinpsi -18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 18*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2crossconst = 1./64 * (4*cospsi*sinpsi -27*cospsi*sinlambda*sinlambda*sinpsi -4*cospsi*sinbeta*sinbeta*sinpsi + 4*cosbeta*cosbeta*cospsi*sinpsi + 27*coslambda*coslambda*cospsi*sinpsi -36*coslambda*cospsi*cospsi*sinbeta*sinlambda -18*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi -18*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda -9*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -9*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 9*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 9*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 18*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta + 18*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 36*coslambda*sinbeta*sinlambda*sinpsi*sinpsi + 54*sqrt3*coslambda*cospsi*sinlambda*sinpsi -18*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 18*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2crosscos[0] = -1./16*cosbeta * (-9*coslambda*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi -7*sqrt3*cospsi*cospsi*sinlambda + 7*sqrt3*sinlambda*sinpsi*sinpsi + 18*cospsi*sinbeta*sinlambda*sinpsi + 14*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn2Hn2crosscos[0] = -1./16*cosbeta * (-9*coslambda*sinpsi*sinpsi + 9*coslambda*cospsi*cospsi -7*sqrt3*cospsi*cospsi*sinlambda + 7*sqrt3*sinlambda*sinpsi*sinpsi + 18*cospsi*sinbeta*sinlambda*sinpsi + 14*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn2Hn2crosscos[1] = -3./32 * (-3*cospsi*sinpsi -6*cospsi*sinlambda*sinlambda*sinpsi -3*cosbeta*cosbeta*cospsi*sinpsi + 3*cospsi*sinbeta*sinbeta*sinpsi + 6*coslambda*coslambda*cospsi*sinpsi -8*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -2*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 2*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 8*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn2Hn2crosscos[1] = -3./32 * (-3*cospsi*sinpsi -6*cospsi*sinlambda*sinlambda*sinpsi -3*cosbeta*cosbeta*cospsi*sinpsi + 3*cospsi*sinbeta*sinbeta*sinpsi + 6*coslambda*coslambda*cospsi*sinpsi -8*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -2*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + 2*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 8*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn2Hn2crosscos[2] = -1./16*cosbeta * (-3*coslambda*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi + sqrt3*cospsi*cospsi*sinlambda -sqrt3*sinlambda*sinpsi*sinpsi + 6*cospsi*sinbeta*sinlambda*sinpsi -2*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn2Hn2crosscos[2] = -1./16*cosbeta * (-3*coslambda*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi + sqrt3*cospsi*cospsi*sinlambda -sqrt3*sinlambda*sinpsi*sinpsi + 6*cospsi*sinbeta*sinlambda*sinpsi -2*sqrt3*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn2Hn2crosscos[3] = 1./64 * (-3*cospsi*sinlambda*sinlambda*sinpsi + 3*coslambda*coslambda*cospsi*sinpsi + cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta -2*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi + 2*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -6*sqrt3*coslambda*cospsi*sinlambda*sinpsi -2*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2crosscos[3] = 1./64 * (-3*cospsi*sinlambda*sinlambda*sinpsi + 3*coslambda*coslambda*cospsi*sinpsi + cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*sqrt3*coslambda*coslambda*cospsi*cospsi*sinbeta -2*sqrt3*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*sqrt3*coslambda*coslambda*sinbeta*sinpsi*sinpsi + 2*sqrt3*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -6*sqrt3*coslambda*cospsi*sinlambda*sinpsi -2*sqrt3*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 2*sqrt3*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2crosssin[0] = -1./16*cosbeta * (-9*cospsi*cospsi*sinlambda + 9*sinlambda*sinpsi*sinpsi + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi + 18*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2crosssin[0] = -1./16*cosbeta * (-9*cospsi*cospsi*sinlambda + 9*sinlambda*sinpsi*sinpsi + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi + 18*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2crosssin[1] = -3./32 * (-4*coslambda*coslambda*sinbeta*sinpsi*sinpsi -4*cospsi*cospsi*sinbeta*sinlambda*sinlambda -3*sqrt3*cospsi*sinpsi + 4*coslambda*coslambda*cospsi*cospsi*sinbeta + 4*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cosbeta*cosbeta*cospsi*sinpsi + 3*sqrt3*cospsi*sinbeta*sinbeta*sinpsi + 12*coslambda*cospsi*sinlambda*sinpsi -4*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 4*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2crosssin[1] = -3./32 * (-4*coslambda*coslambda*sinbeta*sinpsi*sinpsi -4*cospsi*cospsi*sinbeta*sinlambda*sinlambda -3*sqrt3*cospsi*sinpsi + 4*coslambda*coslambda*cospsi*cospsi*sinbeta + 4*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cosbeta*cosbeta*cospsi*sinpsi + 3*sqrt3*cospsi*sinbeta*sinbeta*sinpsi + 12*coslambda*cospsi*sinlambda*sinpsi -4*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi + 4*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2crosssin[2] = 1./16*cosbeta * (-3*cospsi*cospsi*sinlambda + 3*sinlambda*sinpsi*sinpsi + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi + 6*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn2Hn2crosssin[2] = 1./16*cosbeta * (-3*cospsi*cospsi*sinlambda + 3*sinlambda*sinpsi*sinpsi + sqrt3*coslambda*cospsi*cospsi -sqrt3*coslambda*sinpsi*sinpsi + 6*coslambda*cospsi*sinbeta*sinpsi + 2*sqrt3*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn2Hn2crosssin[3] = 1./64 * (-2*coslambda*coslambda*sinbeta*sinpsi*sinpsi -2*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 2*coslambda*coslambda*cospsi*cospsi*sinbeta + 2*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cospsi*sinlambda*sinlambda*sinpsi + 3*sqrt3*coslambda*coslambda*cospsi*sinpsi + 6*coslambda*cospsi*sinlambda*sinpsi + sqrt3*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + sqrt3*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi -sqrt3*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 4*sqrt3*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn2Hn2crosssin[3] = 1./64 * (-2*coslambda*coslambda*sinbeta*sinpsi*sinpsi -2*cospsi*cospsi*sinbeta*sinlambda*sinlambda + 2*coslambda*coslambda*cospsi*cospsi*sinbeta + 2*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*sqrt3*cospsi*sinlambda*sinlambda*sinpsi + 3*sqrt3*coslambda*coslambda*cospsi*sinpsi + 6*coslambda*cospsi*sinlambda*sinpsi + sqrt3*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + sqrt3*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*sqrt3*coslambda*cospsi*cospsi*sinbeta*sinlambda -2*cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi -sqrt3*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -sqrt3*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 2*coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi + 4*sqrt3*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
 
   /* Projection coefficients for hplus in n1.H.n1 */
   /**/
-  coeffn1Hn1plusconst = 1./64 * (-2*cospsi*cospsi + 2*sinpsi*sinpsi -27*coslambda*coslambda*sinpsi*sinpsi -27*cospsi*cospsi*sinlambda*sinlambda -2*cosbeta*cosbeta*cospsi*cospsi -2*sinbeta*sinbeta*sinpsi*sinpsi + 2*cosbeta*cosbeta*sinpsi*sinpsi + 2*cospsi*cospsi*sinbeta*sinbeta + 27*coslambda*coslambda*cospsi*cospsi + 27*sinlambda*sinlambda*sinpsi*sinpsi -9*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi -9*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi -9*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi -9*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda + 9*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi + 9*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda + 9*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta + 9*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 144*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1plusconst = 1./64 * (-2*cospsi*cospsi + 2*sinpsi*sinpsi -27*coslambda*coslambda*sinpsi*sinpsi -27*cospsi*cospsi*sinlambda*sinlambda -2*cosbeta*cosbeta*cospsi*cospsi -2*sinbeta*sinbeta*sinpsi*sinpsi + 2*cosbeta*cosbeta*sinpsi*sinpsi + 2*cospsi*cospsi*sinbeta*sinbeta + 27*coslambda*coslambda*cospsi*cospsi + 27*sinlambda*sinlambda*sinpsi*sinpsi -9*cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi -9*cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi -9*coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi -9*cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda + 9*cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi + 9*cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda + 9*coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta + 9*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi + 144*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1pluscos[0] = -1./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi*sinbeta -coslambda*sinbeta*sinpsi*sinpsi + 2*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1pluscos[0] = -1./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi*sinbeta -coslambda*sinbeta*sinpsi*sinpsi + 2*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1pluscos[1] = -3./32 * (-3*cospsi*cospsi + 3*sinpsi*sinpsi -3*cosbeta*cosbeta*cospsi*cospsi -3*coslambda*coslambda*cospsi*cospsi -3*sinbeta*sinbeta*sinpsi*sinpsi -3*sinlambda*sinlambda*sinpsi*sinpsi + 3*cosbeta*cosbeta*sinpsi*sinpsi + 3*coslambda*coslambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinbeta*sinbeta + 3*cospsi*cospsi*sinlambda*sinlambda + cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -16*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1pluscos[1] = -3./32 * (-3*cospsi*cospsi + 3*sinpsi*sinpsi -3*cosbeta*cosbeta*cospsi*cospsi -3*coslambda*coslambda*cospsi*cospsi -3*sinbeta*sinbeta*sinpsi*sinpsi -3*sinlambda*sinlambda*sinpsi*sinpsi + 3*cosbeta*cosbeta*sinpsi*sinpsi + 3*coslambda*coslambda*sinpsi*sinpsi + 3*cospsi*cospsi*sinbeta*sinbeta + 3*cospsi*cospsi*sinlambda*sinlambda + cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi + cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi + coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda -cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta -sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -16*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1pluscos[2] = 1./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi*sinbeta -coslambda*sinbeta*sinpsi*sinpsi + 2*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1pluscos[2] = 1./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi*sinbeta -coslambda*sinbeta*sinpsi*sinpsi + 2*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1pluscos[3] = 1./64 * (-3*coslambda*coslambda*sinpsi*sinpsi -3*cospsi*cospsi*sinlambda*sinlambda + 3*coslambda*coslambda*cospsi*cospsi + 3*sinlambda*sinlambda*sinpsi*sinpsi + cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi + cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda + coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta + sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi -cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi -coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi -cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda + 16*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1pluscos[3] = 1./64 * (-3*coslambda*coslambda*sinpsi*sinpsi -3*cospsi*cospsi*sinlambda*sinlambda + 3*coslambda*coslambda*cospsi*cospsi + 3*sinlambda*sinlambda*sinpsi*sinpsi + cosbeta*cosbeta*coslambda*coslambda*sinpsi*sinpsi + cosbeta*cosbeta*cospsi*cospsi*sinlambda*sinlambda + coslambda*coslambda*cospsi*cospsi*sinbeta*sinbeta + sinbeta*sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*cospsi -cosbeta*cosbeta*sinlambda*sinlambda*sinpsi*sinpsi -coslambda*coslambda*sinbeta*sinbeta*sinpsi*sinpsi -cospsi*cospsi*sinbeta*sinbeta*sinlambda*sinlambda + 16*coslambda*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1plussin[0] = 5./8*sqrt3*cosbeta * (cospsi*cospsi*sinbeta*sinlambda -2*coslambda*cospsi*sinpsi -sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn1Hn1plussin[0] = 5./8*sqrt3*cosbeta * (cospsi*cospsi*sinbeta*sinlambda -2*coslambda*cospsi*sinpsi -sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn1Hn1plussin[1] = -3./16 * (-3*coslambda*cospsi*cospsi*sinlambda + 3*coslambda*sinlambda*sinpsi*sinpsi + coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda -4*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 4*coslambda*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn1Hn1plussin[1] = -3./16 * (-3*coslambda*cospsi*cospsi*sinlambda + 3*coslambda*sinlambda*sinpsi*sinpsi + coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi + cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda -4*cospsi*sinbeta*sinlambda*sinlambda*sinpsi -coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda -cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi + 4*coslambda*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn1Hn1plussin[2] = 1./8*sqrt3*cosbeta * (cospsi*cospsi*sinbeta*sinlambda -2*coslambda*cospsi*sinpsi -sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn1Hn1plussin[2] = 1./8*sqrt3*cosbeta * (cospsi*cospsi*sinbeta*sinlambda -2*coslambda*cospsi*sinpsi -sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn1Hn1plussin[3] = 1./32 * (-3*coslambda*sinlambda*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi*sinlambda + coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi -4*coslambda*coslambda*cospsi*sinbeta*sinpsi -coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 4*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1plussin[3] = 1./32 * (-3*coslambda*sinlambda*sinpsi*sinpsi + 3*coslambda*cospsi*cospsi*sinlambda + coslambda*cospsi*cospsi*sinbeta*sinbeta*sinlambda + cosbeta*cosbeta*coslambda*sinlambda*sinpsi*sinpsi -4*coslambda*coslambda*cospsi*sinbeta*sinpsi -coslambda*sinbeta*sinbeta*sinlambda*sinpsi*sinpsi -cosbeta*cosbeta*coslambda*cospsi*cospsi*sinlambda + 4*cospsi*sinbeta*sinlambda*sinlambda*sinpsi);
 
   /* Projection coefficients for hcross in n1.H.n1 */
   /**/
-  coeffn1Hn1crossconst = 1./32 * (2*cospsi*sinpsi -27*coslambda*coslambda*cospsi*sinpsi -2*cospsi*sinbeta*sinbeta*sinpsi + 2*cosbeta*cosbeta*cospsi*sinpsi + 27*cospsi*sinlambda*sinlambda*sinpsi -36*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -9*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi -9*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 9*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi + 9*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 36*coslambda*cospsi*cospsi*sinbeta*sinlambda);
+  coeffs->coeffn1Hn1crossconst = 1./32 * (2*cospsi*sinpsi -27*coslambda*coslambda*cospsi*sinpsi -2*cospsi*sinbeta*sinbeta*sinpsi + 2*cosbeta*cosbeta*cospsi*sinpsi + 27*cospsi*sinlambda*sinlambda*sinpsi -36*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -9*cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi -9*coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 9*cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi + 9*cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 36*coslambda*cospsi*cospsi*sinbeta*sinlambda);
   /**/
-  coeffn1Hn1crosscos[0] = -1./8*sqrt3*cosbeta * (cospsi*cospsi*sinlambda -sinlambda*sinpsi*sinpsi -2*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn1Hn1crosscos[0] = -1./8*sqrt3*cosbeta * (cospsi*cospsi*sinlambda -sinlambda*sinpsi*sinpsi -2*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn1Hn1crosscos[1] = -3./16 * (3*cospsi*sinpsi -3*cospsi*sinbeta*sinbeta*sinpsi -3*cospsi*sinlambda*sinlambda*sinpsi + 3*cosbeta*cosbeta*cospsi*sinpsi + 3*coslambda*coslambda*cospsi*sinpsi + cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinlambda -cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
+  coeffs->coeffn1Hn1crosscos[1] = -3./16 * (3*cospsi*sinpsi -3*cospsi*sinbeta*sinbeta*sinpsi -3*cospsi*sinlambda*sinlambda*sinpsi + 3*cosbeta*cosbeta*cospsi*sinpsi + 3*coslambda*coslambda*cospsi*sinpsi + cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi + coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi -4*coslambda*cospsi*cospsi*sinbeta*sinlambda -cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi + 4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi);
   /**/
-  coeffn1Hn1crosscos[2] = 1./8*sqrt3*cosbeta * (cospsi*cospsi*sinlambda -sinlambda*sinpsi*sinpsi -2*coslambda*cospsi*sinbeta*sinpsi);
+  coeffs->coeffn1Hn1crosscos[2] = 1./8*sqrt3*cosbeta * (cospsi*cospsi*sinlambda -sinlambda*sinpsi*sinpsi -2*coslambda*cospsi*sinbeta*sinpsi);
   /**/
-  coeffn1Hn1crosscos[3] = 1./32 * (-3*coslambda*coslambda*cospsi*sinpsi + 3*cospsi*sinlambda*sinlambda*sinpsi + cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi + cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi -4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi -coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 4*coslambda*cospsi*cospsi*sinbeta*sinlambda);
+  coeffs->coeffn1Hn1crosscos[3] = 1./32 * (-3*coslambda*coslambda*cospsi*sinpsi + 3*cospsi*sinlambda*sinlambda*sinpsi + cospsi*sinbeta*sinbeta*sinlambda*sinlambda*sinpsi + cosbeta*cosbeta*coslambda*coslambda*cospsi*sinpsi -4*coslambda*sinbeta*sinlambda*sinpsi*sinpsi -cosbeta*cosbeta*cospsi*sinlambda*sinlambda*sinpsi -coslambda*coslambda*cospsi*sinbeta*sinbeta*sinpsi + 4*coslambda*cospsi*cospsi*sinbeta*sinlambda);
   /**/
-  coeffn1Hn1crosssin[0] = -5./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi -coslambda*sinpsi*sinpsi + 2*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1crosssin[0] = -5./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi -coslambda*sinpsi*sinpsi + 2*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1crosssin[1] = -3./8 * (coslambda*coslambda*cospsi*cospsi*sinbeta + sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -coslambda*coslambda*sinbeta*sinpsi*sinpsi -cospsi*cospsi*sinbeta*sinlambda*sinlambda + 3*coslambda*cospsi*sinlambda*sinpsi + coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1crosssin[1] = -3./8 * (coslambda*coslambda*cospsi*cospsi*sinbeta + sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -coslambda*coslambda*sinbeta*sinpsi*sinpsi -cospsi*cospsi*sinbeta*sinlambda*sinlambda + 3*coslambda*cospsi*sinlambda*sinpsi + coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi -cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1crosssin[2] = -1./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi -coslambda*sinpsi*sinpsi + 2*cospsi*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1crosssin[2] = -1./8*sqrt3*cosbeta * (coslambda*cospsi*cospsi -coslambda*sinpsi*sinpsi + 2*cospsi*sinbeta*sinlambda*sinpsi);
   /**/
-  coeffn1Hn1crosssin[3] = 1./16 * (coslambda*coslambda*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta -sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*coslambda*cospsi*sinlambda*sinpsi + cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi -coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
+  coeffs->coeffn1Hn1crosssin[3] = 1./16 * (coslambda*coslambda*sinbeta*sinpsi*sinpsi + cospsi*cospsi*sinbeta*sinlambda*sinlambda -coslambda*coslambda*cospsi*cospsi*sinbeta -sinbeta*sinlambda*sinlambda*sinpsi*sinpsi -3*coslambda*cospsi*sinlambda*sinpsi + cosbeta*cosbeta*coslambda*cospsi*sinlambda*sinpsi -coslambda*cospsi*sinbeta*sinbeta*sinlambda*sinpsi);
 
   /* Coefficients in k.n3 */
   /**/
-  coeffkn3const = 3./8*cosbeta * (sinlambda -sqrt3*coslambda);
+  coeffs->coeffkn3const = 3./8*cosbeta * (sinlambda -sqrt3*coslambda);
   /**/
-  coeffkn3cos[0] = 3./4 * (-sinbeta);
+  coeffs->coeffkn3cos[0] = 3./4 * (-sinbeta);
   /**/
-  coeffkn3cos[1] = -1./8*cosbeta * (-sinlambda -sqrt3*coslambda);
+  coeffs->coeffkn3cos[1] = -1./8*cosbeta * (-sinlambda -sqrt3*coslambda);
   /**/
-  coeffkn3sin[0] = -1./4*sqrt3 * (-sinbeta);
+  coeffs->coeffkn3sin[0] = -1./4*sqrt3 * (-sinbeta);
   /**/
-  coeffkn3sin[1] = 1./8*cosbeta * (-coslambda + sqrt3*sinlambda);
+  coeffs->coeffkn3sin[1] = 1./8*cosbeta * (-coslambda + sqrt3*sinlambda);
 
   /* Coefficients in k.n2 */
   /**/
-  coeffkn2const = -3./8*cosbeta * (-sinlambda -sqrt3*coslambda);
+  coeffs->coeffkn2const = -3./8*cosbeta * (-sinlambda -sqrt3*coslambda);
   /**/
-  coeffkn2cos[0] = -3./4 * (-sinbeta);
+  coeffs->coeffkn2cos[0] = -3./4 * (-sinbeta);
   /**/
-  coeffkn2cos[1] = 1./8*cosbeta * (sinlambda -sqrt3*coslambda);
+  coeffs->coeffkn2cos[1] = 1./8*cosbeta * (sinlambda -sqrt3*coslambda);
   /**/
-  coeffkn2sin[0] = -1./4*sqrt3 * (-sinbeta);
+  coeffs->coeffkn2sin[0] = -1./4*sqrt3 * (-sinbeta);
   /**/
-  coeffkn2sin[1] = 1./8*cosbeta * (-coslambda -sqrt3*sinlambda);
+  coeffs->coeffkn2sin[1] = 1./8*cosbeta * (-coslambda -sqrt3*sinlambda);
 
   /* Coefficients in k.n1 */
   /**/
-  coeffkn1const = 3./4*cosbeta * (-sinlambda);
+  coeffs->coeffkn1const = 3./4*cosbeta * (-sinlambda);
   /**/
-  coeffkn1cos[0] =  0. ;
+  coeffs->coeffkn1cos[0] =  0. ;
   /**/
-  coeffkn1cos[1] = 1./4*cosbeta * (-sinlambda);
+  coeffs->coeffkn1cos[1] = 1./4*cosbeta * (-sinlambda);
   /**/
-  coeffkn1sin[0] = 1./2*sqrt3 * (-sinbeta);
+  coeffs->coeffkn1sin[0] = 1./2*sqrt3 * (-sinbeta);
   /**/
-  coeffkn1sin[1] = -1./4*cosbeta * (-coslambda);
+  coeffs->coeffkn1sin[1] = -1./4*cosbeta * (-coslambda);
 
   /* Coefficients in k.(p1+p2) */
   /**/
-  coeffkp1plusp2const = -1./8*cosbeta * (-3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp1plusp2const = -1./8*cosbeta * (-3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp1plusp2cos[0] = -1./4 * (-sinbeta);
+  coeffs->coeffkp1plusp2cos[0] = -1./4 * (-sinbeta);
   /**/
-  coeffkp1plusp2cos[1] = 1./24*cosbeta * (3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp1plusp2cos[1] = 1./24*cosbeta * (3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp1plusp2sin[0] = -1./4*sqrt3 * (-sinbeta);
+  coeffs->coeffkp1plusp2sin[0] = -1./4*sqrt3 * (-sinbeta);
   /**/
-  coeffkp1plusp2sin[1] = 1./24*cosbeta * (-3*coslambda -sqrt3*sinlambda);
+  coeffs->coeffkp1plusp2sin[1] = 1./24*cosbeta * (-3*coslambda -sqrt3*sinlambda);
 
   /* Coefficients in k.(p2+p3) */
   /**/
-  coeffkp2plusp3const = 1./4*sqrt3*cosbeta * (-coslambda);
+  coeffs->coeffkp2plusp3const = 1./4*sqrt3*cosbeta * (-coslambda);
   /**/
-  coeffkp2plusp3cos[0] = 1./2 * (-sinbeta);
+  coeffs->coeffkp2plusp3cos[0] = 1./2 * (-sinbeta);
   /**/
-  coeffkp2plusp3cos[1] = -1./4/sqrt3 * (-cosbeta*coslambda);
+  coeffs->coeffkp2plusp3cos[1] = -1./4/sqrt3 * (-cosbeta*coslambda);
   /**/
-  coeffkp2plusp3sin[0] =  0. ;
+  coeffs->coeffkp2plusp3sin[0] =  0. ;
   /**/
-  coeffkp2plusp3sin[1] = -1./4/sqrt3 * (-cosbeta*sinlambda);
+  coeffs->coeffkp2plusp3sin[1] = -1./4/sqrt3 * (-cosbeta*sinlambda);
 
   /* Coefficients in k.(p3+p1) */
   /**/
-  coeffkp3plusp1const = -1./8*cosbeta * (3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp3plusp1const = -1./8*cosbeta * (3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp3plusp1cos[0] = -1./4 * (-sinbeta);
+  coeffs->coeffkp3plusp1cos[0] = -1./4 * (-sinbeta);
   /**/
-  coeffkp3plusp1cos[1] = 1./24*cosbeta * (-3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp3plusp1cos[1] = 1./24*cosbeta * (-3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp3plusp1sin[0] = 1./4*sqrt3 * (-sinbeta);
+  coeffs->coeffkp3plusp1sin[0] = 1./4*sqrt3 * (-sinbeta);
   /**/
-  coeffkp3plusp1sin[1] = -1./24*cosbeta * (-3*coslambda + sqrt3*sinlambda);
+  coeffs->coeffkp3plusp1sin[1] = -1./24*cosbeta * (-3*coslambda + sqrt3*sinlambda);
 
   /* Coefficients in k.p1 */
   /**/
-  coeffkp1const = -1./4*sqrt3 * (-cosbeta*coslambda);
+  coeffs->coeffkp1const = -1./4*sqrt3 * (-cosbeta*coslambda);
   /**/
-  coeffkp1cos[0] = -1./2 * (-sinbeta);
+  coeffs->coeffkp1cos[0] = -1./2 * (-sinbeta);
   /**/
-  coeffkp1cos[1] = 1./(4*sqrt3) * (-cosbeta*coslambda);
+  coeffs->coeffkp1cos[1] = 1./(4*sqrt3) * (-cosbeta*coslambda);
   /**/
-  coeffkp1sin[0] =  0. ;
+  coeffs->coeffkp1sin[0] =  0. ;
   /**/
-  coeffkp1sin[1] = 1./(4*sqrt3) * (-cosbeta*sinlambda);
+  coeffs->coeffkp1sin[1] = 1./(4*sqrt3) * (-cosbeta*sinlambda);
 
   /* Coefficients in k.p2 */
   /**/
-  coeffkp2const = 1./8*cosbeta * (3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp2const = 1./8*cosbeta * (3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp2cos[0] = 1./4 * (-sinbeta);
+  coeffs->coeffkp2cos[0] = 1./4 * (-sinbeta);
   /**/
-  coeffkp2cos[1] = -1./24*cosbeta * (-3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp2cos[1] = -1./24*cosbeta * (-3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp2sin[0] = -1./4*sqrt3 * (-sinbeta);
+  coeffs->coeffkp2sin[0] = -1./4*sqrt3 * (-sinbeta);
   /**/
-  coeffkp2sin[1] = 1./24*cosbeta * (-3*coslambda + sqrt3*sinlambda);
+  coeffs->coeffkp2sin[1] = 1./24*cosbeta * (-3*coslambda + sqrt3*sinlambda);
 
   /* Coefficients in k.p3 */
   /**/
-  coeffkp3const = 1./8*cosbeta * (-3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp3const = 1./8*cosbeta * (-3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp3cos[0] = 1./4 * (-sinbeta);
+  coeffs->coeffkp3cos[0] = 1./4 * (-sinbeta);
   /**/
-  coeffkp3cos[1] = -1./24*cosbeta * (3*sinlambda -sqrt3*coslambda);
+  coeffs->coeffkp3cos[1] = -1./24*cosbeta * (3*sinlambda -sqrt3*coslambda);
   /**/
-  coeffkp3sin[0] = 1./4*sqrt3 * (-sinbeta);
+  coeffs->coeffkp3sin[0] = 1./4*sqrt3 * (-sinbeta);
   /**/
-  coeffkp3sin[1] = -1./24*cosbeta * (-3*coslambda -sqrt3*sinlambda);
+  coeffs->coeffkp3sin[1] = -1./24*cosbeta * (-3*coslambda -sqrt3*sinlambda);
 
   /* Coefficients in k.R */
   /**/
-  coeffkRconst = 0.;
-  coeffkRcos[0] = 1. * (-cosbeta*coslambda);
-  coeffkRsin[0] = 1. * (-cosbeta*sinlambda);
-  coeffkRcos[1] = 0.;
-  coeffkRsin[1] = 0.;
+  coeffs->coeffkRconst = 0.;
+  coeffs->coeffkRcos[0] = 1. * (-cosbeta*coslambda);
+  coeffs->coeffkRsin[0] = 1. * (-cosbeta*sinlambda);
+  coeffs->coeffkRcos[1] = 0.;
+  coeffs->coeffkRsin[1] = 0.;
 
 }
 
@@ -483,150 +435,162 @@ void SetCoeffsG(const double lambda, const double beta, const double psi) {
 /* Conventions changed: now MLDC conventions */
 
 /* Function evaluating G21, combining the two polarization with the spherical harmonics factors */
-double complex G21mode(const LISAconstellation *variant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
+double complex G21mode(const LISAconstellation *variant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
 {
 
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
 
+  double cosarray[4], sinarray[4];
+
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
-  double kn3 = coeffkn3const;
-  double kp1plusp2 = coeffkp1plusp2const;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1plusp2 = coeffs->coeffkp1plusp2const;
   for(int j=0; j<2; j++) {
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1plusp2 += cosarray[j] * coeffkp1plusp2cos[j] + sinarray[j] * coeffkp1plusp2sin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1plusp2 += cosarray[j] * coeffs->coeffkp1plusp2cos[j] + sinarray[j] * coeffs->coeffkp1plusp2sin[j];
   }
   return I*PI*f*variant->ConstL/C_SI * (n3Pn3plus*Yfactorplus + n3Pn3cross*Yfactorcross) * sinc( PI*f*variant->ConstL/C_SI * (1.+kn3)) * cexp( I*PI*f*variant->ConstL/C_SI * (1.+kp1plusp2) );
 }
 /* Function evaluating G12, combining the two polarization with the spherical harmonics factors */
-double complex G12mode(const LISAconstellation *variant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
+double complex G12mode(const LISAconstellation *variant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
 {
 
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
 
+  double cosarray[4], sinarray[4];
+
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
-  double kn3 = coeffkn3const;
-  double kp1plusp2 = coeffkp1plusp2const;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1plusp2 = coeffs->coeffkp1plusp2const;
   for(int j=0; j<2; j++) {
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1plusp2 += cosarray[j] * coeffkp1plusp2cos[j] + sinarray[j] * coeffkp1plusp2sin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1plusp2 += cosarray[j] * coeffs->coeffkp1plusp2cos[j] + sinarray[j] * coeffs->coeffkp1plusp2sin[j];
   }
 
   return I*PI*f*variant->ConstL/C_SI * (n3Pn3plus*Yfactorplus + n3Pn3cross*Yfactorcross) * sinc( PI*f*variant->ConstL/C_SI * (1.-kn3)) * cexp( I*PI*f*variant->ConstL/C_SI * (1.+kp1plusp2) );
 }
 /* Function evaluating G32, combining the two polarization with the spherical harmonics factors */
-double complex G32mode(const LISAconstellation *variant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
+double complex G32mode(const LISAconstellation *variant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
 {
 
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
 
+  double cosarray[4], sinarray[4];
+
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
-  double n1Pn1plus = coeffn1Hn1plusconst;
-  double n1Pn1cross = coeffn1Hn1crossconst;
+  double n1Pn1plus = coeffs->coeffn1Hn1plusconst;
+  double n1Pn1cross = coeffs->coeffn1Hn1crossconst;
   for(int j=0; j<4; j++) {
-    n1Pn1plus += cosarray[j] * coeffn1Hn1pluscos[j] + sinarray[j] * coeffn1Hn1plussin[j];
-    n1Pn1cross += cosarray[j] * coeffn1Hn1crosscos[j] + sinarray[j] * coeffn1Hn1crosssin[j];
+    n1Pn1plus += cosarray[j] * coeffs->coeffn1Hn1pluscos[j] + sinarray[j] * coeffs->coeffn1Hn1plussin[j];
+    n1Pn1cross += cosarray[j] * coeffs->coeffn1Hn1crosscos[j] + sinarray[j] * coeffs->coeffn1Hn1crosssin[j];
   }
-  double kn1 = coeffkn1const;
-  double kp2plusp3 = coeffkp2plusp3const;
+  double kn1 = coeffs->coeffkn1const;
+  double kp2plusp3 = coeffs->coeffkp2plusp3const;
   for(int j=0; j<2; j++) {
-    kn1 += cosarray[j] * coeffkn1cos[j] + sinarray[j] * coeffkn1sin[j];
-    kp2plusp3 += cosarray[j] * coeffkp2plusp3cos[j] + sinarray[j] * coeffkp2plusp3sin[j];
+    kn1 += cosarray[j] * coeffs->coeffkn1cos[j] + sinarray[j] * coeffs->coeffkn1sin[j];
+    kp2plusp3 += cosarray[j] * coeffs->coeffkp2plusp3cos[j] + sinarray[j] * coeffs->coeffkp2plusp3sin[j];
   }
 
   return I*PI*f*variant->ConstL/C_SI * (n1Pn1plus*Yfactorplus + n1Pn1cross*Yfactorcross) * sinc( PI*f*variant->ConstL/C_SI * (1.+kn1)) * cexp( I*PI*f*variant->ConstL/C_SI * (1.+kp2plusp3) );
 }
 /* Function evaluating G23, combining the two polarization with the spherical harmonics factors */
-double complex G23mode(const LISAconstellation *variant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
+double complex G23mode(const LISAconstellation *variant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
 {
 
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
 
+  double cosarray[4], sinarray[4];
+
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1)* phase);
     sinarray[j] = sin((j+1)* phase);
   }
-  double n1Pn1plus = coeffn1Hn1plusconst;
-  double n1Pn1cross = coeffn1Hn1crossconst;
+  double n1Pn1plus = coeffs->coeffn1Hn1plusconst;
+  double n1Pn1cross = coeffs->coeffn1Hn1crossconst;
   for(int j=0; j<4; j++) {
-    n1Pn1plus += cosarray[j] * coeffn1Hn1pluscos[j] + sinarray[j] * coeffn1Hn1plussin[j];
-    n1Pn1cross += cosarray[j] * coeffn1Hn1crosscos[j] + sinarray[j] * coeffn1Hn1crosssin[j];
+    n1Pn1plus += cosarray[j] * coeffs->coeffn1Hn1pluscos[j] + sinarray[j] * coeffs->coeffn1Hn1plussin[j];
+    n1Pn1cross += cosarray[j] * coeffs->coeffn1Hn1crosscos[j] + sinarray[j] * coeffs->coeffn1Hn1crosssin[j];
   }
-  double kn1 = coeffkn1const;
-  double kp2plusp3 = coeffkp2plusp3const;
+  double kn1 = coeffs->coeffkn1const;
+  double kp2plusp3 = coeffs->coeffkp2plusp3const;
   for(int j=0; j<2; j++) {
-    kn1 += cosarray[j] * coeffkn1cos[j] + sinarray[j] * coeffkn1sin[j];
-    kp2plusp3 += cosarray[j] * coeffkp2plusp3cos[j] + sinarray[j] * coeffkp2plusp3sin[j];
+    kn1 += cosarray[j] * coeffs->coeffkn1cos[j] + sinarray[j] * coeffs->coeffkn1sin[j];
+    kp2plusp3 += cosarray[j] * coeffs->coeffkp2plusp3cos[j] + sinarray[j] * coeffs->coeffkp2plusp3sin[j];
   }
 
   return I*PI*f*variant->ConstL/C_SI * (n1Pn1plus*Yfactorplus + n1Pn1cross*Yfactorcross) * sinc( PI*f*variant->ConstL/C_SI * (1.-kn1)) * cexp( I*PI*f*variant->ConstL/C_SI * (1.+kp2plusp3) );
 }
 /* Function evaluating G13, combining the two polarization with the spherical harmonics factors */
-double complex G13mode(const LISAconstellation *variant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
+double complex G13mode(const LISAconstellation *variant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
 {
 
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
 
+  double cosarray[4], sinarray[4];
+
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
-  double n2Pn2plus = coeffn2Hn2plusconst;
-  double n2Pn2cross = coeffn2Hn2crossconst;
+  double n2Pn2plus = coeffs->coeffn2Hn2plusconst;
+  double n2Pn2cross = coeffs->coeffn2Hn2crossconst;
   for(int j=0; j<4; j++) {
-    n2Pn2plus += cosarray[j] * coeffn2Hn2pluscos[j] + sinarray[j] * coeffn2Hn2plussin[j];
-    n2Pn2cross += cosarray[j] * coeffn2Hn2crosscos[j] + sinarray[j] * coeffn2Hn2crosssin[j];
+    n2Pn2plus += cosarray[j] * coeffs->coeffn2Hn2pluscos[j] + sinarray[j] * coeffs->coeffn2Hn2plussin[j];
+    n2Pn2cross += cosarray[j] * coeffs->coeffn2Hn2crosscos[j] + sinarray[j] * coeffs->coeffn2Hn2crosssin[j];
   }
-  double kn2 = coeffkn2const;
-  double kp3plusp1 = coeffkp3plusp1const;
+  double kn2 = coeffs->coeffkn2const;
+  double kp3plusp1 = coeffs->coeffkp3plusp1const;
   for(int j=0; j<2; j++) {
-    kn2 += cosarray[j] * coeffkn2cos[j] + sinarray[j] * coeffkn2sin[j];
-    kp3plusp1 += cosarray[j] * coeffkp3plusp1cos[j] + sinarray[j] * coeffkp3plusp1sin[j];
+    kn2 += cosarray[j] * coeffs->coeffkn2cos[j] + sinarray[j] * coeffs->coeffkn2sin[j];
+    kp3plusp1 += cosarray[j] * coeffs->coeffkp3plusp1cos[j] + sinarray[j] * coeffs->coeffkp3plusp1sin[j];
   }
 
   return I*PI*f*variant->ConstL/C_SI * (n2Pn2plus*Yfactorplus + n2Pn2cross*Yfactorcross) * sinc( PI*f*variant->ConstL/C_SI * (1.+kn2)) * cexp( I*PI*f*variant->ConstL/C_SI * (1.+kp3plusp1) );
 }
 /* Function evaluating G31, combining the two polarization with the spherical harmonics factors */
-double complex G31mode(const LISAconstellation *variant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
+double complex G31mode(const LISAconstellation *variant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross)
 {
 
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
 
+  double cosarray[4], sinarray[4];
+
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
-  double n2Pn2plus = coeffn2Hn2plusconst;
-  double n2Pn2cross = coeffn2Hn2crossconst;
+  double n2Pn2plus = coeffs->coeffn2Hn2plusconst;
+  double n2Pn2cross = coeffs->coeffn2Hn2crossconst;
   for(int j=0; j<4; j++) {
-    n2Pn2plus += cosarray[j] * coeffn2Hn2pluscos[j] + sinarray[j] * coeffn2Hn2plussin[j];
-    n2Pn2cross += cosarray[j] * coeffn2Hn2crosscos[j] + sinarray[j] * coeffn2Hn2crosssin[j];
+    n2Pn2plus += cosarray[j] * coeffs->coeffn2Hn2pluscos[j] + sinarray[j] * coeffs->coeffn2Hn2plussin[j];
+    n2Pn2cross += cosarray[j] * coeffs->coeffn2Hn2crosscos[j] + sinarray[j] * coeffs->coeffn2Hn2crosssin[j];
   }
-  double kn2 = coeffkn2const;
-  double kp3plusp1 = coeffkp3plusp1const;
+  double kn2 = coeffs->coeffkn2const;
+  double kp3plusp1 = coeffs->coeffkp3plusp1const;
   for(int j=0; j<2; j++) {
-    kn2 += cosarray[j] * coeffkn2cos[j] + sinarray[j] * coeffkn2sin[j];
-    kp3plusp1 += cosarray[j] * coeffkp3plusp1cos[j] + sinarray[j] * coeffkp3plusp1sin[j];
+    kn2 += cosarray[j] * coeffs->coeffkn2cos[j] + sinarray[j] * coeffs->coeffkn2sin[j];
+    kp3plusp1 += cosarray[j] * coeffs->coeffkp3plusp1cos[j] + sinarray[j] * coeffs->coeffkp3plusp1sin[j];
   }
 
   return I*PI*f*variant->ConstL/C_SI * (n2Pn2plus*Yfactorplus + n2Pn2cross*Yfactorcross) * sinc( PI*f*variant->ConstL/C_SI * (1.-kn2)) * cexp( I*PI*f*variant->ConstL/C_SI * (1.+kp3plusp1) );
@@ -636,6 +600,7 @@ double complex G31mode(const LISAconstellation *variant, const double f, const d
 /* Note: includes orbital delay */
 int EvaluateGABmode(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double complex* G12,                     /* Output for G12 */
   double complex* G21,                     /* Output for G21 */
   double complex* G23,                     /* Output for G23 */
@@ -652,41 +617,42 @@ int EvaluateGABmode(
   double phase = variant->ConstOmega*t + variant->ConstPhi0;
 
   /* Precompute array of sine/cosine */
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n1Pn1plus = coeffn1Hn1plusconst;
-  double n1Pn1cross = coeffn1Hn1crossconst;
-  double n2Pn2plus = coeffn2Hn2plusconst;
-  double n2Pn2cross = coeffn2Hn2crossconst;
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n1Pn1plus = coeffs->coeffn1Hn1plusconst;
+  double n1Pn1cross = coeffs->coeffn1Hn1crossconst;
+  double n2Pn2plus = coeffs->coeffn2Hn2plusconst;
+  double n2Pn2cross = coeffs->coeffn2Hn2crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n1Pn1plus += cosarray[j] * coeffn1Hn1pluscos[j] + sinarray[j] * coeffn1Hn1plussin[j];
-    n1Pn1cross += cosarray[j] * coeffn1Hn1crosscos[j] + sinarray[j] * coeffn1Hn1crosssin[j];
-    n2Pn2plus += cosarray[j] * coeffn2Hn2pluscos[j] + sinarray[j] * coeffn2Hn2plussin[j];
-    n2Pn2cross += cosarray[j] * coeffn2Hn2crosscos[j] + sinarray[j] * coeffn2Hn2crosssin[j];
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n1Pn1plus += cosarray[j] * coeffs->coeffn1Hn1pluscos[j] + sinarray[j] * coeffs->coeffn1Hn1plussin[j];
+    n1Pn1cross += cosarray[j] * coeffs->coeffn1Hn1crosscos[j] + sinarray[j] * coeffs->coeffn1Hn1crosssin[j];
+    n2Pn2plus += cosarray[j] * coeffs->coeffn2Hn2pluscos[j] + sinarray[j] * coeffs->coeffn2Hn2plussin[j];
+    n2Pn2cross += cosarray[j] * coeffs->coeffn2Hn2crosscos[j] + sinarray[j] * coeffs->coeffn2Hn2crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
   /* Scalar products with k */
-  double kn1 = coeffkn1const;
-  double kn2 = coeffkn2const;
-  double kn3 = coeffkn3const;
-  double kp1plusp2 = coeffkp1plusp2const;
-  double kp2plusp3 = coeffkp2plusp3const;
-  double kp3plusp1 = coeffkp3plusp1const;
-  double kR = coeffkRconst;
+  double kn1 = coeffs->coeffkn1const;
+  double kn2 = coeffs->coeffkn2const;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1plusp2 = coeffs->coeffkp1plusp2const;
+  double kp2plusp3 = coeffs->coeffkp2plusp3const;
+  double kp3plusp1 = coeffs->coeffkp3plusp1const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn1 += cosarray[j] * coeffkn1cos[j] + sinarray[j] * coeffkn1sin[j];
-    kn2 += cosarray[j] * coeffkn2cos[j] + sinarray[j] * coeffkn2sin[j];
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1plusp2 += cosarray[j] * coeffkp1plusp2cos[j] + sinarray[j] * coeffkp1plusp2sin[j];
-    kp2plusp3 += cosarray[j] * coeffkp2plusp3cos[j] + sinarray[j] * coeffkp2plusp3sin[j];
-    kp3plusp1 += cosarray[j] * coeffkp3plusp1cos[j] + sinarray[j] * coeffkp3plusp1sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn1 += cosarray[j] * coeffs->coeffkn1cos[j] + sinarray[j] * coeffs->coeffkn1sin[j];
+    kn2 += cosarray[j] * coeffs->coeffkn2cos[j] + sinarray[j] * coeffs->coeffkn2sin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1plusp2 += cosarray[j] * coeffs->coeffkp1plusp2cos[j] + sinarray[j] * coeffs->coeffkp1plusp2sin[j];
+    kp2plusp3 += cosarray[j] * coeffs->coeffkp2plusp3cos[j] + sinarray[j] * coeffs->coeffkp2plusp3sin[j];
+    kp3plusp1 += cosarray[j] * coeffs->coeffkp3plusp1cos[j] + sinarray[j] * coeffs->coeffkp3plusp1sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factors */
   double complex factn1Pn1 = n1Pn1plus*Yfactorplus + n1Pn1cross*Yfactorcross;
@@ -1046,6 +1012,7 @@ int RestoreInPlaceScaledFactorTDI(
 /* Processing single mode in amp/phase form through orbital time delay */
 static double hOTDAmpPhase(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double* amp,                             /* Output: amplitude */
   double* phase,                           /* Output: phase */
   gsl_spline* splineamp,                   /* Input spline for TD mode amplitude */
@@ -1056,14 +1023,15 @@ static double hOTDAmpPhase(
 {
   double tphase=variant->ConstOmega*t + variant->ConstPhi0;
   /* Precompute array of sine/cosine */
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * tphase);
     sinarray[j] = sin((j+1) * tphase);
   }
   /* Scalar product k.R */
-  double kR = coeffkRconst;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double delay = -(kR*variant->OrbitR)/C_SI;
@@ -1077,6 +1045,7 @@ static double hOTDAmpPhase(
 /* Note: includes both h22 and h2m2 contributions, assuming planar orbits so that h2-2 = h22* */
 static double y12LTDfromh22AmpPhase(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splineamp,                   /* Input spline for h22 TD amp */
   gsl_spline* splinephase,                 /* Input spline for h22 TD phase */
   gsl_interp_accel* accelamp,              /* Accelerator for amp spline */
@@ -1087,25 +1056,26 @@ static double y12LTDfromh22AmpPhase(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
   /* Scalar products with k */
-  double kn3 = coeffkn3const;
-  double kp1 = coeffkp1const;
-  double kp2 = coeffkp2const;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1 = coeffs->coeffkp1const;
+  double kp2 = coeffs->coeffkp2const;
   for(int j=0; j<2; j++) {
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1 += cosarray[j] * coeffkp1cos[j] + sinarray[j] * coeffkp1sin[j];
-    kp2 += cosarray[j] * coeffkp2cos[j] + sinarray[j] * coeffkp2sin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1 += cosarray[j] * coeffs->coeffkp1cos[j] + sinarray[j] * coeffs->coeffkp1sin[j];
+    kp2 += cosarray[j] * coeffs->coeffkp2cos[j] + sinarray[j] * coeffs->coeffkp2sin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.-kn3)) * 0.5*n3Pn3plus;
@@ -1137,6 +1107,7 @@ static double y12LTDfromh22AmpPhase(
 /* Note: includes both h22 and h2m2 contributions, assuming planar orbits so that h2-2 = h22* */
 static double y12TDfromh22AmpPhase(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splineamp,                   /* Input spline for h22 TD amp */
   gsl_spline* splinephase,                 /* Input spline for h22 TD phase */
   gsl_interp_accel* accelamp,              /* Accelerator for amp spline */
@@ -1147,32 +1118,33 @@ static double y12TDfromh22AmpPhase(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar product k.R */
-  double kR = coeffkRconst;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double delay0 = -(kR*variant->OrbitR)/C_SI;
   /* Scalar products with k */
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
   /* Scalar products with k */
-  double kn3 = coeffkn3const;
-  double kp1 = coeffkp1const;
-  double kp2 = coeffkp2const;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1 = coeffs->coeffkp1const;
+  double kp2 = coeffs->coeffkp2const;
   for(int j=0; j<2; j++) {
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1 += cosarray[j] * coeffkp1cos[j] + sinarray[j] * coeffkp1sin[j];
-    kp2 += cosarray[j] * coeffkp2cos[j] + sinarray[j] * coeffkp2sin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1 += cosarray[j] * coeffs->coeffkp1cos[j] + sinarray[j] * coeffs->coeffkp1sin[j];
+    kp2 += cosarray[j] * coeffs->coeffkp2cos[j] + sinarray[j] * coeffs->coeffkp2sin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.-kn3)) * 0.5*n3Pn3plus;
@@ -1203,6 +1175,7 @@ static double y12TDfromh22AmpPhase(
 /* Functions evaluating yAB observables in time domain */
 double y12TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -1211,27 +1184,28 @@ double y12TD(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
   /* Scalar products with k */
-  double kn3 = coeffkn3const;
-  double kp1 = coeffkp1const;
-  double kp2 = coeffkp2const;
-  double kR = coeffkRconst;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1 = coeffs->coeffkp1const;
+  double kp2 = coeffs->coeffkp2const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1 += cosarray[j] * coeffkp1cos[j] + sinarray[j] * coeffkp1sin[j];
-    kp2 += cosarray[j] * coeffkp2cos[j] + sinarray[j] * coeffkp2sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1 += cosarray[j] * coeffs->coeffkp1cos[j] + sinarray[j] * coeffs->coeffkp1sin[j];
+    kp2 += cosarray[j] * coeffs->coeffkp2cos[j] + sinarray[j] * coeffs->coeffkp2sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.-kn3)) * 0.5*n3Pn3plus;
@@ -1246,6 +1220,7 @@ double y12TD(
 
 double y21TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -1254,27 +1229,28 @@ double y21TD(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n3Pn3plus = coeffn3Hn3plusconst;
-  double n3Pn3cross = coeffn3Hn3crossconst;
+  double n3Pn3plus = coeffs->coeffn3Hn3plusconst;
+  double n3Pn3cross = coeffs->coeffn3Hn3crossconst;
   for(int j=0; j<4; j++) {
-    n3Pn3plus += cosarray[j] * coeffn3Hn3pluscos[j] + sinarray[j] * coeffn3Hn3plussin[j];
-    n3Pn3cross += cosarray[j] * coeffn3Hn3crosscos[j] + sinarray[j] * coeffn3Hn3crosssin[j];
+    n3Pn3plus += cosarray[j] * coeffs->coeffn3Hn3pluscos[j] + sinarray[j] * coeffs->coeffn3Hn3plussin[j];
+    n3Pn3cross += cosarray[j] * coeffs->coeffn3Hn3crosscos[j] + sinarray[j] * coeffs->coeffn3Hn3crosssin[j];
   }
   /* Scalar products with k */
-  double kn3 = coeffkn3const;
-  double kp1 = coeffkp1const;
-  double kp2 = coeffkp2const;
-  double kR = coeffkRconst;
+  double kn3 = coeffs->coeffkn3const;
+  double kp1 = coeffs->coeffkp1const;
+  double kp2 = coeffs->coeffkp2const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn3 += cosarray[j] * coeffkn3cos[j] + sinarray[j] * coeffkn3sin[j];
-    kp1 += cosarray[j] * coeffkp1cos[j] + sinarray[j] * coeffkp1sin[j];
-    kp2 += cosarray[j] * coeffkp2cos[j] + sinarray[j] * coeffkp2sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn3 += cosarray[j] * coeffs->coeffkn3cos[j] + sinarray[j] * coeffs->coeffkn3sin[j];
+    kp1 += cosarray[j] * coeffs->coeffkp1cos[j] + sinarray[j] * coeffs->coeffkp1sin[j];
+    kp2 += cosarray[j] * coeffs->coeffkp2cos[j] + sinarray[j] * coeffs->coeffkp2sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.+kn3)) * 0.5*n3Pn3plus;
@@ -1288,6 +1264,7 @@ double y21TD(
 }
 double y23TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -1296,27 +1273,28 @@ double y23TD(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n1Pn1plus = coeffn1Hn1plusconst;
-  double n1Pn1cross = coeffn1Hn1crossconst;
+  double n1Pn1plus = coeffs->coeffn1Hn1plusconst;
+  double n1Pn1cross = coeffs->coeffn1Hn1crossconst;
   for(int j=0; j<4; j++) {
-    n1Pn1plus += cosarray[j] * coeffn1Hn1pluscos[j] + sinarray[j] * coeffn1Hn1plussin[j];
-    n1Pn1cross += cosarray[j] * coeffn1Hn1crosscos[j] + sinarray[j] * coeffn1Hn1crosssin[j];
+    n1Pn1plus += cosarray[j] * coeffs->coeffn1Hn1pluscos[j] + sinarray[j] * coeffs->coeffn1Hn1plussin[j];
+    n1Pn1cross += cosarray[j] * coeffs->coeffn1Hn1crosscos[j] + sinarray[j] * coeffs->coeffn1Hn1crosssin[j];
   }
   /* Scalar products with k */
-  double kn1 = coeffkn1const;
-  double kp2 = coeffkp2const;
-  double kp3 = coeffkp3const;
-  double kR = coeffkRconst;
+  double kn1 = coeffs->coeffkn1const;
+  double kp2 = coeffs->coeffkp2const;
+  double kp3 = coeffs->coeffkp3const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn1 += cosarray[j] * coeffkn1cos[j] + sinarray[j] * coeffkn1sin[j];
-    kp2 += cosarray[j] * coeffkp2cos[j] + sinarray[j] * coeffkp2sin[j];
-    kp3 += cosarray[j] * coeffkp3cos[j] + sinarray[j] * coeffkp3sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn1 += cosarray[j] * coeffs->coeffkn1cos[j] + sinarray[j] * coeffs->coeffkn1sin[j];
+    kp2 += cosarray[j] * coeffs->coeffkp2cos[j] + sinarray[j] * coeffs->coeffkp2sin[j];
+    kp3 += cosarray[j] * coeffs->coeffkp3cos[j] + sinarray[j] * coeffs->coeffkp3sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.-kn1)) * 0.5*n1Pn1plus;
@@ -1330,6 +1308,7 @@ double y23TD(
 }
 double y32TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -1338,27 +1317,28 @@ double y32TD(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n1Pn1plus = coeffn1Hn1plusconst;
-  double n1Pn1cross = coeffn1Hn1crossconst;
+  double n1Pn1plus = coeffs->coeffn1Hn1plusconst;
+  double n1Pn1cross = coeffs->coeffn1Hn1crossconst;
   for(int j=0; j<4; j++) {
-    n1Pn1plus += cosarray[j] * coeffn1Hn1pluscos[j] + sinarray[j] * coeffn1Hn1plussin[j];
-    n1Pn1cross += cosarray[j] * coeffn1Hn1crosscos[j] + sinarray[j] * coeffn1Hn1crosssin[j];
+    n1Pn1plus += cosarray[j] * coeffs->coeffn1Hn1pluscos[j] + sinarray[j] * coeffs->coeffn1Hn1plussin[j];
+    n1Pn1cross += cosarray[j] * coeffs->coeffn1Hn1crosscos[j] + sinarray[j] * coeffs->coeffn1Hn1crosssin[j];
   }
   /* Scalar products with k */
-  double kn1 = coeffkn1const;
-  double kp2 = coeffkp2const;
-  double kp3 = coeffkp3const;
-  double kR = coeffkRconst;
+  double kn1 = coeffs->coeffkn1const;
+  double kp2 = coeffs->coeffkp2const;
+  double kp3 = coeffs->coeffkp3const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn1 += cosarray[j] * coeffkn1cos[j] + sinarray[j] * coeffkn1sin[j];
-    kp2 += cosarray[j] * coeffkp2cos[j] + sinarray[j] * coeffkp2sin[j];
-    kp3 += cosarray[j] * coeffkp3cos[j] + sinarray[j] * coeffkp3sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn1 += cosarray[j] * coeffs->coeffkn1cos[j] + sinarray[j] * coeffs->coeffkn1sin[j];
+    kp2 += cosarray[j] * coeffs->coeffkp2cos[j] + sinarray[j] * coeffs->coeffkp2sin[j];
+    kp3 += cosarray[j] * coeffs->coeffkp3cos[j] + sinarray[j] * coeffs->coeffkp3sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.+kn1)) * 0.5*n1Pn1plus;
@@ -1372,6 +1352,7 @@ double y32TD(
 }
 double y31TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -1380,27 +1361,28 @@ double y31TD(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n2Pn2plus = coeffn2Hn2plusconst;
-  double n2Pn2cross = coeffn2Hn2crossconst;
+  double n2Pn2plus = coeffs->coeffn2Hn2plusconst;
+  double n2Pn2cross = coeffs->coeffn2Hn2crossconst;
   for(int j=0; j<4; j++) {
-    n2Pn2plus += cosarray[j] * coeffn2Hn2pluscos[j] + sinarray[j] * coeffn2Hn2plussin[j];
-    n2Pn2cross += cosarray[j] * coeffn2Hn2crosscos[j] + sinarray[j] * coeffn2Hn2crosssin[j];
+    n2Pn2plus += cosarray[j] * coeffs->coeffn2Hn2pluscos[j] + sinarray[j] * coeffs->coeffn2Hn2plussin[j];
+    n2Pn2cross += cosarray[j] * coeffs->coeffn2Hn2crosscos[j] + sinarray[j] * coeffs->coeffn2Hn2crosssin[j];
   }
   /* Scalar products with k */
-  double kn2 = coeffkn2const;
-  double kp3 = coeffkp3const;
-  double kp1 = coeffkp1const;
-  double kR = coeffkRconst;
+  double kn2 = coeffs->coeffkn2const;
+  double kp3 = coeffs->coeffkp3const;
+  double kp1 = coeffs->coeffkp1const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn2 += cosarray[j] * coeffkn2cos[j] + sinarray[j] * coeffkn2sin[j];
-    kp3 += cosarray[j] * coeffkp3cos[j] + sinarray[j] * coeffkp3sin[j];
-    kp1 += cosarray[j] * coeffkp1cos[j] + sinarray[j] * coeffkp1sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn2 += cosarray[j] * coeffs->coeffkn2cos[j] + sinarray[j] * coeffs->coeffkn2sin[j];
+    kp3 += cosarray[j] * coeffs->coeffkp3cos[j] + sinarray[j] * coeffs->coeffkp3sin[j];
+    kp1 += cosarray[j] * coeffs->coeffkp1cos[j] + sinarray[j] * coeffs->coeffkp1sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.-kn2)) * 0.5*n2Pn2plus;
@@ -1414,6 +1396,7 @@ double y31TD(
 }
 double y13TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -1422,27 +1405,28 @@ double y13TD(
 {
   /* Precompute array of sine/cosine */
   double phase=variant->ConstOmega*t + variant->ConstPhi0;
+  double cosarray[4], sinarray[4];
   for(int j=0; j<4; j++) {
     cosarray[j] = cos((j+1) * phase);
     sinarray[j] = sin((j+1) * phase);
   }
   /* Scalar products with k */
-  double n2Pn2plus = coeffn2Hn2plusconst;
-  double n2Pn2cross = coeffn2Hn2crossconst;
+  double n2Pn2plus = coeffs->coeffn2Hn2plusconst;
+  double n2Pn2cross = coeffs->coeffn2Hn2crossconst;
   for(int j=0; j<4; j++) {
-    n2Pn2plus += cosarray[j] * coeffn2Hn2pluscos[j] + sinarray[j] * coeffn2Hn2plussin[j];
-    n2Pn2cross += cosarray[j] * coeffn2Hn2crosscos[j] + sinarray[j] * coeffn2Hn2crosssin[j];
+    n2Pn2plus += cosarray[j] * coeffs->coeffn2Hn2pluscos[j] + sinarray[j] * coeffs->coeffn2Hn2plussin[j];
+    n2Pn2cross += cosarray[j] * coeffs->coeffn2Hn2crosscos[j] + sinarray[j] * coeffs->coeffn2Hn2crosssin[j];
   }
   /* Scalar products with k */
-  double kn2 = coeffkn2const;
-  double kp3 = coeffkp3const;
-  double kp1 = coeffkp1const;
-  double kR = coeffkRconst;
+  double kn2 = coeffs->coeffkn2const;
+  double kp3 = coeffs->coeffkp3const;
+  double kp1 = coeffs->coeffkp1const;
+  double kR = coeffs->coeffkRconst;
   for(int j=0; j<2; j++) {
-    kn2 += cosarray[j] * coeffkn2cos[j] + sinarray[j] * coeffkn2sin[j];
-    kp3 += cosarray[j] * coeffkp3cos[j] + sinarray[j] * coeffkp3sin[j];
-    kp1 += cosarray[j] * coeffkp1cos[j] + sinarray[j] * coeffkp1sin[j];
-    kR += cosarray[j] * coeffkRcos[j] + sinarray[j] * coeffkRsin[j];
+    kn2 += cosarray[j] * coeffs->coeffkn2cos[j] + sinarray[j] * coeffs->coeffkn2sin[j];
+    kp3 += cosarray[j] * coeffs->coeffkp3cos[j] + sinarray[j] * coeffs->coeffkp3sin[j];
+    kp1 += cosarray[j] * coeffs->coeffkp1cos[j] + sinarray[j] * coeffs->coeffkp1sin[j];
+    kR += cosarray[j] * coeffs->coeffkRcos[j] + sinarray[j] * coeffs->coeffkRsin[j];
   }
   /* Common factor and delay */
   double factorp = (1./(1.+kn2)) * 0.5*n2Pn2plus;
@@ -1458,6 +1442,7 @@ double y13TD(
 /**/
 int EvaluateTDIXYZTD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double* TDIX,                            /* Output: value of TDI observable X */
   double* TDIY,                            /* Output: value of TDI observable Y */
   double* TDIZ,                            /* Output: value of TDI observable Z */
@@ -1468,9 +1453,9 @@ int EvaluateTDIXYZTD(
   const double t)                          /* Time */
 {
   double armdelay = variant->ConstL/C_SI;
-  double X = (y31TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y13TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y21TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y12TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y21TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y12TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y31TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y13TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
-  double Y = (y12TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y21TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y32TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y23TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y32TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y23TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y12TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y21TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
-  double Z = (y23TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y32TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y13TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y31TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y13TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y31TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y23TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y32TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
+  double X = (y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
+  double Y = (y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
+  double Z = (y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
 
   /* Output */
   *TDIX = X;
@@ -1483,6 +1468,7 @@ int EvaluateTDIXYZTD(
 /**/
 int EvaluateTDIAETXYZTD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double* TDIA,                            /* Output: value of TDI observable X */
   double* TDIE,                            /* Output: value of TDI observable Y */
   double* TDIT,                            /* Output: value of TDI observable Z */
@@ -1493,9 +1479,9 @@ int EvaluateTDIAETXYZTD(
   const double t)                          /* Time */
 {
   double armdelay = variant->ConstL/C_SI;
-  double X = (y31TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y13TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y21TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y12TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y21TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y12TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y31TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y13TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
-  double Y = (y12TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y21TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y32TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y23TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y32TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y23TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y12TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y21TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
-  double Z = (y23TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y32TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y13TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y31TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y13TD(variant, splinehp, splinehc, accelhp, accelhc, t) + y31TD(variant, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y23TD(variant, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y32TD(variant, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
+  double X = (y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
+  double Y = (y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
+  double Z = (y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) + (y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay)) - (y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t) + y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - armdelay)) - (y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 2*armdelay) + y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t - 3*armdelay));
 
   /* Output */
   *TDIA = 1./(2*sqrt(2)) * (Z-X);
@@ -1505,9 +1491,123 @@ int EvaluateTDIAETXYZTD(
   return SUCCESS;
 }
 
+/* Weights of the 4-point Lagrange interpolation for a delay of s samples on a uniform grid */
+/* With s = n + x, 0<=x<1, the delayed value at i is interpolated from the points i-n-2, i-n-1, i-n, i-n+1 - an integer delay gives x=0 and is an exact index shift */
+static void SetDelayWeights(const double s, int* n, double* x, double w[4])
+{
+  *n = (int) floor(s);
+  *x = s - *n;
+  if(*x < 1e-9) *x = 0.;
+  else if(1. - *x < 1e-9) { *n += 1; *x = 0.; }
+  double u = -*x;
+  w[0] = -(u+1)*u*(u-1)/6.;
+  w[1] = (u+2)*u*(u-1)/2.;
+  w[2] = -(u+2)*(u+1)*(u-1)/2.;
+  w[3] = (u+2)*(u+1)*u/6.;
+}
+
+/* Value of the precomputed array y at index i, delayed by n + x samples */
+static inline double DelayedValue(const double* y, const int i, const int n, const double x, const double w[4])
+{
+  if(x==0.) return y[i-n];
+  return w[0]*y[i-n-2] + w[1]*y[i-n-1] + w[2]*y[i-n] + w[3]*y[i-n+1];
+}
+
+/* Generate TDI XYZ or AET from hplus, hcross on a uniform time grid, evaluating each yAB only once */
+/* The six yAB are computed on the grid, in parallel over blocks of time, and the delays kL are applied as index shifts (interpolated if kL is not a multiple of the time step) */
+/* Returns FAILURE if the grid is not uniform or if the margin is too small for the delays, in which case nothing is written */
+static int GenerateTDITDXYZhphcDelayed(
+  const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
+  double* tdi1,                            /* Output: values of TDI channel 1 */
+  double* tdi2,                            /* Output: values of TDI channel 2 */
+  double* tdi3,                            /* Output: values of TDI channel 3 */
+  gsl_spline* splinehp,                    /* Input spline for TD hplus */
+  gsl_spline* splinehc,                    /* Input spline for TD hcross */
+  gsl_vector* times,                       /* Vector of times to evaluate */
+  int nbptmargin,                          /* Margin set to 0 on both side to avoid problems with delays out of the domain */
+  TDItag tditag)                           /* Tag selecting the TDI observables - TDIXYZ or TDIAETXYZ */
+{
+  int nbpt = times->size;
+  double* tval = times->data;
+  if(nbpt<2) return FAILURE;
+
+  /* Check that the time grid is uniform */
+  double deltat = (tval[nbpt-1] - tval[0]) / (nbpt-1);
+  for(int i=0; i<nbpt; i++) {
+    if(fabs(tval[i] - tval[0] - i*deltat) > 1e-6*deltat) return FAILURE;
+  }
+
+  /* Delays by 0, L, 2L, 3L in units of the time step */
+  double armdelay = variant->ConstL/C_SI;
+  int n[4];
+  double x[4];
+  double w[4][4];
+  for(int k=0; k<4; k++) SetDelayWeights(k*armdelay/deltat, &n[k], &x[k], w[k]);
+
+  /* Range of samples where the yAB are needed */
+  int imin = nbptmargin - n[3] - 2;
+  int imax = nbpt - nbptmargin;
+  if(imin<0 || n[1]<1 || imax>nbpt || imax<=nbptmargin) return FAILURE;
+  int nby = imax - imin;
+
+  /* Compute the six yAB on the grid - splines are shared, accelerators are per-thread */
+  double* y12arr = malloc(nby*sizeof(double));
+  double* y21arr = malloc(nby*sizeof(double));
+  double* y23arr = malloc(nby*sizeof(double));
+  double* y32arr = malloc(nby*sizeof(double));
+  double* y31arr = malloc(nby*sizeof(double));
+  double* y13arr = malloc(nby*sizeof(double));
+  #pragma omp parallel
+  {
+    gsl_interp_accel* accelhp = gsl_interp_accel_alloc();
+    gsl_interp_accel* accelhc = gsl_interp_accel_alloc();
+    #pragma omp for schedule(static)
+    for(int j=0; j<nby; j++) {
+      double t = tval[imin + j];
+      y12arr[j] = y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
+      y21arr[j] = y21TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
+      y23arr[j] = y23TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
+      y32arr[j] = y32TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
+      y31arr[j] = y31TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
+      y13arr[j] = y13TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
+    }
+    gsl_interp_accel_free(accelhp);
+    gsl_interp_accel_free(accelhc);
+  }
+
+  /* Assemble the TDI combinations from the delayed yAB */
+  #pragma omp parallel for schedule(static)
+  for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
+    int j = i - imin;
+    double X = (y31arr[j] + DelayedValue(y13arr, j, n[1], x[1], w[1])) + (DelayedValue(y21arr, j, n[2], x[2], w[2]) + DelayedValue(y12arr, j, n[3], x[3], w[3])) - (y21arr[j] + DelayedValue(y12arr, j, n[1], x[1], w[1])) - (DelayedValue(y31arr, j, n[2], x[2], w[2]) + DelayedValue(y13arr, j, n[3], x[3], w[3]));
+    double Y = (y12arr[j] + DelayedValue(y21arr, j, n[1], x[1], w[1])) + (DelayedValue(y32arr, j, n[2], x[2], w[2]) + DelayedValue(y23arr, j, n[3], x[3], w[3])) - (y32arr[j] + DelayedValue(y23arr, j, n[1], x[1], w[1])) - (DelayedValue(y12arr, j, n[2], x[2], w[2]) + DelayedValue(y21arr, j, n[3], x[3], w[3]));
+    double Z = (y23arr[j] + DelayedValue(y32arr, j, n[1], x[1], w[1])) + (DelayedValue(y13arr, j, n[2], x[2], w[2]) + DelayedValue(y31arr, j, n[3], x[3], w[3])) - (y13arr[j] + DelayedValue(y31arr, j, n[1], x[1], w[1])) - (DelayedValue(y23arr, j, n[2], x[2], w[2]) + DelayedValue(y32arr, j, n[3], x[3], w[3]));
+    if(tditag==TDIXYZ) {
+      tdi1[i] = X;
+      tdi2[i] = Y;
+      tdi3[i] = Z;
+    }
+    else {
+      tdi1[i] = 1./(2*sqrt(2)) * (Z-X);
+      tdi2[i] = 1./(2*sqrt(6)) * (X-2*Y+Z);
+      tdi3[i] = 1./(2*sqrt(3)) * (X+Y+Z);
+    }
+  }
+
+  free(y12arr);
+  free(y21arr);
+  free(y23arr);
+  free(y32arr);
+  free(y31arr);
+  free(y13arr);
+  return SUCCESS;
+}
+
 /**/
 int GenerateTDITD3Chanhphc(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   RealTimeSeries** TDI1,                   /* Output: real time series for TDI channel 1 */
   RealTimeSeries** TDI2,                   /* Output: real time series for TDI channel 2 */
   RealTimeSeries** TDI3,                   /* Output: real time series for TDI channel 3 */
@@ -1543,27 +1643,22 @@ int GenerateTDITD3Chanhphc(
   if(tditag==y12) {
     for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
       t = tval[i];
-      tdi1[i] = y12TD(variant, splinehp, splinehc, accelhp, accelhc, t);
+      tdi1[i] = y12TD(variant, coeffs, splinehp, splinehc, accelhp, accelhc, t);
       tdi2[i] = 0.;
       tdi3[i] = 0.;
     }
   }
-  else if(tditag==TDIXYZ) {
-    for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
-      t = tval[i];
-      EvaluateTDIXYZTD(variant, &tdi1val, &tdi2val, &tdi3val, splinehp, splinehc, accelhp, accelhc, t);
-      tdi1[i] = tdi1val;
-      tdi2[i] = tdi2val;
-      tdi3[i] = tdi3val;
-    }
-  }
-  else if(tditag==TDIAETXYZ) {
-    for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
-      t = tval[i];
-      EvaluateTDIAETXYZTD(variant, &tdi1val, &tdi2val, &tdi3val, splinehp, splinehc, accelhp, accelhc, t);
-      tdi1[i] = tdi1val;
-      tdi2[i] = tdi2val;
-      tdi3[i] = tdi3val;
+  /* XYZ and AET: on a uniform grid, each yAB is computed once and reused for all delays - otherwise fall back to sample-by-sample evaluation */
+  else if(tditag==TDIXYZ || tditag==TDIAETXYZ) {
+    if(GenerateTDITDXYZhphcDelayed(variant, coeffs, tdi1, tdi2, tdi3, splinehp, splinehc, times, nbptmargin, tditag)==FAILURE) {
+      for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
+        t = tval[i];
+        if(tditag==TDIXYZ) EvaluateTDIXYZTD(variant, coeffs, &tdi1val, &tdi2val, &tdi3val, splinehp, splinehc, accelhp, accelhc, t);
+        else EvaluateTDIAETXYZTD(variant, coeffs, &tdi1val, &tdi2val, &tdi3val, splinehp, splinehc, accelhp, accelhc, t);
+        tdi1[i] = tdi1val;
+        tdi2[i] = tdi2val;
+        tdi3[i] = tdi3val;
+      }
     }
   }
   else {
@@ -1576,6 +1671,7 @@ int GenerateTDITD3Chanhphc(
 /* Generate hO orbital-delayed for one mode contribution from amp, phase */
 int Generateh22TDO(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   AmpPhaseTimeSeries** h22tdO,             /* Output: amp/phase time series for h22TDO */
   gsl_spline* splineamp,                   /* Input spline for TD mode amplitude */
   gsl_spline* splinephase,                 /* Input spline for TD mode phase */
@@ -1600,7 +1696,7 @@ int Generateh22TDO(
   /* Loop over time samples */
   for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
     t = tval[i];
-    hOTDAmpPhase(variant,&(amp[i]), &(phase[i]), splineamp, splinephase, accelamp, accelphase, t);
+    hOTDAmpPhase(variant, coeffs, &(amp[i]), &(phase[i]), splineamp, splinephase, accelamp, accelphase, t);
   }
 
   return SUCCESS;
@@ -1611,6 +1707,7 @@ int Generateh22TDO(
 /* BEWARE: this ignores the fact that processing through orbital delay breaks the h2-2 = h22* symmetry */
 int Generatey12LTD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   RealTimeSeries** y12Ltd,                 /* Output: real time series for y12L */
   gsl_spline* splineamp,                   /* Input spline for h22 TD amplitude */
   gsl_spline* splinephase,                 /* Input spline for h22 TD phase */
@@ -1639,7 +1736,7 @@ int Generatey12LTD(
   /* Loop over time samples */
   for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
     t = tval[i];
-    y12val[i] = y12LTDfromh22AmpPhase(variant, splineamp, splinephase, accelamp, accelphase, Y22, Y2m2, t);
+    y12val[i] = y12LTDfromh22AmpPhase(variant, coeffs, splineamp, splinephase, accelamp, accelphase, Y22, Y2m2, t);
   }
 
   return SUCCESS;
@@ -1650,6 +1747,7 @@ int Generatey12LTD(
 /* Note: includes both h22 and h2m2 contributions, assuming planar orbits so that h2-2 = h22* */
 int Generatey12TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   RealTimeSeries** y12td,                 /* Output: real time series for y12L */
   gsl_spline* splineamp,                   /* Input spline for h22 TD amplitude */
   gsl_spline* splinephase,                 /* Input spline for h22 TD phase */
@@ -1678,7 +1776,7 @@ int Generatey12TD(
   /* Loop over time samples */
   for(int i=nbptmargin; i<nbpt-nbptmargin; i++) {
     t = tval[i];
-    y12val[i] = y12TDfromh22AmpPhase(variant, splineamp, splinephase, accelamp, accelphase, Y22, Y2m2, t);
+    y12val[i] = y12TDfromh22AmpPhase(variant, coeffs, splineamp, splinephase, accelamp, accelphase, Y22, Y2m2, t);
   }
 
   return SUCCESS;
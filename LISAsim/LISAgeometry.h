@@ -98,6 +98,50 @@ extern LISAconstellation fastOrbitLISA;
 extern LISAconstellation bigOrbitLISA;
 
 
+/**************************************************/
+/********* Geometric response coefficients ********/
+
+/* Time-independent trigonometric coefficients entering the response, for a given position in the sky and polarization */
+/* Set by SetCoeffsG and passed explicitly to the response functions - holds no global state, so that different sky positions can be processed concurrently */
+typedef struct tagLISAGeometricCoeffs {
+  /* Projection coefficients for hplus, hcross in nA.H.nA */
+  double coeffn1Hn1plusconst, coeffn1Hn1crossconst, coeffn2Hn2plusconst, coeffn2Hn2crossconst, coeffn3Hn3plusconst, coeffn3Hn3crossconst;
+  double coeffn1Hn1pluscos[4];
+  double coeffn1Hn1plussin[4];
+  double coeffn2Hn2pluscos[4];
+  double coeffn2Hn2plussin[4];
+  double coeffn3Hn3pluscos[4];
+  double coeffn3Hn3plussin[4];
+  double coeffn1Hn1crosscos[4];
+  double coeffn1Hn1crosssin[4];
+  double coeffn2Hn2crosscos[4];
+  double coeffn2Hn2crosssin[4];
+  double coeffn3Hn3crosscos[4];
+  double coeffn3Hn3crosssin[4];
+  /* Coefficients in k.nA, k.pA, k.(pA+pB), k.R */
+  double coeffkn1const, coeffkn2const, coeffkn3const, coeffkp1plusp2const, coeffkp2plusp3const, coeffkp3plusp1const, coeffkp1const, coeffkp2const, coeffkp3const, coeffkRconst;
+  double coeffkn1cos[2];
+  double coeffkn1sin[2];
+  double coeffkn2cos[2];
+  double coeffkn2sin[2];
+  double coeffkn3cos[2];
+  double coeffkn3sin[2];
+  double coeffkp1plusp2cos[2];
+  double coeffkp1plusp2sin[2];
+  double coeffkp2plusp3cos[2];
+  double coeffkp2plusp3sin[2];
+  double coeffkp3plusp1cos[2];
+  double coeffkp3plusp1sin[2];
+  double coeffkp1cos[2];
+  double coeffkp1sin[2];
+  double coeffkp2cos[2];
+  double coeffkp2sin[2];
+  double coeffkp3cos[2];
+  double coeffkp3sin[2];
+  double coeffkRcos[2];
+  double coeffkRsin[2];
+} LISAGeometricCoeffs;
+
 /**************************************************/
 /**************** Prototypes **********************/
 
@@ -115,17 +159,18 @@ double tSSBfromtL(const LISAconstellation *LISAvariant, const double tL, const d
 double tLfromtSSB(const LISAconstellation *LISAvariant, const double tSSB, const double lambda, const double beta);
 
 /* Function to compute, given a value of a sky position and polarization, all the complicated time-independent trigonometric coefficients entering the response */
-void SetCoeffsG(const double lambda, const double beta, const double psi);
+void SetCoeffsG(LISAGeometricCoeffs* coeffs, const double lambda, const double beta, const double psi);
 
 /* Functions evaluating the G_AB functions, combining the two polarization with the spherical harmonics factors */
-double complex G21mode(const LISAconstellation *LISAvariant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
-double complex G12mode(const LISAconstellation *LISAvariant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
-double complex G32mode(const LISAconstellation *LISAvariant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
-double complex G23mode(const LISAconstellation *LISAvariant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
-double complex G13mode(const LISAconstellation *LISAvariant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
-double complex G31mode(const LISAconstellation *LISAvariant, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
+double complex G21mode(const LISAconstellation *LISAvariant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
+double complex G12mode(const LISAconstellation *LISAvariant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
+double complex G32mode(const LISAconstellation *LISAvariant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
+double complex G23mode(const LISAconstellation *LISAvariant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
+double complex G13mode(const LISAconstellation *LISAvariant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
+double complex G31mode(const LISAconstellation *LISAvariant, const LISAGeometricCoeffs *coeffs, const double f, const double t, const double complex Yfactorplus, const double complex Yfactorcross);
 int EvaluateGABmode(
   const LISAconstellation *LISAvariant,
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double complex* G12,                     /* Output for G12 */
   double complex* G21,                     /* Output for G21 */
   double complex* G23,                     /* Output for G23 */
@@ -190,6 +235,7 @@ int RestoreInPlaceScaledFactorTDI(
 /* Basic yslr observables (including orbital delay) from hplus, hcross */
 double y12TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -197,6 +243,7 @@ double y12TD(
   const double t);                         /* Time */
 double y21TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -204,6 +251,7 @@ double y21TD(
   const double t);                         /* Time */
 double y23TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -211,6 +259,7 @@ double y23TD(
   const double t);                         /* Time */
 double y32TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -218,6 +267,7 @@ double y32TD(
   const double t);                         /* Time */
 double y31TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -225,6 +275,7 @@ double y31TD(
   const double t);                         /* Time */
 double y13TD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   gsl_spline* splinehp,                    /* Input spline for TD hplus */
   gsl_spline* splinehc,                    /* Input spline for TD hcross */
   gsl_interp_accel* accelhp,               /* Accelerator for hp spline */
@@ -233,6 +284,7 @@ double y13TD(
 /* TDI observables (including orbital delay) from hplus, hcross */
 int EvaluateTDIXYZTDhphc(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double* TDIX,                            /* Output: value of TDI observable X */
   double* TDIY,                            /* Output: value of TDI observable Y */
   double* TDIZ,                            /* Output: value of TDI observable Z */
@@ -243,6 +295,7 @@ int EvaluateTDIXYZTDhphc(
   const double t);                         /* Time */
 int EvaluateTDIAETXYZTDhphc(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   double* TDIA,                            /* Output: value of TDI observable X */
   double* TDIE,                            /* Output: value of TDI observable Y */
   double* TDIT,                            /* Output: value of TDI observable Z */
@@ -255,6 +308,7 @@ int EvaluateTDIAETXYZTDhphc(
 /* Generate hO orbital-delayed for one mode contribution from amp, phase */
 int Generateh22TDO(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   AmpPhaseTimeSeries** h22tdO,             /* Output: amp/phase time series for h22TDO */
   gsl_spline* splineamp,                   /* Input spline for TD mode amplitude */
   gsl_spline* splinephase,                 /* Input spline for TD mode phase */
@@ -265,6 +319,7 @@ int Generateh22TDO(
 /* Generate y12L from orbital-delayed h22 in amp/phase form */
 int Generatey12LTD(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   RealTimeSeries** y12Ltd,                 /* Output: real time series for y12L */
   gsl_spline* splineamp,                   /* Input spline for TD mode amplitude */
   gsl_spline* splinephase,                 /* Input spline for TD mode phase */
@@ -274,6 +329,19 @@ int Generatey12LTD(
   double Theta,                            /* Inclination */
   double Phi,                              /* Phase */
   int nbptmargin);                         /* Margin set to 0 on both side to avoid problems with delays out of the domain */
+/* Generate y12 from original h22 in amp/phase form, with the full response evaluated at once */
+int Generatey12TD(
+  const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
+  RealTimeSeries** y12td,                  /* Output: real time series for y12 */
+  gsl_spline* splineamp,                   /* Input spline for TD mode amplitude */
+  gsl_spline* splinephase,                 /* Input spline for TD mode phase */
+  gsl_interp_accel* accelamp,              /* Accelerator for amp spline */
+  gsl_interp_accel* accelphase,            /* Accelerator for phase spline */
+  gsl_vector* times,                       /* Vector of times to evaluate */
+  double Theta,                            /* Inclination */
+  double Phi,                              /* Phase */
+  int nbptmargin);                         /* Margin set to 0 on both side to avoid problems with delays out of the domain */
 
 
 /* Generate TDI observables (including orbital delay) for one mode contritbution from amp, phase */
@@ -296,6 +364,7 @@ int GenerateTDITD3Chanhlm(
 /* Generate TDI observables (including orbital delay) for one mode contritbution from hplus, hcross */
 int GenerateTDITD3Chanhphc(
   const LISAconstellation *variant,    /* Description of LISA variant */
+  const LISAGeometricCoeffs *coeffs,      /* Geometric coefficients for the sky position and polarization, set by SetCoeffsG */
   RealTimeSeries** TDI1,                   /* Output: real time series for TDI channel 1 */
   RealTimeSeries** TDI2,                   /* Output: real time series for TDI channel 2 */
   RealTimeSeries** TDI3,                   /* Output: real time series for TDI channel 3 */
@@ -316,6 +316,104 @@ ObjectFunction NoiseFunction(const LISAconstellation *variant, const TDItag tdit
   return fn;
 }
 
+/**************************************************************/
+/****** Tabulated noise functions  *******/
+
+/* Number of points of the first attempt, and maximal number of points, in the construction of the tables */
+#define noisetablenmin 1024
+#define noisetablenmax 4194304
+
+/* Interpolation of ln Sn at the fractional index x, with the 4 points around x (shifted at the edges) */
+static double NoiseTableInterp(const double* lnSn, const int n, const double x) {
+  int i = (int) x - 1;
+  if(i<0) i = 0;
+  if(i>n-4) i = n-4;
+  double u = x - i;
+  double um1 = u - 1., um2 = u - 2., um3 = u - 3.;
+  double l0 = -um1*um2*um3/6.;
+  double l1 = u*um2*um3/2.;
+  double l2 = -u*um1*um3/2.;
+  double l3 = u*um1*um2/6.;
+  return l0*lnSn[i] + l1*lnSn[i+1] + l2*lnSn[i+2] + l3*lnSn[i+3];
+}
+
+NoiseTable* NoiseTable_Build(const ObjectFunction fn, const double fLow, const double fHigh, const double tol)
+{
+  NoiseTable* table = malloc(sizeof(NoiseTable));
+  table->fn = fn;
+  table->lnfmin = log(fLow);
+  table->lnfmax = log(fHigh);
+  table->lnSn = NULL;
+  double maxerr = 0.;
+  for(int n=noisetablenmin; n<=noisetablenmax; n*=2) {
+    free(table->lnSn);
+    table->n = n;
+    table->lnSn = malloc(n*sizeof(double));
+    double dlnf = (table->lnfmax - table->lnfmin)/(n-1);
+    table->invdlnf = 1./dlnf;
+    for(int i=0; i<n; i++) table->lnSn[i] = log(ObjectFunctionCall(&fn, exp(table->lnfmin + i*dlnf)));
+    /* Check the accuracy at the middle of all intervals */
+    maxerr = 0.;
+    for(int i=0; i<n-1; i++) {
+      double Sn = ObjectFunctionCall(&fn, exp(table->lnfmin + (i+0.5)*dlnf));
+      maxerr = fmax(maxerr, fabs(exp(NoiseTableInterp(table->lnSn, n, i+0.5))/Sn - 1.));
+    }
+    if(maxerr<=tol) break;
+  }
+  if(maxerr>tol) printf("Warning in NoiseTable_Build: tolerance %g not reached, relative error %g with %d points.\n", tol, maxerr, table->n);
+  return table;
+}
+void NoiseTable_Cleanup(NoiseTable* table) {
+  free(table->lnSn);
+  free(table);
+}
+
+double NoiseTableEval(const NoiseTable* table, double f) {
+  double lnf = log(f);
+  if(!(lnf>=table->lnfmin && lnf<=table->lnfmax)) return ObjectFunctionCall(&(table->fn), f);
+  return exp(NoiseTableInterp(table->lnSn, table->n, (lnf - table->lnfmin)*table->invdlnf));
+}
+
+/* Tables already built - the noise functions only depend on the arm length and the noise model of the constellation */
+#define noisetablecachesize 32
+typedef struct tagNoiseTableCacheEntry
+{
+  double ConstL;
+  LISANoiseType noise;
+  TDItag tditag;
+  int nchan;
+  double tol;
+  NoiseTable* table;
+} NoiseTableCacheEntry;
+static NoiseTableCacheEntry noisetablecache[noisetablecachesize];
+static int noisetablecachecount = 0;
+
+ObjectFunction NoiseFunctionTabulated(const LISAconstellation *variant, const TDItag tditag, const int nchan, const double tol)
+{
+  NoiseTable* table = NULL;
+  /* Lookup and construction are serialized, the tables themselves are only read afterwards */
+  #pragma omp critical (noisetablecache)
+  {
+    for(int k=0; k<noisetablecachecount; k++) {
+      NoiseTableCacheEntry* entry = &noisetablecache[k];
+      if(entry->ConstL==variant->ConstL && entry->noise==variant->noise && entry->tditag==tditag && entry->nchan==nchan && entry->tol==tol) {
+        table = entry->table;
+        break;
+      }
+    }
+    if(!table) {
+      if(noisetablecachecount>=noisetablecachesize) {
+        printf("Error in NoiseFunctionTabulated: too many noise tables.\n");
+        exit(1);
+      }
+      table = NoiseTable_Build(NoiseFunction(variant, tditag, nchan), __LISASimFD_Noise_fLow, __LISASimFD_Noise_fHigh, tol);
+      noisetablecache[noisetablecachecount] = (NoiseTableCacheEntry){variant->ConstL, variant->noise, tditag, nchan, tol, table};
+      noisetablecachecount++;
+    }
+  }
+  return (ObjectFunction){table, (RealObjectFunctionPtr)NoiseTableEval};
+}
+
 //Previous version - we had put a noise floor to mitigate cancellation lines
 /* double NoiseSnA(const double f) { */
 /*   double twopifL = 2.*PI*L_SI/C_SI*f; */
@@ -77,6 +77,30 @@ double SnAXYZNoRescaling(const LISAconstellation *variant, double f);
 double SnEXYZNoRescaling(const LISAconstellation *variant, double f);
 double SnTXYZNoRescaling(const LISAconstellation *variant, double f);
 
+/**************************************************************/
+/****** Tabulated noise functions  *******/
+
+/* Noise function tabulated as ln Sn on a uniform grid in ln f, interpolated with 4-point Lagrange polynomials */
+/* Outside the range of the table, the exact function is called */
+typedef struct tagNoiseTable
+{
+  ObjectFunction fn;  /* Exact noise function */
+  int n;              /* Number of points */
+  double lnfmin;      /* ln f of the first point */
+  double lnfmax;      /* ln f of the last point */
+  double invdlnf;     /* Inverse of the step in ln f */
+  double* lnSn;       /* Values of ln Sn, size n */
+} NoiseTable;
+
+/* Build a table for fn on [fLow, fHigh] - the number of points is doubled until the relative error on Sn at the middle of all intervals is below tol */
+NoiseTable* NoiseTable_Build(const ObjectFunction fn, const double fLow, const double fHigh, const double tol);
+void NoiseTable_Cleanup(NoiseTable* table);
+double NoiseTableEval(const NoiseTable* table, double f);
+
+/* Same as NoiseFunction, but returning a tabulated version on [__LISASimFD_Noise_fLow, __LISASimFD_Noise_fHigh] with relative accuracy tol */
+/* Tables are built once per constellation/TDI/channel/tolerance, kept for the whole run and shared read-only between threads */
+ObjectFunction NoiseFunctionTabulated(const LISAconstellation *variant, const TDItag tditag, const int nchan, const double tol);
+
 /* Function returning the relevant noise function, given a set of TDI observables and a channel */
 /* double (*NoiseFunction(const TDItag tditag, const int chan))(double); */
 
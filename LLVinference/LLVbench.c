@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+
+#include "LLVutils.h"
+#include "benchutils.h"
+
+
+/************************************************** Benchmark program *******************************************************/
+/* Microbenchmarks of the stages of the LLV likelihood, on a grid of total masses and lower frequencies (standing for the
+   duration of the signal) around the injection given on the command line (all options of LLVinference are accepted) -
+   reports ns/eval and allocations/eval, and checks the overlaps and loglikelihoods against reference values stored in
+   a file (LLVbench.ref holds the values before the optimizations, for the default options - written on the first run
+   if missing, or with --writeref) */
+
+/* Grid of total masses (solar masses, mass ratio benchq) and lower frequencies (Hz) */
+static const double benchMtot[] = {20., 50., 100.};
+static const double benchminf[] = {10., 20.};
+static const double benchq = 2.;
+#define nbbenchMtot (int) (sizeof(benchMtot)/sizeof(benchMtot[0]))
+#define nbbenchminf (int) (sizeof(benchminf)/sizeof(benchminf[0]))
+
+/* Number of frequencies for the evaluation of the noise */
+#define nbbenchnoise 4096
+
+/* Everything needed by the benchmarked functions for one point of the grid */
+typedef struct tagLLVBenchPoint {
+  LLVParams* tparams;                          /* Template parameters, close to the injection */
+  ListmodesCAmpPhaseFrequencySeries* listROM;  /* Template modes, before the response */
+  ListmodesCAmpPhaseFrequencySeries* listDet[3];  /* Template modes in the three detectors */
+  ObjectFunction* Sn[3];                       /* Noise functions of the three detectors */
+  LLVInjectionCAmpPhase* injCAmpPhase;
+  LLVInjectionReIm* injReIm;
+  LLVSignalReIm* sigReIm;                      /* Template on the frequencies of injReIm */
+  int nwip;                                    /* Injection 22 mode in LHO as plain arrays, for wip_phase */
+  double* fwip;
+  double* Arwip;
+  double* Aiwip;
+  double* phwip;
+  double* fnoise;                              /* Frequencies for the evaluation of the noise */
+  double value;                                /* Output of the last call */
+} LLVBenchPoint;
+
+/* wip_phase takes a plain function for the noise */
+static double BenchWIPNoise(double f) {
+  return NoiseSnLHO(f);
+}
+
+/************** Benchmarked functions *****************/
+
+static void BenchROM(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  LLVParams* t = p->tparams;
+  ListmodesCAmpPhaseFrequencySeries* list = NULL;
+  SimEOBNRv2HMROM(&list, t->nbmode, t->tRef - injectedparams->tRef, t->phiRef, globalparams->fRef, t->m1*MSUN_SI, t->m2*MSUN_SI, t->distance*1e6*PC_SI);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(list);
+}
+
+static void BenchResponse(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  LLVParams* t = p->tparams;
+  ListmodesCAmpPhaseFrequencySeries* l1 = NULL;
+  ListmodesCAmpPhaseFrequencySeries* l2 = NULL;
+  ListmodesCAmpPhaseFrequencySeries* l3 = NULL;
+  LLVSimFDResponse3Det(&l1, &l2, &l3, &(p->listROM), t->tRef, t->ra, t->dec, t->inclination, t->polarization, globalparams->tagnetwork);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(l1);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(l2);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(l3);
+}
+
+static void BenchSplines(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  for(int d=0; d<3; d++) {
+    ListmodesCAmpPhaseSpline* splines = NULL;
+    BuildListmodesCAmpPhaseSpline(&splines, p->listDet[d]);
+    ListmodesCAmpPhaseSpline_Destroy(splines);
+  }
+}
+
+static void BenchSplines3Chan(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  ListmodesCAmpPhaseSpline* splines[3] = {NULL, NULL, NULL};
+  BuildListmodesCAmpPhaseSpline3Chan(&splines[0], &splines[1], &splines[2], p->listDet[0], p->listDet[1], p->listDet[2]);
+  for(int d=0; d<3; d++) ListmodesCAmpPhaseSpline_Destroy(splines[d]);
+}
+
+static void BenchOverlap(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  p->value = FDListmodesFresnelOverlap(p->listDet[0], p->injCAmpPhase->LHOSplines, p->Sn[0], globalparams->minf, globalparams->maxf, 0., 0.)
+           + FDListmodesFresnelOverlap(p->listDet[1], p->injCAmpPhase->LLOSplines, p->Sn[1], globalparams->minf, globalparams->maxf, 0., 0.)
+           + FDListmodesFresnelOverlap(p->listDet[2], p->injCAmpPhase->VIRGOSplines, p->Sn[2], globalparams->minf, globalparams->maxf, 0., 0.);
+}
+
+static void BenchWIP(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  CAmpPhaseFrequencySeries* h1 = ListmodesCAmpPhaseFrequencySeries_GetMode(p->listDet[0], 2, 2)->freqseries;
+  p->value = 4.*creal(wip_phase(h1->freq->data, (int) h1->freq->size, p->fwip, p->nwip, h1->amp_real->data, h1->amp_imag->data, h1->phase->data, p->Arwip, p->Aiwip, p->phwip, BenchWIPNoise, 1.0, globalparams->minf, globalparams->maxf));
+}
+
+static void BenchNoise(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  double sum = 0.;
+  for(int i=0; i<nbbenchnoise; i++) sum += 1./NoiseSnLHO(p->fnoise[i]);
+  p->value = sum;
+}
+
+static void BenchLogLCAmpPhase(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  p->value = CalculateLogLCAmpPhase(p->tparams, p->injCAmpPhase);
+}
+
+static void BenchLogLReIm(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  p->value = CalculateLogLReIm(p->tparams, p->injReIm);
+}
+
+static void BenchFDLogLikelihoodReIm(void* arg) {
+  LLVBenchPoint* p = (LLVBenchPoint*) arg;
+  p->value = FDLogLikelihoodReIm(p->injReIm->LHOSignal, p->sigReIm->LHOSignal, p->injReIm->noisevaluesLHO)
+           + FDLogLikelihoodReIm(p->injReIm->LLOSignal, p->sigReIm->LLOSignal, p->injReIm->noisevaluesLLO)
+           + FDLogLikelihoodReIm(p->injReIm->VIRGOSignal, p->sigReIm->VIRGOSignal, p->injReIm->noisevaluesVIRGO);
+}
+
+/************** Driver *****************/
+
+/* Time fn on the point p and print the result - with check of p->value if hasvalue */
+static void BenchPoint(BenchContext* ctx, const char name[], const int index, void (*fn)(void*), LLVBenchPoint* p, const int hasvalue) {
+  double nseval, allocseval;
+  BenchRun(ctx, fn, p, &nseval, &allocseval);
+  BenchReport(ctx, name, index, nseval, allocseval, hasvalue, p->value);
+}
+
+static void BenchGridPoint(BenchContext* ctx, const int index) {
+  LLVBenchPoint p;
+  memset(&p, 0, sizeof(LLVBenchPoint));
+
+  /* Template: injection with slightly shifted mass and phase */
+  LLVParams tparams = *injectedparams;
+  tparams.m1 *= 1. + 1e-4;
+  tparams.phiRef += 0.1;
+  tparams.nbmode = globalparams->nbmodetemp;
+  p.tparams = &tparams;
+  p.Sn[0] = &LLVNoiseSnLHO;
+  p.Sn[1] = &LLVNoiseSnLLO;
+  p.Sn[2] = &LLVNoiseSnVIRGO;
+
+  /* Injections for the two likelihoods */
+  LLVInjectionCAmpPhase_Init(&(p.injCAmpPhase));
+  LLVInjectionReIm_Init(&(p.injReIm));
+  LLVSignalReIm_Init(&(p.sigReIm));
+  if(LLVGenerateInjectionCAmpPhase(injectedparams, p.injCAmpPhase)==FAILURE
+     || LLVGenerateInjectionReIm(injectedparams, globalparams->minf, globalparams->maxf, globalparams->nbptsoverlap, 1, p.injReIm)==FAILURE
+     || LLVGenerateSignalReIm(&tparams, p.injReIm->freq, p.sigReIm)==FAILURE) {
+    printf("Error: generation of the injection failed for grid point %d\n", index);
+    ctx->nbfail++;
+    LLVInjectionCAmpPhase_Cleanup(p.injCAmpPhase);
+    LLVInjectionReIm_Cleanup(p.injReIm);
+    LLVSignalReIm_Cleanup(p.sigReIm);
+    return;
+  }
+
+  /* Template modes, before and after the response */
+  SimEOBNRv2HMROM(&(p.listROM), tparams.nbmode, tparams.tRef - injectedparams->tRef, tparams.phiRef, globalparams->fRef, tparams.m1*MSUN_SI, tparams.m2*MSUN_SI, tparams.distance*1e6*PC_SI);
+  LLVSimFDResponse3Det(&(p.listDet[0]), &(p.listDet[1]), &(p.listDet[2]), &(p.listROM), tparams.tRef, tparams.ra, tparams.dec, tparams.inclination, tparams.polarization, globalparams->tagnetwork);
+
+  /* Injection 22 mode in LHO for wip_phase - the first column of the splines holds the frequencies, the second the values */
+  CAmpPhaseSpline* splinesinj22 = ListmodesCAmpPhaseSpline_GetMode(p.injCAmpPhase->LHOSplines, 2, 2)->splines;
+  p.nwip = (int) splinesinj22->spline_amp_real->size1;
+  p.fwip = (double*) malloc(p.nwip*sizeof(double));
+  p.Arwip = (double*) malloc(p.nwip*sizeof(double));
+  p.Aiwip = (double*) malloc(p.nwip*sizeof(double));
+  p.phwip = (double*) malloc(p.nwip*sizeof(double));
+  for(int i=0; i<p.nwip; i++) {
+    p.fwip[i] = gsl_matrix_get(splinesinj22->spline_amp_real, i, 0);
+    p.Arwip[i] = gsl_matrix_get(splinesinj22->spline_amp_real, i, 1);
+    p.Aiwip[i] = gsl_matrix_get(splinesinj22->spline_amp_imag, i, 1);
+    p.phwip[i] = gsl_matrix_get(splinesinj22->quadspline_phase, i, 1);
+  }
+
+  /* Logarithmically spaced frequencies in the band, for the noise evaluation */
+  p.fnoise = (double*) malloc(nbbenchnoise*sizeof(double));
+  double fLownoise = fmax(globalparams->minf, __LLVSimFD_LHONoise_fLow);
+  double fHighnoise = globalparams->maxf>0 ? fmin(globalparams->maxf, __LLVSimFD_LHONoise_fHigh) : __LLVSimFD_LHONoise_fHigh;
+  for(int i=0; i<nbbenchnoise; i++) p.fnoise[i] = fLownoise * pow(fHighnoise/fLownoise, (double) i/(nbbenchnoise-1));
+
+  printf("# Grid point %d: m1=%g m2=%g minf=%g - %d frequencies in the 22 mode\n", index, injectedparams->m1, injectedparams->m2, globalparams->minf, (int) ListmodesCAmpPhaseFrequencySeries_GetMode(p.listDet[0], 2, 2)->freqseries->freq->size);
+  BenchPoint(ctx, "SimEOBNRv2HMROM", index, BenchROM, &p, 0);
+  BenchPoint(ctx, "LLVSimFDResponse3Det", index, BenchResponse, &p, 0);
+  BenchPoint(ctx, "BuildListmodesCAmpPhaseSpline", index, BenchSplines, &p, 0);
+  BenchPoint(ctx, "BuildListmodesCAmpPhaseSpline3Chan", index, BenchSplines3Chan, &p, 0);
+  BenchPoint(ctx, "FDListmodesFresnelOverlap", index, BenchOverlap, &p, 1);
+  BenchPoint(ctx, "wip_phase", index, BenchWIP, &p, 1);
+  BenchPoint(ctx, "NoiseSnLHO", index, BenchNoise, &p, 1);
+  BenchPoint(ctx, "CalculateLogLCAmpPhase", index, BenchLogLCAmpPhase, &p, 1);
+  BenchPoint(ctx, "CalculateLogLReIm", index, BenchLogLReIm, &p, 1);
+  BenchPoint(ctx, "FDLogLikelihoodReIm", index, BenchFDLogLikelihoodReIm, &p, 1);
+
+  /* Clean up */
+  free(p.fwip);
+  free(p.Arwip);
+  free(p.Aiwip);
+  free(p.phwip);
+  free(p.fnoise);
+  ListmodesCAmpPhaseFrequencySeries_Destroy(p.listROM);
+  for(int d=0; d<3; d++) ListmodesCAmpPhaseFrequencySeries_Destroy(p.listDet[d]);
+  LLVInjectionCAmpPhase_Cleanup(p.injCAmpPhase);
+  LLVInjectionReIm_Cleanup(p.injReIm);
+  LLVSignalReIm_Cleanup(p.sigReIm);
+}
+
+static const char* benchusage = "\
+LLVbench: microbenchmarks of the LLV likelihood, on a grid of masses and lower frequencies around the injection\n\
+Options specific to LLVbench - all other options are passed to the LLVinference parser:\n\
+ --nrep                Number of evaluations per timing (default 10)\n\
+ --nround              Number of timings, the fastest being reported (default 3)\n\
+ --reffile             File of reference values (default LLVbench.ref)\n\
+ --writeref            Write the values of this run to the reference file (done anyway when the file does not exist)\n\
+ --reftol              Tolerance on the deviation |value-ref|/max(|ref|,1) from the reference values (default 1e-8)\n\
+\n";
+
+int main(int argc, char *argv[])
+{
+  BenchContext ctx;
+  memset(&ctx, 0, sizeof(BenchContext));
+  ctx.nbrep = 10;
+  ctx.nbround = 3;
+  ctx.reftol = 1e-8;
+  char reffile[256] = "LLVbench.ref";
+  int writeref = 0;
+
+  /* Extract the options of the benchmark, pass the others to the LLVinference parser */
+  char** argvLLV = (char**) malloc((argc+1)*sizeof(char*));
+  int argcLLV = 0;
+  argvLLV[argcLLV++] = argv[0];
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "--nrep")==0 && i+1<argc) ctx.nbrep = atoi(argv[++i]);
+    else if(strcmp(argv[i], "--nround")==0 && i+1<argc) ctx.nbround = atoi(argv[++i]);
+    else if(strcmp(argv[i], "--reffile")==0 && i+1<argc) strncpy(reffile, argv[++i], 255);
+    else if(strcmp(argv[i], "--writeref")==0) writeref = 1;
+    else if(strcmp(argv[i], "--reftol")==0 && i+1<argc) ctx.reftol = atof(argv[++i]);
+    else {
+      if(strcmp(argv[i], "--help")==0) printf("%s", benchusage);
+      argvLLV[argcLLV++] = argv[i];
+    }
+  }
+  argvLLV[argcLLV] = NULL;
+  if(ctx.nbrep<1 || ctx.nbround<1) {
+    printf("Error: --nrep and --nround must be positive\n");
+    exit(1);
+  }
+
+  LLVRunParams runParams;
+  memset(&runParams, 0, sizeof(LLVRunParams));
+  injectedparams = (LLVParams*) malloc(sizeof(LLVParams));
+  memset(injectedparams, 0, sizeof(LLVParams));
+  globalparams = (LLVGlobalParams*) malloc(sizeof(LLVGlobalParams));
+  memset(globalparams, 0, sizeof(LLVGlobalParams));
+  priorParams = (LLVPrior*) malloc(sizeof(LLVPrior));
+  memset(priorParams, 0, sizeof(LLVPrior));
+  LLVParams* addparams = (LLVParams*) malloc(sizeof(LLVParams));
+  memset(addparams, 0, sizeof(LLVParams));
+  parse_args_LLV(argcLLV, argvLLV, injectedparams, globalparams, priorParams, &runParams, addparams);
+  injectedparams->nbmode = globalparams->nbmodeinj;
+
+  /* Load and initialize the detector noise */
+  LLVSimFD_Noise_Init_ParsePath();
+
+  /* Reference values */
+  BenchReference_Init(&ctx.ref);
+  BenchReference_Init(&ctx.out);
+  if(BenchReference_Read(ctx.ref, reffile)==FAILURE) {
+    printf("# No reference values in %s - they will be written at the end of this run\n", reffile);
+    writeref = 1;
+  }
+  printf("# %d evaluations per timing, best of %d - allocations %s\n", ctx.nbrep, ctx.nbround, BenchAllocations()>=0 ? "counted" : "not counted on this platform");
+
+  /* Grid of masses and lower frequencies */
+  for(int im=0; im<nbbenchMtot; im++) {
+    for(int jf=0; jf<nbbenchminf; jf++) {
+      injectedparams->m1 = benchMtot[im] * benchq/(1.+benchq);
+      injectedparams->m2 = benchMtot[im] / (1.+benchq);
+      globalparams->minf = benchminf[jf];
+      BenchGridPoint(&ctx, im*nbbenchminf + jf);
+    }
+  }
+
+  printf("# %d values checked against the reference and %d cross-checks, %d failed, %d without reference\n", ctx.out->n - ctx.nbmissing, ctx.nbcheck, ctx.nbfail, ctx.nbmissing);
+  if(writeref) {
+    if(BenchReference_Write(ctx.out, reffile)==SUCCESS) printf("# Reference values written to %s\n", reffile);
+  }
+
+  BenchReference_Cleanup(ctx.ref);
+  BenchReference_Cleanup(ctx.out);
+  free(argvLLV);
+  free(addparams);
+  return ctx.nbfail>0 ? 1 : 0;
+}
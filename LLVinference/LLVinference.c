@@ -177,7 +177,10 @@ void getLogLike(double *Cube, int *ndim, int *npars, double *lnew, void *context
   templateparams.nbmode = globalparams->nbmodetemp;
 
 	/* Note: context points to a LLVContext structure containing a LLVSignal* */
-  if(globalparams->tagint==0) {
+  if(globalparams->margdist || globalparams->margphase) {
+    *lnew = CalculateLogLMarginalized(&templateparams, context);
+  }
+  else if(globalparams->tagint==0) {
     LLVInjectionCAmpPhase* injection = ((LLVInjectionCAmpPhase*) context);
 
     //TESTING
@@ -287,10 +290,18 @@ int main(int argc, char *argv[])
   /* Parse commandline to read parameters of injection - copy the number of modes demanded for the injection  */
   parse_args_LLV(argc, argv, injectedparams, globalparams, priorParams, &runParams, addparams);
   injectedparams->nbmode = globalparams->nbmodeinj;
+  ProfileEnable(runParams.profile);
 	if(myid == 0) print_parameters_to_file_LLV(injectedparams, globalparams, priorParams, &runParams);
 
   /* Load and initialize the detector noise */
-  LLVSimFD_Noise_Init_ParsePath();
+  /* With MPI, the noise tables and the ROM data are loaded once per node in memory shared by the processes of the node */
+  if(NodeSharedEnabled()) {
+    const double* noisetables = NULL;
+    if(NodeSharedLoad(LLVSimFD_Noise_TablesSize(), LLVSimFD_Noise_Read_Tables, NULL, (const void**) &noisetables)==FAILURE) exit(1);
+    LLVSimFD_Noise_Init_Tables(noisetables);
+    EOBNRv2HMROM_Init_DATA_Loader(NodeSharedReadFile);
+  }
+  else LLVSimFD_Noise_Init_ParsePath();
 
 	/* Initialize the data structure for the injection */
   LLVInjectionCAmpPhase* injectedsignalCAmpPhase = NULL;
@@ -351,15 +362,8 @@ int main(int argc, char *argv[])
     printf("SNR Network: %g\n", SNR123);
   }
 
-  /* Calculate logL of injection */
-	double logZinj = 0;
-	if(globalparams->tagint==0) {
-    logZinj = CalculateLogLCAmpPhase(injectedparams, injectedsignalCAmpPhase);
-  }
-  else if(globalparams->tagint==1) {
-    logZinj = CalculateLogLReIm(injectedparams, injectedsignalReIm);
-  }
-  if (myid == 0) printf("logZinj = %lf\n", logZinj);
+  /* Quadrature for the marginalization over the distance, with the overlaps computed at dist_min - after the possible rescaling of the prior */
+  if(globalparams->margdist) DistanceMarginalization_Init(&distmarginalization, priorParams->dist_min, priorParams->dist_max, priorParams->dist_min, priorParams->flat_distprior, 64);
 
 	/* Set the context pointer */
   void *context = NULL;
@@ -370,6 +374,19 @@ int main(int argc, char *argv[])
     context = injectedsignalReIm;
   }
 
+  /* Calculate logL of injection */
+	double logZinj = 0;
+	if(globalparams->margdist || globalparams->margphase) {
+    logZinj = CalculateLogLMarginalized(injectedparams, context);
+  }
+  else if(globalparams->tagint==0) {
+    logZinj = CalculateLogLCAmpPhase(injectedparams, injectedsignalCAmpPhase);
+  }
+  else if(globalparams->tagint==1) {
+    logZinj = CalculateLogLReIm(injectedparams, injectedsignalReIm);
+  }
+  if (myid == 0) printf("logZinj = %lf\n", logZinj);
+
   int nPar = 9;	  /* Total no. of parameters including free & derived parameters */
   int ndim = 9;   /* No. of free parameters - to be changed later if some parameters are fixed */
 
@@ -429,18 +446,23 @@ int main(int argc, char *argv[])
     templateparams.nbmode = globalparams->nbmodetemp;
 
 		double logL = 0.;
-		if(globalparams->tagint==0) {
+		if(globalparams->margdist || globalparams->margphase) {
+			logL = CalculateLogLMarginalized(&templateparams, context);
+		}
+		else if(globalparams->tagint==0) {
 			logL = CalculateLogLCAmpPhase(&templateparams, injectedsignalCAmpPhase);
 		}
 		else if(globalparams->tagint==1) {
 			logL = CalculateLogLReIm(&templateparams, injectedsignalReIm);
 		}
     if (myid == 0) printf("logL = %lf\n", logL);
+    print_profile_to_file_LLV(&runParams, myid);
 
     free(injectedparams);
     free(priorParams);
 
 #ifdef PARALLEL
+    NodeSharedCleanup();
     MPI_Finalize();
 #endif
 
@@ -592,10 +614,24 @@ int main(int argc, char *argv[])
 
 	BAMBIrun(mmodal, ceff, nlive, tol, efr, ndim, nPar, nClsPar, maxModes, updInt, Ztol, root, seed, pWrap, fb, resume, outfile, initMPI, logZero, maxiter, LogLikeFctn, dumper, BAMBIfctn, context);
 
+  /* Post-processing: draw the marginalized distance and/or phase for the equally weighted posterior samples */
+  if(myid==0 && (globalparams->margdist || globalparams->margphase)) {
+    char* pathpost = malloc(strlen(runParams.outroot)+64);
+    char* pathreconstructed = malloc(strlen(runParams.outroot)+64);
+    sprintf(pathpost, "%s%s", runParams.outroot, "post_equal_weights.dat");
+    sprintf(pathreconstructed, "%s%s", runParams.outroot, "post_equal_weights_reconstructed.dat");
+    LLVReconstructMarginalizedPosterior(pathpost, pathreconstructed, context);
+    free(pathpost);
+    free(pathreconstructed);
+  }
+
+  print_profile_to_file_LLV(&runParams, myid);
+
   free(injectedparams);
   free(priorParams);
 
 #ifdef PARALLEL
+ 	NodeSharedCleanup();
  	MPI_Finalize();
 #endif
 }
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 
 #include "LLVutils.h"
+#include "nodeshared.h"
 #include "bambi.h"
 
 #ifdef __INTEL_COMPILER 			// if the MultiNest library was compiled with ifort
@@ -31,6 +31,7 @@ int main(int argc, char *argv[])
   parse_args_LLV(argc, argv, injectedparams, globalparams, priorParams, &runParams, addparams);
   injectedparams->nbmode = globalparams->nbmodeinj;
   addparams->nbmode = globalparams->nbmodetemp;
+  if(globalparams->margdist) DistanceMarginalization_Init(&distmarginalization, priorParams->dist_min, priorParams->dist_max, priorParams->dist_min, priorParams->flat_distprior, 64);
 
   /* Load and initialize the detector noise */
   LLVSimFD_Noise_Init_ParsePath();
@@ -69,9 +70,15 @@ int main(int argc, char *argv[])
   printf("nbmode |                      %d |                      %d\n", injectedparams->nbmode, addparams->nbmode);
   printf("--------------------------------------------------------\n");
 
+  /* Context for the marginalized likelihood */
+  void* context = (globalparams->tagint==0) ? (void*) injectedsignalCAmpPhase : (void*) injectedsignalReIm;
+
   /* Calculate logL of injection */
   double logZinj = 0;
-  if(globalparams->tagint==0) {
+  if(globalparams->margdist || globalparams->margphase) {
+    logZinj = CalculateLogLMarginalized(injectedparams, context);
+  }
+  else if(globalparams->tagint==0) {
     logZinj = CalculateLogLCAmpPhase(injectedparams, injectedsignalCAmpPhase);
   }
   else if(globalparams->tagint==1) {
@@ -81,7 +88,10 @@ int main(int argc, char *argv[])
 
   /* Calculate logL of template */
   double logZtemp = 0;
-  if(globalparams->tagint==0) {
+  if(globalparams->margdist || globalparams->margphase) {
+    logZtemp = CalculateLogLMarginalized(addparams, context);
+  }
+  else if(globalparams->tagint==0) {
     logZtemp = CalculateLogLCAmpPhase(addparams, injectedsignalCAmpPhase);
   }
   else if(globalparams->tagint==1) {
@@ -4,8 +4,10 @@
 
 LLVParams* injectedparams = NULL;
 LLVGlobalParams* globalparams = NULL;
+DistanceMarginalization* distmarginalization = NULL;
 LLVPrior* priorParams = NULL;
 LLVParams* addparams = NULL;
+double logZdata = 0.;
 
 /************ Functions to initalize and clean up structure for the signals ************/
 
@@ -146,6 +148,8 @@ Arguments are as follows:\n\
  --tagnetwork          Tag choosing the network of detectors to use (default LHV)\n\
  --nbptsoverlap        Number of points to use for linear integration (default 32768)\n\
  --constL              Set all logLikelihood to 0 - allows to sample from the prior for testing (no option, default off)\n\
+ --margdist            Marginalize the likelihood over the distance, for the prior set by dist-min, dist-max and flat-distprior - the distance is pinned, and drawn in post-processing (no option, default off)\n\
+ --margphase           Marginalize the likelihood over the phase, exact for templates with the 22 mode only - the phase is pinned, and drawn in post-processing (no option, default off)\n\
 \n\
 --------------------------------------------------\n\
 ----- Prior Boundary Settings --------------------\n\
@@ -195,6 +199,7 @@ Syntax: --PARAM-min\n\
  --nclspar             Number of parameters to use for multimodal decomposition - in the order of the cube (default 1)\n\
  --ztol                In multimodal decomposition, modes with lnZ lower than ztol are ignored (default -1e90)\n\
  --seed                Seed the inference by setting one of the live points to the injection (no option, default off)\n\
+ --profile             Time the stages of the likelihood (ROM, response, splines, integrand, Fresnel/WIP integration, noise) and write the profile to [outroot]profile_[rank].dat at the end of the run (no option, default off)\n\
  -----------------------------------------------------------------\n\
  ----- Additional Parameters -------------------------------------\n\
  -----------------------------------------------------------------\n\
@@ -225,6 +230,8 @@ Syntax: --PARAM-min\n\
     globalparams->tagnetwork = LHV;
     globalparams->nbptsoverlap = 32768;
     globalparams->constL = 0;
+    globalparams->margdist = 0;
+    globalparams->margphase = 0;
 
     /* set default values for the prior limits */
     prior->deltaT = 0.1;
@@ -281,6 +288,7 @@ Syntax: --PARAM-min\n\
     run->nclspar = 1;
     run->ztol = -1e90;
     run->seed = 0;
+    run->profile = 0;
 
     /* Consume command line */
     for (i = 1; i < argc; ++i) {
@@ -323,6 +331,10 @@ Syntax: --PARAM-min\n\
             globalparams->nbptsoverlap = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--constL") == 0) {
             globalparams->constL = 1;
+        } else if (strcmp(argv[i], "--margdist") == 0) {
+            globalparams->margdist = 1;
+        } else if (strcmp(argv[i], "--margphase") == 0) {
+            globalparams->margphase = 1;
         } else if (strcmp(argv[i], "--deltaT") == 0) {
             prior->deltaT = atof(argv[++i]);
         } else if (strcmp(argv[i], "--comp-min") == 0) {
@@ -427,6 +439,8 @@ Syntax: --PARAM-min\n\
             run->ztol = atof(argv[++i]);
         } else if (strcmp(argv[i], "--seed") == 0) {
             run->seed = 1;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            run->profile = 1;
         } else if (strcmp(argv[i], "--addparams") == 0) {
             /* Must be followed by the values of m1 m2 tRef distance phiRef inclination ra dec polarization */
             addparams->m1 = atof(argv[++i]);
@@ -444,6 +458,17 @@ Syntax: --PARAM-min\n\
         }
     }
 
+    /* If marginalizing over distance or phase, these are pinned - the value is ignored by the likelihood and drawn in post-processing */
+    if(globalparams->margphase && !(prior->phase_min==0. && prior->phase_max==2*PI)) {
+        printf("Error in parse_args_LLV: marginalization over the phase requires the full range of phase [0, 2pi].");
+        goto fail;
+    }
+    if(globalparams->margphase && globalparams->nbmodetemp>1) {
+        printf("Warning in parse_args_LLV: marginalization over the phase is exact only for templates with the 22 mode - with nbmodetemp=%d, higher modes are treated as if their phase scaled like the 22 one.\n", globalparams->nbmodetemp);
+    }
+    if(globalparams->margdist) prior->pin_dist = 1;
+    if(globalparams->margphase) prior->pin_phase = 1;
+
     return;
 
     fail:
@@ -491,6 +516,8 @@ int print_parameters_to_file_LLV(
   fprintf(f, "tagnetwork:   %d\n", globalparams->tagnetwork); //Translation back from enum to string not implemented yet
   fprintf(f, "nbptsoverlap: %d\n", globalparams->nbptsoverlap);
   fprintf(f, "constL:       %d\n", globalparams->constL);
+  fprintf(f, "margdist:     %d\n", globalparams->margdist);
+  fprintf(f, "margphase:    %d\n", globalparams->margphase);
   fprintf(f, "-----------------------------------------------\n");
   fprintf(f, "\n");
 
@@ -556,6 +583,7 @@ int print_parameters_to_file_LLV(
   fprintf(f, "nclspar: %d\n", run->nclspar);
   fprintf(f, "ztol:    %g\n", run->ztol);
   fprintf(f, "seed:    %d\n", run->seed);
+  fprintf(f, "profile: %d\n", run->profile);
   fprintf(f, "-----------------------------------------------\n");
 
   /* Close output file */
@@ -590,8 +618,28 @@ int print_rescaleddist_to_file_LLV(
   return SUCCESS;
 }
 
+/* Function writing the profile of the stages of the likelihood, if enabled by --profile - one file per MPI process */
+int print_profile_to_file_LLV(LLVRunParams* run, int rank)
+{
+  if(!run->profile) return SUCCESS;
+  char *path=malloc(strlen(run->outroot)+64);
+  sprintf(path,"%sprofile_%d.dat", run->outroot, rank);
+  int ret = ProfileWrite(path);
+  if(ret==SUCCESS) printf("Profile of the likelihood written to %s\n", path);
+  free(path);
+  return ret;
+}
+
 /************************* Functions to generate signals and compute likelihoods **************************/
 
+/* The noise functions of the detectors, in the ObjectFunction form expected by the overlap functions */
+static double LLVNoiseSnLHOCall(const void* object UNUSED, double f) { return NoiseSnLHO(f); }
+static double LLVNoiseSnLLOCall(const void* object UNUSED, double f) { return NoiseSnLLO(f); }
+static double LLVNoiseSnVIRGOCall(const void* object UNUSED, double f) { return NoiseSnVIRGO(f); }
+ObjectFunction LLVNoiseSnLHO = {NULL, LLVNoiseSnLHOCall};
+ObjectFunction LLVNoiseSnLLO = {NULL, LLVNoiseSnLLOCall};
+ObjectFunction LLVNoiseSnVIRGO = {NULL, LLVNoiseSnVIRGOCall};
+
 /* Function generating a LLV signal as a list of modes in CAmp/Phase form, from LLV parameters */
 int LLVGenerateSignalCAmpPhase(
   struct tagLLVParams* params,            /* Input: set of LLV parameters of the signal */
@@ -629,18 +677,16 @@ int LLVGenerateSignalCAmpPhase(
   ListmodesCAmpPhaseSpline* listsplinesgen1 = NULL;
   ListmodesCAmpPhaseSpline* listsplinesgen2 = NULL;
   ListmodesCAmpPhaseSpline* listsplinesgen3 = NULL;
-  BuildListmodesCAmpPhaseSpline(&listsplinesgen1, listDet1);
-  BuildListmodesCAmpPhaseSpline(&listsplinesgen2, listDet2);
-  BuildListmodesCAmpPhaseSpline(&listsplinesgen3, listDet3);
+  BuildListmodesCAmpPhaseSpline3Chan(&listsplinesgen1, &listsplinesgen2, &listsplinesgen3, listDet1, listDet2, listDet3);
 
   /* Precompute the inner product (h|h) */
   //TESTING
   //tbeg = clock();
   /* Note: we ignore fstartobs and assume (for the noises) that the detectors are LHO, LLO and VIRGO */
   /* Note: beacause the response induces a difference in the phases (the time delay to each detector), we have to compute three separate overlaps - which is not optimal*/
-  double LHOhh =  FDListmodesFresnelOverlap(listDet1, listsplinesgen1, NoiseSnLHO, globalparams->minf, globalparams->maxf, 0., 0.);
-  double LLOhh =  FDListmodesFresnelOverlap(listDet2, listsplinesgen2, NoiseSnLLO, globalparams->minf, globalparams->maxf, 0., 0.);
-  double VIRGOhh =  FDListmodesFresnelOverlap(listDet3, listsplinesgen3, NoiseSnVIRGO, globalparams->minf, globalparams->maxf, 0., 0.);
+  double LHOhh =  FDListmodesFresnelOverlap(listDet1, listsplinesgen1, &LLVNoiseSnLHO, globalparams->minf, globalparams->maxf, 0., 0.);
+  double LLOhh =  FDListmodesFresnelOverlap(listDet2, listsplinesgen2, &LLVNoiseSnLLO, globalparams->minf, globalparams->maxf, 0., 0.);
+  double VIRGOhh =  FDListmodesFresnelOverlap(listDet3, listsplinesgen3, &LLVNoiseSnVIRGO, globalparams->minf, globalparams->maxf, 0., 0.);
   double Det123hh = LHOhh + LLOhh + VIRGOhh;
   //tend = clock();
   //printf("time SNRs: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
@@ -691,18 +737,16 @@ int LLVGenerateInjectionCAmpPhase(
   ListmodesCAmpPhaseSpline* listsplinesinj1 = NULL;
   ListmodesCAmpPhaseSpline* listsplinesinj2 = NULL;
   ListmodesCAmpPhaseSpline* listsplinesinj3 = NULL;
-  BuildListmodesCAmpPhaseSpline(&listsplinesinj1, listDet1);
-  BuildListmodesCAmpPhaseSpline(&listsplinesinj2, listDet2);
-  BuildListmodesCAmpPhaseSpline(&listsplinesinj3, listDet3);
+  BuildListmodesCAmpPhaseSpline3Chan(&listsplinesinj1, &listsplinesinj2, &listsplinesinj3, listDet1, listDet2, listDet3);
 
   /* Precompute the inner product (h|h) - we ignore deltatobs */
   /* Note: for the noise functions we assume the detectors are L,H,V */
   //TESTING
   //tbeg = clock();
   /* Note: beacause the response induces a difference in the phases (the time delay to each detector), we have to compute three separate overlaps - which is not optimal*/
-  double LHOss =  FDListmodesFresnelOverlap(listDet1, listsplinesinj1, NoiseSnLHO, globalparams->minf, globalparams->maxf, 0., 0.);
-  double LLOss =  FDListmodesFresnelOverlap(listDet2, listsplinesinj2, NoiseSnLLO, globalparams->minf, globalparams->maxf, 0., 0.);
-  double VIRGOss =  FDListmodesFresnelOverlap(listDet3, listsplinesinj3, NoiseSnVIRGO, globalparams->minf, globalparams->maxf, 0., 0.);
+  double LHOss =  FDListmodesFresnelOverlap(listDet1, listsplinesinj1, &LLVNoiseSnLHO, globalparams->minf, globalparams->maxf, 0., 0.);
+  double LLOss =  FDListmodesFresnelOverlap(listDet2, listsplinesinj2, &LLVNoiseSnLLO, globalparams->minf, globalparams->maxf, 0., 0.);
+  double VIRGOss =  FDListmodesFresnelOverlap(listDet3, listsplinesinj3, &LLVNoiseSnVIRGO, globalparams->minf, globalparams->maxf, 0., 0.);
   double Det123ss = LHOss + LLOss + VIRGOss;
   //tend = clock();
   //printf("time SNRs: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
@@ -845,9 +889,9 @@ int LLVGenerateInjectionReIm(
   gsl_vector* noisevalues1 = gsl_vector_alloc(nbpts);
   gsl_vector* noisevalues2 = gsl_vector_alloc(nbpts);
   gsl_vector* noisevalues3 = gsl_vector_alloc(nbpts);
-  EvaluateNoise(noisevalues1, freq, NoiseSnLHO, __LLVSimFD_LHONoise_fLow, __LLVSimFD_LHONoise_fHigh);
-  EvaluateNoise(noisevalues2, freq, NoiseSnLLO, __LLVSimFD_LLONoise_fLow, __LLVSimFD_LLONoise_fHigh);
-  EvaluateNoise(noisevalues3, freq, NoiseSnVIRGO, __LLVSimFD_VIRGONoise_fLow, __LLVSimFD_VIRGONoise_fHigh);
+  EvaluateNoise(noisevalues1, freq, &LLVNoiseSnLHO, __LLVSimFD_LHONoise_fLow, __LLVSimFD_LHONoise_fHigh);
+  EvaluateNoise(noisevalues2, freq, &LLVNoiseSnLLO, __LLVSimFD_LLONoise_fLow, __LLVSimFD_LLONoise_fHigh);
+  EvaluateNoise(noisevalues3, freq, &LLVNoiseSnVIRGO, __LLVSimFD_VIRGONoise_fLow, __LLVSimFD_VIRGONoise_fHigh);
 
   /* Output and clean up */
   injection->LHOSignal = freqseriesDet1;
@@ -867,9 +911,9 @@ int LLVGenerateInjectionReIm(
 
 /* Log-Likelihood function */
 
-double CalculateLogLCAmpPhase(LLVParams *params, LLVInjectionCAmpPhase* injection)
+/* Overlaps (d|h) and (h|h) of a template with the injection, in CAmp/Phase form - FAILURE if the generation failed */
+static int LLVOverlapsCAmpPhase(LLVParams *params, LLVInjectionCAmpPhase* injection, double* dh, double* hh)
 {
-  double logL = -DBL_MAX;
   int ret;
 
   /* Generating the signal in the three detectors for the input parameters */
@@ -883,31 +927,39 @@ double CalculateLogLCAmpPhase(LLVParams *params, LLVInjectionCAmpPhase* injectio
   //printf("time GenerateSignal: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
   //
 
-  /* If LLVGenerateSignal failed (e.g. parameters out of bound), silently return -Infinity logL */
-  if(ret==FAILURE) {
-    logL = -DBL_MAX;
-  }
-  else if(ret==SUCCESS) {
-    /* Computing the likelihood for each detector - fstartobs is ignored, and we assume for the noises that the detectors are LHO, LLO, VIRGO */
+  if(ret==SUCCESS) {
+    /* Computing the overlaps for each detector - fstartobs is ignored, and we assume for the noises that the detectors are LHO, LLO, VIRGO */
     //TESTING
     //tbeg = clock();
     /* Note: beacause the response induces a difference in the phases (the time delay to each detector), we have to compute three separate overlaps - which is not optimal*/
-    double overlapLHO =  FDListmodesFresnelOverlap(generatedsignal->LHOSignal, injection->LHOSplines, NoiseSnLHO, globalparams->minf, globalparams->maxf, 0., 0.);
-    double overlapLLO =  FDListmodesFresnelOverlap(generatedsignal->LLOSignal, injection->LLOSplines, NoiseSnLLO, globalparams->minf, globalparams->maxf, 0., 0.);
-    double overlapVIRGO =  FDListmodesFresnelOverlap(generatedsignal->VIRGOSignal, injection->VIRGOSplines, NoiseSnVIRGO, globalparams->minf, globalparams->maxf, 0., 0.);
+    double overlapLHO =  FDListmodesFresnelOverlap(generatedsignal->LHOSignal, injection->LHOSplines, &LLVNoiseSnLHO, globalparams->minf, globalparams->maxf, 0., 0.);
+    double overlapLLO =  FDListmodesFresnelOverlap(generatedsignal->LLOSignal, injection->LLOSplines, &LLVNoiseSnLLO, globalparams->minf, globalparams->maxf, 0., 0.);
+    double overlapVIRGO =  FDListmodesFresnelOverlap(generatedsignal->VIRGOSignal, injection->VIRGOSplines, &LLVNoiseSnVIRGO, globalparams->minf, globalparams->maxf, 0., 0.);
     double overlapDet123 = overlapLHO + overlapLLO + overlapVIRGO;
     //tend = clock();
     //printf("time Overlaps: %g\n", (double) (tend-tbeg)/CLOCKS_PER_SEC);
     //
 
-    /* Output: value of the loglikelihood for the combined signals, assuming noise independence */
-    logL = overlapDet123 - 1./2*(injection->LLVss) - 1./2*(generatedsignal->LLVhh);
+    /* Output: overlaps for the combined signals, assuming noise independence */
+    *dh = overlapDet123;
+    *hh = generatedsignal->LLVhh;
   }
 
   /* Clean up */
   LLVSignalCAmpPhase_Cleanup(generatedsignal);
 
-  return logL;
+  return ret;
+}
+
+double CalculateLogLCAmpPhase(LLVParams *params, LLVInjectionCAmpPhase* injection)
+{
+  double overlapDet123, LLVhh;
+
+  /* If LLVGenerateSignal failed (e.g. parameters out of bound), silently return -Infinity logL */
+  if(LLVOverlapsCAmpPhase(params, injection, &overlapDet123, &LLVhh)==FAILURE) return -DBL_MAX;
+
+  /* Output: value of the loglikelihood for the combined signals, assuming noise independence */
+  return overlapDet123 - 1./2*(injection->LLVss) - 1./2*LLVhh;
 }
 
 double CalculateLogLReIm(LLVParams *params, LLVInjectionReIm* injection)
@@ -954,6 +1006,115 @@ double CalculateLogLReIm(LLVParams *params, LLVInjectionReIm* injection)
   return logL;
 }
 
+/****************** Likelihood marginalized over distance and phase *****************/
+
+/* Overlaps (d|h), (h|h) and (d|d) of a template with the injection, for the likelihood set by tagint - FAILURE if the generation failed */
+static int LLVOverlaps(LLVParams* params, void* injection, double* dh, double* hh, double* ss)
+{
+  if(globalparams->tagint==0) {
+    *ss = ((LLVInjectionCAmpPhase*) injection)->LLVss;
+    return LLVOverlapsCAmpPhase(params, (LLVInjectionCAmpPhase*) injection, dh, hh);
+  }
+  else if(globalparams->tagint==1) {
+    /* The Re/Im injection does not store (d|d), recomputed here */
+    LLVInjectionReIm* injectionReIm = (LLVInjectionReIm*) injection;
+    LLVSignalReIm* generatedsignal = NULL;
+    LLVSignalReIm_Init(&generatedsignal);
+    int ret = LLVGenerateSignalReIm(params, injectionReIm->freq, generatedsignal);
+    if(ret==SUCCESS) {
+      *dh = FDOverlapReImvsReIm(injectionReIm->LHOSignal, generatedsignal->LHOSignal, injectionReIm->noisevaluesLHO)
+        + FDOverlapReImvsReIm(injectionReIm->LLOSignal, generatedsignal->LLOSignal, injectionReIm->noisevaluesLLO)
+        + FDOverlapReImvsReIm(injectionReIm->VIRGOSignal, generatedsignal->VIRGOSignal, injectionReIm->noisevaluesVIRGO);
+      *hh = FDOverlapReImvsReIm(generatedsignal->LHOSignal, generatedsignal->LHOSignal, injectionReIm->noisevaluesLHO)
+        + FDOverlapReImvsReIm(generatedsignal->LLOSignal, generatedsignal->LLOSignal, injectionReIm->noisevaluesLLO)
+        + FDOverlapReImvsReIm(generatedsignal->VIRGOSignal, generatedsignal->VIRGOSignal, injectionReIm->noisevaluesVIRGO);
+      *ss = FDOverlapReImvsReIm(injectionReIm->LHOSignal, injectionReIm->LHOSignal, injectionReIm->noisevaluesLHO)
+        + FDOverlapReImvsReIm(injectionReIm->LLOSignal, injectionReIm->LLOSignal, injectionReIm->noisevaluesLLO)
+        + FDOverlapReImvsReIm(injectionReIm->VIRGOSignal, injectionReIm->VIRGOSignal, injectionReIm->noisevaluesVIRGO);
+    }
+    LLVSignalReIm_Cleanup(generatedsignal);
+    return ret;
+  }
+  return FAILURE;
+}
+
+/* Overlaps at the reference distance if marginalizing over the distance, and at zero phase if marginalizing over the phase */
+/* For the phase, dh gets (d|i h) as imaginary part: for the 22 mode, shifting phiRef by pi/4 multiplies the template by i */
+static int LLVMarginalizedOverlaps(LLVParams* params, void* injection, double complex* dh, double* hh, double* ss)
+{
+  LLVParams refparams = *params;
+  double dhreal = 0., dhimag = 0., hhimag, ssimag;
+  if(globalparams->margdist) refparams.distance = distmarginalization->dist_ref;
+  if(globalparams->margphase) refparams.phiRef = 0.;
+  if(LLVOverlaps(&refparams, injection, &dhreal, hh, ss)==FAILURE) return FAILURE;
+  if(globalparams->margphase) {
+    refparams.phiRef = PI/4;
+    if(LLVOverlaps(&refparams, injection, &dhimag, &hhimag, &ssimag)==FAILURE) return FAILURE;
+  }
+  *dh = dhreal + I*dhimag;
+  return SUCCESS;
+}
+
+double CalculateLogLMarginalized(LLVParams* params, void* injection)
+{
+  double complex dh;
+  double hh, ss;
+
+  /* If the generation failed (e.g. parameters out of bound), silently return -Infinity logL */
+  if(LLVMarginalizedOverlaps(params, injection, &dh, &hh, &ss)==FAILURE) return -DBL_MAX;
+
+  return MarginalizedLogLikelihood(globalparams->margdist ? distmarginalization : NULL, dh, hh, globalparams->margphase) - 1./2*ss;
+}
+
+int LLVDrawMarginalizedParams(LLVParams* params, void* injection, gsl_rng* r, double* logL)
+{
+  double complex dh;
+  double hh, ss;
+  if(LLVMarginalizedOverlaps(params, injection, &dh, &hh, &ss)==FAILURE) {
+    if(logL) *logL = -DBL_MAX;
+    return FAILURE;
+  }
+  /* The marginalized likelihood comes from the same overlaps, before the draw overwrites distance and/or phase */
+  if(logL) *logL = MarginalizedLogLikelihood(globalparams->margdist ? distmarginalization : NULL, dh, hh, globalparams->margphase) - 1./2*ss;
+  MarginalizedDraw(globalparams->margdist ? distmarginalization : NULL, dh, hh, globalparams->margphase, r, &params->distance, &params->phiRef);
+  return SUCCESS;
+}
+
+int LLVReconstructMarginalizedPosterior(const char inpath[], const char outpath[], void* injection)
+{
+  FILE* fin = fopen(inpath, "r");
+  if(!fin) {
+    printf("Error: cannot open %s for the reconstruction of the marginalized parameters\n", inpath);
+    return FAILURE;
+  }
+  FILE* fout = fopen(outpath, "w");
+  if(!fout) {
+    printf("Error: cannot open %s for writing the reconstructed posterior\n", outpath);
+    fclose(fin);
+    return FAILURE;
+  }
+
+  /* Format (same as in the internals): m1, m2, tRef, dist, phase, inc, ra, dec, pol, loglike - one draw per sample, with a fixed seed */
+  gsl_rng* r = gsl_rng_alloc(gsl_rng_mt19937);
+  LLVParams params;
+  double loglike;
+  char line[4096];
+  int nbsamples = 0;
+  while(fgets(line, sizeof(line), fin)) {
+    if(sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf", &params.m1, &params.m2, &params.tRef, &params.distance, &params.phiRef, &params.inclination, &params.ra, &params.dec, &params.polarization, &loglike)!=10) continue;
+    params.nbmode = globalparams->nbmodetemp;
+    if(LLVDrawMarginalizedParams(&params, injection, r, NULL)==FAILURE) continue;
+    fprintf(fout, "%.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e %.16e\n", params.m1, params.m2, params.tRef, params.distance, params.phiRef, params.inclination, params.ra, params.dec, params.polarization, loglike);
+    nbsamples++;
+  }
+  printf("Reconstructed the marginalized parameters for %d samples in %s\n", nbsamples, outpath);
+
+  gsl_rng_free(r);
+  fclose(fin);
+  fclose(fout);
+  return SUCCESS;
+}
+
 /* Function generating a LLV signal from LLV parameters */
 // int LLVGenerateSignal(
 //   struct tagLLVParams* params,   /* Input: set of LLV parameters of the signal */
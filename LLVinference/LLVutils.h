@@ -14,6 +14,8 @@
 #include "wip.h"
 #include "likelihood.h"
 #include "splinecoeffs.h"
+#include "profiling.h"
+#include "marginalization.h"
 #include "LLVFDresponse.h"
 #include "LLVnoise.h"
 
@@ -44,6 +46,8 @@ typedef struct tagLLVGlobalParams {
   int tagnetwork;            /* Tag choosing the network of detectors to use */
   int nbptsoverlap;          /* Number of points to use in loglinear overlaps (default 32768) */
   int constL;                /* set all logLikelihood to 0 - allows to sample from the prior for testing */
+  int margdist;              /* Tag to marginalize the likelihood over the distance, for the distance prior - distance then pinned and drawn in post-processing (default 0) */
+  int margphase;             /* Tag to marginalize the likelihood over the phase, exact for the 22 mode only - phase then pinned and drawn in post-processing (default 0) */
 } LLVGlobalParams;
 
 typedef struct tagLLVPrior {
@@ -102,6 +106,7 @@ typedef struct tagLLVRunParams {
   int    nclspar;            /* number of parameters to use for multimodal decomposition - in the order of the cube */
   double ztol;               /* in multimodal decomposition, modes with lnZ lower than Ztol are ignored */
   int    seed;               /* seed the inference by setting one of the live points to the injection ? */
+  int    profile;            /* time the stages of the likelihood and write the profile at the end of the run ? (default 0) */
 } LLVRunParams;
 
 /************ Structures for signals and injections ************/
@@ -172,6 +177,8 @@ int print_rescaleddist_to_file_LLV(
   LLVGlobalParams* globalparams,
   LLVPrior* prior,
   LLVRunParams* run);
+/* Function writing the profile of the likelihood stages to [outroot]profile_[rank].dat, if enabled by --profile */
+int print_profile_to_file_LLV(LLVRunParams* run, int rank);
 
 /* Initialization and clean-up for LLVSignal structures */
 void LLVSignalCAmpPhase_Cleanup(LLVSignalCAmpPhase* signal);
@@ -231,11 +238,24 @@ double CosPriorToCube(double y, double x1, double x2);
 double CalculateLogLCAmpPhase(LLVParams *params, LLVInjectionCAmpPhase* injection);
 double CalculateLogLReIm(LLVParams *params, LLVInjectionReIm* injection);
 
+/* Functions for the likelihood marginalized over distance and/or phase - injection is the context for the likelihood set by tagint */
+double CalculateLogLMarginalized(LLVParams* params, void* injection);
+/* Draw distance and/or phase in params from their posterior conditional on the other parameters - logL, if not NULL, gets the marginalized log-likelihood computed from the same overlaps */
+int LLVDrawMarginalizedParams(LLVParams* params, void* injection, gsl_rng* r, double* logL);
+/* Replace distance and/or phase by draws in a file of posterior samples (m1, m2, tRef, dist, phase, inc, ra, dec, pol, loglike) */
+int LLVReconstructMarginalizedPosterior(const char inpath[], const char outpath[], void* injection);
+
+/* Noise functions of LHO, LLO and VIRGO, in ObjectFunction form */
+extern ObjectFunction LLVNoiseSnLHO;
+extern ObjectFunction LLVNoiseSnLLO;
+extern ObjectFunction LLVNoiseSnVIRGO;
+
 /************ Global Parameters ************/
 
 extern LLVParams* injectedparams;
 extern LLVGlobalParams* globalparams;
 extern LLVPrior* priorParams;
-double logZdata;
+extern DistanceMarginalization* distmarginalization;
+extern double logZdata; /* TODO: not used */
 
 #endif
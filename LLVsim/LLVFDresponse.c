@@ -34,6 +34,7 @@
 #include "constants.h"
 #include "LLVgeometry.h"
 #include "struct.h"
+#include "profiling.h"
 #include "LLVFDresponse.h"
 #include "timeconversion.h"
 
@@ -347,6 +348,8 @@ int LLVSimFDResponse3Det(
   const double psi,                                       /* Polarization angle (rad) */
   const Networktag tag)                                   /* Tag identifying the network to use */
 {
+  long long t0 = ProfileStart();
+
   /* Read which detectors are to be included in the network */
   double factor1 = 0;
   double factor2 = 0;
@@ -531,5 +534,6 @@ int LLVSimFDResponse3Det(
   gsl_vector_free(DY2);
   gsl_vector_free(DY3);
 
+  ProfileStop(ProfileResponse, t0);
   return SUCCESS;
 }
@@ -31,26 +31,20 @@
 #include <gsl/gsl_spline.h>
 #include <gsl/gsl_complex.h>
 
+#include <stdint.h>
+#include <sys/stat.h>
+
 #include "constants.h"
 #include "struct.h"
 #include "LLVnoise.h"
 
 
 /******************************************************************************/
-/****** Global variables storing interpolating splines for the noise PSD ******/
-
-gsl_spline* __LLVSimFD_LHONoiseSpline_init = NULL; /* for initialization only */
-gsl_spline** const __LLVSimFD_LHONoiseSpline = &__LLVSimFD_LHONoiseSpline_init;
-gsl_spline* __LLVSimFD_LLONoiseSpline_init = NULL; /* for initialization only */
-gsl_spline** const __LLVSimFD_LLONoiseSpline = &__LLVSimFD_LLONoiseSpline_init;
-gsl_spline* __LLVSimFD_VIRGONoiseSpline_init = NULL; /* for initialization only */
-gsl_spline** const __LLVSimFD_VIRGONoiseSpline = &__LLVSimFD_VIRGONoiseSpline_init;
-gsl_interp_accel* __LLVSimFD_LHONoiseAccel_init = NULL; /* for initialization only */
-gsl_interp_accel** const __LLVSimFD_LHONoiseAccel = &__LLVSimFD_LHONoiseAccel_init;
-gsl_interp_accel* __LLVSimFD_LLONoiseAccel_init = NULL; /* for initialization only */
-gsl_interp_accel** const __LLVSimFD_LLONoiseAccel = &__LLVSimFD_LLONoiseAccel_init;
-gsl_interp_accel* __LLVSimFD_VIRGONoiseAccel_init = NULL; /* for initialization only */
-gsl_interp_accel** const __LLVSimFD_VIRGONoiseAccel = &__LLVSimFD_VIRGONoiseAccel_init;
+/****** Global variables storing the tables of the noise PSD ******/
+
+/* Tables of sqrt(Sn) on a uniform grid for LHO, LLO, VIRGO, contiguous - see the layout below */
+/* Evaluated by linear interpolation with a direct index computation, read-only once set, so that they can be shared between threads and processes */
+const double* __LLVSimFD_NoiseTables = NULL;
 double __LLVSimFD_LHONoise_fLow = 0;
 double __LLVSimFD_LHONoise_fHigh = 0;
 double __LLVSimFD_LLONoise_fLow = 0;
@@ -63,9 +57,136 @@ int __LLVSimFD_Noise_setup = FAILURE;
 //#define noisedata_pts 3000
 #define noisedata_pts 16365
 
+/* Layout of the table for one detector: a header logscale, x0, dx, n, fLow, fHigh, followed by the n values of sqrt(Sn) at x0 + i*dx */
+/* The variable x is f if logscale is 0, ln(f) otherwise - data given on a uniform grid in f is used as is, other data is resampled on a uniform grid in ln(f) */
+#define noisetable_header 6
+#define noisegrid_max (4*noisedata_pts)
+#define noisetable_size (noisetable_header + noisegrid_max)
+
+/* Binary cache of a table, written next to the data file with the extension .bin, and used as long as the data file is unchanged */
+#define noisecache_version 1
+typedef struct tagLLVNoiseCacheHeader {
+  char     magic[8];       /* "FLARELLV" */
+  uint32_t version;        /* noisecache_version */
+  uint32_t tablesize;      /* Number of doubles of the table that follows */
+  int64_t  datasize;       /* Size of the data file */
+  int64_t  datamtime;      /* Modification time of the data file */
+} LLVNoiseCacheHeader;
+
 /**************************************************************/
 /****** Functions loading and evaluating the noise PSD  *******/
 
+/* Build the table of one detector from the data (columns f, sqrt(Sn)) */
+static void Build_Noise_Table(gsl_matrix* data, double* table) {
+  int n = data->size1;
+  double f0 = gsl_matrix_get(data, 0, 0);
+  double fN = gsl_matrix_get(data, n-1, 0);
+  double df = (fN - f0)/(n-1);
+  double* values = table + noisetable_header;
+
+  /* Check if the data is on a uniform grid in f */
+  int uniform = 1;
+  for(int i=0; i<n; i++) {
+    if(fabs(gsl_matrix_get(data, i, 0) - (f0 + i*df)) > 1e-9*df) { uniform = 0; break; }
+  }
+
+  if(uniform) {
+    table[0] = 0;
+    table[1] = f0;
+    table[2] = df;
+    table[3] = n;
+    for(int i=0; i<n; i++) values[i] = gsl_matrix_get(data, i, 1);
+  }
+  else {
+    /* Resampling on a uniform grid in ln(f), with linear interpolation in f of the data */
+    int ngrid = noisegrid_max;
+    double x0 = log(f0);
+    double dx = (log(fN) - x0)/(ngrid-1);
+    table[0] = 1;
+    table[1] = x0;
+    table[2] = dx;
+    table[3] = ngrid;
+    int j = 0;
+    for(int i=0; i<ngrid; i++) {
+      double f = (i==ngrid-1) ? fN : exp(x0 + i*dx);
+      while(j<n-2 && gsl_matrix_get(data, j+1, 0)<=f) j++;
+      double fj = gsl_matrix_get(data, j, 0);
+      double fj1 = gsl_matrix_get(data, j+1, 0);
+      values[i] = gsl_matrix_get(data, j, 1) + (f - fj)/(fj1 - fj) * (gsl_matrix_get(data, j+1, 1) - gsl_matrix_get(data, j, 1));
+    }
+  }
+  table[4] = f0;
+  table[5] = fN;
+}
+
+/* Read the table of one detector from the data file in dir, using the binary cache if it is up to date, and writing it otherwise */
+static int Read_Noise_Table(const char dir[], const char file[], double* table) {
+  char* path = malloc(strlen(dir)+64);
+  char* pathcache = malloc(strlen(dir)+64);
+  sprintf(path, "%s/%s", dir, file);
+  sprintf(pathcache, "%s/%s.bin", dir, file);
+  struct stat st;
+  if(stat(path, &st)!=0) {
+    fprintf(stderr, "Error reading data from %s\n", path);
+    free(path);
+    free(pathcache);
+    return(FAILURE);
+  }
+
+  /* Try the cache */
+  int ret = FAILURE;
+  FILE* f = fopen(pathcache, "rb");
+  if(f) {
+    LLVNoiseCacheHeader h;
+    if(fread(&h, sizeof(LLVNoiseCacheHeader), 1, f)==1 && memcmp(h.magic, "FLARELLV", 8)==0 && h.version==noisecache_version && h.tablesize<=noisetable_size && h.datasize==(int64_t) st.st_size && h.datamtime==(int64_t) st.st_mtime) {
+      if(fread(table, sizeof(double), h.tablesize, f)==h.tablesize) ret = SUCCESS;
+    }
+    fclose(f);
+  }
+
+  /* Otherwise, read the text data and write the cache - failing to write the cache is not an error */
+  if(ret==FAILURE) {
+    gsl_matrix* data = gsl_matrix_alloc(noisedata_pts, 2);
+    ret = Read_Text_Matrix(dir, file, data);
+    if(ret==SUCCESS) {
+      Build_Noise_Table(data, table);
+      LLVNoiseCacheHeader h;
+      memset(&h, 0, sizeof(LLVNoiseCacheHeader));
+      memcpy(h.magic, "FLARELLV", 8);
+      h.version = noisecache_version;
+      h.tablesize = noisetable_header + (int) table[3];
+      h.datasize = st.st_size;
+      h.datamtime = st.st_mtime;
+      /* Written to a temporary file then renamed, so that concurrent processes never read a partial cache */
+      char* pathtmp = malloc(strlen(dir)+96);
+      sprintf(pathtmp, "%s.%d", pathcache, (int) getpid());
+      f = fopen(pathtmp, "wb");
+      if(f) {
+        int ok = (fwrite(&h, sizeof(LLVNoiseCacheHeader), 1, f)==1) && (fwrite(table, sizeof(double), h.tablesize, f)==h.tablesize);
+        fclose(f);
+        if(!ok || rename(pathtmp, pathcache)!=0) remove(pathtmp);
+      }
+      free(pathtmp);
+    }
+    gsl_matrix_free(data);
+  }
+  free(path);
+  free(pathcache);
+  return(ret);
+}
+
+/* Read the noise data files of dir into tables for LHO, LLO, VIRGO */
+static int Read_Noise_Tables_Dir(const char dir[], double* tables) {
+  int ret = SUCCESS;
+  //sprintf(file_LIGO, "%s", "LIGO-P1200087-v18-aLIGO_DESIGN.txt");
+  //sprintf(file_VIRGO, "%s", "LIGO-P1200087-v18-AdV_DESIGN.txt");
+  /* The same data is used for LHO and LLO */
+  ret |= Read_Noise_Table(dir, "aLIGO_sensitivity.dat", tables);
+  ret |= Read_Noise_Table(dir, "aVirgo_sensitivity.dat", tables + 2*noisetable_size);
+  if(ret==SUCCESS) memcpy(tables + noisetable_size, tables, noisetable_size*sizeof(double));
+  return(ret);
+}
+
 /* Function parsing the environment variable $LLV_NOISE_DATA_PATH and trying to run LLVSimFD_Noise_Init in each */
 int LLVSimFD_Noise_Init_ParsePath(void)
 {
@@ -102,75 +223,66 @@ int LLVSimFD_Noise_Init(const char dir[]) {
     exit(1);
   }
 
-  /* Loading noise data in gsl_vectors */
-  int ret = SUCCESS;
-  gsl_matrix* noise_LHO = gsl_matrix_alloc(noisedata_pts, 2);
-  gsl_matrix* noise_LLO = gsl_matrix_alloc(noisedata_pts, 2);
-  gsl_matrix* noise_VIRGO = gsl_matrix_alloc(noisedata_pts, 2);
-  char* file_LIGO = malloc(strlen(dir)+64);
-  char* file_VIRGO = malloc(strlen(dir)+64);
-  //sprintf(file_LIGO, "%s", "LIGO-P1200087-v18-aLIGO_DESIGN.txt");
-  //sprintf(file_VIRGO, "%s", "LIGO-P1200087-v18-AdV_DESIGN.txt");
-  sprintf(file_LIGO, "%s", "aLIGO_sensitivity.dat");
-  sprintf(file_VIRGO, "%s", "aVirgo_sensitivity.dat");
-  ret |= Read_Text_Matrix(dir, file_LIGO, noise_LHO);
-  ret |= Read_Text_Matrix(dir, file_LIGO, noise_LLO);
-  ret |= Read_Text_Matrix(dir, file_VIRGO, noise_VIRGO);
-
-  if(ret==FAILURE) {
+  /* The tables are kept for the lifetime of the process */
+  double* tables = malloc(LLVSimFD_Noise_TablesSize());
+  if(Read_Noise_Tables_Dir(dir, tables)==FAILURE) {
     printf("Error: problem reading LLV noise data.");
     exit(1);
   }
+  return LLVSimFD_Noise_Init_Tables(tables);
+}
 
-  /* Linear interpolation of the data, after setting the gsl_spline structures */
-  else if(ret==SUCCESS) {
-    /* Extracting te vectors for the frequencies and data */
-    gsl_vector* noise_LHO_freq = gsl_vector_alloc(noisedata_pts);
-    gsl_vector* noise_LLO_freq = gsl_vector_alloc(noisedata_pts);
-    gsl_vector* noise_VIRGO_freq = gsl_vector_alloc(noisedata_pts);
-    gsl_vector* noise_LHO_data = gsl_vector_alloc(noisedata_pts);
-    gsl_vector* noise_LLO_data = gsl_vector_alloc(noisedata_pts);
-    gsl_vector* noise_VIRGO_data = gsl_vector_alloc(noisedata_pts);
-    gsl_matrix_get_col(noise_LHO_freq, noise_LHO, 0);
-    gsl_matrix_get_col(noise_LLO_freq, noise_LLO, 0);
-    gsl_matrix_get_col(noise_VIRGO_freq, noise_VIRGO, 0);
-    gsl_matrix_get_col(noise_LHO_data, noise_LHO, 1);
-    gsl_matrix_get_col(noise_LLO_data, noise_LLO, 1);
-    gsl_matrix_get_col(noise_VIRGO_data, noise_VIRGO, 1);
-    /* Setting the global variables that indicate the range in frequency of these splines */
-    __LLVSimFD_LHONoise_fLow = gsl_vector_get(noise_LHO_freq, 0);
-    __LLVSimFD_LHONoise_fHigh = gsl_vector_get(noise_LHO_freq, noise_LHO_freq->size - 1);
-    __LLVSimFD_LLONoise_fLow = gsl_vector_get(noise_LLO_freq, 0);
-    __LLVSimFD_LLONoise_fHigh = gsl_vector_get(noise_LLO_freq, noise_LLO_freq->size - 1);
-    __LLVSimFD_VIRGONoise_fLow = gsl_vector_get(noise_VIRGO_freq, 0);
-    __LLVSimFD_VIRGONoise_fHigh = gsl_vector_get(noise_VIRGO_freq, noise_VIRGO_freq->size - 1);
-    /* Initializing the splines and accelerators */
-    *__LLVSimFD_LHONoiseSpline = gsl_spline_alloc(gsl_interp_linear, noisedata_pts);
-    *__LLVSimFD_LLONoiseSpline = gsl_spline_alloc(gsl_interp_linear, noisedata_pts);
-    *__LLVSimFD_VIRGONoiseSpline = gsl_spline_alloc(gsl_interp_linear, noisedata_pts);
-    *__LLVSimFD_LHONoiseAccel = gsl_interp_accel_alloc();
-    *__LLVSimFD_LLONoiseAccel = gsl_interp_accel_alloc();
-    *__LLVSimFD_VIRGONoiseAccel = gsl_interp_accel_alloc();
-    gsl_spline_init(*__LLVSimFD_LHONoiseSpline, gsl_vector_const_ptr(noise_LHO_freq, 0), gsl_vector_const_ptr(noise_LHO_data, 0), noisedata_pts);
-    gsl_spline_init(*__LLVSimFD_LLONoiseSpline, gsl_vector_const_ptr(noise_LLO_freq, 0), gsl_vector_const_ptr(noise_LLO_data, 0), noisedata_pts);
-    gsl_spline_init(*__LLVSimFD_VIRGONoiseSpline, gsl_vector_const_ptr(noise_VIRGO_freq, 0), gsl_vector_const_ptr(noise_VIRGO_data, 0), noisedata_pts);
-    /* Setting the global tag to success and clean up */
-    gsl_matrix_free(noise_LHO);
-    gsl_matrix_free(noise_LLO);
-    gsl_matrix_free(noise_VIRGO);
-    gsl_vector_free(noise_LHO_freq);
-    gsl_vector_free(noise_LLO_freq);
-    gsl_vector_free(noise_VIRGO_freq);
-    gsl_vector_free(noise_LHO_data);
-    gsl_vector_free(noise_LLO_data);
-    gsl_vector_free(noise_VIRGO_data);
-    __LLVSimFD_Noise_setup = SUCCESS;
-  }
-  
-  /* Cleaning and output */
-  free(file_LIGO);
-  free(file_VIRGO);
-  return(ret);
+/* Size in bytes of the noise tables */
+size_t LLVSimFD_Noise_TablesSize(void) {
+  return 3*noisetable_size*sizeof(double);
+}
+/* Read the noise tables from the first directory of $LLV_NOISE_DATA_PATH containing the data */
+/* The signature allows its use to fill memory shared between processes - size is LLVSimFD_Noise_TablesSize(), ctx is ignored */
+int LLVSimFD_Noise_Read_Tables(void* tables, size_t size, void* ctx UNUSED) {
+  if(size<LLVSimFD_Noise_TablesSize()) return(FAILURE);
+  char *envpath = getenv("LLV_NOISE_DATA_PATH");
+  char path[32768];
+  char *brkt, *word;
+  if(!envpath) {
+    printf("Error: the environment variable LLV_NOISE_DATA_PATH, giving the path to the noise data, seems undefined\n");
+    exit(1);
+  }
+  strncpy(path, envpath, sizeof(path));
+  for(word=strtok_r(path,":",&brkt); word; word=strtok_r(NULL,":",&brkt)) {
+    if(Read_Noise_Tables_Dir(word, (double*) tables)==SUCCESS) return(SUCCESS);
+  }
+  printf("Error: unable to find LLVSimFD noise data files in $LLV_NOISE_DATA_PATH\n");
+  return(FAILURE);
+}
+/* Setup the noise from tables in memory, used in place - they have to stay valid and unmodified */
+int LLVSimFD_Noise_Init_Tables(const double* tables) {
+  if(!__LLVSimFD_Noise_setup) {
+    printf("Error: LLVSimFD noise was already set up!");
+    exit(1);
+  }
+  __LLVSimFD_NoiseTables = tables;
+  /* Setting the global variables that indicate the range in frequency of the tables */
+  __LLVSimFD_LHONoise_fLow = tables[4];
+  __LLVSimFD_LHONoise_fHigh = tables[5];
+  __LLVSimFD_LLONoise_fLow = tables[noisetable_size + 4];
+  __LLVSimFD_LLONoise_fHigh = tables[noisetable_size + 5];
+  __LLVSimFD_VIRGONoise_fLow = tables[2*noisetable_size + 4];
+  __LLVSimFD_VIRGONoise_fHigh = tables[2*noisetable_size + 5];
+  __LLVSimFD_Noise_setup = SUCCESS;
+  return(SUCCESS);
+}
+
+/* Linear interpolation in the table of sqrt(Sn) of a detector - f is assumed to be in the range of the table */
+static double NoiseInterpTable(const double* table, const double f) {
+  double x = table[0] ? log(f) : f;
+  double u = (x - table[1])/table[2];
+  int n = (int) table[3];
+  int i = (int) u;
+  if(i<0) i = 0;
+  if(i>n-2) i = n-2;
+  double t = u - i;
+  const double* values = table + noisetable_header;
+  return values[i] + t * (values[i+1] - values[i]);
 }
 
 /* The noise functions themselves */
@@ -183,7 +295,7 @@ double NoiseSnLHO(const double f) {
     return INFINITY;
   }
   else { 
-    double sqrtSn = gsl_spline_eval(*__LLVSimFD_LHONoiseSpline, f, *__LLVSimFD_LHONoiseAccel);
+    double sqrtSn = NoiseInterpTable(__LLVSimFD_NoiseTables, f);
     return sqrtSn * sqrtSn;
   }
 }
@@ -196,7 +308,7 @@ double NoiseSnLLO(const double f) {
     return INFINITY;
   }
   else { 
-    double sqrtSn = gsl_spline_eval(*__LLVSimFD_LLONoiseSpline, f, *__LLVSimFD_LLONoiseAccel);
+    double sqrtSn = NoiseInterpTable(__LLVSimFD_NoiseTables + noisetable_size, f);
     return sqrtSn * sqrtSn;
   }
 }
@@ -209,7 +321,7 @@ double NoiseSnVIRGO(const double f) {
     return INFINITY;
   }
   else { 
-    double sqrtSn = gsl_spline_eval(*__LLVSimFD_VIRGONoiseSpline, f, *__LLVSimFD_VIRGONoiseAccel);
+    double sqrtSn = NoiseInterpTable(__LLVSimFD_NoiseTables + 2*noisetable_size, f);
     return sqrtSn * sqrtSn;
   }
 }
@@ -55,6 +55,14 @@ int LLVSimFD_Noise_Init_ParsePath(void);
 /* Function loading the noise data from a directory */
 int LLVSimFD_Noise_Init(const char dir[]);
 
+/* Functions for noise tables in memory, allowing to share them between processes */
+/* Size in bytes of the noise tables */
+size_t LLVSimFD_Noise_TablesSize(void);
+/* Read the noise tables from $LLV_NOISE_DATA_PATH - size is LLVSimFD_Noise_TablesSize(), ctx is ignored */
+int LLVSimFD_Noise_Read_Tables(void* tables, size_t size, void* ctx);
+/* Setup the noise from tables in memory, used in place */
+int LLVSimFD_Noise_Init_Tables(const double* tables);
+
 /* The noise functions themselves */
 double NoiseSnLHO(const double f);
 double NoiseSnLLO(const double f);
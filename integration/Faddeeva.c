@@ -1,3 +1,75 @@
 /* The Faddeeva.cc file contains macros to let it compile as C code
    (assuming C99 complex-number support), so just #include it. */
 #include "Faddeeva.cc"
+
+/* Batched evaluation of w(z), used by the WIP integrator.
+   Arguments are sorted by algorithmic region: those that Faddeeva_w would
+   evaluate with its general continued fraction (|z| large, but x+|y|<=4000)
+   are gathered into blocks and the continued fraction is run over the whole
+   block at once, with a fixed trip count (the largest nu in the block) and
+   lanes whose own expansion is exhausted left unchanged, so that the inner
+   loop is branch-free and can be vectorized.  All other arguments (small |z|,
+   real or imaginary axis, very large |z|) go through the scalar Faddeeva_w.
+   The per-lane arithmetic is the same as in Faddeeva_w. */
+#define FADDEEVA_W_VEC_BLOCK 64
+
+void Faddeeva_w_vec(const double complex *z, int n, double complex *w, double relerr)
+{
+  const double ispi = 0.56418958354775628694807945156; // 1 / sqrt(pi)
+  const double c0=3.9, c1=11.398, c2=0.08254, c3=0.1421, c4=0.2023; // fit
+  int idx[FADDEEVA_W_VEC_BLOCK];
+  double xs[FADDEEVA_W_VEC_BLOCK], ys[FADDEEVA_W_VEC_BLOCK], ya[FADDEEVA_W_VEC_BLOCK];
+  double nu0[FADDEEVA_W_VEC_BLOCK], wr[FADDEEVA_W_VEC_BLOCK], wi[FADDEEVA_W_VEC_BLOCK];
+  int i = 0;
+  while (i < n) {
+    /* Gather the next block of continued-fraction arguments */
+    int m = 0;
+    double numax = 0;
+    for (; i < n && m < FADDEEVA_W_VEC_BLOCK; i++) {
+      const double xr = creal(z[i]), y = cimag(z[i]);
+      const double x = fabs(xr), yabs = fabs(y);
+      if (xr != 0.0 && y != 0 && x + yabs <= 4000
+          && (yabs > 7 || (x > 6 && (yabs > 0.1 || (x > 8 && yabs > 1e-10) || x > 28)))) {
+        idx[m] = i;
+        xs[m] = y < 0 ? -xr : xr; // compute for -z if y < 0
+        ys[m] = y;
+        ya[m] = yabs;
+        nu0[m] = 0.5 * (floor(c0 + c1 / (c2*x + c3*yabs + c4)) - 1);
+        if (nu0[m] > numax) numax = nu0[m];
+        m++;
+      }
+      else
+        w[i] = Faddeeva_w(z[i], relerr);
+    }
+    if (m == 0) continue;
+
+    /* w <- z - nu/w, for nu = nu0, nu0-0.5, ..., > 0.4 in each lane */
+    int j;
+    for (j = 0; j < m; j++) {
+      wr[j] = xs[j];
+      wi[j] = ya[j];
+    }
+    double step;
+    for (step = 0; numax - step > 0.4; step += 0.5) {
+#pragma omp simd
+      for (j = 0; j < m; j++) {
+        const double nu = nu0[j] - step;
+        const double denom = nu / (wr[j]*wr[j] + wi[j]*wi[j]);
+        const double wrnew = xs[j] - wr[j] * denom;
+        const double winew = ya[j] + wi[j] * denom;
+        wr[j] = nu > 0.4 ? wrnew : wr[j];
+        wi[j] = nu > 0.4 ? winew : wi[j];
+      }
+    }
+
+    /* w(z) = i/sqrt(pi) / w, with w(z) = 2.0*exp(-z*z) - w(-z) if y < 0 */
+    for (j = 0; j < m; j++) {
+      const double denom = ispi / (wr[j]*wr[j] + wi[j]*wi[j]);
+      const double complex ret = C(denom*wi[j], denom*wr[j]);
+      if (ys[j] < 0)
+        w[idx[j]] = 2.0*cexp(C((ya[j]-xs[j])*(xs[j]+ya[j]), 2*xs[j]*ys[j])) - ret;
+      else
+        w[idx[j]] = ret;
+    }
+  }
+}
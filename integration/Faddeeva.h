@@ -38,6 +38,8 @@ extern "C"
 // compute w(z) = exp(-z^2) erfc(-iz) [ Faddeeva / scaled complex error func ]
 extern double complex Faddeeva_w(double complex z,double relerr);
 extern double Faddeeva_w_im(double x); // special-case code for Im[w(x)] of real x
+// compute w(z[k]) for k=0..n-1 into w[k], batching arguments by region
+extern void Faddeeva_w_vec(const double complex *z, int n, double complex *w, double relerr);
 
 // Various functions that we can compute with the help of w(z)
 
@@ -145,169 +145,30 @@ void interpolate_ip_integrand(double *f1, double *s1Ar, double *s1Ai, double  *s
         
     
 //#Now perform the integration...
-double complex wip_phase (double *f1, int n1, double *f2, int n2, double *s1Ar, double *s1Ai, double  *s1p, double *s2Ar, double*s2Ai, double *s2p, double (*Snoise)(double), double scalefactor, double min_f, double max_f){
-  int i;
-  double f1x[n1],f2x[n2];
-  if(wip_uselogf){
-    for(i=0; i<n1;i++){
-      double f=f1[i];
-      if(f<=0)printf("wip_phase:Trouble using log grid: f1=%g\n",f);
-      f1x[i]=log(f);
-    }
-    for(i=0; i<n2;i++){
-      double f=f2[i];
-      if(f<=0)printf("wip_phase:Trouble using log grid: f2=%g\n",f);
-      f2x[i]=log(f);
-    }
-  } else {
-    for(i=0; i<n1;i++)f1x[i]=f1[i];
-    for(i=0; i<n2;i++)f2x[i]=f2[i];
-  }
-  
-  //#integrate to new grid
-  int NfMax=(n1+n2)*scalefactor;//should be adequately large. 
-  double fs[NfMax],Ars[NfMax],Ais[NfMax],Arz[NfMax],Aiz[NfMax],dphis[NfMax],dphiz[NfMax];//(does this work in C?)
-  int nf=NfMax;
-  interpolate_ip_integrand(f1x, s1Ar, s1Ai, s1p, n1, f2x, s2Ar, s2Ai, s2p, n2, Snoise, scalefactor, fs, Ars, Ais, dphis, &nf, min_f, max_f);
-  wip_count=nf;//just for testing/reference
-  spline_construct(fs,Ars,Arz,nf);
-  spline_construct(fs,Ais,Aiz,nf);
-  spline_construct(fs,dphis,dphiz,nf);
-
-  //printf( "fs: [");for(i=0;i<nf-1;i++)printf(" %g,",fs[i]);printf(" %g ]\n",fs[nf-1]);
-  //printf( "Ars: [");for(i=0;i<nf-1;i++)printf(" %g,",Ars[i]);printf(" %g ]\n",Ars[nf-1]);
-  //printf( "Ais: [");for(i=0;i<nf-1;i++)printf(" %g,",Ais[i]);printf(" %g ]\n",Ais[nf-1]);
-  //printf( "dphis: [");for(i=0;i<nf-1;i++)printf(" %g,",dphis[i]);printf(" %g ]\n",dphis[nf-1]);
+//# The integral over each interval needs w(z) at two points when the quadratic phase term is
+//# large.  To evaluate these with the batched Faddeeva_w_vec, the one-interval computation is
+//# split into a setup stage, which computes the local coefficients and the Faddeeva arguments,
+//# and a finish stage, which completes the interval once the w values are known.
+#define WIP_BATCH 64
 
+typedef struct tagwip_interval {
+  double eps;
+  double p1,p2,p3;
+  double complex cofac;         /* ampscale*E0 */
+  double complex a0,a1,a2,a3;
+  double complex E2m1;
+  double complex s;
+  int useapproxquad;
+  double complex I02,I12,I22,I32;
+} wip_interval;
 
-  double complex intsum=0;
-  //intd3vec(f,fs,Ars,Azs,nf)
-  const double complex sqrti = cexp(0.25*I*M_PI);
-  const double sqrtpi = sqrt(M_PI);
-  
-  for(i=0;i<nf-1;i++){//loop over freq intervals
-    //#quadratic phase integration over the current interval (fs[0],fs[2]):
-    //#might also try a linear-phase version for comparison...
-    double f=fs[i];
-    double eps=fs[i+1]-f;
-    double eps2=eps*eps;
-    //printf("[ %.8g -- %.8g ]\n",f,f+eps);
-
-    //#amp coeffs
-    double a0r,a0i,a1r,a1i,a2r,a2i,a3r,a3i;
-    spline_intd3(f,fs,Ars,Arz,nf,&a0r,&a1r,&a2r,&a3r);
-    spline_intd3(f,fs,Ais,Aiz,nf,&a0i,&a1i,&a2i,&a3i);
-    double complex a0=a0r+I*a0i;
-    double complex a1=a1r+I*a1i;
-    double complex a2=a2r+I*a2i;
-    double complex a3=a3r+I*a3i;
-      
-    a2=a2/2.0;
-    a3=a3/6.0;
-    //printf("i=%i: As = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",i,a0r,a0i,a1r,a1i,a2r/2,a2i/2,a3r/6,a3i/6);
-    double complex ampscale=1;
-    if(wip_relative){
-      ampscale=fabs(a0r)+fabs(a0i)+1.0e-50;
-      a0=a0/ampscale;
-      a1=a1/ampscale;
-      a2=a2/ampscale;
-      a3=a3/ampscale;
-    }
-    //#phase coefficients
-    double p0,p1,p2,p3;
-    spline_intd3(f,fs,dphis,dphiz,nf,&p0,&p1,&p2,&p3);
-    p2=p2/2.0;
-    p3=p3/6.0;
-
-    //#Inm   = Integrate(x^n Em(x), {x,0,eps}) / E0
-    //#Em(x) = Exp(p1*x+...pm*x^m)
-    double p1e=p1*eps;
-    double p2e2=p2*eps2;
-    double p3e3=p3*eps*eps2;
-    double complex E0=cexp(I*p0);
-    double complex E2m1=cexpm1i(p1e+p2e2);
-    double complex E2=E2m1+1.0;
-    //#const phase terms
-    double I00, I10, I20, I30;
-    I00=eps;
-    I10=eps2/2.0;
-    I20=eps2*eps/3.0;
-    I30=eps2*eps2/4.0;
-    //#linear phase terms (if needed), and quadratic phase terms
-    double complex I01, I11, I21, I31;
-    double complex I02, I12, I22, I32;
-    int useapproxquad=p2e2*p2e2*p2e2*p2<wip_errtol;
-    if(useapproxquad){
-      double p1e2=p1e*p1e;
-      if(p1e2*p1e2<wip_errtol){// #small p1e approx with errs order p1e^4
-	double complex ip1=I*p1;
-	I01=I00+ip1*(I10+ip1/2.0*(I20+ip1/3.0*I30));
-	I11=I10+ip1*(I20+ip1/2.0*I30);
-	I21=I20+ip1*I30;
-	I31=I30;
-      } else {
-	double complex iop1=I/p1;
-	//A space for the cexpm1 function is reserved in the C99 standard, though it need not be implemented.
-	//If it exists it can avoid precision issues with small values of the argument.
-	double complex E1m1=cexpm1i(p1e);
-	double complex E1=1.0+E1m1;
-	I01=-iop1*E1m1;
-	I11=iop1*(I01-I00*E1);
-	I21=2.0*iop1*(I11-I10*E1);
-	I31=3.0*iop1*(I21-I20*E1);
-      }
-      //#small p2e approx with errs order p2e^2
-      double complex ip2=I*p2;
-      I02=I01+ip2*I21;
-      I12=I11+ip2*I31;
-      I22=I21;
-      I32=I31;
-    } else {
-      double complex io2p2=0.5*I/p2;
-      double complex s=csqrt(p2);
-      double complex z0=p1/s/2.0;
-      double complex w0=Faddeeva_w(sqrti*z0,wip_errtol);
-      double complex wp=Faddeeva_w(sqrti*( eps*s+z0),wip_errtol);
-      double complex ip1=I*p1;
-      I02=-0.5/s*sqrti*sqrtpi*( E2*wp - w0 );
-      I12= -io2p2*(E2m1-ip1*I02);
-      I22=-io2p2*(I00*E2-I02-ip1*I12);
-      I32=-io2p2*(2.0*(I10*E2-I12)-ip1*I22);
-    }
-    //printf("i=%i: Ix2s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",i,creal(I02),cimag(I02),creal(I12),cimag(I12),creal(I22),cimag(I22),creal(I32),cimag(I32));
-    //#cubic phase terms
-    //#small p3e3 approx is our only option (we can keep more terms... above)
-    double complex I03, I13, I23, I33;
-    double complex ip3=I*p3;
-    I03=I02+ip3*I32;
-    I13=I12;
-    I23=I22;
-    I33=I32;
-    //printf("i=%i: In3s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",i,creal(I03),cimag(I03),creal(I13),cimag(I13),creal(I23),cimag(I23),creal(I33),cimag(I33));
-    //#finish
-    //printf("i=%i cofac=%g+%gi\n",i,creal(ampscale*E0),cimag(ampscale*E0));
-    //printf("i=%i: ampscale=%g+%gi, E0=%g+%gi\n",i,creal(ampscale),cimag(ampscale),creal(E0),cimag(E0));
-    //printf("i=%i: As = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",i,creal(a0),cimag(a0),creal(a1),cimag(a1),creal(a2),cimag(a2),creal(a3),cimag(a3));
-    double complex dint=ampscale*E0*(a0*I03 + a1*I13 + a2*I23 + a3*I33);
-    // #step
-    intsum += dint;
-    //printf("i=%i: intsum,dint= %g+%gi, %g+%gi\n",i,creal(intsum),cimag(intsum),creal(dint),cimag(dint)); 
-  }//#end of loop over freq intervals
-  
-  return intsum;
-};
-
-///This is just the one-step part of the integration routine abstracted
-double complex compute_int(double fleft, double fright, double *fs, int nf, double *Ars, double *Arz, double *Ais, double *Aiz, double *dphis, double *dphiz){
+///Set up the integral over [fleft,fright]; returns the number of Faddeeva arguments written to z (0 or 2)
+static int wip_interval_setup(double fleft, double fright, double *fs, int nf, double *Ars, double *Arz, double *Ais, double *Aiz, double *dphis, double *dphiz, int verbose, wip_interval *iv, double complex *z){
   double f=fleft;
   double eps=fright-fleft;
   double eps2=eps*eps;
-
-  if(wip_adapt_verbose)printf("\n[ %.8g -- %.8g ] Delta=%.4g\n",fleft,fright,fright-fleft);
-  //intd3vec(f,fs,Ars,Azs,nf)
   const double complex sqrti = cexp(0.25*I*M_PI);
-  const double sqrtpi = sqrt(M_PI);
-  
+
   //#amp coeffs
   double a0r,a0i,a1r,a1i,a2r,a2i,a3r,a3i;
   spline_intd3(f,fs,Ars,Arz,nf,&a0r,&a1r,&a2r,&a3r);
@@ -316,10 +177,10 @@ double complex compute_int(double fleft, double fright, double *fs, int nf, doub
   double complex a1=a1r+I*a1i;
   double complex a2=a2r+I*a2i;
   double complex a3=a3r+I*a3i;
-  
+
   a2=a2/2.0;
   a3=a3/6.0;
-  if(wip_adapt_verbose)printf(" As = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",a0r,a0i,a1r,a1i,a2r/2,a2i/2,a3r/6,a3i/6);
+  if(verbose)printf(" As = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",a0r,a0i,a1r,a1i,a2r/2,a2i/2,a3r/6,a3i/6);
   double complex ampscale=1;
   if(wip_relative){
     ampscale=fabs(a0r)+fabs(a0i)+1.0e-50;
@@ -333,27 +194,38 @@ double complex compute_int(double fleft, double fright, double *fs, int nf, doub
   spline_intd3(f,fs,dphis,dphiz,nf,&p0,&p1,&p2,&p3);
   p2=p2/2.0;
   p3=p3/6.0;
-  
+
   //#Inm   = Integrate(x^n Em(x), {x,0,eps}) / E0
   //#Em(x) = Exp(p1*x+...pm*x^m)
   double p1e=p1*eps;
   double p2e2=p2*eps2;
-  double p3e3=p3*eps*eps2;
   double complex E0=cexp(I*p0);
-  double complex E2m1=cexpm1i(p1e+p2e2);
-  double complex E2=E2m1+1.0;
+  iv->eps=eps;
+  iv->p1=p1;
+  iv->p2=p2;
+  iv->p3=p3;
+  iv->cofac=ampscale*E0;
+  iv->a0=a0;
+  iv->a1=a1;
+  iv->a2=a2;
+  iv->a3=a3;
+  iv->E2m1=cexpm1i(p1e+p2e2);
+  if(verbose){
+    printf(" cofac=%g+%gi\n",creal(ampscale*E0),cimag(ampscale*E0));
+    printf(" ampscale=%g+%gi, E0=%g+%gi\n",creal(ampscale),cimag(ampscale),creal(E0),cimag(E0));
+    printf(" As = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(a0),cimag(a0),creal(a1),cimag(a1),creal(a2),cimag(a2),creal(a3),cimag(a3));
+  }
   //#const phase terms
   double I00, I10, I20, I30;
   I00=eps;
   I10=eps2/2.0;
   I20=eps2*eps/3.0;
   I30=eps2*eps2/4.0;
-  if(wip_adapt_verbose)printf(" Ix0s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I00),cimag(I00),creal(I10),cimag(I10),creal(I20),cimag(I20),creal(I30),cimag(I30));
+  if(verbose)printf(" Ix0s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I00),cimag(I00),creal(I10),cimag(I10),creal(I20),cimag(I20),creal(I30),cimag(I30));
   //#linear phase terms (if needed), and quadratic phase terms
-  double complex I01, I11, I21, I31;
-  double complex I02, I12, I22, I32;
-  int useapproxquad=p2e2*p2e2*p2e2*p2<wip_errtol;
-  if(useapproxquad){
+  iv->useapproxquad=p2e2*p2e2*p2e2*p2<wip_errtol;
+  if(iv->useapproxquad){
+    double complex I01, I11, I21, I31;
     double p1e2=p1e*p1e;
     if(p1e2*p1e2<wip_errtol){// #small p1e approx with errs order p1e^4
       double complex ip1=I*p1;
@@ -372,46 +244,144 @@ double complex compute_int(double fleft, double fright, double *fs, int nf, doub
       I21=2.0*iop1*(I11-I10*E1);
       I31=3.0*iop1*(I21-I20*E1);
     }
-    if(wip_adapt_verbose)printf(" Ix1s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I02),cimag(I01),creal(I11),cimag(I11),creal(I21),cimag(I21),creal(I31),cimag(I31));
+    if(verbose)printf(" Ix1s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I01),cimag(I01),creal(I11),cimag(I11),creal(I21),cimag(I21),creal(I31),cimag(I31));
     //#small p2e approx with errs order p2e^2
     double complex ip2=I*p2;
-    I02=I01+ip2*I21;
-    I12=I11+ip2*I31;
-    I22=I21;
-    I32=I31;
-  } else {
+    iv->I02=I01+ip2*I21;
+    iv->I12=I11+ip2*I31;
+    iv->I22=I21;
+    iv->I32=I31;
+    return 0;
+  }
+  //#exact quadratic phase terms, needing w(z) at both ends of the interval
+  double complex s=csqrt(p2);
+  double complex z0=p1/s/2.0;
+  iv->s=s;
+  z[0]=sqrti*z0;
+  z[1]=sqrti*( eps*s+z0);
+  return 2;
+};
+
+///Finish the integral over an interval set up by wip_interval_setup, given the w values for its Faddeeva arguments
+static double complex wip_interval_finish(wip_interval *iv, const double complex *w, int verbose){
+  const double complex sqrti = cexp(0.25*I*M_PI);
+  const double sqrtpi = sqrt(M_PI);
+  double complex I02=iv->I02, I12=iv->I12, I22=iv->I22, I32=iv->I32;
+  if(!iv->useapproxquad){
+    double eps=iv->eps;
+    double p1=iv->p1, p2=iv->p2;
+    double complex s=iv->s;
+    double complex E2m1=iv->E2m1;
+    double complex E2=E2m1+1.0;
+    double I00=eps, I10=eps*eps/2.0;
     double complex io2p2=0.5*I/p2;
-    double complex s=csqrt(p2);
-    double complex z0=p1/s/2.0;
-    double complex w0=Faddeeva_w(sqrti*z0,wip_errtol);
-    double complex wp=Faddeeva_w(sqrti*( eps*s+z0),wip_errtol);
+    double complex w0=w[0];
+    double complex wp=w[1];
     double complex ip1=I*p1;
     I02=-0.5/s*sqrti*sqrtpi*( E2*wp - w0 );
     I12= -io2p2*(E2m1-ip1*I02);
     I22=-io2p2*(I00*E2-I02-ip1*I12);
     I32=-io2p2*(2.0*(I10*E2-I12)-ip1*I22);
   }
-  if(wip_adapt_verbose)printf(" Ix2s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I02),cimag(I02),creal(I12),cimag(I12),creal(I22),cimag(I22),creal(I32),cimag(I32));
+  if(verbose)printf(" Ix2s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I02),cimag(I02),creal(I12),cimag(I12),creal(I22),cimag(I22),creal(I32),cimag(I32));
   //#cubic phase terms
   //#small p3e3 approx is our only option (we can keep more terms... above)
   double complex I03, I13, I23, I33;
-  double complex ip3=I*p3;
+  double complex ip3=I*iv->p3;
   I03=I02+ip3*I32;
   I13=I12;
   I23=I22;
   I33=I32;
-  if(wip_adapt_verbose){
-    printf(" In3s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I03),cimag(I03),creal(I13),cimag(I13),creal(I23),cimag(I23),creal(I33),cimag(I33));
+  if(verbose)printf(" In3s = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(I03),cimag(I03),creal(I13),cimag(I13),creal(I23),cimag(I23),creal(I33),cimag(I33));
   //#finish
-    printf(" cofac=%g+%gi\n",creal(ampscale*E0),cimag(ampscale*E0));
-    printf(" ampscale=%g+%gi, E0=%g+%gi\n",creal(ampscale),cimag(ampscale),creal(E0),cimag(E0));
-    printf(" As = %g+%gi ,  %g+%gi ,  %g+%gi , %g+%gi \n",creal(a0),cimag(a0),creal(a1),cimag(a1),creal(a2),cimag(a2),creal(a3),cimag(a3));
-  }
-  double complex dint=ampscale*E0*(a0*I03 + a1*I13 + a2*I23 + a3*I33);
-  // #step
+  double complex dint=iv->cofac*(iv->a0*I03 + iv->a1*I13 + iv->a2*I23 + iv->a3*I33);
   return dint;
 };
 
+double complex wip_phase (double *f1, int n1, double *f2, int n2, double *s1Ar, double *s1Ai, double  *s1p, double *s2Ar, double*s2Ai, double *s2p, double (*Snoise)(double), double scalefactor, double min_f, double max_f){
+  int i;
+  double f1x[n1],f2x[n2];
+  if(wip_uselogf){
+    for(i=0; i<n1;i++){
+      double f=f1[i];
+      if(f<=0)printf("wip_phase:Trouble using log grid: f1=%g\n",f);
+      f1x[i]=log(f);
+    }
+    for(i=0; i<n2;i++){
+      double f=f2[i];
+      if(f<=0)printf("wip_phase:Trouble using log grid: f2=%g\n",f);
+      f2x[i]=log(f);
+    }
+  } else {
+    for(i=0; i<n1;i++)f1x[i]=f1[i];
+    for(i=0; i<n2;i++)f2x[i]=f2[i];
+  }
+  
+  //#integrate to new grid
+  int NfMax=(n1+n2)*scalefactor;//should be adequately large. 
+  double fs[NfMax],Ars[NfMax],Ais[NfMax],Arz[NfMax],Aiz[NfMax],dphis[NfMax],dphiz[NfMax];//(does this work in C?)
+  int nf=NfMax;
+  interpolate_ip_integrand(f1x, s1Ar, s1Ai, s1p, n1, f2x, s2Ar, s2Ai, s2p, n2, Snoise, scalefactor, fs, Ars, Ais, dphis, &nf, min_f, max_f);
+  wip_count=nf;//just for testing/reference
+  spline_construct(fs,Ars,Arz,nf);
+  spline_construct(fs,Ais,Aiz,nf);
+  spline_construct(fs,dphis,dphiz,nf);
+
+  //printf( "fs: [");for(i=0;i<nf-1;i++)printf(" %g,",fs[i]);printf(" %g ]\n",fs[nf-1]);
+  //printf( "Ars: [");for(i=0;i<nf-1;i++)printf(" %g,",Ars[i]);printf(" %g ]\n",Ars[nf-1]);
+  //printf( "Ais: [");for(i=0;i<nf-1;i++)printf(" %g,",Ais[i]);printf(" %g ]\n",Ais[nf-1]);
+  //printf( "dphis: [");for(i=0;i<nf-1;i++)printf(" %g,",dphis[i]);printf(" %g ]\n",dphis[nf-1]);
+
+
+  double complex intsum=0;
+  //intd3vec(f,fs,Ars,Azs,nf)
+
+  //#loop over freq intervals in batches, so that the Faddeeva function evaluations
+  //#for the whole batch are done in one call
+  wip_interval iv[WIP_BATCH];
+  double complex zs[2*WIP_BATCH],ws[2*WIP_BATCH];
+  int nzs[WIP_BATCH];
+  int ib;
+  for(ib=0;ib<nf-1;ib+=WIP_BATCH){
+    int nb=(nf-1-ib<WIP_BATCH)?nf-1-ib:WIP_BATCH;
+    int j,nz=0;
+    for(j=0;j<nb;j++){
+      //#quadratic phase integration over the current interval (fs[i],fs[i+1]):
+      nzs[j]=nz;
+      nz+=wip_interval_setup(fs[ib+j],fs[ib+j+1],fs,nf,Ars,Arz,Ais,Aiz,dphis,dphiz,0,&iv[j],&zs[nz]);
+    }
+    if(nz>0)Faddeeva_w_vec(zs,nz,ws,wip_errtol);
+    for(j=0;j<nb;j++){
+      double complex dint=wip_interval_finish(&iv[j],&ws[nzs[j]],0);
+      // #step
+      intsum += dint;
+    }
+  }//#end of loop over freq intervals
+
+  return intsum;
+};
+
+///This is just the one-step part of the integration routine abstracted
+double complex compute_int(double fleft, double fright, double *fs, int nf, double *Ars, double *Arz, double *Ais, double *Aiz, double *dphis, double *dphiz){
+  wip_interval iv;
+  double complex z[2],w[2];
+  if(wip_adapt_verbose)printf("\n[ %.8g -- %.8g ] Delta=%.4g\n",fleft,fright,fright-fleft);
+  int nz=wip_interval_setup(fleft,fright,fs,nf,Ars,Arz,Ais,Aiz,dphis,dphiz,wip_adapt_verbose,&iv,z);
+  if(nz>0)Faddeeva_w_vec(z,nz,w,wip_errtol);
+  return wip_interval_finish(&iv,w,wip_adapt_verbose);
+};
+
+///Compute the integrals over the two halves [fleft,fcent] and [fcent,fright] together, batching their Faddeeva evaluations
+static void compute_int_pair(double fleft, double fcent, double fright, double *fs, int nf, double *Ars, double *Arz, double *Ais, double *Aiz, double *dphis, double *dphiz, double complex *left, double complex *right){
+  wip_interval ivl,ivr;
+  double complex z[4],w[4];
+  int nzl=wip_interval_setup(fleft,fcent,fs,nf,Ars,Arz,Ais,Aiz,dphis,dphiz,0,&ivl,z);
+  int nzr=wip_interval_setup(fcent,fright,fs,nf,Ars,Arz,Ais,Aiz,dphis,dphiz,0,&ivr,&z[nzl]);
+  if(nzl+nzr>0)Faddeeva_w_vec(z,nzl+nzr,w,wip_errtol);
+  *left=wip_interval_finish(&ivl,w,0);
+  *right=wip_interval_finish(&ivr,&w[nzl],0);
+};
+
 
 //#Now perform the integration adaptively.
 //This version is the same as above, but implementing an experimental adaptive approach.
@@ -491,10 +461,12 @@ double complex wip_adaptive_phase (double *f1, int n1, double *f2, int n2, doubl
 	int k;
 	if(wip_adapt_verbose)for(k=0;k<=ilevel;k++)printf("%i: [%.8g,%.8g]\n",k,fleft,fright[k]);
 
-	if(wip_adapt_verbose)printf("\n  left:\n");
-	left_result=compute_int(fleft,fcent,fs, nf, Ars, Arz, Ais, Aiz, dphis, dphiz);
-	if(wip_adapt_verbose)printf("\n  right:\n");
-	right_result[ilevel]=compute_int(fcent,fright[ilevel],fs, nf, Ars, Arz, Ais, Aiz, dphis, dphiz);
+	if(wip_adapt_verbose){
+	  printf("\n  left:\n");
+	  left_result=compute_int(fleft,fcent,fs, nf, Ars, Arz, Ais, Aiz, dphis, dphiz);
+	  printf("\n  right:\n");
+	  right_result[ilevel]=compute_int(fcent,fright[ilevel],fs, nf, Ars, Arz, Ais, Aiz, dphis, dphiz);
+	} else compute_int_pair(fleft,fcent,fright[ilevel],fs, nf, Ars, Arz, Ais, Aiz, dphis, dphiz, &left_result, &right_result[ilevel]);
 	trial=left_result+right_result[ilevel];
 	double complex diff=trial-oldtrial;
 	ncount+=2;
@@ -6,6 +6,7 @@
 #include <complex.h>
 #include <time.h>
 #include "wip.h"
+#include "Faddeeva.h"
 
 double testfn_I_p(double x, double c2,double c3,double x0){
   double xo=x-x0;
@@ -35,6 +36,7 @@ double Swhitenoise(double x){
 extern int wip_count;
 extern int wip_adapt_verbose;
 extern double wip_adaptTOL;
+extern double wip_errtol;
 
 int main (){
   //Define the test function
@@ -82,6 +84,34 @@ int main (){
     }
   }
 
+  //#batched Faddeeva check against the scalar routine
+  if(1){
+    //Arguments along the diagonals sqrt(i)*t, as they arise in wip_phase, plus a random scatter
+    const int Nw=20000;
+    double complex zw[Nw],ww[Nw];
+    const double complex sqrti = cexp(0.25*I*M_PI);
+    int i;
+    for(i=0;i<Nw;i++){
+      double r=pow(10.0,-2.0+6.0*rand()/((double) RAND_MAX));
+      if(i%4==0)zw[i]=sqrti*r;
+      else if(i%4==1)zw[i]=-sqrti*r;
+      else if(i%4==2)zw[i]=I*sqrti*r;
+      else zw[i]=r*cexp(2*M_PI*I*rand()/((double) RAND_MAX));
+    }
+    double start=((double)clock())/CLOCKS_PER_SEC;
+    Faddeeva_w_vec(zw,Nw,ww,wip_errtol);
+    double end=((double)clock())/CLOCKS_PER_SEC;
+    double maxerr=0;
+    for(i=0;i<Nw;i++){
+      double complex w=Faddeeva_w(zw[i],wip_errtol);
+      double err=cabs(ww[i]-w)/cabs(w);
+      if(err>maxerr)maxerr=err;
+    }
+    double end2=((double)clock())/CLOCKS_PER_SEC;
+    printf("\nFaddeeva_w_vec (N=%i): max rel err vs Faddeeva_w = %g (tol %g): %s\n",Nw,maxerr,wip_errtol,maxerr<wip_errtol?"PASS":"FAIL");
+    printf( "batched time= %g   scalar time= %g\n",end-start,end2-end);
+  }
+
   double complex rex=a0*(cexp(I*testfn_I_p(fmax, c2, c3, x0))*testfn_I_A(fmax, sig, xc)-cexp(I*testfn_I_p(fmin, c2, c3, x0))*testfn_I_A(fmin, sig, xc));
   rex=conj(rex);
   printf("rex=%g + %gi\n",creal(rex),cimag(rex));
@@ -12,6 +12,7 @@ flare.flare_dir="../flare"
 #flare.onlyInspiral=True;flare.FisherReIm=True;flare.ReIm_npts=8192;flare.deltatobs=10.0;flare.LISAvariant="LISA2010";label="LISA2010reim8192_10yr_In_McW_100/" 
 #flare.onlyInspiral=False;flare.SampleReIm=True;flare.FisherReIm=True;flare.ReIm_npts=16384;flare.deltatobs=10.0;flare.LISAvariant="LISA2017";label="LISA2017reim16384_10yr/" 
 flare.onlyInspiral=False;flare.SampleReIm=True;flare.FisherReIm=True;flare.ReIm_npts=8192;flare.deltatobs=10.0;flare.LISAvariant="LISA2017";label="LISA2017reim8192_0seed_10yr/" 
+#flare.FisherBatch=True #compute the Fisher matrices of each (Mtot,q,snr) batch in a single LISAFisher process
 #flare.onlyInspiral=False;flare.FisherReIm=True;flare.ReIm_npts=32768;flare.deltatobs=10.0;flare.LISAvariant="LISA2017";label="LISA2017reim32768_10yr/" 
 #flare.FisherReIm=True;flare.deltatobs=10.0;flare.LISAvariant="LISA2017";label="LISA2017reim_10yr_PM_100/"
 #flare.FisherReIm=True;flare.deltatobs=10.0;flare.LISAvariant="LISA2017";label="LISA2017reim_10yr/"
@@ -32,6 +32,7 @@ SampleReIm=False;
 FisherReIm=True;
 ReIm_npts=32768;
 linearSNRplot=False;
+FisherBatch=False; #compute all the Fisher matrices of a batch in one LISAFisher process instead of one LISAinference_ptmcmc process per point
 
 def set_flare_flags(snr,params):
     flags=""
@@ -367,6 +368,43 @@ def threadedFisherRun(Mtot,q,snr,delta,label,Nruns,Nthreads,data,extrapoints):
         irun += count
         print( " Batch of runs done, now irun=",irun)
 
+def FisherRunBatch(Mtot,q,snr,label,Nruns,data):
+    #All the Fisher matrices for Nruns points are computed by a single LISAFisher process, reading the points from file
+    global FisherRunFailCount
+    paramslist=[draw_params(Mtot,q) for i in range(Nruns)]
+    if(not getattr(all_params_file,"write",None)==None):
+        for params in paramslist:
+            all_params_file.write(str(snr)+"\t")
+            for pval in params:
+                all_params_file.write(str(pval)+"\t")
+            all_params_file.write("\n")
+    name=str(label)
+    with open(name+"_points.dat",'w') as f:
+        #Format of LISAFisher: m1, m2, tRef, dist, phase, inc, lambda, beta, pol
+        for p in paramslist:
+            f.write("\t".join(str(v) for v in [p[0],p[1],p[2],p[4],p[3],p[7],p[5],p[6],p[8]])+"\n")
+    #Injection flags from the first point - Mtot and q are the same for all the points of the batch
+    flags=set_flare_flags(snr,paramslist[0])
+    if(FisherReIm):
+        flags+=" --tagint 1 --nbptsoverlap "+str(ReIm_npts)
+    flags+=" --loadparamsfile --nlinesparams "+str(Nruns)+" --indir . --infile "+name+"_points.dat --outdir . --outfile "+name+"_fisher.dat"
+    cmd=flare_dir+"/LISAinference/LISAFisher"+flags+" >"+name+".out"
+    setenv="export ROM_DATA_PATH="+flare_dir+"/"+ROM_DATA_PATH
+    print( "Executing '"+cmd+"'")
+    if noRun: return
+    code=subprocess.call(setenv+";"+cmd,shell=True)
+    print( "Batch "+name+" completed with code(",code,")")
+    out=np.atleast_2d(np.loadtxt(name+"_fisher.dat"))
+    for row in out:
+        pars=row[:9]
+        covar=row[10:].reshape((9,9))
+        try:
+            data.append([row[3]]+covarErrors(pars,covar))
+        except (ValueError,ArithmeticError):
+            print( "Exception",sys.exc_info()[0]," occurred in batch "+name+" for params ",pars)
+            FisherRunFailCount+=1
+            print( "  FailCount=",FisherRunFailCount)
+
 def readCovarFile(file):
     pars=[]
     done=False
@@ -387,40 +425,7 @@ def readCovarFile(file):
                     line=f.readline()
                     covar[i]=np.array(line.split())
                     i+=1
-                inc    = pars[5] #runs from 0 to pi at poles
-                #lam    = pars[6]
-                beta   = pars[7] #runs from -pi/2 to pi/2 at poles
-                #pol    = pars[8]
-                val=covar[0][0]
-                if val<0: dm1=float('nan')
-                else: dm1=math.sqrt(val)
-                val=covar[1][1]
-                if val<0: dm2=float('nan')
-                else: dm2=math.sqrt(val)
-                dtRef  = math.sqrt(covar[2][2])
-                dD     = math.sqrt(covar[3][3])
-                dphase = math.sqrt(covar[4][4])
-                dinc   = math.sqrt(covar[5][5])
-                dlam   = math.sqrt(covar[6][6])
-                dbeta  = math.sqrt(covar[7][7])
-                dpol   = math.sqrt(covar[8][8])
-                val=covar[6][6]*covar[7][7]-covar[6][7]**2
-                if val<0:
-                    dsky=float('nan')
-                    if -val<1e-13*covar[6][6]*covar[7][7]:dsky=0
-                else: dsky=math.sqrt(val)*math.cos(pars[7])
-                print( "sky",val,dsky,covar[6][6],covar[7][7])
-                val=covar[5][5]*covar[8][8]-covar[5][8]**2
-                if val<0:
-                    dori=float('nan')
-                    if -val<1e-13*covar[5][5]*covar[8][8]:dori=0
-                else: dori=math.sqrt(val)*math.sin(pars[5])
-                #HACK? need to verify factor of sin(inc) here!
-                val=covar[0][0]*covar[1][1]-covar[0][1]**2
-                if val<0:
-                    dmvol=float('nan')
-                    if -val<1e-13*covar[0][0]*covar[1][1]:dmvol=0
-                else: dmvol=math.sqrt(val)
+                errors=covarErrors(pars,covar)
             done=True
         except EnvironmentError:
             print( "Something went wrong in trying to open covariance file:",sys.exc_info()[0])
@@ -436,6 +441,43 @@ def readCovarFile(file):
             print( "Continuing after arithmetic error:")
         #else: print "...No execption in read covar"
             raise
+    return errors
+
+def covarErrors(pars,covar):
+    inc    = pars[5] #runs from 0 to pi at poles
+    #lam    = pars[6]
+    beta   = pars[7] #runs from -pi/2 to pi/2 at poles
+    #pol    = pars[8]
+    val=covar[0][0]
+    if val<0: dm1=float('nan')
+    else: dm1=math.sqrt(val)
+    val=covar[1][1]
+    if val<0: dm2=float('nan')
+    else: dm2=math.sqrt(val)
+    dtRef  = math.sqrt(covar[2][2])
+    dD     = math.sqrt(covar[3][3])
+    dphase = math.sqrt(covar[4][4])
+    dinc   = math.sqrt(covar[5][5])
+    dlam   = math.sqrt(covar[6][6])
+    dbeta  = math.sqrt(covar[7][7])
+    dpol   = math.sqrt(covar[8][8])
+    val=covar[6][6]*covar[7][7]-covar[6][7]**2
+    if val<0:
+        dsky=float('nan')
+        if -val<1e-13*covar[6][6]*covar[7][7]:dsky=0
+    else: dsky=math.sqrt(val)*math.cos(pars[7])
+    print( "sky",val,dsky,covar[6][6],covar[7][7])
+    val=covar[5][5]*covar[8][8]-covar[5][8]**2
+    if val<0:
+        dori=float('nan')
+        if -val<1e-13*covar[5][5]*covar[8][8]:dori=0
+    else: dori=math.sqrt(val)*math.sin(pars[5])
+    #HACK? need to verify factor of sin(inc) here!
+    val=covar[0][0]*covar[1][1]-covar[0][1]**2
+    if val<0:
+        dmvol=float('nan')
+        if -val<1e-13*covar[0][0]*covar[1][1]:dmvol=0
+    else: dmvol=math.sqrt(val)
     return [dm1,dm2,dtRef,dD,dphase,dinc,dlam,dbeta,dpol,dsky,dori,dmvol]
             
 def writeFisherSamples(name,numSamples):
@@ -485,7 +527,9 @@ def FisherStudy(outlabel,MtotList,qList,SNRList,deltalist,Navg,Nthreads,extrapoi
                     data=[]
                     logzs=np.zeros(Navg);
                     print( "Running FisherRun(",Mtot,",",q,",",snr,")")
-                    if(multithreaded):
+                    if(FisherBatch):
+                        FisherRunBatch(Mtot,q,snr,outlabel+"dummy",Navg,data)
+                    elif(multithreaded):
                         threadedFisherRun(Mtot,q,snr,delta,outlabel+"dummy",Navg,Nthreads,data,extrapoints)
                     else:
                         for i in range(Navg):
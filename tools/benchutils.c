@@ -0,0 +1,184 @@
+/**
+ * \brief C code for the microbenchmarks of the likelihood stack: timers, allocation counts and reference values.
+ *
+ * Allocations are counted by defining malloc, calloc and realloc in the executable, which takes precedence over the
+ * C library for all the code of the process, GSL included - the counting versions forward to the glibc allocator.
+ *
+ */
+
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "constants.h"
+#include "benchutils.h"
+
+/************** Allocation counts *****************/
+
+#if defined(__GLIBC__) && defined(__GNUC__)
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static long benchnballoc = 0;
+
+void* malloc(size_t size) {
+  __atomic_fetch_add(&benchnballoc, 1, __ATOMIC_RELAXED);
+  return __libc_malloc(size);
+}
+void* calloc(size_t nmemb, size_t size) {
+  __atomic_fetch_add(&benchnballoc, 1, __ATOMIC_RELAXED);
+  return __libc_calloc(nmemb, size);
+}
+void* realloc(void* ptr, size_t size) {
+  __atomic_fetch_add(&benchnballoc, 1, __ATOMIC_RELAXED);
+  return __libc_realloc(ptr, size);
+}
+
+long BenchAllocations(void) {
+  return __atomic_load_n(&benchnballoc, __ATOMIC_RELAXED);
+}
+#else
+long BenchAllocations(void) {
+  return -1;
+}
+#endif
+
+/************** Timer *****************/
+
+double BenchTime(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + 1e-9 * (double) ts.tv_nsec;
+}
+
+/************** Reference values *****************/
+
+void BenchReference_Init(BenchReference** ref) {
+  if(!ref) exit(1);
+  *ref = (BenchReference*) malloc(sizeof(BenchReference));
+  (*ref)->n = 0;
+  (*ref)->nmax = 0;
+  (*ref)->names = NULL;
+  (*ref)->index = NULL;
+  (*ref)->values = NULL;
+}
+
+void BenchReference_Cleanup(BenchReference* ref) {
+  if(!ref) return;
+  free(ref->names);
+  free(ref->index);
+  free(ref->values);
+  free(ref);
+}
+
+void BenchReference_Add(BenchReference* ref, const char name[], const int index, const double value) {
+  if(ref->n==ref->nmax) {
+    ref->nmax = ref->nmax ? 2*ref->nmax : 64;
+    ref->names = realloc(ref->names, ref->nmax * sizeof(*ref->names));
+    ref->index = (int*) realloc(ref->index, ref->nmax * sizeof(int));
+    ref->values = (double*) realloc(ref->values, ref->nmax * sizeof(double));
+    if(!ref->names || !ref->index || !ref->values) {
+      printf("Error: allocation failed in BenchReference_Add\n");
+      exit(1);
+    }
+  }
+  strncpy(ref->names[ref->n], name, benchnamelength-1);
+  ref->names[ref->n][benchnamelength-1] = '\0';
+  ref->index[ref->n] = index;
+  ref->values[ref->n] = value;
+  ref->n++;
+}
+
+int BenchReference_Find(const BenchReference* ref, const char name[], const int index, double* value) {
+  if(!ref) return FAILURE;
+  for(int i=0; i<ref->n; i++) {
+    if(ref->index[i]==index && strncmp(ref->names[i], name, benchnamelength-1)==0) {
+      *value = ref->values[i];
+      return SUCCESS;
+    }
+  }
+  return FAILURE;
+}
+
+int BenchReference_Read(BenchReference* ref, const char path[]) {
+  FILE* f = fopen(path, "r");
+  if(!f) return FAILURE;
+  char line[256];
+  char name[benchnamelength];
+  int index;
+  double value;
+  while(fgets(line, sizeof(line), f)) {
+    if(line[0]=='#') continue;
+    if(sscanf(line, "%63s %d %lf", name, &index, &value)==3) BenchReference_Add(ref, name, index, value);
+  }
+  fclose(f);
+  return SUCCESS;
+}
+
+int BenchReference_Write(const BenchReference* ref, const char path[]) {
+  FILE* f = fopen(path, "w");
+  if(!f) {
+    printf("Error: cannot open %s for writing the reference values\n", path);
+    return FAILURE;
+  }
+  fprintf(f, "# name index value\n");
+  for(int i=0; i<ref->n; i++) fprintf(f, "%s %d %.16e\n", ref->names[i], ref->index[i], ref->values[i]);
+  fclose(f);
+  return SUCCESS;
+}
+
+/************** Running and reporting *****************/
+
+void BenchRun(const BenchContext* ctx, void (*fn)(void*), void* arg, double* nseval, double* allocseval) {
+  double best = INFINITY;
+  long nballoc = -1;
+  for(int round=0; round<ctx->nbround; round++) {
+    long a0 = BenchAllocations();
+    double t0 = BenchTime();
+    for(int rep=0; rep<ctx->nbrep; rep++) fn(arg);
+    double t = BenchTime() - t0;
+    long a = BenchAllocations() - a0;
+    if(t<best) best = t;
+    if(a0>=0) nballoc = a;
+  }
+  *nseval = 1e9 * best / ctx->nbrep;
+  *allocseval = nballoc>=0 ? (double) nballoc / ctx->nbrep : -1.;
+}
+
+void BenchReport(BenchContext* ctx, const char name[], const int index, const double nseval, const double allocseval, const int hasvalue, const double value) {
+  printf("%-40s %3d", name, index);
+  if(nseval>=0) printf(" %14.1f ns/eval %10.1f allocs/eval", nseval, allocseval);
+  else printf(" %14s         %10s            ", "", "");
+  if(hasvalue) {
+    double refvalue;
+    BenchReference_Add(ctx->out, name, index, value);
+    printf("  value % .16e", value);
+    if(BenchReference_Find(ctx->ref, name, index, &refvalue)==SUCCESS) {
+      double dev = fabs(value - refvalue) / fmax(fabs(refvalue), 1.);
+      int pass = dev<=ctx->reftol;
+      if(!pass) ctx->nbfail++;
+      printf("  dev %.3e %s", dev, pass ? "PASS" : "FAIL");
+    }
+    else {
+      ctx->nbmissing++;
+      printf("  (no reference)");
+    }
+  }
+  printf("\n");
+  fflush(stdout);
+}
+
+void BenchCheck(BenchContext* ctx, const char name[], const int index, const double value, const double expected, const double scale, const double tol) {
+  double dev = fabs(value - expected) / fmax(fabs(expected), scale);
+  int pass = dev<=tol;
+  ctx->nbcheck++;
+  if(!pass) ctx->nbfail++;
+  printf("%-40s %3d  check % .16e vs % .16e  dev %.3e (tol %.1e) %s\n", name, index, value, expected, dev, tol, pass ? "PASS" : "FAIL");
+  fflush(stdout);
+}
@@ -0,0 +1,106 @@
+/**
+ * \brief C header for the microbenchmarks of the likelihood stack: timers, allocation counts and reference values.
+ *
+ * benchutils.o replaces malloc, calloc and realloc by counting versions (with glibc), and is to be linked only into
+ * the benchmark programs LISAbench and LLVbench.
+ *
+ */
+
+#ifndef _BENCHUTILS_H
+#define _BENCHUTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#elif 0
+} /* so that editors will match preceding brace */
+#endif
+
+/* Maximal length of the name of a benchmark */
+#define benchnamelength 64
+
+/**************************************************/
+/**************** Type definitions ****************/
+
+/* Values computed by the benchmarks, stored as lines "name index value" */
+typedef struct tagBenchReference
+{
+  int n;                              /* Number of values */
+  int nmax;                           /* Capacity */
+  char (*names)[benchnamelength];     /* Names of the benchmarks */
+  int* index;                         /* Index of the point of the grid */
+  double* values;                     /* Values */
+} BenchReference;
+
+/* Settings and results of a benchmark run */
+typedef struct tagBenchContext
+{
+  int nbrep;                          /* Number of evaluations per timing */
+  int nbround;                        /* Number of timings - the fastest is reported */
+  double reftol;                      /* Tolerance on the deviation from the reference values */
+  BenchReference* ref;                /* Reference values read from file - NULL if none */
+  BenchReference* out;                /* Values computed in this run */
+  int nbfail;                         /* Number of values deviating from the reference by more than reftol */
+  int nbmissing;                      /* Number of values without a reference */
+  int nbcheck;                        /* Number of cross-checks between two computations of the same quantity */
+} BenchContext;
+
+/*************************/
+/****** Prototypes ******/
+
+/* Wall-clock time in seconds, from an arbitrary origin */
+double BenchTime(void);
+/* Number of calls to malloc, calloc and realloc since the start of the program - -1 if not counted on this platform */
+long BenchAllocations(void);
+
+void BenchReference_Init(BenchReference** ref);
+void BenchReference_Cleanup(BenchReference* ref);
+/* Read values from a file - returns FAILURE if the file cannot be opened */
+int BenchReference_Read(BenchReference* ref, const char path[]);
+int BenchReference_Write(const BenchReference* ref, const char path[]);
+void BenchReference_Add(BenchReference* ref, const char name[], const int index, const double value);
+/* Returns SUCCESS and sets value if (name, index) is found */
+int BenchReference_Find(const BenchReference* ref, const char name[], const int index, double* value);
+
+/* Time fn(arg) - ctx->nbround timings of ctx->nbrep calls, the fastest is kept - outputs time and number of allocations per call */
+void BenchRun(
+  const BenchContext* ctx,            /* Settings of the run */
+  void (*fn)(void*),                  /* Function to time */
+  void* arg,                          /* Argument passed to fn */
+  double* nseval,                     /* Output: time per call (ns) */
+  double* allocseval);                /* Output: number of allocations per call (-1 if not counted) */
+
+/* Print a result line - if hasvalue, record the value and compare it to the reference */
+/* The deviation is |value-ref|/max(|ref|,1), i.e. relative for large values and absolute for values near 0 such as loglikelihoods of close templates */
+void BenchReport(
+  BenchContext* ctx,                  /* Settings and results of the run */
+  const char name[],                  /* Name of the benchmark */
+  const int index,                    /* Index of the point of the grid */
+  const double nseval,                /* Time per call (ns) - negative to print no timing */
+  const double allocseval,            /* Number of allocations per call */
+  const int hasvalue,                 /* Whether value is to be checked */
+  const double value);                /* Value computed by the benchmark */
+
+/* Print a cross-check line, comparing value to the same quantity computed by another path - failures are counted in ctx->nbfail */
+/* The deviation is |value-expected|/max(|expected|,scale) */
+void BenchCheck(
+  BenchContext* ctx,                  /* Settings and results of the run */
+  const char name[],                  /* Name of the check */
+  const int index,                    /* Index of the point of the grid */
+  const double value,                 /* Value computed by the path under test */
+  const double expected,              /* Value computed by the reference path */
+  const double scale,                 /* Floor of the normalization of the deviation */
+  const double tol);                  /* Tolerance on the deviation */
+
+#if 0
+{ /* so that editors will match succeeding brace */
+#elif defined(__cplusplus)
+}
+#endif
+
+#endif /* _BENCHUTILS_H */
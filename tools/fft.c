@@ -54,22 +54,151 @@ double WindowFunctionRight(double x, double xi, double deltaxi)
   else return 1;
 }
 
-/* FFT of real time series */
-/* Note: FFT uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
-int FFTRealTimeSeries(ReImFrequencySeries** freqseries, RealTimeSeries* timeseries, double twindowbeg, double twindowend, int nzeropad)
+/***************** FFTW plans *****************/
+
+/* Plans are cached by (size, number of transforms, kind) and executed on new arrays - they are created on scratch arrays, so that FFTW_MEASURE does not overwrite the data, and all arrays are allocated with fftw_malloc to share the same alignment */
+/* Planning is not thread-safe in FFTW and is serialized, execution of a plan on new arrays is thread-safe */
+typedef enum FFTPlanKind {
+  FFTPlanR2C,
+  FFTPlanC2R,
+  FFTPlanC2CForward,
+  FFTPlanC2CBackward
+} FFTPlanKind;
+
+typedef struct tagFFTPlanCacheEntry {
+  int n;
+  int howmany;
+  FFTPlanKind kind;
+  fftw_plan plan;
+} FFTPlanCacheEntry;
+
+#define FFTPlanCacheSize 64
+static FFTPlanCacheEntry FFTPlanCache[FFTPlanCacheSize];
+static int FFTPlanCacheCount = 0;
+static unsigned FFTPlanFlags = FFTW_ESTIMATE;
+
+/* Get a plan for howmany transforms of size n, stored contiguously - when the cache is full, the plan is not cached and *owned is set to 1, the caller then has to destroy it */
+static fftw_plan FFTGetPlan(const int n, const int howmany, const FFTPlanKind kind, int* owned)
+{
+  fftw_plan plan = NULL;
+  *owned = 0;
+  #pragma omp critical (fftwplanner)
+  {
+    for(int k=0; k<FFTPlanCacheCount; k++) {
+      if(FFTPlanCache[k].n==n && FFTPlanCache[k].howmany==howmany && FFTPlanCache[k].kind==kind) {
+        plan = FFTPlanCache[k].plan;
+        break;
+      }
+    }
+    if(!plan) {
+      int size = n;
+      int nc = n/2 + 1; /* Number of complex elements for the real transforms */
+      double* r = NULL;
+      fftw_complex* c1 = NULL;
+      fftw_complex* c2 = NULL;
+      switch(kind) {
+        case FFTPlanR2C:
+          r = fftw_malloc(sizeof(double) * n * howmany);
+          c1 = fftw_malloc(sizeof(fftw_complex) * nc * howmany);
+          plan = fftw_plan_many_dft_r2c(1, &size, howmany, r, NULL, 1, n, c1, NULL, 1, nc, FFTPlanFlags);
+          break;
+        case FFTPlanC2R:
+          c1 = fftw_malloc(sizeof(fftw_complex) * nc * howmany);
+          r = fftw_malloc(sizeof(double) * n * howmany);
+          plan = fftw_plan_many_dft_c2r(1, &size, howmany, c1, NULL, 1, nc, r, NULL, 1, n, FFTPlanFlags);
+          break;
+        case FFTPlanC2CForward:
+        case FFTPlanC2CBackward:
+          c1 = fftw_malloc(sizeof(fftw_complex) * n * howmany);
+          c2 = fftw_malloc(sizeof(fftw_complex) * n * howmany);
+          plan = fftw_plan_many_dft(1, &size, howmany, c1, NULL, 1, n, c2, NULL, 1, n, kind==FFTPlanC2CForward ? FFTW_FORWARD : FFTW_BACKWARD, FFTPlanFlags);
+          break;
+      }
+      if(r) fftw_free(r);
+      if(c1) fftw_free(c1);
+      if(c2) fftw_free(c2);
+      if(FFTPlanCacheCount<FFTPlanCacheSize) {
+        FFTPlanCache[FFTPlanCacheCount].n = n;
+        FFTPlanCache[FFTPlanCacheCount].howmany = howmany;
+        FFTPlanCache[FFTPlanCacheCount].kind = kind;
+        FFTPlanCache[FFTPlanCacheCount].plan = plan;
+        FFTPlanCacheCount++;
+      }
+      else *owned = 1;
+    }
+  }
+  return plan;
+}
+static void FFTReleasePlan(fftw_plan plan, const int owned)
 {
+  if(owned) {
+    #pragma omp critical (fftwplanner)
+    fftw_destroy_plan(plan);
+  }
+}
 
-  /* deltat of time series */
+/* Destroy all cached plans */
+void FFTPlanCacheCleanup(void)
+{
+  #pragma omp critical (fftwplanner)
+  {
+    for(int k=0; k<FFTPlanCacheCount; k++) fftw_destroy_plan(FFTPlanCache[k].plan);
+    FFTPlanCacheCount = 0;
+  }
+}
+
+/* Use FFTW_MEASURE (measure=1) or FFTW_ESTIMATE (measure=0, default) for the plans created from now on - clears the cache */
+void FFTSetPlanMeasure(int measure)
+{
+  FFTPlanCacheCleanup();
+  FFTPlanFlags = measure ? FFTW_MEASURE : FFTW_ESTIMATE;
+}
+
+/* Number of threads used by each transform - requires compiling with -DFFTW_THREADS and linking with the fftw3_threads library, otherwise transforms remain single-threaded - clears the cache */
+int FFTSetThreads(int nthreads)
+{
+  FFTPlanCacheCleanup();
+#ifdef FFTW_THREADS
+  static int initialized = 0;
+  if(!initialized) {
+    if(!fftw_init_threads()) {
+      printf("Error in FFTSetThreads: initialization of FFTW threads failed.\n");
+      return FAILURE;
+    }
+    initialized = 1;
+  }
+  fftw_plan_with_nthreads(nthreads);
+  return SUCCESS;
+#else
+  if(nthreads>1) printf("Warning in FFTSetThreads: compiled without FFTW_THREADS, FFTs will be single-threaded.\n");
+  return FAILURE;
+#endif
+}
+
+/* Import/export FFTW wisdom from/to file, so that FFTW_MEASURE plans are not measured again in later runs */
+int FFTImportWisdom(const char* filename)
+{
+  int ret;
+  #pragma omp critical (fftwplanner)
+  ret = fftw_import_wisdom_from_filename(filename);
+  return ret ? SUCCESS : FAILURE;
+}
+int FFTExportWisdom(const char* filename)
+{
+  int ret;
+  #pragma omp critical (fftwplanner)
+  ret = fftw_export_wisdom_to_filename(filename);
+  if(!ret) printf("Error in FFTExportWisdom: could not write wisdom to %s.\n", filename);
+  return ret ? SUCCESS : FAILURE;
+}
+
+/* Windowed input of the FFT of a real time series, 0-padded to the length N */
+static void FFTWindowRealTimeSeries(double* hval, const int N, RealTimeSeries* timeseries, double twindowbeg, double twindowend)
+{
   /* Warning: assumes linear sampling in time */
   double* times = timeseries->times->data;
   double deltat = times[1] - times[0];
-  double tshift = times[0]; /* time shift to be re-applied later */
-
-  /* Initialize vector for windowed, 0-padded FFT input */
   int n = (int) timeseries->times->size;
-  int nzeros = (int) pow(2, ((int) ceil(log(n)/log(2))) + nzeropad) - n; /* Here defined with ceil, but with floor in IFFT */
-  gsl_vector* hvalues = gsl_vector_alloc(n + nzeros);
-  gsl_vector_set_zero(hvalues);
 
   /* Compute input TD values, with windowing */
   int nbptswindowbeg = (int) ceil(twindowbeg/deltat) + 1;
@@ -81,7 +210,6 @@ int FFTRealTimeSeries(ReImFrequencySeries** freqseries, RealTimeSeries* timeseri
   double deltatwindowbeg = t2windowbeg - t1windowbeg;
   double deltatwindowend = t2windowend - t1windowend;
   double* h = timeseries->h->data;
-  double* hval = hvalues->data;
 
   for (int i=0; i<nbptswindowbeg; i++) {
     hval[i] = WindowFunctionRight(times[i], t1windowbeg, deltatwindowbeg) * h[i];
@@ -92,16 +220,14 @@ int FFTRealTimeSeries(ReImFrequencySeries** freqseries, RealTimeSeries* timeseri
   for (int i=n-nbptswindowend; i<n; i++) {
     hval[i] = WindowFunctionLeft(times[i], t2windowend, deltatwindowend) * h[i];
   }
+  for (int i=n; i<N; i++) {
+    hval[i] = 0.;
+  }
+}
 
-  /* FFT - uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
-  int N = (int) hvalues->size;
-  fftw_plan p;
-  double* in = hvalues->data;
-  fftw_complex* out;
-  out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (N/2+1)); /* Note: N/2+1 elements */
-  p = fftw_plan_dft_r2c_1d(N, in, out, FFTW_ESTIMATE);
-  fftw_execute(p);
-
+/* Frequency series from the output of the real FFT, with the N/2+1 elements of out */
+static void FFTRealOutput(ReImFrequencySeries** freqseries, fftw_complex* out, const int N, const double deltat, const double tshift)
+{
   /* Initialize output structure */
   ReImFrequencySeries_Init(freqseries, N/2); /* Note: N/2+1 elements as output of fftw, we drop the last one (at Nyquist frequency) */
 
@@ -120,10 +246,82 @@ int FFTRealTimeSeries(ReImFrequencySeries** freqseries, RealTimeSeries* timeseri
     hreal[i] = creal(hcomplex);
     himag[i] = cimag(hcomplex);
   }
+}
+
+/* FFT of real time series */
+/* Note: FFT uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
+int FFTRealTimeSeries(ReImFrequencySeries** freqseries, RealTimeSeries* timeseries, double twindowbeg, double twindowend, int nzeropad)
+{
+  /* deltat of time series */
+  /* Warning: assumes linear sampling in time */
+  double* times = timeseries->times->data;
+  double deltat = times[1] - times[0];
+  double tshift = times[0]; /* time shift to be re-applied later */
+
+  /* Windowed, 0-padded FFT input */
+  int n = (int) timeseries->times->size;
+  int nzeros = (int) pow(2, ((int) ceil(log(n)/log(2))) + nzeropad) - n; /* Here defined with ceil, but with floor in IFFT */
+  int N = n + nzeros;
+  double* in = fftw_malloc(sizeof(double) * N);
+  FFTWindowRealTimeSeries(in, N, timeseries, twindowbeg, twindowend);
+
+  /* FFT - uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
+  fftw_complex* out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (N/2+1)); /* Note: N/2+1 elements */
+  int owned;
+  fftw_plan p = FFTGetPlan(N, 1, FFTPlanR2C, &owned);
+  fftw_execute_dft_r2c(p, in, out);
+  FFTReleasePlan(p, owned);
+
+  /* Output */
+  FFTRealOutput(freqseries, out, N, deltat, tshift);
+
+  /* Clean up */
+  fftw_free(in);
+  fftw_free(out);
+
+  return SUCCESS;
+}
+
+/* FFT of three real time series with the same sampling, e.g. three TDI channels, as one batched transform */
+/* Note: FFT uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
+int FFTRealTimeSeries3Chan(ReImFrequencySeries** freqseries1, ReImFrequencySeries** freqseries2, ReImFrequencySeries** freqseries3, RealTimeSeries* timeseries1, RealTimeSeries* timeseries2, RealTimeSeries* timeseries3, double twindowbeg, double twindowend, int nzeropad)
+{
+  /* Check the sampling */
+  int n = (int) timeseries1->times->size;
+  if(!((int) timeseries2->times->size==n && (int) timeseries3->times->size==n)) {
+    printf("Error in FFTRealTimeSeries3Chan: time series have different lengths.\n");
+    return FAILURE;
+  }
+
+  /* deltat of time series */
+  /* Warning: assumes linear sampling in time */
+  double* times = timeseries1->times->data;
+  double deltat = times[1] - times[0];
+  double tshift = times[0]; /* time shift to be re-applied later */
+
+  /* Windowed, 0-padded FFT inputs, stored contiguously */
+  int nzeros = (int) pow(2, ((int) ceil(log(n)/log(2))) + nzeropad) - n; /* Here defined with ceil, but with floor in IFFT */
+  int N = n + nzeros;
+  int nc = N/2 + 1;
+  double* in = fftw_malloc(sizeof(double) * 3 * N);
+  FFTWindowRealTimeSeries(in, N, timeseries1, twindowbeg, twindowend);
+  FFTWindowRealTimeSeries(in + N, N, timeseries2, twindowbeg, twindowend);
+  FFTWindowRealTimeSeries(in + 2*N, N, timeseries3, twindowbeg, twindowend);
+
+  /* FFT - uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
+  fftw_complex* out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * 3 * nc);
+  int owned;
+  fftw_plan p = FFTGetPlan(N, 3, FFTPlanR2C, &owned);
+  fftw_execute_dft_r2c(p, in, out);
+  FFTReleasePlan(p, owned);
+
+  /* Outputs */
+  FFTRealOutput(freqseries1, out, N, deltat, tshift);
+  FFTRealOutput(freqseries2, out + nc, N, deltat, tshift);
+  FFTRealOutput(freqseries3, out + 2*nc, N, deltat, tshift);
 
   /* Clean up */
-  gsl_vector_free(hvalues);
-  fftw_destroy_plan(p);
+  fftw_free(in);
   fftw_free(out);
 
   return SUCCESS;
@@ -170,11 +368,12 @@ int FFTTimeSeries(ReImFrequencySeries** freqseries, ReImTimeSeries* timeseries,
 
   /* FFT - uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
   /* Represented here by the use of FFTW_BACKWARD (plus sign in the exp) */
-  fftw_plan p;
   fftw_complex* out;
   out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * N); /* Note: N/2+1 elements */
-  p = fftw_plan_dft_1d(N, in, out, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
+  int owned;
+  fftw_plan p = FFTGetPlan(N, 1, FFTPlanC2CBackward, &owned);
+  fftw_execute_dft(p, in, out);
+  FFTReleasePlan(p, owned);
 
   /* Initialize output structure */
   ReImFrequencySeries_Init(freqseries, N/2); /* NOTE: N/2 first elements of output of fftw are positive freqs, we eliminate negative frequency (the second half of the series) */
@@ -196,7 +395,6 @@ int FFTTimeSeries(ReImFrequencySeries** freqseries, ReImTimeSeries* timeseries,
   }
 
   /* Clean up */
-  fftw_destroy_plan(p);
   fftw_free(in);
   fftw_free(out);
 
@@ -253,10 +451,11 @@ int IFFTFrequencySeriesReal(RealTimeSeries** timeseries, ReImFrequencySeries* fr
   }
 
   /* FFT - uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
-  fftw_plan p;
   double* out = fftw_malloc(sizeof(double) * N);
-  p = fftw_plan_dft_c2r_1d(N, in, out, FFTW_ESTIMATE);
-  fftw_execute(p);
+  int owned;
+  fftw_plan p = FFTGetPlan(N, 1, FFTPlanC2R, &owned);
+  fftw_execute_dft_c2r(p, in, out);
+  FFTReleasePlan(p, owned);
 
   /* Initialize output structure */
   RealTimeSeries_Init(timeseries, N);
@@ -276,7 +475,6 @@ int IFFTFrequencySeriesReal(RealTimeSeries** timeseries, ReImFrequencySeries* fr
   /* Clean up */
   gsl_vector_free(hrealvalues);
   gsl_vector_free(himagvalues);
-  fftw_destroy_plan(p);
   fftw_free(in);
   fftw_free(out);
 
@@ -335,10 +533,11 @@ int IFFTFrequencySeries(ReImTimeSeries** timeseries, ReImFrequencySeries* freqse
 
   /* FFT - FFTW uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) - our convention is h(f) = int e^(-2ipift)h(t) */
   /* NOTE: due to the difference in convention for the FT, we use the FFTW_FORWARD sign (sign - in the exponential) */
-  fftw_plan p;
   double complex* out = fftw_malloc(sizeof(fftw_complex) * N);
-  p = fftw_plan_dft_1d(N, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
+  int owned;
+  fftw_plan p = FFTGetPlan(N, 1, FFTPlanC2CForward, &owned);
+  fftw_execute_dft(p, in, out);
+  FFTReleasePlan(p, owned);
 
   /* Initialize output structure */
   ReImTimeSeries_Init(timeseries, N);
@@ -361,7 +560,6 @@ int IFFTFrequencySeries(ReImTimeSeries** timeseries, ReImFrequencySeries* freqse
   /* Clean up */
   gsl_vector_free(hrealvalues);
   gsl_vector_free(himagvalues);
-  fftw_destroy_plan(p);
   fftw_free(in);
   fftw_free(out);
 
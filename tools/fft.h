@@ -38,6 +38,16 @@
 #include "constants.h"
 #include "struct.h"
 
+/* FFTW plans - plans are cached by size, number of transforms and kind, and reused by all the functions below */
+void FFTPlanCacheCleanup(void);
+/* Use FFTW_MEASURE (measure=1) or FFTW_ESTIMATE (measure=0, default) for new plans - clears the cache */
+void FFTSetPlanMeasure(int measure);
+/* Number of threads per transform - requires -DFFTW_THREADS and the fftw3_threads library - clears the cache */
+int FFTSetThreads(int nthreads);
+/* Import/export FFTW wisdom from/to file */
+int FFTImportWisdom(const char* filename);
+int FFTExportWisdom(const char* filename);
+
 /* Window functions */
 double WindowFunction(double x, double xi, double xf, double deltaxi, double deltaxf);
 double WindowFunctionLeft(double x, double xf, double deltaxf);
@@ -52,6 +62,19 @@ int FFTRealTimeSeries(
   double twindowend,                  /* Extent of the window at the end (end at the last point) */
   int nzeropad);                      /* For 0-padding: length will be (upper power of 2)*2^nzeropad */
 
+/* FFT of three real time series with the same sampling, e.g. three TDI channels, as one batched transform */
+/* Note: FFT uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
+int FFTRealTimeSeries3Chan(
+  ReImFrequencySeries** freqseries1,  /* Output: frequency series for channel 1 */
+  ReImFrequencySeries** freqseries2,  /* Output: frequency series for channel 2 */
+  ReImFrequencySeries** freqseries3,  /* Output: frequency series for channel 3 */
+  RealTimeSeries* timeseries1,        /* Input: real time series for channel 1 */
+  RealTimeSeries* timeseries2,        /* Input: real time series for channel 2 */
+  RealTimeSeries* timeseries3,        /* Input: real time series for channel 3 */
+  double twindowbeg,                  /* Extent of the window at beginning (starts at the first point) */
+  double twindowend,                  /* Extent of the window at the end (end at the last point) */
+  int nzeropad);                      /* For 0-padding: length will be (upper power of 2)*2^nzeropad */
+
 /* FFT of Re/Im time series */
 /* Note: FFT uses flipped convention (i.e. h(f) = int e^(+2ipift)h(t)) */
 int FFTTimeSeries(
@@ -390,57 +390,663 @@ double complex ComputeIntCase4(
   return term1 + term2;
 }
 
-double complex ComputeInt(
+/* Contribution of the interval j, treating the interval on its own */
+static double complex ComputeIntInterval(
+  gsl_matrix* splinecoeffsAreal,         /*  */
+  gsl_matrix* splinecoeffsAimag,         /*  */
+  gsl_matrix* quadsplinecoeffsphase,     /*  */
+  const int j)                           /*  */
+{
+  double eps = gsl_matrix_get(quadsplinecoeffsphase, j+1, 0) - gsl_matrix_get(quadsplinecoeffsphase, j, 0);
+  double epspow[4];
+  epspow[0] = 1.;
+  epspow[1] = eps;
+  epspow[2] = eps*eps;
+  epspow[3] = eps*epspow[2];
+  double p0 = gsl_matrix_get(quadsplinecoeffsphase, j, 1);
+
+  /* Rescale the interval to [0,1] and scale out the constant amplitude term */
+  double p1 = gsl_matrix_get(quadsplinecoeffsphase, j, 2) * eps;
+  double p2 = gsl_matrix_get(quadsplinecoeffsphase, j, 3) * epspow[2];
+  double complex A0 = gsl_matrix_get(splinecoeffsAreal, j, 1) + I*gsl_matrix_get(splinecoeffsAimag, j, 1);
+  double complex A0inv = 1./A0;
+  double A0abs = cabs(A0); /* Used for accuracy requirement of adaptive Taylor expansions Ia and Ib */
+  double complex coeffsA[4] = {0.,0.,0.,0.};
+  coeffsA[0] = 1.;
+  for(int i=1; i<=3; i++) coeffsA[i] = epspow[i] * A0inv * (gsl_matrix_get(splinecoeffsAreal, j, i+1) + I*gsl_matrix_get(splinecoeffsAimag, j, i+1));
+
+  /* Factor scaled out */
+  double complex factor = eps * A0 * cexp(I*p0);
+
+  double absp1 = fabs(p1); double absp2 = fabs(p2);
+  if(absp1<p1threshold1 && absp2<p2threshold) {
+    return factor * ComputeIntCase1a(coeffsA, p1, p2, A0abs);
+  }
+  else if(p1threshold1<=absp1 && absp1<p1threshold2 && absp2<p2threshold) {
+    return factor * ComputeIntCase1b(coeffsA, p1, p2, A0abs);
+  }
+  else if(absp2>=p2p1slopethreshold*absp1 && absp2>=p2threshold) {
+    return factor * ComputeIntCase2(coeffsA, p1, p2);
+  }
+  else if(absp2<p2p1slopethreshold*absp1 && absp2>=p2threshold && absp1<p1threshold2) {
+    return factor * ComputeIntCase3(coeffsA, p1, p2);
+  }
+  else {
+    return factor * ComputeIntCase4(coeffsA, p1, p2);
+  }
+}
+
+/* Reference implementation, treating the intervals one by one - kept for validation of ComputeInt */
+double complex ComputeIntScalar(
   gsl_matrix* splinecoeffsAreal,         /*  */
   gsl_matrix* splinecoeffsAimag,         /*  */
   gsl_matrix* quadsplinecoeffsphase)     /*  */
 {
   double complex res = 0.;
-  double complex resint = 0.;
   /* Number of points - i.e. nb of intervals + 1 */
   /* Assumes that the dimensions match and that the frequency vectors are the same between the different splinecoeffs */
   int nbpts = (int) quadsplinecoeffsphase->size1;
 
-  //clock_t tbegtotal = clock();
   for(int j=0; j<nbpts-1; j++) {
-    double eps = gsl_matrix_get(quadsplinecoeffsphase, j+1, 0) - gsl_matrix_get(quadsplinecoeffsphase, j, 0);
-    double epspow[4];
-    epspow[0] = 1.;
-    epspow[1] = eps;
-    epspow[2] = eps*eps;
-    epspow[3] = eps*epspow[2];
-    double p0 = gsl_matrix_get(quadsplinecoeffsphase, j, 1);
-
-    /* Rescale the interval to [0,1] and scale out the constant amplitude term */
-    double p1 = gsl_matrix_get(quadsplinecoeffsphase, j, 2) * eps;
-    double p2 = gsl_matrix_get(quadsplinecoeffsphase, j, 3) * epspow[2];
-    double complex A0 = gsl_matrix_get(splinecoeffsAreal, j, 1) + I*gsl_matrix_get(splinecoeffsAimag, j, 1);
-    double complex A0inv = 1./A0;
-    double A0abs = cabs(A0); /* Used for accuracy requirement of adaptive Taylor expansions Ia and Ib */
-    double complex coeffsA[4] = {0.,0.,0.,0.};
-    coeffsA[0] = 1.;
-    for(int i=1; i<=3; i++) coeffsA[i] = epspow[i] * A0inv * (gsl_matrix_get(splinecoeffsAreal, j, i+1) + I*gsl_matrix_get(splinecoeffsAimag, j, i+1));
+    res += ComputeIntInterval(splinecoeffsAreal, splinecoeffsAimag, quadsplinecoeffsphase, j);
+  }
 
+  return res;
+}
+
+/* Classification of an interval in the cases of ComputeInt */
+static int ComputeIntCaseOf(const double p1, const double p2) {
+  double absp1 = fabs(p1); double absp2 = fabs(p2);
+  if(absp1<p1threshold1 && absp2<p2threshold) return 0; /* Case 1a */
+  else if(p1threshold1<=absp1 && absp1<p1threshold2 && absp2<p2threshold) return 1; /* Case 1b */
+  else if(absp2>=p2p1slopethreshold*absp1 && absp2>=p2threshold) return 2; /* Case 2 */
+  else if(absp2<p2p1slopethreshold*absp1 && absp2>=p2threshold && absp1<p1threshold2) return 3; /* Case 3 */
+  else return 4; /* Case 4 */
+}
+
+/******************************************************************************/
+/* Batched evaluation of ComputeInt */
+/******************************************************************************/
+
+/* The kernels below treat a whole batch of intervals of the same case in one loop, on separate arrays */
+/* for real and imaginary parts, without branching and without C complex arithmetic (which goes through */
+/* library calls), so that the compiler can vectorize them. The adaptive truncations of FresnelE and of */
+/* cases 1a and 1b are reproduced with per-interval masks: the terms beyond the truncation are zero. */
+/* Intervals with a trigonometric argument out of the range of SinCosKernel are flagged, and recomputed */
+/* by ComputeIntInterval. */
+
+#if defined(__GNUC__) && !defined(__INTEL_COMPILER)
+#define COMPUTEINT_INLINE static inline __attribute__ ((always_inline))
+#else
+#define COMPUTEINT_INLINE static inline
+#endif
+
+/* Runtime dispatch between instruction sets, only on x86 with gcc-compatible compilers */
+#if defined(__GNUC__) && !defined(__INTEL_COMPILER) && (defined(__x86_64__) || defined(__i386__))
+#define COMPUTEINT_DISPATCH
+#endif
+
+/* Range of the argument of SinCosKernel: beyond, the reduction by multiples of pi/2 loses accuracy */
+static const double sincosmaxarg = 8.e5;
+/* Reduction by pi/2 in three parts, the first two having 33 significant bits (from fdlibm) */
+static const double invpio2 = 6.36619772367581382433e-01;
+static const double pio2_1 = 1.57079632673412561417e+00;
+static const double pio2_2 = 6.07710050630396597660e-11;
+static const double pio2_3 = 2.02226624871116645580e-21;
+/* Rounding to the nearest integer by addition and subtraction of 1.5*2^52 */
+static const double roundmagic = 6755399441055744.0;
+/* Polynomial coefficients for sin and cos on [-pi/4,pi/4] (from fdlibm) */
+static const double sincoeffs[6] = {-1.66666666666666324348e-01, 8.33333333332248946124e-03, -1.98412698298579493134e-04, 2.75573137070700676789e-06, -2.50507602534068634195e-08, 1.58969099521155010221e-10};
+static const double coscoeffs[6] = {4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05, -2.75573143513906633035e-07, 2.08757232129817482790e-09, -1.13596475577881948265e-11};
+
+/* Sine and cosine, returns 1. if the argument is out of range (the values are then meaningless) */
+/* The quadrant is kept as a double, so that all the masks have the width of a double */
+COMPUTEINT_INLINE double SinCosKernel(const double x, double* s, double* c)
+{
+  double nd = (x*invpio2 + roundmagic) - roundmagic;
+  double quadrant = nd - 4.*((0.25*nd + roundmagic) - roundmagic); /* nd modulo 4, in {-2,-1,0,1,2} */
+  double r = ((x - nd*pio2_1) - nd*pio2_2) - nd*pio2_3;
+  double z = r*r;
+  double sr = r + r*z*(sincoeffs[0] + z*(sincoeffs[1] + z*(sincoeffs[2] + z*(sincoeffs[3] + z*(sincoeffs[4] + z*sincoeffs[5])))));
+  double cr = 1. - 0.5*z + z*z*(coscoeffs[0] + z*(coscoeffs[1] + z*(coscoeffs[2] + z*(coscoeffs[3] + z*(coscoeffs[4] + z*coscoeffs[5])))));
+  quadrant += (quadrant<0.) ? 4. : 0.; /* Now in {0,1,2,3} */
+  double swap = (fabs(quadrant - 2.)==1.) ? 1. : 0.;
+  double signs = (quadrant>=2.) ? -1. : 1.;
+  double signc = (fabs(quadrant - 1.5)<1.) ? -1. : 1.;
+  *s = signs * (swap*cr + (1.-swap)*sr);
+  *c = signc * (swap*sr + (1.-swap)*cr);
+  return (fabs(x) <= sincosmaxarg) ? 0. : 1.; /* Also catches NaN */
+}
+
+/* FresnelE, returns 1. if out of range - the Taylor expansion is identical to FresnelE */
+COMPUTEINT_INLINE double FresnelEKernel(const double x, double* resr, double* resi)
+{
+  double ax = fabs(x);
+  double taylor = (ax<2) ? 1. : 0.;
+
+  /* If x<2, Taylor expansion - terms are added as long as FresnelE would add them */
+  double xt = taylor * ax;
+  double x3 = xt*xt*xt;
+  double x4 = x3*xt;
+  double C = 0.;
+  double S = 0.;
+  double deltaC = xt;
+  double deltaS = x3/3.;
+  double active = 1.;
+#pragma GCC unroll 13
+  for(int n=0; n<13; n++) {
+    C += active * deltaC;
+    S += active * deltaS;
+    deltaC = coeffdeltaC[n] * x4 * deltaC;
+    deltaS = coeffdeltaS[n] * x4 * deltaS;
+    active *= 1. - ((fabs(deltaC)<acc) ? 1. : 0.) * ((fabs(deltaS)<acc) ? 1. : 0.);
+  }
+
+  /* If x>2, Mielenz-Boersma formula using tabulated coeffs */
+  double xa = (ax<2) ? 2. : ax;
+  double xinv = 1./xa;
+  double xinv2 = xinv*xinv;
+  double y = xinv;
+  double f = fcoeff[0] * y;
+  double g = gcoeff[0] * y;
+#pragma GCC unroll 11
+  for(int i=1; i<12; i++) {
+    y = y*xinv2;
+    f += fcoeff[i] * y;
+    g += gcoeff[i] * y;
+  }
+  double s, c;
+  double outofrange = SinCosKernel(xa*xa, &s, &c);
+  double sqrtpiov2 = sqrt(PI/2);
+  double Er = sqrtpiov2 * (0.5 - (g*c - f*s));
+  double Ei = sqrtpiov2 * (0.5 - (g*s + f*c));
+
+  double sign = copysign(1., x);
+  *resr = sign * (taylor*C + (1.-taylor)*Er);
+  *resi = sign * (taylor*S + (1.-taylor)*Ei);
+  return (1.-taylor) * outofrange;
+}
+
+/* Storage for one block of intervals - intervals are sorted by case, and the per-case arrays are contiguous */
+#define nbintervalblock 256
+typedef struct tagComputeIntBlock {
+  /* Interval data, in the order of the intervals */
+  double p1[nbintervalblock];
+  double p2[nbintervalblock];
+  double scale[nbintervalblock];
+  double ar[3][nbintervalblock];
+  double ai[3][nbintervalblock];
+  double factorr[nbintervalblock];
+  double factori[nbintervalblock];
+  double resr[nbintervalblock];
+  double resi[nbintervalblock];
+  double outofrange[nbintervalblock];
+  int caseof[nbintervalblock];
+  /* Interval data, sorted by case */
+  int order[nbintervalblock];
+  double sp1[nbintervalblock];
+  double sp2[nbintervalblock];
+  double sscale[nbintervalblock];
+  double sar[3][nbintervalblock];
+  double sai[3][nbintervalblock];
+  double sresr[nbintervalblock];
+  double sresi[nbintervalblock];
+  double soutofrange[nbintervalblock];
+} ComputeIntBlock;
+
+/* One block per thread, not on the stack */
+static ComputeIntBlock __ComputeIntBlock __attribute__ ((aligned(64)));
+#pragma omp threadprivate(__ComputeIntBlock)
+
+/* Interval data, rescaled to [0,1] with the constant amplitude term scaled out */
+COMPUTEINT_INLINE void ComputeIntBlockSetupKernel(
+  ComputeIntBlock* restrict b,           /* Block storage */
+  const double* restrict Areal,          /* First row of the block of splinecoeffsAreal */
+  const double* restrict Aimag,          /* First row of the block of splinecoeffsAimag */
+  const double* restrict phase,          /* First row of the block of quadsplinecoeffsphase */
+  const int tdaA,                        /* Row stride of splinecoeffsAreal */
+  const int tdaAimag,                    /* Row stride of splinecoeffsAimag */
+  const int tdaphase,                    /* Row stride of quadsplinecoeffsphase */
+  const int nb)                          /* Number of intervals in the block */
+{
+  for(int k=0; k<nb; k++) {
+    double eps = phase[(k+1)*tdaphase] - phase[k*tdaphase];
+    double epspow2 = eps*eps;
+    double epspow3 = eps*epspow2;
+    double p0 = phase[k*tdaphase + 1];
+    b->p1[k] = phase[k*tdaphase + 2] * eps;
+    b->p2[k] = phase[k*tdaphase + 3] * epspow2;
+    double A0r = Areal[k*tdaA + 1];
+    double A0i = Aimag[k*tdaAimag + 1];
+    double A0abs2 = A0r*A0r + A0i*A0i;
+    double A0invr = A0r/A0abs2;
+    double A0invi = -A0i/A0abs2;
+    b->scale[k] = sqrt(A0abs2); /* Used for accuracy requirement of adaptive Taylor expansions Ia and Ib */
+    double epspow[3] = {eps, epspow2, epspow3};
+#pragma GCC unroll 3
+    for(int i=0; i<3; i++) {
+      double cr = epspow[i] * A0invr;
+      double ci = epspow[i] * A0invi;
+      double Ar = Areal[k*tdaA + i+2];
+      double Ai = Aimag[k*tdaAimag + i+2];
+      b->ar[i][k] = cr*Ar - ci*Ai;
+      b->ai[i][k] = cr*Ai + ci*Ar;
+    }
     /* Factor scaled out */
-    double complex factor = eps * A0 * cexp(I*p0);
+    double s, c;
+    b->outofrange[k] = SinCosKernel(p0, &s, &c);
+    b->factorr[k] = eps * (A0r*c - A0i*s);
+    b->factori[k] = eps * (A0r*s + A0i*c);
+  }
+}
 
-    double absp1 = fabs(p1); double absp2 = fabs(p2);
-    if(absp1<p1threshold1 && absp2<p2threshold) {
-      resint = factor * ComputeIntCase1a(coeffsA, p1, p2, A0abs);
+/* Taylor coefficients of cexp(I*p2*x^2) in x^0, x^2, x^4, x^6, truncated as in ComputeIntCase1a and ComputeIntCase1b */
+COMPUTEINT_INLINE void ComputeIntPoly2Kernel(const double p2, const double acctol, double* poly2r, double* poly2i)
+{
+  double p2abs = fabs(p2);
+  double term2r = 1.; double term2i = 0.; double term2absmax = 1.;
+  double active2 = 1.;
+#pragma GCC unroll 4
+  for(int i=0; i<4; i++) {
+    poly2r[i] = active2 * term2r;
+    poly2i[i] = active2 * term2i;
+    term2absmax = term2absmax * p2abs * invn[i];
+    active2 *= (term2absmax<acctol) ? 0. : 1.;
+    double tr = -term2i*p2*invn[i];
+    term2i = term2r*p2*invn[i];
+    term2r = tr;
+  }
+}
+
+/* Product of a polynomial with the even polynomial above, truncated to x^11 */
+COMPUTEINT_INLINE void ComputeIntMulPoly2Kernel(const double* cr, const double* ci, const int ncoeffs, const double* poly2r, const double* poly2i, double* resr, double* resi)
+{
+#pragma GCC unroll 12
+  for(int i=0; i<12; i++) {
+    resr[i] = 0.;
+    resi[i] = 0.;
+  }
+#pragma GCC unroll 4
+  for(int j=0; j<4; j++) {
+#pragma GCC unroll 12
+    for(int i=0; i<ncoeffs; i++) {
+      if(i+2*j<=11) {
+        resr[i+2*j] += cr[i]*poly2r[j] - ci[i]*poly2i[j];
+        resi[i+2*j] += cr[i]*poly2i[j] + ci[i]*poly2r[j];
+      }
     }
-    else if(p1threshold1<=absp1 && absp1<p1threshold2 && absp2<p2threshold) {
-      resint = factor * ComputeIntCase1b(coeffsA, p1, p2, A0abs);
+  }
+}
+
+/* Case 1a for the intervals [nbeg,nend) of the sorted arrays */
+COMPUTEINT_INLINE void ComputeIntCase1aKernel(ComputeIntBlock* restrict b, const int nbeg, const int nend)
+{
+  for(int n=nbeg; n<nend; n++) {
+    double p1 = b->sp1[n];
+    double p2 = b->sp2[n];
+    double acctol = 1.e-5/b->sscale[n];
+    double c0r[4] = {1.,b->sar[0][n],b->sar[1][n],b->sar[2][n]};
+    double c0i[4] = {0.,b->sai[0][n],b->sai[1][n],b->sai[2][n]};
+
+    /* Polynomial given by the expansion of cexp(I*p1*x) */
+    double poly1r[9], poly1i[9];
+    double p1abs = fabs(p1);
+    double term1r = 1.; double term1i = 0.; double term1absmax = 1.;
+    double active1 = 1.;
+#pragma GCC unroll 8
+    for(int i=0; i<8; i++) {
+      poly1r[i] = active1 * term1r;
+      poly1i[i] = active1 * term1i;
+      term1absmax = term1absmax * p1abs * invn[i];
+      active1 *= (term1absmax<acctol) ? 0. : 1.;
+      double tr = -term1i*p1*invn[i];
+      term1i = term1r*p1*invn[i];
+      term1r = tr;
     }
-    else if(absp2>=p2p1slopethreshold*absp1 && absp2>=p2threshold) {
-      resint = factor * ComputeIntCase2(coeffsA, p1, p2);
+    poly1r[8] = active1 * term1r;
+    poly1i[8] = active1 * term1i;
+
+    /* Polynomial given by the expansion of cexp(I*p2*x2) - only even powers */
+    double poly2r[4], poly2i[4];
+    ComputeIntPoly2Kernel(p2, acctol, poly2r, poly2i);
+
+    /* Multiplying the polynomials, accumulating the terms in the same order as ComputeIntCase1a */
+    double c1r[12] = {0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.};
+    double c1i[12] = {0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.};
+#pragma GCC unroll 9
+    for(int j=0; j<=8; j++) {
+#pragma GCC unroll 4
+      for(int i=3; i>=0; i--) {
+        c1r[i+j] += c0r[i]*poly1r[j] - c0i[i]*poly1i[j];
+        c1i[i+j] += c0r[i]*poly1i[j] + c0i[i]*poly1r[j];
+      }
     }
-    else if(absp2<p2p1slopethreshold*absp1 && absp2>=p2threshold && absp1<p1threshold2) {
-      resint = factor * ComputeIntCase3(coeffsA, p1, p2);
+    double cr[12], ci[12];
+    ComputeIntMulPoly2Kernel(c1r, c1i, 12, poly2r, poly2i, cr, ci);
+
+    /* Computing the integral itself */
+    double resr = 0.; double resi = 0.;
+#pragma GCC unroll 12
+    for(int i=0; i<12; i++) {
+      resr += cr[i] * invn[i];
+      resi += ci[i] * invn[i];
     }
-    else {
-      resint = factor * ComputeIntCase4(coeffsA, p1, p2);
+    b->sresr[n] = resr;
+    b->sresi[n] = resi;
+    b->soutofrange[n] = 0.;
+  }
+}
+
+/* Case 1b for the intervals [nbeg,nend) of the sorted arrays */
+COMPUTEINT_INLINE void ComputeIntCase1bKernel(ComputeIntBlock* restrict b, const int nbeg, const int nend)
+{
+  for(int n=nbeg; n<nend; n++) {
+    double p1 = b->sp1[n];
+    double p2 = b->sp2[n];
+    double acctol = 1.e-5/b->sscale[n];
+    double c0r[4] = {1.,b->sar[0][n],b->sar[1][n],b->sar[2][n]};
+    double c0i[4] = {0.,b->sai[0][n],b->sai[1][n],b->sai[2][n]};
+
+    /* Polynomial given by the expansion of cexp(I*p2*x2) - only even powers */
+    double poly2r[4], poly2i[4];
+    ComputeIntPoly2Kernel(p2, acctol, poly2r, poly2i);
+
+    /* Multiplying the polynomials, accumulating the terms in the same order as ComputeIntCase1b */
+    double cr[12], ci[12];
+    ComputeIntMulPoly2Kernel(c0r, c0i, 4, poly2r, poly2i, cr, ci);
+
+    /* Go down the recursion relation */
+    double invp1 = 1./p1;
+    double coeffE1r = 0.; double coeffE1i = 0.;
+#pragma GCC unroll 11
+    for(int i=11; i>=1; i--) {
+      coeffE1r += invp1 * ci[i];
+      coeffE1i += -invp1 * cr[i];
+      cr[i-1] += -invp1 * i * ci[i];
+      ci[i-1] += invp1 * i * cr[i];
+    }
+    double coeffE1minus1r = invp1 * ci[0];
+    double coeffE1minus1i = -invp1 * cr[0];
+
+    /* Result, with cexp(I*p1)-1 computed as in cexpm1i */
+    double sinhalf, coshalf;
+    double outofrange = SinCosKernel(0.5*p1, &sinhalf, &coshalf);
+    double cexpm1r = -2.0*sinhalf*sinhalf;
+    double cexpm1i = 2.0*sinhalf*coshalf;
+    b->sresr[n] = coeffE1r*(cexpm1r+1.) - coeffE1i*cexpm1i + coeffE1minus1r*cexpm1r - coeffE1minus1i*cexpm1i;
+    b->sresi[n] = coeffE1r*cexpm1i + coeffE1i*(cexpm1r+1.) + coeffE1minus1r*cexpm1i + coeffE1minus1i*cexpm1r;
+    b->soutofrange[n] = outofrange;
+  }
+}
+
+/* Case 2 for the intervals [nbeg,nend) of the sorted arrays */
+COMPUTEINT_INLINE void ComputeIntCase2Kernel(ComputeIntBlock* restrict b, const int nbeg, const int nend)
+{
+  for(int n=nbeg; n<nend; n++) {
+    /* Conjugate if p2<0 */
+    double sign = copysign(1., b->sp2[n]);
+    double p1b = sign * b->sp1[n];
+    double p2b = sign * b->sp2[n];
+    double c0r = 1.; double c0i = 0.;
+    double c1r = b->sar[0][n]; double c1i = sign * b->sai[0][n];
+    double c2r = b->sar[1][n]; double c2i = sign * b->sai[1][n];
+    double c3r = b->sar[2][n]; double c3i = sign * b->sai[2][n];
+
+    /* n=3 and n=2 */
+    double inv2p2 = 1. / (2.*p2b);
+    double coeffE2r = inv2p2 * c3i;
+    double coeffE2i = -inv2p2 * c3r;
+    c1r += -inv2p2 * 2 * c3i; c1i += inv2p2 * 2 * c3r;
+    c2r += -p1b * inv2p2 * c3r; c2i += -p1b * inv2p2 * c3i;
+    coeffE2r += inv2p2 * c2i;
+    coeffE2i += -inv2p2 * c2r;
+    c0r += -inv2p2 * c2i; c0i += inv2p2 * c2r;
+    c1r += -p1b * inv2p2 * c2r; c1i += -p1b * inv2p2 * c2i;
+    /* n=1 */
+    coeffE2r += inv2p2 * c1i;
+    coeffE2i += -inv2p2 * c1r;
+    double constantr = -inv2p2 * c1i;
+    double constanti = inv2p2 * c1r;
+    double coefffresnelr = -p1b * inv2p2 * c1r;
+    double coefffresneli = -p1b * inv2p2 * c1i;
+    /* n=0 */
+    coefffresnelr += c0r;
+    coefffresneli += c0i;
+
+    /* Fresnel integral and complex exponential */
+    double outofrange = 0.;
+    double E2r, E2i;
+    outofrange += SinCosKernel(p1b + p2b, &E2i, &E2r);
+    double sqrtp2 = sqrt(p2b);
+    double invsqrtp2 = 1./sqrtp2;
+    double halfratio = 0.5 * p1b * invsqrtp2;
+    double Esr, Esi;
+    outofrange += SinCosKernel(halfratio*halfratio, &Esi, &Esr);
+    double Fbr, Fbi, Far, Fai;
+    outofrange += FresnelEKernel(halfratio + sqrtp2, &Fbr, &Fbi);
+    outofrange += FresnelEKernel(halfratio, &Far, &Fai);
+    double dFr = invsqrtp2 * (Fbr - Far);
+    double dFi = invsqrtp2 * (Fbi - Fai);
+    double fresnelr = Esr*dFr + Esi*dFi;
+    double fresneli = Esr*dFi - Esi*dFr;
+
+    /* Result, remembering possible conjugation */
+    b->sresr[n] = constantr + (coeffE2r*E2r - coeffE2i*E2i) + (coefffresnelr*fresnelr - coefffresneli*fresneli);
+    b->sresi[n] = sign * (constanti + (coeffE2r*E2i + coeffE2i*E2r) + (coefffresnelr*fresneli + coefffresneli*fresnelr));
+    b->soutofrange[n] = outofrange;
+  }
+}
+
+/* Case 3 for the intervals [nbeg,nend) of the sorted arrays */
+/* As in ComputeIntCase3, the integrand on the nodes is real and only keeps the real part of the coefficients */
+COMPUTEINT_INLINE void ComputeIntCase3Kernel(ComputeIntBlock* restrict b, const int nbeg, const int nend)
+{
+  for(int n=nbeg; n<nend; n++) {
+    double p1 = b->sp1[n];
+    double p2 = b->sp2[n];
+    double a1 = b->sar[0][n]; double a2 = b->sar[1][n]; double a3 = b->sar[2][n];
+    /* Prepare change of variables */
+    double r = p2/p1;
+
+    /* Compute integrand F on nodes */
+    double Fvalues[6];
+#pragma GCC unroll 6
+    for(int i=0; i<6; i++) {
+      double y = (1.+ChebyshevNodes[i])/2.;
+      double sqrtterm = sqrt(1. + 4.*r*(1.+r)*y);
+      double factor = (1.+r)/sqrtterm;
+      double x = (2.*(1.+r)*y)/(1. + sqrtterm);
+      Fvalues[i] = factor * (1. + x*(a1 + x*(a2 + x*a3)));
+    }
+
+    /* Compute Chebyshev coefficients ci */
+    double c[6] = {0.,0.,0.,0.,0.,0.};
+#pragma GCC unroll 6
+    for(int i=0; i<6; i++) {
+#pragma GCC unroll 6
+      for(int j=0; j<6; j++) c[i] += ChebyshevWeights[i][j] * Fvalues[j];
+    }
+
+    /* Coefficients of polynomial in z=1/(I*p), p=p1*(1+r) - they are real */
+    double p = p1*(1.+r);
+    double coeffszcos[5], coeffszsin[6];
+    coeffszcos[0] = c[1] + c[3] + c[5];
+    coeffszcos[1] = -8.*c[2] - 32.*c[4];
+    coeffszcos[2] = 96.*c[3] + 800.*c[5];
+    coeffszcos[3] = -1536.*c[4];
+    coeffszcos[4] = 30720.*c[5];
+    coeffszsin[0] = 0.5*c[0] + c[2] + c[4];
+    coeffszsin[1] = -2.*c[1] - 18.*c[3] - 50.*c[5];
+    coeffszsin[2] = 16.*c[2] + 320.*c[4];
+    coeffszsin[3] = -192.*c[3] -6720.*c[5];
+    coeffszsin[4] = 3072.*c[4];
+    coeffszsin[5] = -61440.*c[5];
+
+    /* Coefficients of cos(p/2) and sin(p/2) - z=-I/p is imaginary, z*(x+Iy) = (-zi*y) + I*(zi*x) */
+    double zi = -1./p;
+    double coeffcosr = 0.; double coeffcosi = 0.;
+#pragma GCC unroll 5
+    for(int i=4; i>=0; i--) {
+      double tr = coeffszcos[i] - zi*coeffcosi;
+      coeffcosi = zi*coeffcosr;
+      coeffcosr = tr;
+    }
+    double coeffsinr = coeffszsin[5]; double coeffsini = 0.;
+#pragma GCC unroll 5
+    for(int i=4; i>=0; i--) {
+      double tr = coeffszsin[i] - zi*coeffsini;
+      coeffsini = zi*coeffsinr;
+      coeffsinr = tr;
+    }
+    double tcos = -zi*coeffcosi; coeffcosi = zi*coeffcosr; coeffcosr = tcos;
+    double tsin = -zi*coeffsini; coeffsini = zi*coeffsinr; coeffsinr = tsin;
+
+    /* Result */
+    double s, co;
+    double outofrange = SinCosKernel(p/2., &s, &co);
+    double innerr = 2*co*coeffcosr - 2*s*coeffsini;
+    double inneri = 2*co*coeffcosi + 2*s*coeffsinr;
+    b->sresr[n] = co*innerr - s*inneri;
+    b->sresi[n] = co*inneri + s*innerr;
+    b->soutofrange[n] = outofrange;
+  }
+}
+
+/* Case 4 for the intervals [nbeg,nend) of the sorted arrays */
+COMPUTEINT_INLINE void ComputeIntCase4Kernel(ComputeIntBlock* restrict b, const int nbeg, const int nend)
+{
+  for(int n=nbeg; n<nend; n++) {
+    double p1 = b->sp1[n];
+    double p2 = b->sp2[n];
+    double a1r = b->sar[0][n]; double a1i = b->sai[0][n];
+    double a2r = b->sar[1][n]; double a2i = b->sai[1][n];
+    double a3r = b->sar[2][n]; double a3i = b->sai[2][n];
+    double r = 2.*p2/p1;
+    double inv1plusr = 1./(1.+r); double inv1plusr2 = inv1plusr*inv1plusr;
+    double inv1plusr4 = inv1plusr2*inv1plusr2;
+    double invp1 = 1./p1; double invp12 = invp1*invp1; double invp13 = invp12*invp1;
+
+    /* term1 = cexp(I*(p1+p2))*(-I*invp1*S0*inv1plusr + invp12*S1*inv1plusr2 + I*invp13*S2*inv1plusr4) */
+    double S0r = 1. + a1r + a2r + a3r; double S0i = a1i + a2i + a3i;
+    double S1r = a1r + 2.*a2r + 3.*a3r; double S1i = a1i + 2.*a2i + 3.*a3i;
+    double S2r = 2.*a2r + 6.*a3r + r*(3.*a3r - a1r); double S2i = 2.*a2i + 6.*a3i + r*(3.*a3i - a1i);
+    double innerr = invp1*S0i*inv1plusr + invp12*S1r*inv1plusr2 - invp13*S2i*inv1plusr4;
+    double inneri = -invp1*S0r*inv1plusr + invp12*S1i*inv1plusr2 + invp13*S2r*inv1plusr4;
+    double s, c;
+    double outofrange = SinCosKernel(p1 + p2, &s, &c);
+    /* term2 = -(-I*invp1 + invp12*a1 + I*invp13*T), T = 2*a2 - a1*r */
+    double Tr = 2.*a2r - a1r*r; double Ti = 2.*a2i - a1i*r;
+    double term2r = -(invp12*a1r - invp13*Ti);
+    double term2i = -(-invp1 + invp12*a1i + invp13*Tr);
+    b->sresr[n] = (c*innerr - s*inneri) + term2r;
+    b->sresi[n] = (c*inneri + s*innerr) + term2i;
+    b->soutofrange[n] = outofrange;
+  }
+}
+
+/* Evaluation of the sorted block: gather the data of each case, evaluate case by case, multiply by the factor */
+COMPUTEINT_INLINE void ComputeIntBlockCasesKernel(ComputeIntBlock* restrict b, const int* nbcase, const int nb)
+{
+  for(int n=0; n<nb; n++) {
+    int k = b->order[n];
+    b->sp1[n] = b->p1[k];
+    b->sp2[n] = b->p2[k];
+    b->sscale[n] = b->scale[k];
+#pragma GCC unroll 3
+    for(int i=0; i<3; i++) {
+      b->sar[i][n] = b->ar[i][k];
+      b->sai[i][n] = b->ai[i][k];
+    }
+  }
+  int n0 = 0;
+  ComputeIntCase1aKernel(b, n0, n0 + nbcase[0]); n0 += nbcase[0];
+  ComputeIntCase1bKernel(b, n0, n0 + nbcase[1]); n0 += nbcase[1];
+  ComputeIntCase2Kernel(b, n0, n0 + nbcase[2]); n0 += nbcase[2];
+  ComputeIntCase3Kernel(b, n0, n0 + nbcase[3]); n0 += nbcase[3];
+  ComputeIntCase4Kernel(b, n0, n0 + nbcase[4]);
+  for(int n=0; n<nb; n++) {
+    int k = b->order[n];
+    b->resr[k] = b->factorr[k]*b->sresr[n] - b->factori[k]*b->sresi[n];
+    b->resi[k] = b->factorr[k]*b->sresi[n] + b->factori[k]*b->sresr[n];
+    b->outofrange[k] += b->soutofrange[n];
+  }
+}
+
+/* Instantiation of the kernels for a given instruction set */
+#define COMPUTEINT_KERNELS(suffix) \
+static void ComputeIntBlockSetup##suffix(ComputeIntBlock* b, const double* Areal, const double* Aimag, const double* phase, const int tdaA, const int tdaAimag, const int tdaphase, const int nb) { \
+  ComputeIntBlockSetupKernel(b, Areal, Aimag, phase, tdaA, tdaAimag, tdaphase, nb); \
+} \
+static void ComputeIntBlockCases##suffix(ComputeIntBlock* b, const int* nbcase, const int nb) { \
+  ComputeIntBlockCasesKernel(b, nbcase, nb); \
+}
+
+COMPUTEINT_KERNELS(Default)
+#ifdef COMPUTEINT_DISPATCH
+#pragma GCC push_options
+#pragma GCC target("avx2")
+COMPUTEINT_KERNELS(AVX2)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+COMPUTEINT_KERNELS(AVX512)
+#pragma GCC pop_options
+#endif
+
+/* Computing the integral by blocks of intervals: the intervals of a block are sorted by case, */
+/* and each case is evaluated by a vectorized kernel for all its intervals in a row. */
+/* Contributions are summed in the order of the intervals; the result agrees with ComputeIntScalar up to rounding errors */
+double complex ComputeInt(
+  gsl_matrix* splinecoeffsAreal,         /*  */
+  gsl_matrix* splinecoeffsAimag,         /*  */
+  gsl_matrix* quadsplinecoeffsphase)     /*  */
+{
+  double complex res = 0.;
+  /* Number of points - i.e. nb of intervals + 1 */
+  /* Assumes that the dimensions match and that the frequency vectors are the same between the different splinecoeffs */
+  int nbpts = (int) quadsplinecoeffsphase->size1;
+  int nbintervals = nbpts - 1;
+  ComputeIntBlock* b = &__ComputeIntBlock;
+
+  /* Select the kernels for the instruction set of the machine */
+  void (*blocksetup)(ComputeIntBlock*, const double*, const double*, const double*, const int, const int, const int, const int) = ComputeIntBlockSetupDefault;
+  void (*blockcases)(ComputeIntBlock*, const int*, const int) = ComputeIntBlockCasesDefault;
+#ifdef COMPUTEINT_DISPATCH
+  if(__builtin_cpu_supports("avx512f")) {
+    blocksetup = ComputeIntBlockSetupAVX512;
+    blockcases = ComputeIntBlockCasesAVX512;
+  }
+  else if(__builtin_cpu_supports("avx2")) {
+    blocksetup = ComputeIntBlockSetupAVX2;
+    blockcases = ComputeIntBlockCasesAVX2;
+  }
+#endif
+
+  for(int jblock=0; jblock<nbintervals; jblock+=nbintervalblock) {
+    int nb = min(nbintervalblock, nbintervals - jblock);
+
+    /* Interval data */
+    blocksetup(b, gsl_matrix_const_ptr(splinecoeffsAreal, jblock, 0), gsl_matrix_const_ptr(splinecoeffsAimag, jblock, 0), gsl_matrix_const_ptr(quadsplinecoeffsphase, jblock, 0), (int) splinecoeffsAreal->tda, (int) splinecoeffsAimag->tda, (int) quadsplinecoeffsphase->tda, nb);
+
+    /* Sort the intervals by case */
+    int nbcase[5] = {0,0,0,0,0};
+    int offset[5];
+    for(int k=0; k<nb; k++) {
+      b->caseof[k] = ComputeIntCaseOf(b->p1[k], b->p2[k]);
+      nbcase[b->caseof[k]]++;
+    }
+    offset[0] = 0;
+    for(int c=1; c<5; c++) offset[c] = offset[c-1] + nbcase[c-1];
+    for(int k=0; k<nb; k++) b->order[offset[b->caseof[k]]++] = k;
+
+    /* Evaluation case by case */
+    blockcases(b, nbcase, nb);
+
+    /* Sum in the order of the intervals - intervals out of the range of the kernels are recomputed one by one */
+    for(int k=0; k<nb; k++) {
+      if(b->outofrange[k]!=0.) res += ComputeIntInterval(splinecoeffsAreal, splinecoeffsAimag, quadsplinecoeffsphase, jblock + k);
+      else res += b->resr[k] + I*b->resi[k];
     }
-    res += resint;
   }
 
   return res;
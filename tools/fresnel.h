@@ -48,6 +48,11 @@ double complex ComputeInt(
   gsl_matrix* splinecoeffsAreal,         /*  */
   gsl_matrix* splinecoeffsAimag,         /*  */
   gsl_matrix* splinecoeffsphase);        /*  */
+/* Reference version going through the intervals one by one, same result up to rounding errors - for validation */
+double complex ComputeIntScalar(
+  gsl_matrix* splinecoeffsAreal,         /*  */
+  gsl_matrix* splinecoeffsAimag,         /*  */
+  gsl_matrix* splinecoeffsphase);        /*  */
 
 double complex ComputeIntCase1a(
   const double complex* coeffsA,         /* */
@@ -33,6 +33,7 @@
 
 #include "constants.h"
 #include "struct.h"
+#include "profiling.h"
 #include "splinecoeffs.h"
 #include "fresnel.h"
 #include "likelihood.h"
@@ -48,6 +49,88 @@
 
 /********************************* Utilities ****************************************/
 
+/******** Functions to initialize and clean up the OverlapWorkspace structure ********/
+void OverlapWorkspace_Init(OverlapWorkspace **ws, const int nmax) {
+  if(!ws) exit(1);
+  /* Create storage for structures */
+  if(!*ws) *ws=malloc(sizeof(OverlapWorkspace));
+  else
+  {
+    if((*ws)->bufferseries) CAmpPhaseFrequencySeries_Cleanup((*ws)->bufferseries);
+    if((*ws)->buffersplines) CAmpPhaseSpline_Cleanup((*ws)->buffersplines);
+    if((*ws)->splinews) SplineWorkspace_Cleanup((*ws)->splinews);
+    if((*ws)->splinessoa) ModesCAmpPhaseSpline3ChanSoA_Cleanup((*ws)->splinessoa);
+  }
+  (*ws)->nmax = 0;
+  (*ws)->nbregrow = 0;
+  (*ws)->bufferseries = NULL;
+  (*ws)->buffersplines = NULL;
+  (*ws)->splinews = NULL;
+  (*ws)->splinessoa = NULL;
+  ModesCAmpPhaseSpline3ChanSoA_Init(&((*ws)->splinessoa), 0);
+  OverlapWorkspace_Reserve(*ws, nmax);
+}
+void OverlapWorkspace_Cleanup(OverlapWorkspace *ws) {
+  if(ws->bufferseries) CAmpPhaseFrequencySeries_Cleanup(ws->bufferseries);
+  if(ws->buffersplines) CAmpPhaseSpline_Cleanup(ws->buffersplines);
+  if(ws->splinews) SplineWorkspace_Cleanup(ws->splinews);
+  if(ws->splinessoa) ModesCAmpPhaseSpline3ChanSoA_Cleanup(ws->splinessoa);
+  free(ws);
+}
+/* Ensure the capacity of the workspace is at least n points - grows by at least a factor 2 to limit reallocations */
+void OverlapWorkspace_Reserve(OverlapWorkspace *ws, const int n) {
+  if(n<=ws->nmax) return;
+  int nmax = max(n, 2*ws->nmax);
+  /* Buffers are released first, the contents are not preserved */
+  if(ws->bufferseries) CAmpPhaseFrequencySeries_Cleanup(ws->bufferseries);
+  if(ws->buffersplines) CAmpPhaseSpline_Cleanup(ws->buffersplines);
+  if(ws->splinews) SplineWorkspace_Cleanup(ws->splinews);
+  ws->bufferseries = NULL;
+  ws->buffersplines = NULL;
+  ws->splinews = NULL;
+  CAmpPhaseFrequencySeries_Init(&(ws->bufferseries), nmax);
+  CAmpPhaseSpline_Init(&(ws->buffersplines), nmax);
+  SplineWorkspace_Init(&(ws->splinews), nmax);
+  ws->nmax = nmax;
+  ws->nbregrow++;
+}
+/* Set the views of the workspace to the first n points of the buffers */
+static void OverlapWorkspace_SetLength(OverlapWorkspace *ws, const int n) {
+  OverlapWorkspace_Reserve(ws, n);
+  ws->viewfreq = gsl_vector_subvector(ws->bufferseries->freq, 0, n);
+  ws->viewampreal = gsl_vector_subvector(ws->bufferseries->amp_real, 0, n);
+  ws->viewampimag = gsl_vector_subvector(ws->bufferseries->amp_imag, 0, n);
+  ws->viewphase = gsl_vector_subvector(ws->bufferseries->phase, 0, n);
+  ws->viewsplineampreal = gsl_matrix_submatrix(ws->buffersplines->spline_amp_real, 0, 0, n, 5);
+  ws->viewsplineampimag = gsl_matrix_submatrix(ws->buffersplines->spline_amp_imag, 0, 0, n, 5);
+  ws->viewquadsplinephase = gsl_matrix_submatrix(ws->buffersplines->quadspline_phase, 0, 0, n, 4);
+  ws->integrand.freq = &(ws->viewfreq.vector);
+  ws->integrand.amp_real = &(ws->viewampreal.vector);
+  ws->integrand.amp_imag = &(ws->viewampimag.vector);
+  ws->integrand.phase = &(ws->viewphase.vector);
+  ws->integrandspline.spline_amp_real = &(ws->viewsplineampreal.matrix);
+  ws->integrandspline.spline_amp_imag = &(ws->viewsplineampimag.matrix);
+  ws->integrandspline.quadspline_phase = &(ws->viewquadsplinephase.matrix);
+}
+/* Copy the splines of the three channels of a mode of wf 2 in the slot k of the workspace, in SoA form - slots are created when needed */
+static CAmpPhaseSpline3ChanSoA* OverlapWorkspace_SetSplinesSoA(OverlapWorkspace *ws, const int k, CAmpPhaseSpline* splineschan1, CAmpPhaseSpline* splineschan2, CAmpPhaseSpline* splineschan3) {
+  if(ModesCAmpPhaseSpline3ChanSoA_Reserve(ws->splinessoa, k+1)) ws->nbregrow++;
+  CAmpPhaseSpline3ChanSoA* splines = ws->splinessoa->splines[k];
+  if(CAmpPhaseSpline3ChanSoA_Reserve(splines, (int) splineschan1->quadspline_phase->size1)) ws->nbregrow++;
+  CAmpPhaseSpline3ChanSoA_Set(splines, splineschan1, splineschan2, splineschan3);
+  return splines;
+}
+/* Build the splines of all the modes of a signal in SoA form directly in the workspace - no copy from the matrix form */
+ModesCAmpPhaseSpline3ChanSoA* OverlapWorkspace_BuildSplinesSoA(
+  OverlapWorkspace* ws,                               /* Workspace providing the storage - capacity at least the longest mode */
+  ListmodesCAmpPhaseFrequencySeries* listh1,          /* Input: list of modes in amplitude/phase form, channel 1 */
+  ListmodesCAmpPhaseFrequencySeries* listh2,          /* Input: list of modes in amplitude/phase form, channel 2 */
+  ListmodesCAmpPhaseFrequencySeries* listh3)          /* Input: list of modes in amplitude/phase form, channel 3 */
+{
+  ws->nbregrow += BuildModesCAmpPhaseSpline3ChanSoA(ws->splinessoa, listh1, listh2, listh3, ws->splinews);
+  return ws->splinessoa;
+}
+
 /* Function to evaluate a Noise function  */
 void EvaluateNoise(
   gsl_vector* noisevalues,                         /* Output: vector of the noise values */
@@ -73,9 +156,11 @@ void EvaluateNoise(
     exit(1);
   }
 
+  long long t0 = ProfileStart();
   for(int i=0; i<nbpts; i++) {
     gsl_vector_set(noisevalues, i, ObjectFunctionCall(Snoise,gsl_vector_get(freq, i)));
   }
+  ProfileStop(ProfileNoise, t0);
 }
 
 /* Function building a frequency vector with linear or logarithmic sampling */
@@ -432,7 +517,9 @@ double FDSinglemodeWIPOverlap(
 
   /* fLow or fHigh <= 0 means use intersection of signal domains  */
   /* NOTE: factor 4 was previously missing */
+  long long t0 = ProfileStart();
   double overlap = 4.*wip_phase(f1, n1, f2, n2, h1Ar, h1Ai, h1p, h2Ar, h2Ai, h2p, Snoise, 1.0, fLow, fHigh);
+  ProfileStop(ProfileWIP, t0);
   return overlap;
 }
 
@@ -605,6 +692,7 @@ void ComputeIntegrandValues(
   double fLow,                              /* Lower bound of the frequency - 0 to ignore */
   double fHigh)                             /* Upper bound of the frequency - 0 to ignore */
 {
+  long long t0 = ProfileStart();
   gsl_set_error_handler(&Err_Handler);
 
   /* Determining the boundaries of indices */
@@ -692,17 +780,18 @@ void ComputeIntegrandValues(
     gsl_vector_set(phase, j, phase1 - phase2);
     j++;
   }
+  ProfileStop(ProfileIntegrand, t0);
 }
 
 /* Function computing the integrand values, combining three non-correlated channels */
-int ComputeIntegrandValues3Chan(
-  CAmpPhaseFrequencySeries** integrand,     /* Output: values of the integrand on common frequencies (initialized in the function) */
+/* If ws is NULL, the output is allocated, otherwise it is taken from the workspace */
+static int ComputeIntegrandValues3ChanCore(
+  CAmpPhaseFrequencySeries** integrand,     /* Output: values of the integrand on common frequencies */
+  OverlapWorkspace* ws,                          /* Workspace providing the storage for the output - NULL to allocate */
   CAmpPhaseFrequencySeries* freqseries1chan1,    /* Input: frequency series for wf 1, channel 1 */
   CAmpPhaseFrequencySeries* freqseries1chan2,    /* Input: frequency series for wf 1, channel 2 */
   CAmpPhaseFrequencySeries* freqseries1chan3,    /* Input: frequency series for wf 1, channel 3 */
-  CAmpPhaseSpline* splines2chan1,                /* Input: splines in matrix form for wf 2, channel 1 */
-  CAmpPhaseSpline* splines2chan2,                /* Input: splines in matrix form for wf 2, channel 2 */
-  CAmpPhaseSpline* splines2chan3,                /* Input: splines in matrix form for wf 2, channel 3 */
+  CAmpPhaseSpline3ChanSoA* splines2,             /* Input: splines in SoA form for wf 2, channels 1,2,3 */
   ObjectFunction * Snoise1,                /* Noise function */
   ObjectFunction * Snoise2,                /* Noise function */
   ObjectFunction * Snoise3,                /* Noise function */
@@ -716,8 +805,9 @@ int ComputeIntegrandValues3Chan(
   int imin1 = 0;
   int imax1 = freq1->size - 1;
   double* f1 = freq1->data;
-  double f2min = gsl_matrix_get(splines2chan1->quadspline_phase, 0, 0);
-  double f2max = gsl_matrix_get(splines2chan1->quadspline_phase, splines2chan1->quadspline_phase->size1 - 1, 0);
+  const double* f2 = splines2->freq;
+  double f2min = f2[0];
+  double f2max = f2[splines2->n - 1];
   if((fLow>0 && (f1[imax1]<=fLow || f2max<=fLow)) || (fHigh>0 && (f1[imin1]>=fHigh || f2min>=fHigh))) {
     //printf("Error: range of frequencies incompatible with fLow, fHigh in IntegrandValues.\n");
     //printf("need both {%g, %g} > %g and both {%g, %g} < %g\n",f1[imax1],f2max,fLow,f1[imin1],f2min,fHigh);
@@ -751,14 +841,19 @@ int ComputeIntegrandValues3Chan(
   double phi1maxf = EstimateBoundaryLegendreQuad(freq1, freqseries1chan1->phase, imax1-2, maxf); /* Note the imax1-2 */
 
   /* Initializing output structure */
-  CAmpPhaseFrequencySeries_Init(integrand, nbpts);
+  if(ws) {
+    OverlapWorkspace_SetLength(ws, nbpts);
+    *integrand = &(ws->integrand);
+  }
+  else CAmpPhaseFrequencySeries_Init(integrand, nbpts);
 
   /* Loop computing integrand values - phases are the same for chan1, chan2 and chan3 */
   gsl_vector* freq = (*integrand)->freq;
   gsl_vector* ampreal = (*integrand)->amp_real;
   gsl_vector* ampimag = (*integrand)->amp_imag;
   gsl_vector* phase = (*integrand)->phase;
-  double f, eps, eps2, eps3, ampreal1chan1, ampimag1chan1, ampreal1chan2, ampimag1chan2, ampreal1chan3, ampimag1chan3, phase1, ampreal2chan1, ampimag2chan1, ampreal2chan2, ampimag2chan2, ampreal2chan3, ampimag2chan3, phase2, invSnchan1, invSnchan2, invSnchan3;
+  double f, eps, eps2, eps3, ampreal1chan1, ampimag1chan1, ampreal1chan2, ampimag1chan2, ampreal1chan3, ampimag1chan3, phase1, phase2, invSnchan1, invSnchan2, invSnchan3;
+  double amp2[6]; /* Interleaved real/imag amplitudes of wf 2 for channels 1,2,3 */
   double complex camp;
   double* areal1chan1 = freqseries1chan1->amp_real->data;
   double* aimag1chan1 = freqseries1chan1->amp_imag->data;
@@ -767,13 +862,9 @@ int ComputeIntegrandValues3Chan(
   double* areal1chan3 = freqseries1chan3->amp_real->data;
   double* aimag1chan3 = freqseries1chan3->amp_imag->data;
   double* phi1 = freqseries1chan1->phase->data;
-  gsl_matrix* splinechan1real2chan1 = splines2chan1->spline_amp_real;
-  gsl_matrix* splinechan1imag2chan1 = splines2chan1->spline_amp_imag;
-  gsl_matrix* splinechan1real2chan2 = splines2chan2->spline_amp_real;
-  gsl_matrix* splinechan1imag2chan2 = splines2chan2->spline_amp_imag;
-  gsl_matrix* splinechan1real2chan3 = splines2chan3->spline_amp_real;
-  gsl_matrix* splinechan1imag2chan3 = splines2chan3->spline_amp_imag;
-  gsl_matrix* quadsplinephase2 = splines2chan1->quadspline_phase;
+  const double* phase2c0 = splines2->phase[0];
+  const double* phase2c1 = splines2->phase[1];
+  const double* phase2c2 = splines2->phase[2];
   int i2 = 0; int j = 0;
   for(int i=imin1; i<=imax1; i++) {
     /* Distinguish the case where we are at minf or maxf */
@@ -807,35 +898,27 @@ int ComputeIntegrandValues3Chan(
       ampimag1chan3 = aimag1chan3[i];
       phase1 = phi1[i];
     }
-    /* Adjust the index in the spline if necessary and compute */
-    while(gsl_matrix_get(splines2chan1->quadspline_phase, i2+1, 0)<f) i2++;
-    eps = f - gsl_matrix_get(splines2chan1->quadspline_phase, i2, 0);
+    /* Adjust the index in the spline if necessary and compute - the coefficients of the 6 amplitudes are contiguous */
+    while(f2[i2+1]<f) i2++;
+    eps = f - f2[i2];
     eps2 = eps*eps;
     eps3 = eps2*eps;
-    gsl_vector_view coeffsampreal2chan1 = gsl_matrix_row(splinechan1real2chan1, i2);
-    gsl_vector_view coeffsampimag2chan1 = gsl_matrix_row(splinechan1imag2chan1, i2);
-    gsl_vector_view coeffsampreal2chan2 = gsl_matrix_row(splinechan1real2chan2, i2);
-    gsl_vector_view coeffsampimag2chan2 = gsl_matrix_row(splinechan1imag2chan2, i2);
-    gsl_vector_view coeffsampreal2chan3 = gsl_matrix_row(splinechan1real2chan3, i2);
-    gsl_vector_view coeffsampimag2chan3 = gsl_matrix_row(splinechan1imag2chan3, i2);
-    gsl_vector_view coeffsphase2 = gsl_matrix_row(quadsplinephase2, i2);
-    ampreal2chan1 = EvalCubic(&coeffsampreal2chan1.vector, eps, eps2, eps3);
-    ampimag2chan1 = EvalCubic(&coeffsampimag2chan1.vector, eps, eps2, eps3);
-    ampreal2chan2 = EvalCubic(&coeffsampreal2chan2.vector, eps, eps2, eps3);
-    ampimag2chan2 = EvalCubic(&coeffsampimag2chan2.vector, eps, eps2, eps3);
-    ampreal2chan3 = EvalCubic(&coeffsampreal2chan3.vector, eps, eps2, eps3);
-    ampimag2chan3 = EvalCubic(&coeffsampimag2chan3.vector, eps, eps2, eps3);
-    phase2 = EvalQuad(&coeffsphase2.vector, eps, eps2);
+    const double* amp2c0 = splines2->amp[0] + 6*i2;
+    const double* amp2c1 = splines2->amp[1] + 6*i2;
+    const double* amp2c2 = splines2->amp[2] + 6*i2;
+    const double* amp2c3 = splines2->amp[3] + 6*i2;
+    for(int c=0; c<6; c++) amp2[c] = amp2c0[c] + amp2c1[c]*eps + amp2c2[c]*eps2 + amp2c3[c]*eps3;
+    phase2 = phase2c0[i2] + phase2c1[i2]*eps + phase2c2[i2]*eps2;
     invSnchan1 = 1./ObjectFunctionCall(Snoise1,f);
     invSnchan2 = 1./ObjectFunctionCall(Snoise2,f);
     invSnchan3 = 1./ObjectFunctionCall(Snoise3,f);
 
-    camp = invSnchan1 * (ampreal1chan1 + I*ampimag1chan1) * (ampreal2chan1 - I*ampimag2chan1) + invSnchan2 * (ampreal1chan2 + I*ampimag1chan2) * (ampreal2chan2 - I*ampimag2chan2) + invSnchan3 * (ampreal1chan3 + I*ampimag1chan3) * (ampreal2chan3 - I*ampimag2chan3);
+    camp = invSnchan1 * (ampreal1chan1 + I*ampimag1chan1) * (amp2[0] - I*amp2[1]) + invSnchan2 * (ampreal1chan2 + I*ampimag1chan2) * (amp2[2] - I*amp2[3]) + invSnchan3 * (ampreal1chan3 + I*ampimag1chan3) * (amp2[4] - I*amp2[5]);
     //dump
     /*
     printf("j=%i, im=%g\n a11=(%g,%g),  a12=(%g,%g),  a13=(%g,%g)\n a11=(%g,%g),  a12=(%g,%g),  a13=(%g,%g)\n",j,cimag(camp),
 	   ampreal1chan1,ampimag1chan1,ampreal1chan2,ampimag1chan2,ampreal1chan3,ampimag1chan3,
-	   ampreal2chan1,ampimag2chan1,ampreal2chan2,ampimag2chan2,ampreal2chan3,ampimag2chan3);
+	   amp2[0],amp2[1],amp2[2],amp2[3],amp2[4],amp2[5]);
     printf("in1=%g, in2=%g, in3=%g\n",invSnchan1,invSnchan2,invSnchan3);
     */
     
@@ -848,6 +931,56 @@ int ComputeIntegrandValues3Chan(
   return 0;
 }
 
+int ComputeIntegrandValues3Chan(
+  CAmpPhaseFrequencySeries** integrand,     /* Output: values of the integrand on common frequencies (initialized in the function) */
+  CAmpPhaseFrequencySeries* freqseries1chan1,    /* Input: frequency series for wf 1, channel 1 */
+  CAmpPhaseFrequencySeries* freqseries1chan2,    /* Input: frequency series for wf 1, channel 2 */
+  CAmpPhaseFrequencySeries* freqseries1chan3,    /* Input: frequency series for wf 1, channel 3 */
+  CAmpPhaseSpline* splines2chan1,                /* Input: splines in matrix form for wf 2, channel 1 */
+  CAmpPhaseSpline* splines2chan2,                /* Input: splines in matrix form for wf 2, channel 2 */
+  CAmpPhaseSpline* splines2chan3,                /* Input: splines in matrix form for wf 2, channel 3 */
+  ObjectFunction * Snoise1,                /* Noise function */
+  ObjectFunction * Snoise2,                /* Noise function */
+  ObjectFunction * Snoise3,                /* Noise function */
+  double fLow,                              /* Lower bound of the frequency - 0 to ignore */
+  double fHigh)                             /* Upper bound of the frequency - 0 to ignore */
+{
+  CAmpPhaseSpline3ChanSoA* splines2 = NULL;
+  CAmpPhaseSpline3ChanSoA_Init(&splines2, (int) splines2chan1->quadspline_phase->size1);
+  CAmpPhaseSpline3ChanSoA_Set(splines2, splines2chan1, splines2chan2, splines2chan3);
+  long long t0 = ProfileStart();
+  int ret = ComputeIntegrandValues3ChanCore(integrand, NULL, freqseries1chan1, freqseries1chan2, freqseries1chan3, splines2, Snoise1, Snoise2, Snoise3, fLow, fHigh);
+  ProfileStop(ProfileIntegrand, t0);
+  CAmpPhaseSpline3ChanSoA_Cleanup(splines2);
+  return ret;
+}
+
+int ComputeIntegrandValues3ChanWS(
+  CAmpPhaseFrequencySeries** integrand,     /* Output: values of the integrand on common frequencies (points to storage in the workspace) */
+  OverlapWorkspace* ws,                          /* Workspace providing the storage */
+  CAmpPhaseFrequencySeries* freqseries1chan1,    /* Input: frequency series for wf 1, channel 1 */
+  CAmpPhaseFrequencySeries* freqseries1chan2,    /* Input: frequency series for wf 1, channel 2 */
+  CAmpPhaseFrequencySeries* freqseries1chan3,    /* Input: frequency series for wf 1, channel 3 */
+  CAmpPhaseSpline* splines2chan1,                /* Input: splines in matrix form for wf 2, channel 1 */
+  CAmpPhaseSpline* splines2chan2,                /* Input: splines in matrix form for wf 2, channel 2 */
+  CAmpPhaseSpline* splines2chan3,                /* Input: splines in matrix form for wf 2, channel 3 */
+  ObjectFunction * Snoise1,                /* Noise function */
+  ObjectFunction * Snoise2,                /* Noise function */
+  ObjectFunction * Snoise3,                /* Noise function */
+  double fLow,                              /* Lower bound of the frequency - 0 to ignore */
+  double fHigh)                             /* Upper bound of the frequency - 0 to ignore */
+{
+  if(!ws) {
+    printf("Error: ComputeIntegrandValues3ChanWS called with a NULL workspace.\n");
+    exit(1);
+  }
+  CAmpPhaseSpline3ChanSoA* splines2 = OverlapWorkspace_SetSplinesSoA(ws, 0, splines2chan1, splines2chan2, splines2chan3);
+  long long t0 = ProfileStart();
+  int ret = ComputeIntegrandValues3ChanCore(integrand, ws, freqseries1chan1, freqseries1chan2, freqseries1chan3, splines2, Snoise1, Snoise2, Snoise3, fLow, fHigh);
+  ProfileStop(ProfileIntegrand, t0);
+  return ret;
+}
+
 /* Function computing the overlap (h1|h2) between two given modes in amplitude/phase form, one being already interpolated, for a given noise function - uses the amplitude/phase representation (Fresnel) */
 double FDSinglemodeFresnelOverlap(
   struct tagCAmpPhaseFrequencySeries *freqseries1, /* First mode h1, in amplitude/phase form */
@@ -871,7 +1004,9 @@ double FDSinglemodeFresnelOverlap(
   BuildSplineCoeffs(&integrandspline, integrand);
 
   /* Computing the integral - including here the factor 4 and the real part */
+  long long t0int = ProfileStart();
   double overlap = 4.*creal(ComputeInt(integrandspline->spline_amp_real, integrandspline->spline_amp_imag, integrandspline->quadspline_phase));
+  ProfileStop(ProfileFresnel, t0int);
 
   /* Clean up */
   CAmpPhaseSpline_Cleanup(integrandspline);
@@ -894,40 +1029,71 @@ double FDSinglemodeFresnelOverlap3Chan(
   double fLow,                                      /* Lower bound of the frequency window for the detector */
   double fHigh)                                     /* Upper bound of the frequency window for the detector */
 {
-  /* Computing the integrand values, on the frequency grid of h1 */
+  /* Temporary workspace, sized for the frequency grid of h1 */
+  OverlapWorkspace* ws = NULL;
+  OverlapWorkspace_Init(&ws, (int) freqseries1chan1->freq->size);
+  double overlap = FDSinglemodeFresnelOverlap3ChanWS(freqseries1chan1, freqseries1chan2, freqseries1chan3, splines2chan1, splines2chan2, splines2chan3, Snoisechan1, Snoisechan2, Snoisechan3, fLow, fHigh, ws);
+  OverlapWorkspace_Cleanup(ws);
+  return overlap;
+}
+
+/* Overlap for one mode, wf 2 being given by its splines in SoA form - storage for the integrand taken from the workspace */
+static double FDSinglemodeFresnelOverlap3ChanSoAWS(
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan1, /* First mode h1 for channel 1, in amplitude/phase form */
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan2, /* First mode h1 for channel 2, in amplitude/phase form */
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan3, /* First mode h1 for channel 3, in amplitude/phase form */
+  CAmpPhaseSpline3ChanSoA* splines2,                    /* Second mode h2 for channels 1,2,3, already interpolated in SoA form */
+  ObjectFunction * Snoisechan1,                  /* Noise function */
+  ObjectFunction * Snoisechan2,                  /* Noise function */
+  ObjectFunction * Snoisechan3,                  /* Noise function */
+  double fLow,                                      /* Lower bound of the frequency window for the detector */
+  double fHigh,                                     /* Upper bound of the frequency window for the detector */
+  OverlapWorkspace* ws)                             /* Workspace for the integrand and its splines */
+{
+  /* Computing the integrand values, on the frequency grid of h1 - storage taken from the workspace */
   CAmpPhaseFrequencySeries* integrand = NULL;
-  if(0>ComputeIntegrandValues3Chan(&integrand, freqseries1chan1, freqseries1chan2, freqseries1chan3, splines2chan1, splines2chan2, splines2chan3, Snoisechan1, Snoisechan2, Snoisechan3, fLow, fHigh))return 0;//if allowed freq range does not exist, return 0 for overlap
+  long long t0 = ProfileStart();
+  int ret = ComputeIntegrandValues3ChanCore(&integrand, ws, freqseries1chan1, freqseries1chan2, freqseries1chan3, splines2, Snoisechan1, Snoisechan2, Snoisechan3, fLow, fHigh);
+  ProfileStop(ProfileIntegrand, t0);
+  if(0>ret)return 0;//if allowed freq range does not exist, return 0 for overlap
 
   /* Rescaling the integrand */
   double scaling = 10./gsl_vector_get(integrand->freq, integrand->freq->size-1);
-
-//TEST
-//scaling = 1.;
-
   gsl_vector_scale(integrand->freq, scaling);
   gsl_vector_scale(integrand->amp_real, 1./scaling);
   gsl_vector_scale(integrand->amp_imag, 1./scaling);
 
-  //dump
-  /*
-  for(int ii=0;ii<integrand->freq->size;ii++)
-    printf("ii=%i, f=%g, integrand = ( %g, %g, %g )\n",ii,gsl_vector_get(integrand->freq,ii),gsl_vector_get(integrand->amp_real,ii),gsl_vector_get(integrand->amp_imag,ii),gsl_vector_get(integrand->phase,ii));
-  */
-  
-  /* Interpolating the integrand */
-  CAmpPhaseSpline* integrandspline = NULL;
-  BuildSplineCoeffs(&integrandspline, integrand);
+  /* Interpolating the integrand, in the storage of the workspace */
+  CAmpPhaseSpline* integrandspline = &(ws->integrandspline);
+  BuildSplineCoeffsWS(integrandspline, integrand, ws->splinews);
 
   /* Computing the integral - including here the factor 4 and the real part */
+  long long t0int = ProfileStart();
   double overlap = 4.*creal(ComputeInt(integrandspline->spline_amp_real, integrandspline->spline_amp_imag, integrandspline->quadspline_phase));
-
-  /* Clean up */
-  CAmpPhaseSpline_Cleanup(integrandspline);
-  CAmpPhaseFrequencySeries_Cleanup(integrand);
+  ProfileStop(ProfileFresnel, t0int);
 
   return overlap;
 }
 
+/* Same, using a workspace for the integrand and its splines (no allocation in steady state) */
+double FDSinglemodeFresnelOverlap3ChanWS(
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan1, /* First mode h1 for channel 1, in amplitude/phase form */
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan2, /* First mode h1 for channel 2, in amplitude/phase form */
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan3, /* First mode h1 for channel 3, in amplitude/phase form */
+  struct tagCAmpPhaseSpline *splines2chan1,             /* Second mode h2 for channel 1, already interpolated in matrix form */
+  struct tagCAmpPhaseSpline *splines2chan2,             /* Second mode h2 for channel 2, already interpolated in matrix form */
+  struct tagCAmpPhaseSpline *splines2chan3,             /* Second mode h2 for channel 3, already interpolated in matrix form */
+  ObjectFunction * Snoisechan1,                  /* Noise function */
+  ObjectFunction * Snoisechan2,                  /* Noise function */
+  ObjectFunction * Snoisechan3,                  /* Noise function */
+  double fLow,                                      /* Lower bound of the frequency window for the detector */
+  double fHigh,                                     /* Upper bound of the frequency window for the detector */
+  OverlapWorkspace* ws)                             /* Workspace for the integrand and its splines */
+{
+  CAmpPhaseSpline3ChanSoA* splines2 = OverlapWorkspace_SetSplinesSoA(ws, 0, splines2chan1, splines2chan2, splines2chan3);
+  return FDSinglemodeFresnelOverlap3ChanSoAWS(freqseries1chan1, freqseries1chan2, freqseries1chan3, splines2, Snoisechan1, Snoisechan2, Snoisechan3, fLow, fHigh, ws);
+}
+
 
 /* Function computing the overlap (h1|h2) between two waveforms given as list of modes, one being already interpolated, for a given noise function - two additional parameters for the starting 22-mode frequencies (then properly scaled for the other modes) for a limited duration of the observations */
 double FDListmodesFresnelOverlap(
@@ -974,6 +1140,69 @@ double FDListmodesFresnelOverlap3Chan(
   double fHigh,                                         /* Upper bound of the frequency window for the detector */
   double fstartobs1,                                    /* Starting frequency for the 22 mode of wf 1 - as determined from a limited duration of the observation - set to 0 to ignore */
   double fstartobs2)                                    /* Starting frequency for the 22 mode of wf 2 - as determined from a limited duration of the observation - set to 0 to ignore */
+{
+  /* Temporary workspace, shared between all pairs of modes - sized for the longest mode of h1 */
+  int nmax = 0;
+  ListmodesCAmpPhaseFrequencySeries* listelement = listh1chan1;
+  while(listelement) {
+    nmax = max(nmax, (int) listelement->freqseries->freq->size);
+    listelement = listelement->next;
+  }
+  OverlapWorkspace* ws = NULL;
+  OverlapWorkspace_Init(&ws, nmax);
+  double overlap = FDListmodesFresnelOverlap3ChanWS(listh1chan1, listh1chan2, listh1chan3, listsplines2chan1, listsplines2chan2, listsplines2chan3, Snoise1, Snoise2, Snoise3, fLow, fHigh, fstartobs1, fstartobs2, ws);
+  OverlapWorkspace_Cleanup(ws);
+  return overlap;
+}
+
+/* Same, using a workspace for the integrand and its splines (no allocation in steady state) */
+double FDListmodesFresnelOverlap3ChanWS(
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan1, /* First waveform channel channel 1, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan2, /* First waveform channel channel 2, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan3, /* First waveform channel channel 3, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseSpline *listsplines2chan1,    /* Second waveform channel channel 1, list of modes already interpolated in matrix form */
+  struct tagListmodesCAmpPhaseSpline *listsplines2chan2,    /* Second waveform channel channel 2, list of modes already interpolated in matrix form */
+  struct tagListmodesCAmpPhaseSpline *listsplines2chan3,    /* Second waveform channel channel 3, list of modes already interpolated in matrix form */
+  ObjectFunction * Snoise1,                          /* Noise function for channel 1 */
+  ObjectFunction * Snoise2,                          /* Noise function for channel 1 */
+  ObjectFunction * Snoise3,                          /* Noise function for channel 1 */
+  double fLow,                                          /* Lower bound of the frequency window for the detector */
+  double fHigh,                                         /* Upper bound of the frequency window for the detector */
+  double fstartobs1,                                    /* Starting frequency for the 22 mode of wf 1 - as determined from a limited duration of the observation - set to 0 to ignore */
+  double fstartobs2,                                    /* Starting frequency for the 22 mode of wf 2 - as determined from a limited duration of the observation - set to 0 to ignore */
+  OverlapWorkspace* ws)                                 /* Workspace for the integrand and its splines */
+{
+  /* Copy the splines of all the modes of wf 2 in SoA form, once for all the modes of wf 1 */
+  int nbmode2 = 0;
+  ListmodesCAmpPhaseSpline* listelementsplines2chan1 = listsplines2chan1;
+  while(listelementsplines2chan1) {
+    ListmodesCAmpPhaseSpline* listelementsplines2chan2 = ListmodesCAmpPhaseSpline_GetMode(listsplines2chan2, listelementsplines2chan1->l, listelementsplines2chan1->m);
+    ListmodesCAmpPhaseSpline* listelementsplines2chan3 = ListmodesCAmpPhaseSpline_GetMode(listsplines2chan3, listelementsplines2chan1->l, listelementsplines2chan1->m);
+    OverlapWorkspace_SetSplinesSoA(ws, nbmode2, listelementsplines2chan1->splines, listelementsplines2chan2->splines, listelementsplines2chan3->splines);
+    ws->splinessoa->l[nbmode2] = listelementsplines2chan1->l;
+    ws->splinessoa->m[nbmode2] = listelementsplines2chan1->m;
+    nbmode2++;
+    listelementsplines2chan1 = listelementsplines2chan1->next;
+  }
+  ws->splinessoa->nbmode = nbmode2;
+
+  return FDListmodesFresnelOverlap3ChanSoAWS(listh1chan1, listh1chan2, listh1chan3, ws->splinessoa, Snoise1, Snoise2, Snoise3, fLow, fHigh, fstartobs1, fstartobs2, ws);
+}
+
+/* Same, wf 2 being given by the splines of its modes in SoA form */
+double FDListmodesFresnelOverlap3ChanSoAWS(
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan1, /* First waveform channel channel 1, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan2, /* First waveform channel channel 2, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan3, /* First waveform channel channel 3, list of modes in amplitude/phase form */
+  ModesCAmpPhaseSpline3ChanSoA* splines2,                   /* Second waveform, splines of the modes for channels 1,2,3 in SoA form */
+  ObjectFunction * Snoise1,                          /* Noise function for channel 1 */
+  ObjectFunction * Snoise2,                          /* Noise function for channel 1 */
+  ObjectFunction * Snoise3,                          /* Noise function for channel 1 */
+  double fLow,                                          /* Lower bound of the frequency window for the detector */
+  double fHigh,                                         /* Upper bound of the frequency window for the detector */
+  double fstartobs1,                                    /* Starting frequency for the 22 mode of wf 1 - as determined from a limited duration of the observation - set to 0 to ignore */
+  double fstartobs2,                                    /* Starting frequency for the 22 mode of wf 2 - as determined from a limited duration of the observation - set to 0 to ignore */
+  OverlapWorkspace* ws)                                 /* Workspace for the integrand and its splines */
 {
   double overlap = 0;
 
@@ -982,17 +1211,13 @@ double FDListmodesFresnelOverlap3Chan(
   while(listelementh1chan1) { /* We use the structure for channel 1 to loop through modes */
     ListmodesCAmpPhaseFrequencySeries* listelementh1chan2 = ListmodesCAmpPhaseFrequencySeries_GetMode(listh1chan2, listelementh1chan1->l, listelementh1chan1->m);
     ListmodesCAmpPhaseFrequencySeries* listelementh1chan3 = ListmodesCAmpPhaseFrequencySeries_GetMode(listh1chan3, listelementh1chan1->l, listelementh1chan1->m);
-    ListmodesCAmpPhaseSpline* listelementsplines2chan1 = listsplines2chan1;
-    while(listelementsplines2chan1) { /* We use the structure for channel 1 to loop through modes */
-      ListmodesCAmpPhaseSpline* listelementsplines2chan2 = ListmodesCAmpPhaseSpline_GetMode(listsplines2chan2, listelementsplines2chan1->l, listelementsplines2chan1->m);
-      ListmodesCAmpPhaseSpline* listelementsplines2chan3 = ListmodesCAmpPhaseSpline_GetMode(listsplines2chan3, listelementsplines2chan1->l, listelementsplines2chan1->m);
+    for(int k=0; k<splines2->nbmode; k++) {
       /* Scaling fstartobs1/2 with the appropriate factor of m (for the 21 mode we use m=2) - setting fmin in the overlap accordingly */
       int mmax1 = max(2, listelementh1chan1->m);
-      int mmax2 = max(2, listelementsplines2chan1->m);
+      int mmax2 = max(2, splines2->m[k]);
       double fcutLow = fmax(fLow, fmax(((double) mmax1)/2. * fstartobs1, ((double) mmax2)/2. * fstartobs2));
-      double overlapmode = FDSinglemodeFresnelOverlap3Chan(listelementh1chan1->freqseries, listelementh1chan2->freqseries, listelementh1chan3->freqseries, listelementsplines2chan1->splines, listelementsplines2chan2->splines, listelementsplines2chan3->splines, Snoise1, Snoise2, Snoise3, fcutLow, fHigh);
+      double overlapmode = FDSinglemodeFresnelOverlap3ChanSoAWS(listelementh1chan1->freqseries, listelementh1chan2->freqseries, listelementh1chan3->freqseries, splines2->splines[k], Snoise1, Snoise2, Snoise3, fcutLow, fHigh, ws);
       overlap += overlapmode;
-      listelementsplines2chan1 = listelementsplines2chan1->next;
     }
     listelementh1chan1 = listelementh1chan1->next;
   }
@@ -1000,3 +1225,128 @@ double FDListmodesFresnelOverlap3Chan(
   return overlap;
 }
 
+/* Function computing, on a set of frequency bins, the integrals of the overlap integrand 4 h1 conj(h2)/Sn of two modes weighted by (f-fb)^k, with fb the left edge of each bin */
+/* The edges of the bins are inserted in the knots of h1, so that each bin is a set of consecutive intervals for the Fresnel integration */
+/* Moments are first computed with the weights f^k on the whole range, and recentered on each bin */
+void FDSinglemodeBinnedOverlapMoments(
+  double complex* moments,                          /* Output: binned moments, size nbmoments*nbbins (already allocated) */
+  const int nbmoments,                              /* Number of moments - at most 3 */
+  const double* fbins,                              /* Edges of the bins, increasing, size nbbins+1 */
+  const int nbbins,                                 /* Number of bins */
+  struct tagCAmpPhaseSpline *splines1,              /* First mode h1, interpolated in matrix form */
+  struct tagCAmpPhaseSpline *splines2,              /* Second mode h2, interpolated in matrix form */
+  ObjectFunction * Snoise,                          /* Noise function */
+  double fLow,                                      /* Lower bound of the frequency window for the detector */
+  double fHigh)                                     /* Upper bound of the frequency window for the detector */
+{
+  if(nbmoments<1 || nbmoments>3) {
+    printf("Error: FDSinglemodeBinnedOverlapMoments supports between 1 and 3 moments.\n");
+    exit(1);
+  }
+  for(int i=0; i<nbmoments*nbbins; i++) moments[i] = 0.;
+
+  /* Common range of frequencies */
+  gsl_matrix* knots1 = splines1->quadspline_phase;
+  gsl_matrix* knots2 = splines2->quadspline_phase;
+  int n1 = (int) knots1->size1;
+  double minf = fmax(gsl_matrix_get(knots1, 0, 0), gsl_matrix_get(knots2, 0, 0));
+  double maxf = fmin(gsl_matrix_get(knots1, n1-1, 0), gsl_matrix_get(knots2, knots2->size1-1, 0));
+  if(fLow>0) minf = fmax(fLow, minf);
+  if(fHigh>0) maxf = fmin(fHigh, maxf);
+  minf = fmax(minf, fbins[0]);
+  maxf = fmin(maxf, fbins[nbbins]);
+  if(minf>=maxf) return;
+
+  /* Merged grid: knots of h1 and edges of the bins strictly inside the range, and the range boundaries - knots too close to an edge are dropped */
+  double* grid = malloc((n1 + nbbins + 3)*sizeof(double));
+  int nbgrid = 0;
+  grid[nbgrid++] = minf;
+  int i1 = 0, ib = 0;
+  while(i1<n1 && gsl_matrix_get(knots1, i1, 0)<=minf) i1++;
+  while(ib<=nbbins && fbins[ib]<=minf) ib++;
+  while(1) {
+    double fknot = (i1<n1) ? gsl_matrix_get(knots1, i1, 0) : maxf;
+    double fedge = (ib<=nbbins) ? fbins[ib] : maxf;
+    double fnext = fmin(fknot, fedge);
+    if(fnext>=maxf) break;
+    if(fedge<=fknot) {
+      grid[nbgrid++] = fedge;
+      ib++;
+      while(i1<n1 && gsl_matrix_get(knots1, i1, 0)<=fedge*(1.+1e-10)) i1++;
+    }
+    else {
+      if(fknot>grid[nbgrid-1]*(1.+1e-10) && fknot<fedge*(1.-1e-10)) grid[nbgrid++] = fknot;
+      i1++;
+    }
+  }
+  grid[nbgrid++] = maxf;
+  if(nbgrid<4) {
+    free(grid);
+    return;
+  }
+
+  /* Values of h1 on the merged grid, and integrand values */
+  CAmpPhaseFrequencySeries* series1 = NULL;
+  CAmpPhaseFrequencySeries_Init(&series1, nbgrid);
+  for(int i=0; i<nbgrid; i++) gsl_vector_set(series1->freq, i, grid[i]);
+  EvalCAmpPhaseSpline(splines1, series1);
+  CAmpPhaseFrequencySeries* integrand = NULL;
+  ComputeIntegrandValues(&integrand, series1, splines2, Snoise, minf, maxf);
+  int n = (int) integrand->freq->size;
+
+  /* Rescaling of the frequencies for the interpolation, as in FDSinglemodeFresnelOverlap */
+  double scaling = 10./gsl_vector_get(integrand->freq, n-1);
+  double complex rawmoments[3];
+  CAmpPhaseFrequencySeries* weighted = NULL;
+  CAmpPhaseSpline* weightedspline = NULL;
+  CAmpPhaseFrequencySeries_Init(&weighted, n);
+  double complex* binmoments = malloc(nbmoments*nbbins*sizeof(double complex));
+  for(int k=0; k<nbmoments; k++) {
+    for(int i=0; i<n; i++) {
+      double f = gsl_vector_get(integrand->freq, i);
+      double w = 4. * ((k==0) ? 1. : ((k==1) ? f : f*f)) / scaling;
+      gsl_vector_set(weighted->freq, i, f*scaling);
+      gsl_vector_set(weighted->amp_real, i, w*gsl_vector_get(integrand->amp_real, i));
+      gsl_vector_set(weighted->amp_imag, i, w*gsl_vector_get(integrand->amp_imag, i));
+      gsl_vector_set(weighted->phase, i, gsl_vector_get(integrand->phase, i));
+    }
+    BuildSplineCoeffs(&weightedspline, weighted);
+    /* Integration bin by bin, on the rows of the splines between the edges */
+    int ia = 0;
+    for(int b=0; b<nbbins; b++) {
+      binmoments[k*nbbins + b] = 0.;
+      double flo = fmax(fbins[b], minf);
+      double fhi = fmin(fbins[b+1], maxf);
+      if(flo>=fhi) continue;
+      while(ia<n-1 && gsl_vector_get(integrand->freq, ia)<flo) ia++;
+      int ie = ia;
+      while(ie<n-1 && gsl_vector_get(integrand->freq, ie)<fhi) ie++;
+      if(ie==ia) continue;
+      gsl_matrix_view viewAreal = gsl_matrix_submatrix(weightedspline->spline_amp_real, ia, 0, ie-ia+1, 5);
+      gsl_matrix_view viewAimag = gsl_matrix_submatrix(weightedspline->spline_amp_imag, ia, 0, ie-ia+1, 5);
+      gsl_matrix_view viewphase = gsl_matrix_submatrix(weightedspline->quadspline_phase, ia, 0, ie-ia+1, 4);
+      long long t0 = ProfileStart();
+      binmoments[k*nbbins + b] = ComputeInt(&viewAreal.matrix, &viewAimag.matrix, &viewphase.matrix);
+      ProfileStop(ProfileFresnel, t0);
+    }
+    CAmpPhaseSpline_Cleanup(weightedspline);
+    weightedspline = NULL;
+  }
+
+  /* Recentering the moments on the left edge of each bin */
+  for(int b=0; b<nbbins; b++) {
+    double fb = fbins[b];
+    for(int k=0; k<nbmoments; k++) rawmoments[k] = binmoments[k*nbbins + b];
+    moments[b] = rawmoments[0];
+    if(nbmoments>1) moments[nbbins + b] = rawmoments[1] - fb*rawmoments[0];
+    if(nbmoments>2) moments[2*nbbins + b] = rawmoments[2] - 2.*fb*rawmoments[1] + fb*fb*rawmoments[0];
+  }
+
+  /* Clean up */
+  free(grid);
+  free(binmoments);
+  CAmpPhaseFrequencySeries_Cleanup(series1);
+  CAmpPhaseFrequencySeries_Cleanup(integrand);
+  CAmpPhaseFrequencySeries_Cleanup(weighted);
+}
+
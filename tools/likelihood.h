@@ -36,6 +36,7 @@
 
 #include "constants.h"
 #include "struct.h"
+#include "splinecoeffs.h"
 #include "waveform.h"
 #include "wip.h"
 
@@ -46,8 +47,46 @@ extern "C" {
 } /* so that editors will match preceding brace */
 #endif
 
+/***************************************************/
+/*************** Type definitions ******************/
+
+/* Reusable storage for the Fresnel overlaps: integrand values, integrand splines, splines of wf 2 and spline scratch space */
+/* Buffers grow when needed and are never shrunk, so that after the first few calls the overlaps do not allocate */
+/* Only the overlap stage is covered: the generation of the waveforms and the response allocate their own outputs */
+/* Not thread-safe: use one workspace per thread */
+typedef struct tagOverlapWorkspace
+{
+  int                       nmax;             /* Capacity, in number of frequency points */
+  size_t                    nbregrow;         /* Number of times the buffers have been grown - constant in steady state, does not count other allocations */
+  CAmpPhaseFrequencySeries* bufferseries;     /* Storage for the integrand values, size nmax */
+  CAmpPhaseSpline*          buffersplines;    /* Storage for the integrand splines, size nmax */
+  SplineWorkspace*          splinews;         /* Scratch space for building the splines */
+  gsl_vector_view           viewfreq;         /* Views of the current length on the buffers */
+  gsl_vector_view           viewampreal;
+  gsl_vector_view           viewampimag;
+  gsl_vector_view           viewphase;
+  gsl_matrix_view           viewsplineampreal;
+  gsl_matrix_view           viewsplineampimag;
+  gsl_matrix_view           viewquadsplinephase;
+  CAmpPhaseFrequencySeries  integrand;        /* Integrand values, pointing to the views */
+  CAmpPhaseSpline           integrandspline;  /* Integrand splines, pointing to the views */
+  ModesCAmpPhaseSpline3ChanSoA* splinessoa;   /* Splines of the modes of wf 2 in SoA form, one slot per mode */
+} OverlapWorkspace;
+
 /****** Prototypes: utilities *******/
 
+void OverlapWorkspace_Init(OverlapWorkspace **ws, const int nmax);
+void OverlapWorkspace_Cleanup(OverlapWorkspace *ws);
+/* Ensure the capacity of the workspace is at least n points */
+void OverlapWorkspace_Reserve(OverlapWorkspace *ws, const int n);
+/* Build the splines of all the modes of a signal in three channels directly in SoA form, in the storage of the workspace */
+/* The output is valid until the next call, or the next overlap of the workspace with wf 2 given in matrix form */
+ModesCAmpPhaseSpline3ChanSoA* OverlapWorkspace_BuildSplinesSoA(
+  OverlapWorkspace* ws,                               /* Workspace providing the storage - capacity at least the longest mode */
+  ListmodesCAmpPhaseFrequencySeries* listh1,          /* Input: list of modes in amplitude/phase form, channel 1 */
+  ListmodesCAmpPhaseFrequencySeries* listh2,          /* Input: list of modes in amplitude/phase form, channel 2 */
+  ListmodesCAmpPhaseFrequencySeries* listh3);         /* Input: list of modes in amplitude/phase form, channel 3 */
+
 /* Function to evaluate a Noise function  */
 void EvaluateNoise(
   gsl_vector* noisevalues,                         /* Output: vector of the noise values */
@@ -193,6 +232,21 @@ int ComputeIntegrandValues3Chan(
   ObjectFunction * Snoise3,                         /* Noise function */
   double fLow,                              /* Lower bound of the frequency - 0 to ignore */
   double fHigh);                            /* Upper bound of the frequency - 0 to ignore */
+/* Same, with the output integrand taken from a workspace (no allocation) - *integrand points to ws->integrand on output */
+int ComputeIntegrandValues3ChanWS(
+  CAmpPhaseFrequencySeries** integrand,     /* Output: values of the integrand on common frequencies (points to storage in the workspace) */
+  OverlapWorkspace* ws,                          /* Workspace providing the storage */
+  CAmpPhaseFrequencySeries* freqseries1chan1,    /* Input: frequency series for wf 1, channel 1 */
+  CAmpPhaseFrequencySeries* freqseries1chan2,    /* Input: frequency series for wf 1, channel 2 */
+  CAmpPhaseFrequencySeries* freqseries1chan3,    /* Input: frequency series for wf 1, channel 3 */
+  CAmpPhaseSpline* splines2chan1,                /* Input: splines in matrix form for wf 2, channel 1 */
+  CAmpPhaseSpline* splines2chan2,                /* Input: splines in matrix form for wf 2, channel 2 */
+  CAmpPhaseSpline* splines2chan3,                /* Input: splines in matrix form for wf 2, channel 3 */
+  ObjectFunction * Snoise1,                         /* Noise function */
+  ObjectFunction * Snoise2,                         /* Noise function */
+  ObjectFunction * Snoise3,                         /* Noise function */
+  double fLow,                              /* Lower bound of the frequency - 0 to ignore */
+  double fHigh);                            /* Upper bound of the frequency - 0 to ignore */
 
 /* Function computing the overlap (h1|h2) between two given modes in amplitude/phase form, one being already interpolated, for a given noise function - uses the amplitude/phase representation (Fresnel) */
 double FDSinglemodeFresnelOverlap(
@@ -214,6 +268,20 @@ double FDSinglemodeFresnelOverlap3Chan(
   ObjectFunction * Snoise3,                         /* Noise function */
   double fLow,                                      /* Lower bound of the frequency window for the detector */
   double fHigh);                                    /* Upper bound of the frequency window for the detector */
+/* Same, using a workspace for the integrand and its splines (no allocation in steady state) */
+double FDSinglemodeFresnelOverlap3ChanWS(
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan1, /* First mode h1 for channel 1, in amplitude/phase form */
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan2, /* First mode h1 for channel 2, in amplitude/phase form */
+  struct tagCAmpPhaseFrequencySeries *freqseries1chan3, /* First mode h1 for channel 3, in amplitude/phase form */
+  struct tagCAmpPhaseSpline *splines2chan1,             /* Second mode h2 for channel 1, already interpolated in matrix form */
+  struct tagCAmpPhaseSpline *splines2chan2,             /* Second mode h2 for channel 2, already interpolated in matrix form */
+  struct tagCAmpPhaseSpline *splines2chan3,             /* Second mode h2 for channel 3, already interpolated in matrix form */
+  ObjectFunction * Snoise1,                         /* Noise function */
+  ObjectFunction * Snoise2,                         /* Noise function */
+  ObjectFunction * Snoise3,                         /* Noise function */
+  double fLow,                                      /* Lower bound of the frequency window for the detector */
+  double fHigh,                                     /* Upper bound of the frequency window for the detector */
+  OverlapWorkspace* ws);                            /* Workspace for the integrand and its splines */
 
 /* Function computing the overlap (h1|h2) between two waveforms given as list of modes, one being already interpolated, for a given noise function - two additional parameters for the starting 22-mode frequencies (then properly scaled for the other modes) for a limited duration of the observations */
 double FDListmodesFresnelOverlap(
@@ -239,6 +307,49 @@ double FDListmodesFresnelOverlap3Chan(
   double fHigh,                                         /* Upper bound of the frequency window for the detector */
   double fstartobs1,                                    /* Starting frequency for the 22 mode of wf 1 - as determined from a limited duration of the observation - set to 0 to ignore */
   double fstartobs2);                                    /* Starting frequency for the 22 mode of wf 2 - as determined from a limited duration of the observation - set to 0 to ignore */
+/* Same, using a workspace for the integrand and its splines (no allocation in steady state) */
+double FDListmodesFresnelOverlap3ChanWS(
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan1, /* First waveform channel channel 1, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan2, /* First waveform channel channel 2, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan3, /* First waveform channel channel 3, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseSpline *listsplines2chan1,    /* Second waveform channel channel 1, list of modes already interpolated in matrix form */
+  struct tagListmodesCAmpPhaseSpline *listsplines2chan2,    /* Second waveform channel channel 2, list of modes already interpolated in matrix form */
+  struct tagListmodesCAmpPhaseSpline *listsplines2chan3,    /* Second waveform channel channel 3, list of modes already interpolated in matrix form */
+  ObjectFunction * Snoise1,                         /* Noise function */
+  ObjectFunction * Snoise2,                         /* Noise function */
+  ObjectFunction * Snoise3,                         /* Noise function */
+  double fLow,                                          /* Lower bound of the frequency window for the detector */
+  double fHigh,                                         /* Upper bound of the frequency window for the detector */
+  double fstartobs1,                                    /* Starting frequency for the 22 mode of wf 1 - as determined from a limited duration of the observation - set to 0 to ignore */
+  double fstartobs2,                                    /* Starting frequency for the 22 mode of wf 2 - as determined from a limited duration of the observation - set to 0 to ignore */
+  OverlapWorkspace* ws);                                /* Workspace for the integrand and its splines */
+/* Same, wf 2 being given by the splines of its modes in SoA form, as built by OverlapWorkspace_BuildSplinesSoA or BuildModesCAmpPhaseSpline3ChanSoA - no copy of the splines */
+double FDListmodesFresnelOverlap3ChanSoAWS(
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan1, /* First waveform channel channel 1, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan2, /* First waveform channel channel 2, list of modes in amplitude/phase form */
+  struct tagListmodesCAmpPhaseFrequencySeries *listh1chan3, /* First waveform channel channel 3, list of modes in amplitude/phase form */
+  ModesCAmpPhaseSpline3ChanSoA* splines2,                   /* Second waveform, splines of the modes for channels 1,2,3 in SoA form */
+  ObjectFunction * Snoise1,                         /* Noise function */
+  ObjectFunction * Snoise2,                         /* Noise function */
+  ObjectFunction * Snoise3,                         /* Noise function */
+  double fLow,                                          /* Lower bound of the frequency window for the detector */
+  double fHigh,                                         /* Upper bound of the frequency window for the detector */
+  double fstartobs1,                                    /* Starting frequency for the 22 mode of wf 1 - as determined from a limited duration of the observation - set to 0 to ignore */
+  double fstartobs2,                                    /* Starting frequency for the 22 mode of wf 2 - as determined from a limited duration of the observation - set to 0 to ignore */
+  OverlapWorkspace* ws);                                /* Workspace for the integrand and its splines */
+
+/* Function computing, on a set of frequency bins, the integrals of the overlap integrand 4 h1 conj(h2)/Sn of two modes weighted by (f-fb)^k, with fb the left edge of each bin */
+/* Output moments[k*nbbins + b] for k=0..nbmoments-1 - complex, the real part of the sum of the k=0 moments being the overlap (h1|h2) - bins outside the common range are set to 0 */
+void FDSinglemodeBinnedOverlapMoments(
+  double complex* moments,                          /* Output: binned moments, size nbmoments*nbbins (already allocated) */
+  const int nbmoments,                              /* Number of moments - at most 3 */
+  const double* fbins,                              /* Edges of the bins, increasing, size nbbins+1 */
+  const int nbbins,                                 /* Number of bins */
+  struct tagCAmpPhaseSpline *splines1,              /* First mode h1, interpolated in matrix form */
+  struct tagCAmpPhaseSpline *splines2,              /* Second mode h2, interpolated in matrix form */
+  ObjectFunction * Snoise,                          /* Noise function */
+  double fLow,                                      /* Lower bound of the frequency window for the detector */
+  double fHigh);                                    /* Upper bound of the frequency window for the detector */
 
 #if 0
 { /* so that editors will match succeeding brace */
@@ -0,0 +1,195 @@
+/**
+ * \brief C code for the likelihoods marginalized over distance and orbital phase, and for the draw of these parameters in post-processing.
+ *
+ * All sums are done on logarithms, the likelihoods of loud signals overflowing the exponential.
+ *
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <string.h>
+
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_sf_bessel.h>
+
+#include "constants.h"
+#include "marginalization.h"
+
+/* Number of points of the grid used to draw the distance */
+#define MARGINALIZATION_NBDRAW 1024
+
+void DistanceMarginalization_Init(DistanceMarginalization** dm, const double dist_min, const double dist_max, const double dist_ref, const int flatprior, const int nbnodes)
+{
+  if(!dm) exit(1);
+  *dm = (DistanceMarginalization*) malloc(sizeof(DistanceMarginalization));
+  (*dm)->dist_min = dist_min;
+  (*dm)->dist_max = dist_max;
+  (*dm)->dist_ref = dist_ref;
+  (*dm)->flatprior = flatprior;
+  (*dm)->nbnodes = nbnodes;
+  (*dm)->nodes = (double*) malloc(nbnodes*sizeof(double));
+  (*dm)->weights = (double*) malloc(nbnodes*sizeof(double));
+  if(!(*dm)->nodes || !(*dm)->weights) {
+    printf("Error: allocation failed in DistanceMarginalization_Init\n");
+    exit(1);
+  }
+
+  /* Gauss-Legendre nodes as roots of P_n, by Newton iterations from the Chebyshev estimates */
+  int n = nbnodes;
+  for(int i=0; i<(n+1)/2; i++) {
+    double x = cos(PI*(i + 0.75)/(n + 0.5));
+    double dp = 1.;
+    for(int iter=0; iter<100; iter++) {
+      double p0 = 1., p1 = x;
+      for(int k=2; k<=n; k++) {
+        double p2 = ((2*k - 1)*x*p1 - (k - 1)*p0)/k;
+        p0 = p1;
+        p1 = p2;
+      }
+      dp = n*(x*p1 - p0)/(x*x - 1.);
+      double dx = p1/dp;
+      x -= dx;
+      if(fabs(dx)<1e-15) break;
+    }
+    (*dm)->nodes[i] = -x;
+    (*dm)->nodes[n-1-i] = x;
+    (*dm)->weights[i] = (*dm)->weights[n-1-i] = 2./((1. - x*x)*dp*dp);
+  }
+}
+
+void DistanceMarginalization_Cleanup(DistanceMarginalization* dm)
+{
+  if(!dm) return;
+  free(dm->nodes);
+  free(dm->weights);
+  free(dm);
+}
+
+/* Log of the integrand in s = log(u), u = dist_ref/distance: prior density times distance (Jacobian), times the likelihood */
+static double MarginalizedLogIntegrand(const DistanceMarginalization* dm, const double s, const double x, const double hh, const int marginalizephase)
+{
+  double u = exp(s);
+  double distance = dm->dist_ref/u;
+  double logprior;
+  if(dm->flatprior) logprior = -log(dm->dist_max - dm->dist_min);
+  else logprior = log(3.) + 2*log(distance) - log(pow(dm->dist_max, 3) - pow(dm->dist_min, 3));
+  double logL = u*x - u*u*hh/2.;
+  if(marginalizephase) logL += log(gsl_sf_bessel_I0_scaled(u*x));
+  return logprior + log(distance) + logL;
+}
+
+/* Window [a, b] in u where the integrand is not negligible */
+static void MarginalizedWindow(const DistanceMarginalization* dm, const double x, const double hh, double* a, double* b)
+{
+  double umin = dm->dist_ref/dm->dist_max;
+  double umax = dm->dist_ref/dm->dist_min;
+  *a = umin;
+  *b = umax;
+  if(!(hh>0.)) return;
+  double mu = x/hh;
+  double sigma = 1./sqrt(hh);
+  *a = fmax(umin, mu - 8*sigma);
+  *b = fmin(umax, mu + 8*sigma);
+  /* Peak out of the prior by more than 8 sigma: the integrand decays exponentially away from the nearest boundary */
+  if(*a>=*b) {
+    if(mu>umax) {
+      *b = umax;
+      *a = fmax(umin, umax - 40./(hh*(mu - umax)));
+    }
+    else {
+      *a = umin;
+      *b = fmin(umax, umin + 40./(hh*(umin - mu)));
+    }
+  }
+}
+
+double MarginalizedLogLikelihood(const DistanceMarginalization* dm, const double complex dh, const double hh, const int marginalizephase)
+{
+  double x = marginalizephase ? cabs(dh) : creal(dh);
+
+  /* Distance kept: only the phase may be marginalized */
+  if(!dm) {
+    if(marginalizephase) return x + log(gsl_sf_bessel_I0_scaled(x)) - hh/2.;
+    return x - hh/2.;
+  }
+
+  double a, b;
+  MarginalizedWindow(dm, x, hh, &a, &b);
+  double sa = log(a);
+  double sb = log(b);
+  double halfwidth = (sb - sa)/2.;
+  double center = (sb + sa)/2.;
+  double logmax = -INFINITY;
+  double values[dm->nbnodes];
+  for(int i=0; i<dm->nbnodes; i++) {
+    values[i] = MarginalizedLogIntegrand(dm, center + halfwidth*dm->nodes[i], x, hh, marginalizephase);
+    if(values[i]>logmax) logmax = values[i];
+  }
+  double sum = 0.;
+  for(int i=0; i<dm->nbnodes; i++) sum += dm->weights[i] * exp(values[i] - logmax);
+  return logmax + log(halfwidth*sum);
+}
+
+/* Draw from the von Mises distribution of mean 0 and concentration kappa (Best & Fisher 1979) */
+static double MarginalizedDrawVonMises(const double kappa, gsl_rng* r)
+{
+  if(kappa<1e-8) return PI*(2*gsl_rng_uniform(r) - 1.);
+  /* Gaussian limit, where the rejection would lose its accuracy */
+  if(kappa>1e5) {
+    double u1 = gsl_rng_uniform_pos(r);
+    double u2 = gsl_rng_uniform(r);
+    return sqrt(-2*log(u1))*cos(2*PI*u2)/sqrt(kappa);
+  }
+  double tau = 1. + sqrt(1. + 4*kappa*kappa);
+  double rho = (tau - sqrt(2*tau))/(2*kappa);
+  double rr = (1. + rho*rho)/(2*rho);
+  while(1) {
+    double z = cos(PI*gsl_rng_uniform(r));
+    double f = (1. + rr*z)/(rr + z);
+    double c = kappa*(rr - f);
+    double u2 = gsl_rng_uniform(r);
+    if(c*(2. - c) - u2>0. || log(c/u2) + 1. - c>=0.) {
+      double theta = acos(f);
+      return (gsl_rng_uniform(r)<0.5) ? -theta : theta;
+    }
+  }
+}
+
+void MarginalizedDraw(const DistanceMarginalization* dm, const double complex dh, const double hh, const int marginalizephase, gsl_rng* r, double* distance, double* phase)
+{
+  double x = marginalizephase ? cabs(dh) : creal(dh);
+  double u = 1.;
+
+  /* Distance: inverse of the cumulative distribution on a grid in s = log(u) */
+  if(dm) {
+    double a, b;
+    MarginalizedWindow(dm, x, hh, &a, &b);
+    double sa = log(a);
+    double ds = (log(b) - sa)/(MARGINALIZATION_NBDRAW - 1);
+    double values[MARGINALIZATION_NBDRAW];
+    double cdf[MARGINALIZATION_NBDRAW];
+    double logmax = -INFINITY;
+    for(int i=0; i<MARGINALIZATION_NBDRAW; i++) {
+      values[i] = MarginalizedLogIntegrand(dm, sa + i*ds, x, hh, marginalizephase);
+      if(values[i]>logmax) logmax = values[i];
+    }
+    cdf[0] = 0.;
+    for(int i=1; i<MARGINALIZATION_NBDRAW; i++) cdf[i] = cdf[i-1] + (exp(values[i-1] - logmax) + exp(values[i] - logmax))/2.;
+    double target = gsl_rng_uniform(r) * cdf[MARGINALIZATION_NBDRAW-1];
+    int i = 1;
+    while(i<MARGINALIZATION_NBDRAW-1 && cdf[i]<target) i++;
+    double frac = (cdf[i]>cdf[i-1]) ? (target - cdf[i-1])/(cdf[i] - cdf[i-1]) : 0.;
+    u = exp(sa + (i - 1 + frac)*ds);
+    *distance = dm->dist_ref/u;
+  }
+
+  /* Phase: exp(u Re(z exp(-2i phi))) is a von Mises distribution in 2 phi, the 22 mode leaving phi and phi+pi degenerate */
+  if(marginalizephase) {
+    double theta = carg(dh) + MarginalizedDrawVonMises(u*x, r);
+    double phi = theta/2. + ((gsl_rng_uniform(r)<0.5) ? 0. : PI);
+    *phase = fmod(fmod(phi, 2*PI) + 2*PI, 2*PI);
+  }
+}
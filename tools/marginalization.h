@@ -0,0 +1,85 @@
+/**
+ * \brief C header for the likelihoods marginalized over distance and orbital phase, and for the draw of these parameters in post-processing.
+ *
+ * The amplitude of a template scales as 1/distance: with u = dist_ref/distance and the overlaps (d|h), (h|h) computed at
+ * dist_ref, the likelihood exp(u (d|h) - u^2 (h|h)/2) is a Gaussian in u. The average over the distance prior (flat or
+ * r^2-weighted) is computed by Gauss-Legendre quadrature in log u, on a window of +-8 sigma around the peak (or at the
+ * boundary of the prior when the peak is out of it), which stays accurate at the high SNRs of LISA.
+ *
+ * For a template made of the 22 mode only, the phase phiRef enters as exp(2 i phiRef), and with z = (d|h) + i (d|i h)
+ * the average over a flat phase prior on [0, 2pi] gives the Bessel function I0(u|z|). For templates with higher modes
+ * this treats all modes as m=2, an approximation valid for 22-dominated signals.
+ *
+ */
+
+#ifndef _MARGINALIZATION_H
+#define _MARGINALIZATION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <string.h>
+
+#include <gsl/gsl_rng.h>
+
+#include "constants.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#elif 0
+} /* so that editors will match preceding brace */
+#endif
+
+/**************************************************/
+/**************** Type definitions ****************/
+
+/* Prior on the distance and precomputed quadrature, shared read-only by all threads */
+typedef struct tagDistanceMarginalization {
+  double dist_min;             /* Minimal distance of the prior (Mpc) */
+  double dist_max;             /* Maximal distance of the prior (Mpc) */
+  double dist_ref;             /* Distance at which the overlaps are computed (Mpc) */
+  int flatprior;               /* 1 for a flat prior in distance, 0 for a r^2-weighted prior */
+  int nbnodes;                 /* Number of nodes of the quadrature */
+  double* nodes;               /* Gauss-Legendre nodes on [-1,1] */
+  double* weights;             /* Gauss-Legendre weights on [-1,1] */
+} DistanceMarginalization;
+
+/*************************/
+/****** Prototypes ******/
+
+void DistanceMarginalization_Init(
+  DistanceMarginalization** dm,        /* Output: structure for the distance marginalization */
+  const double dist_min,               /* Minimal distance of the prior (Mpc) */
+  const double dist_max,               /* Maximal distance of the prior (Mpc) */
+  const double dist_ref,               /* Distance at which the overlaps are computed (Mpc) */
+  const int flatprior,                 /* 1 for a flat prior in distance, 0 for a r^2-weighted prior */
+  const int nbnodes);                  /* Number of nodes of the quadrature */
+void DistanceMarginalization_Cleanup(DistanceMarginalization* dm);
+
+/* Marginalized log-likelihood, without the term -(d|d)/2 - dh = (d|h) + i (d|i h) at dist_ref and phase 0, the imaginary part being used only if marginalizephase */
+/* If dm is NULL the distance is not marginalized, and the overlaps are those at the distance of the template */
+double MarginalizedLogLikelihood(
+  const DistanceMarginalization* dm,   /* Distance marginalization, NULL to keep the distance */
+  const double complex dh,             /* Overlap (d|h), with (d|i h) as imaginary part if marginalizephase */
+  const double hh,                     /* Overlap (h|h) */
+  const int marginalizephase);         /* Flag to marginalize over the phase */
+
+/* Draw the distance and phase from their posterior conditional on the other parameters, as given by the same overlaps */
+/* The distance is left unchanged if dm is NULL, and the phase if not marginalizephase */
+void MarginalizedDraw(
+  const DistanceMarginalization* dm,   /* Distance marginalization, NULL to keep the distance */
+  const double complex dh,             /* Overlap (d|h), with (d|i h) as imaginary part if marginalizephase */
+  const double hh,                     /* Overlap (h|h) */
+  const int marginalizephase,          /* Flag to marginalize over the phase */
+  gsl_rng* r,                          /* Random number generator */
+  double* distance,                    /* Output: distance drawn (Mpc) */
+  double* phase);                      /* Output: phase drawn, in [0, 2pi] */
+
+#if 0
+{ /* so that editors will match succeeding brace */
+#elif defined(__cplusplus)
+}
+#endif
+
+#endif /* _MARGINALIZATION_H */
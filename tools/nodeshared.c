@@ -0,0 +1,145 @@
+/**
+ * \brief C code for data shared read-only between the MPI processes of a node.
+ *
+ * The processes of a node are grouped with MPI_Comm_split_type, and the memory is allocated with MPI_Win_allocate_shared,
+ * entirely on the node leader (rank 0 of the node), the other processes attaching to it with MPI_Win_shared_query.
+ *
+ */
+
+
+#define _XOPEN_SOURCE 500
+
+#ifdef __GNUC__
+#define UNUSED __attribute__ ((unused))
+#else
+#define UNUSED
+#endif
+
+#ifdef PARALLEL
+#include "mpi.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "constants.h"
+#include "nodeshared.h"
+
+/* Maximal number of shared windows kept alive */
+#define nbnodesharedmax 16
+
+#ifdef PARALLEL
+/* Communicator of the processes of the node, and windows allocated so far */
+static MPI_Comm nodecomm = MPI_COMM_NULL;
+static MPI_Win nodewins[nbnodesharedmax];
+static int nbnodewins = 0;
+
+/* Set up the node communicator if needed - returns FAILURE if MPI is not initialized */
+static int NodeComm(void) {
+  int initialized = 0, finalized = 0;
+  MPI_Initialized(&initialized);
+  MPI_Finalized(&finalized);
+  if(!initialized || finalized) return FAILURE;
+  if(nodecomm==MPI_COMM_NULL) MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodecomm);
+  return SUCCESS;
+}
+#endif
+
+int NodeSharedEnabled(void) {
+#ifdef PARALLEL
+  return NodeComm()==SUCCESS;
+#else
+  return 0;
+#endif
+}
+
+int NodeSharedLoad(const size_t size, int (*fill)(void* buffer, size_t size, void* ctx), void* ctx, const void** buffer) {
+#ifdef PARALLEL
+  if(NodeComm()==SUCCESS) {
+    if(nbnodewins>=nbnodesharedmax) {
+      printf("Error: too many node-shared windows.\n");
+      exit(1);
+    }
+    int noderank;
+    MPI_Comm_rank(nodecomm, &noderank);
+
+    /* All the memory is allocated on the leader */
+    void* base = NULL;
+    MPI_Win win;
+    MPI_Win_allocate_shared(noderank==0 ? (MPI_Aint) size : 0, 1, MPI_INFO_NULL, nodecomm, &base, &win);
+    if(noderank!=0) {
+      MPI_Aint qsize;
+      int dispunit;
+      MPI_Win_shared_query(win, 0, &qsize, &dispunit, &base);
+    }
+
+    /* The leader fills the memory, the others wait for the result - memory synchronization in the unified model */
+    int ret = SUCCESS;
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+    if(noderank==0) ret = fill(base, size, ctx);
+    MPI_Win_sync(win);
+    MPI_Bcast(&ret, 1, MPI_INT, 0, nodecomm);
+    MPI_Win_sync(win);
+    MPI_Win_unlock_all(win);
+
+    if(ret!=SUCCESS) {
+      MPI_Win_free(&win);
+      return FAILURE;
+    }
+    nodewins[nbnodewins++] = win;
+    *buffer = base;
+    return SUCCESS;
+  }
+#endif
+  /* No MPI: memory private to the process, kept for its lifetime */
+  void* local = malloc(size);
+  if(fill(local, size, ctx)!=SUCCESS) {
+    free(local);
+    return FAILURE;
+  }
+  *buffer = local;
+  return SUCCESS;
+}
+
+/* Fill function reading a file - ctx is the path */
+static int FillFromFile(void* buffer, size_t size, void* ctx) {
+  const char* path = (const char*) ctx;
+  FILE* f = fopen(path, "rb");
+  if(!f) return FAILURE;
+  size_t nread = fread(buffer, 1, size, f);
+  fclose(f);
+  return nread==size ? SUCCESS : FAILURE;
+}
+
+int NodeSharedReadFile(const char path[], const void** buffer, size_t* size) {
+  /* Size of the file, determined by the leader - 0 if it cannot be read */
+  unsigned long long filesize = 0;
+  int leader = 1;
+#ifdef PARALLEL
+  int noderank = 0;
+  if(NodeComm()==SUCCESS) MPI_Comm_rank(nodecomm, &noderank);
+  leader = (noderank==0);
+#endif
+  if(leader) {
+    struct stat st;
+    if(stat(path, &st)==0) filesize = st.st_size;
+  }
+#ifdef PARALLEL
+  if(NodeComm()==SUCCESS) MPI_Bcast(&filesize, 1, MPI_UNSIGNED_LONG_LONG, 0, nodecomm);
+#endif
+  if(filesize==0) return FAILURE;
+
+  *size = filesize;
+  return NodeSharedLoad(filesize, FillFromFile, (void*) path, buffer);
+}
+
+void NodeSharedCleanup(void) {
+#ifdef PARALLEL
+  if(NodeComm()==SUCCESS) {
+    for(int i=0; i<nbnodewins; i++) MPI_Win_free(&nodewins[i]);
+    nbnodewins = 0;
+    MPI_Comm_free(&nodecomm);
+  }
+#endif
+}
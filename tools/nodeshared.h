@@ -0,0 +1,56 @@
+/**
+ * \brief C header for data shared read-only between the MPI processes of a node.
+ *
+ * One process per node (the node leader) loads the data into an MPI-3 shared window, the others attach to it.
+ * Without MPI (PARALLEL undefined, or MPI not initialized), the data is loaded in memory private to the process.
+ *
+ */
+
+#ifndef _NODESHARED_H
+#define _NODESHARED_H
+
+#define _XOPEN_SOURCE 500
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#elif 0
+} /* so that editors will match preceding brace */
+#endif
+
+/*************************/
+/****** Prototypes ******/
+
+/* Returns 1 if the memory is actually shared between processes, i.e. if MPI is available and initialized, 0 otherwise */
+int NodeSharedEnabled(void);
+
+/* Allocate size bytes shared by the processes of the node, filled by the node leader with fill(buffer, size, ctx) */
+/* Collective on the node - size has to be the same on all processes - the returned memory is read-only for all */
+int NodeSharedLoad(
+  const size_t size,                              /* Size in bytes */
+  int (*fill)(void* buffer, size_t size, void* ctx), /* Function filling the memory, called on the node leader only */
+  void* ctx,                                      /* Context passed to fill */
+  const void** buffer);                           /* Output: shared memory */
+
+/* Read a binary file in memory shared by the processes of the node - the file is read by the node leader only */
+/* Collective on the node - returns FAILURE on all processes if the file cannot be read */
+int NodeSharedReadFile(
+  const char path[],                              /* Path of the file */
+  const void** buffer,                            /* Output: shared memory with the contents of the file */
+  size_t* size);                                  /* Output: size in bytes */
+
+/* Free the shared windows - to be called before MPI_Finalize, the shared memory being invalid afterwards */
+void NodeSharedCleanup(void);
+
+#if 0
+{ /* so that editors will match succeeding brace */
+#elif defined(__cplusplus)
+}
+#endif
+
+#endif /* _NODESHARED_H */
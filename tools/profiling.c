@@ -0,0 +1,101 @@
+/**
+ * \brief C code for the profiling of the hot path of the likelihood: per-stage call counts and times.
+ *
+ * Times are taken with clock_gettime(CLOCK_MONOTONIC), served by the vDSO without a system call on Linux, rather than
+ * with the TSC whose rate and synchronization across cores are not guaranteed on all the machines we run on.
+ *
+ */
+
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "constants.h"
+#include "profiling.h"
+
+/* Names of the stages in the profile, in the order of ProfileStage */
+static const char* const profilestagenames[ProfileNbStages] = {"rom", "tf2", "response", "resample", "spline", "integrand", "fresnel", "wip", "noise"};
+
+/* Counters of one thread */
+typedef struct tagProfileCounters {
+  long long calls[ProfileNbStages];     /* Number of calls per stage */
+  long long ns[ProfileNbStages];        /* Time per stage (ns) */
+  int thread;                           /* Index of the thread, in the order of the first call */
+  struct tagProfileCounters* next;      /* Next in the list of all threads */
+} ProfileCounters;
+
+static int profileenabled = 0;
+static double profilewall0 = 0.;
+static int profilenbthreads = 0;
+static ProfileCounters* profilelist = NULL;
+static __thread ProfileCounters* profilecounters = NULL;
+
+static long long ProfileTime(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return 1000000000LL * (long long) ts.tv_sec + (long long) ts.tv_nsec;
+}
+
+/* Counters of the calling thread, allocated and pushed on the list at the first call - the counters are never freed */
+static ProfileCounters* ProfileThreadCounters(void) {
+  if(!profilecounters) {
+    ProfileCounters* c = (ProfileCounters*) calloc(1, sizeof(ProfileCounters));
+    if(!c) {
+      printf("Error: allocation failed in ProfileThreadCounters\n");
+      exit(1);
+    }
+    c->thread = __atomic_fetch_add(&profilenbthreads, 1, __ATOMIC_RELAXED);
+    c->next = __atomic_load_n(&profilelist, __ATOMIC_RELAXED);
+    while(!__atomic_compare_exchange_n(&profilelist, &c->next, c, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    profilecounters = c;
+  }
+  return profilecounters;
+}
+
+void ProfileEnable(int enable) {
+  profileenabled = enable;
+  if(enable) profilewall0 = 1e-9 * (double) ProfileTime();
+}
+
+int ProfileEnabled(void) {
+  return profileenabled;
+}
+
+long long ProfileStart(void) {
+  if(!profileenabled) return 0;
+  return ProfileTime();
+}
+
+void ProfileStop(const ProfileStage stage, const long long t0) {
+  if(!profileenabled) return;
+  ProfileCounters* c = ProfileThreadCounters();
+  c->calls[stage]++;
+  c->ns[stage] += ProfileTime() - t0;
+}
+
+int ProfileWrite(const char path[]) {
+  if(!profileenabled) return SUCCESS;
+  FILE* f = fopen(path, "w");
+  if(!f) {
+    printf("Error: cannot open %s for writing the profile\n", path);
+    return FAILURE;
+  }
+  long long calls[ProfileNbStages] = {0};
+  long long ns[ProfileNbStages] = {0};
+  fprintf(f, "# wall %.6f\n", 1e-9 * (double) ProfileTime() - profilewall0);
+  fprintf(f, "# stage thread calls seconds\n");
+  for(ProfileCounters* c = __atomic_load_n(&profilelist, __ATOMIC_ACQUIRE); c; c = c->next) {
+    for(int s=0; s<ProfileNbStages; s++) {
+      calls[s] += c->calls[s];
+      ns[s] += c->ns[s];
+      if(c->calls[s]>0) fprintf(f, "%s %d %lld %.6f\n", profilestagenames[s], c->thread, c->calls[s], 1e-9 * (double) c->ns[s]);
+    }
+  }
+  for(int s=0; s<ProfileNbStages; s++) fprintf(f, "%s all %lld %.6f\n", profilestagenames[s], calls[s], 1e-9 * ns[s]);
+  fclose(f);
+  return SUCCESS;
+}
@@ -0,0 +1,70 @@
+/**
+ * \brief C header for the profiling of the hot path of the likelihood: per-stage call counts and times.
+ *
+ * Profiling is off by default and enabled at runtime with ProfileEnable. Each thread accumulates in its own counters,
+ * registered once in a lock-free list, so that ProfileStop takes no lock and does no atomic operation. When disabled,
+ * ProfileStart and ProfileStop reduce to a test of a flag.
+ *
+ * Times are inclusive: the resampling is also counted in the response. The noise evaluated point by point within the
+ * integrand is counted in the integrand, timing each evaluation would cost more than the evaluation itself.
+ *
+ */
+
+#ifndef _PROFILING_H
+#define _PROFILING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#elif 0
+} /* so that editors will match preceding brace */
+#endif
+
+/**************************************************/
+/**************** Type definitions ****************/
+
+/* Stages of the hot path */
+typedef enum tagProfileStage {
+  ProfileROM = 0,              /* ROM waveform generation */
+  ProfileTF2,                  /* TaylorF2 extension of the ROM to low frequencies */
+  ProfileResponse,             /* Instrument response (LISA TDI or LLV detectors) */
+  ProfileResample,             /* Resampling of the waveform before the response */
+  ProfileSpline,               /* Build of the splines of the modes */
+  ProfileIntegrand,            /* Build of the integrand of the overlap on the common frequencies */
+  ProfileFresnel,              /* Fresnel integration of the overlap */
+  ProfileWIP,                  /* WIP integration of the overlap */
+  ProfileNoise,                /* Evaluation of the noise on a frequency vector */
+  ProfileNbStages
+} ProfileStage;
+
+/*************************/
+/****** Prototypes ******/
+
+/* Enable or disable the profiling - to be called before the threads start */
+void ProfileEnable(int enable);
+/* Returns 1 if the profiling is enabled */
+int ProfileEnabled(void);
+
+/* Start timing a stage - returns the current time in ns, 0 if the profiling is disabled */
+long long ProfileStart(void);
+/* Stop timing a stage started at t0 by ProfileStart, accumulating into the counters of the calling thread */
+void ProfileStop(
+  const ProfileStage stage,    /* Stage timed */
+  const long long t0);         /* Value returned by ProfileStart */
+
+/* Write the profile to a file, as lines "stage thread calls seconds" for each thread and "stage all calls seconds" for the totals */
+/* The counters of the other threads are read without synchronization, so this is to be called once they are done */
+int ProfileWrite(const char path[]);
+
+#if 0
+{ /* so that editors will match succeeding brace */
+#elif defined(__cplusplus)
+}
+#endif
+
+#endif /* _PROFILING_H */
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include <stdint.h>
 
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_bspline.h>
@@ -16,8 +17,13 @@
 
 #include "constants.h"
 #include "struct.h"
+#include "profiling.h"
 #include "splinecoeffs.h"
 
+/* Number of amplitude series of a mode in three channels: real and imaginary parts for each channel */
+#define spline3channbamp 6
+/* Size of the scratch space of SplineWorkspace, in units of nmax - enough to solve the not-a-knot systems of the amplitude series of three channels together */
+#define splineworkspacesize (3 + 3*spline3channbamp)
 
 /* Implementation of the Thomas algorithm to solve a tridiagonal system */
 /* Note: assumes numerical stability (e.g. diagonal-dominated matrix) */
@@ -30,7 +36,7 @@ static void SolveTridiagThomas(
   int n)                    /* Length of vectx, vecty */
 {
   /* Check lengths */
-  if(!(vectx->size==n && vecty->size==n && vecta->size==n && vectb->size==n-1 && vectc->size==n-1)) {
+  if(!((int) vectx->size==n && (int) vecty->size==n && (int) vecta->size==n && (int) vectb->size==n-1 && (int) vectc->size==n-1)) {
     printf("Error: incompatible lengths in SolveTridiagThomas.\n");
     exit(1);
   }
@@ -61,27 +67,115 @@ static void SolveTridiagThomas(
   }
 }
 
-void BuildNotAKnotSpline(
+/******** Functions to initialize and clean up the SplineWorkspace structure ********/
+void SplineWorkspace_Init(SplineWorkspace **ws, const int nmax) {
+  if(!ws) exit(1);
+  /* Create storage for structures */
+  if(!*ws) *ws=malloc(sizeof(SplineWorkspace));
+  else
+  {
+    free((*ws)->buffer);
+  }
+  (*ws)->nmax = nmax;
+  (*ws)->buffer = malloc(splineworkspacesize*nmax*sizeof(double));
+}
+void SplineWorkspace_Cleanup(SplineWorkspace *ws) {
+  if(ws->buffer) free(ws->buffer);
+  free(ws);
+}
+
+/* Alignment of the arrays of CAmpPhaseSpline3ChanSoA, in bytes - each array is padded to a multiple of 8 doubles */
+#define soaalignment 64
+static int SoAStride(const int n) { return (n + 7) & ~7; }
+
+void CAmpPhaseSpline3ChanSoA_Init(CAmpPhaseSpline3ChanSoA **splines, const int nmax) {
+  if(!splines) exit(1);
+  /* Create storage for structures */
+  if(!*splines) *splines=malloc(sizeof(CAmpPhaseSpline3ChanSoA));
+  else
+  {
+    free((*splines)->block);
+  }
+  (*splines)->n = 0;
+  (*splines)->nmax = 0;
+  (*splines)->block = NULL;
+  CAmpPhaseSpline3ChanSoA_Reserve(*splines, nmax);
+}
+void CAmpPhaseSpline3ChanSoA_Cleanup(CAmpPhaseSpline3ChanSoA *splines) {
+  if(splines->block) free(splines->block);
+  free(splines);
+}
+int CAmpPhaseSpline3ChanSoA_Reserve(CAmpPhaseSpline3ChanSoA *splines, const int n) {
+  if(n<=splines->nmax && splines->block) return 0;
+  int nmax = max(n, 2*splines->nmax);
+  int stride = SoAStride(nmax);
+  /* 1 array for the knots, 3 for the phase, 4 for the amplitudes with 6 values per knot */
+  if(splines->block) free(splines->block);
+  splines->block = malloc((1+3+4*6)*stride*sizeof(double) + soaalignment);
+  if(!splines->block) {
+    printf("Error: allocation failed in CAmpPhaseSpline3ChanSoA_Reserve.\n");
+    exit(1);
+  }
+  double* base = (double*) (((uintptr_t) splines->block + soaalignment - 1) & ~((uintptr_t) soaalignment - 1));
+  splines->freq = base;
+  for(int k=0; k<3; k++) splines->phase[k] = base + (1+k)*stride;
+  for(int k=0; k<4; k++) splines->amp[k] = base + 4*stride + 6*k*stride;
+  splines->nmax = nmax;
+  return 1;
+}
+
+void CAmpPhaseSpline3ChanSoA_Set(
+  CAmpPhaseSpline3ChanSoA* splines,           /* Output: splines in SoA form (grown if needed) */
+  CAmpPhaseSpline* splineschan1,              /* Input: splines in matrix form for channel 1 */
+  CAmpPhaseSpline* splineschan2,              /* Input: splines in matrix form for channel 2 */
+  CAmpPhaseSpline* splineschan3)              /* Input: splines in matrix form for channel 3 */
+{
+  int n = (int) splineschan1->quadspline_phase->size1;
+  /* Check lengths - the three channels are assumed to share the same frequencies */
+  if(!((int) splineschan2->quadspline_phase->size1==n && (int) splineschan3->quadspline_phase->size1==n)) {
+    printf("Error: incompatible lengths in CAmpPhaseSpline3ChanSoA_Set.\n");
+    exit(1);
+  }
+  CAmpPhaseSpline3ChanSoA_Reserve(splines, n);
+  splines->n = n;
+
+  gsl_matrix* ampmatrices[6] = {splineschan1->spline_amp_real, splineschan1->spline_amp_imag, splineschan2->spline_amp_real, splineschan2->spline_amp_imag, splineschan3->spline_amp_real, splineschan3->spline_amp_imag};
+  for(int i=0; i<n; i++) {
+    const double* rowphase = gsl_matrix_const_ptr(splineschan1->quadspline_phase, i, 0);
+    splines->freq[i] = rowphase[0];
+    splines->phase[0][i] = rowphase[1];
+    splines->phase[1][i] = rowphase[2];
+    splines->phase[2][i] = rowphase[3];
+    for(int c=0; c<6; c++) {
+      const double* rowamp = gsl_matrix_const_ptr(ampmatrices[c], i, 0);
+      for(int k=0; k<4; k++) splines->amp[k][6*i+c] = rowamp[k+1];
+    }
+  }
+}
+
+void BuildNotAKnotSplineWS(
   gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
   gsl_vector* vectx,          /* Input: vector x*/
   gsl_vector* vecty,          /* Input: vector y */
-  int n)                      /* Size of x, y, and of output matrix */
+  int n,                      /* Size of x, y, and of output matrix */
+  SplineWorkspace* ws)        /* Scratch space, of capacity at least n */
 {
   /* Check lengths */
-  if(!(vectx->size==n && vecty->size==n && splinecoeffs->size1==n && splinecoeffs->size2==5)) {
+  if(!((int) vectx->size==n && (int) vecty->size==n && (int) splinecoeffs->size1==n && splinecoeffs->size2==5)) {
     printf("Error: incompatible lengths in NotAKnotSpline.\n");
     exit(1);
   }
+  if(ws->nmax<n) {
+    printf("Error: insufficient workspace capacity in NotAKnotSpline.\n");
+    exit(1);
+  }
   double* x = vectx->data;
   double* y = vecty->data;
-  
-  /* Computing vecth and vectDeltay */
-  gsl_vector* vecth = gsl_vector_alloc(n-1);
-  gsl_vector* vectDeltay = gsl_vector_alloc(n-1);
-  gsl_vector* vectDeltayoverh = gsl_vector_alloc(n-1);
-  double* h = vecth->data;
-  double* Deltay = vectDeltay->data;
-  double* Deltayoverh = vectDeltayoverh->data;
+
+  /* Computing h and Deltay - all temporary vectors are taken from the workspace buffer */
+  double* h = ws->buffer;
+  double* Deltay = h + n;
+  double* Deltayoverh = Deltay + n;
   for(int i=0; i<n-1; i++) {
     h[i] = x[i+1] - x[i];
     Deltay[i] = y[i+1] - y[i];
@@ -89,14 +183,10 @@ void BuildNotAKnotSpline(
   }
 
   /* Structures for the tridiagonal system */
-  gsl_vector* vectY = gsl_vector_alloc(n-2);
-  gsl_vector* vecta = gsl_vector_alloc(n-2);
-  gsl_vector* vectb = gsl_vector_alloc(n-3);
-  gsl_vector* vectc = gsl_vector_alloc(n-3);
-  double* Y = vectY->data;
-  double* a = vecta->data;
-  double* b = vectb->data;
-  double* c = vectc->data;
+  double* Y = Deltayoverh + n;
+  double* a = Y + n;
+  double* b = a + n;
+  double* c = b + n;
   for(int i=0; i<=n-3; i++) {
     Y[i] = 3.*(Deltayoverh[i+1] - Deltayoverh[i]);
     a[i] = 2.*(h[i+1] + h[i]);
@@ -110,20 +200,21 @@ void BuildNotAKnotSpline(
   c[0] += -h[0]*h[0]/h[1];
   a[n-3] += h[n-2] + h[n-2]*h[n-2]/h[n-3];
   b[n-4] += -h[n-2]*h[n-2]/h[n-3];
-  
+
   /* Solving the tridiagonal system */
-  gsl_vector* vectp2 = gsl_vector_alloc(n);
-  gsl_vector_view viewp2trunc = gsl_vector_subvector(vectp2, 1, n-2);
-  SolveTridiagThomas(&viewp2trunc.vector, vecta, vectb, vectc, vectY, n-2);
-  double* p2 = vectp2->data;
+  double* p1 = c + n;
+  double* p2 = p1 + n;
+  double* p3 = p2 + n;
+  gsl_vector_view viewp2trunc = gsl_vector_view_array(p2+1, n-2);
+  gsl_vector_view viewY = gsl_vector_view_array(Y, n-2);
+  gsl_vector_view viewa = gsl_vector_view_array(a, n-2);
+  gsl_vector_view viewb = gsl_vector_view_array(b, n-3);
+  gsl_vector_view viewc = gsl_vector_view_array(c, n-3);
+  SolveTridiagThomas(&viewp2trunc.vector, &viewa.vector, &viewb.vector, &viewc.vector, &viewY.vector, n-2);
   p2[0] = p2[1] - h[0]/h[1] * (p2[2] - p2[1]);
   p2[n-1] = p2[n-2] + h[n-2]/h[n-3] * (p2[n-2] - p2[n-3]);
 
   /* Deducing the p1's and the p3's */
-  gsl_vector* vectp1 = gsl_vector_alloc(n);
-  gsl_vector* vectp3 = gsl_vector_alloc(n);
-  double* p1 = vectp1->data;
-  double* p3 = vectp3->data;
   for(int i=0; i<=n-2; i++) {
     p1[i] = Deltayoverh[i] - h[i]/3. * (p2[i+1] + 2.*p2[i]);
     p3[i] = (p2[i+1] - p2[i]) / (3*h[i]);
@@ -133,60 +224,34 @@ void BuildNotAKnotSpline(
   p3[n-1] = p3[n-2];
 
   /* Copying the results in the output matrix */
-  gsl_vector_view viewx = gsl_matrix_column(splinecoeffs, 0);
-  gsl_vector_view viewp0 = gsl_matrix_column(splinecoeffs, 1);
-  gsl_vector_view viewp1 = gsl_matrix_column(splinecoeffs, 2);
-  gsl_vector_view viewp2 = gsl_matrix_column(splinecoeffs, 3);
-  gsl_vector_view viewp3 = gsl_matrix_column(splinecoeffs, 4);
-  gsl_vector_memcpy(&viewx.vector, vectx);
-  gsl_vector_memcpy(&viewp0.vector, vecty);
-  gsl_vector_memcpy(&viewp1.vector, vectp1);
-  gsl_vector_memcpy(&viewp2.vector, vectp2);
-  gsl_vector_memcpy(&viewp3.vector, vectp3);
-
-  /* Cleanup*/
-  gsl_vector_free(vecth);
-  gsl_vector_free(vectDeltay);
-  gsl_vector_free(vectDeltayoverh);
-  gsl_vector_free(vectY);
-  gsl_vector_free(vecta);
-  gsl_vector_free(vectb);
-  gsl_vector_free(vectc);
-  gsl_vector_free(vectp1);
-  gsl_vector_free(vectp2);
-  gsl_vector_free(vectp3);
+  for(int i=0; i<n; i++) {
+    gsl_matrix_set(splinecoeffs, i, 0, x[i]);
+    gsl_matrix_set(splinecoeffs, i, 1, y[i]);
+    gsl_matrix_set(splinecoeffs, i, 2, p1[i]);
+    gsl_matrix_set(splinecoeffs, i, 3, p2[i]);
+    gsl_matrix_set(splinecoeffs, i, 4, p3[i]);
+  }
 }
 
-void BuildQuadSpline(
-  gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
-  gsl_vector* vectx,          /* Input: vector x*/
-  gsl_vector* vecty,          /* Input: vector y */
-  int n)                      /* Size of x, y, and of output matrix */
+/* Solve for the coefficients of the quadratic spline - on output p1 and p2 are in buffer+3*n and buffer+4*n */
+static void QuadSplineSolve(
+  const double* x,            /* Input: values x */
+  const double* y,            /* Input: values y */
+  const int n,                /* Size of x, y */
+  double* buffer)             /* Scratch space, of size at least 5*n */
 {
-  /* Check lengths */
-  if(!(vectx->size==n && vecty->size==n && splinecoeffs->size1==n && splinecoeffs->size2==4)) {
-    printf("Error: incompatible lengths in NotAKnotSpline.\n");
-    exit(1);
-  }
-  double* x = vectx->data;
-  double* y = vecty->data;
-
-  /* Computing vecth and vectDeltay */
-  gsl_vector* vecth = gsl_vector_alloc(n-1);
-  gsl_vector* vectDeltay = gsl_vector_alloc(n-1);
-  gsl_vector* vectDeltayoverh = gsl_vector_alloc(n-1);
-  double* h = vecth->data;
-  double* Deltay = vectDeltay->data;
-  double* Deltayoverh = vectDeltayoverh->data;
+  /* Computing h and Deltay - all temporary vectors are taken from the buffer */
+  double* h = buffer;
+  double* Deltay = h + n;
+  double* Deltayoverh = Deltay + n;
   for(int i=0; i<n-1; i++) {
     h[i] = x[i+1] - x[i];
     Deltay[i] = y[i+1] - y[i];
     Deltayoverh[i] = Deltay[i] / h[i];
   }
-  
+
   /* Solving for p1 */
-  gsl_vector* vectp1 = gsl_vector_alloc(n);
-  double* p1 = vectp1->data;
+  double* p1 = Deltayoverh + n;
   double ratio = h[n-2] / h[n-3];
   p1[n-3] = ((2. + ratio)*Deltayoverh[n-3] - Deltayoverh[n-2]) / (1. + ratio);
   p1[n-2] = -p1[n-3] + 2.*Deltayoverh[n-3];
@@ -196,44 +261,108 @@ void BuildQuadSpline(
   p1[n-1] = (1. + ratio)*p1[n-2] - ratio*p1[n-3];
 
   /* Deducing the p2's */
-  gsl_vector* vectp2 = gsl_vector_alloc(n);
-  double* p2 = vectp2->data;
+  double* p2 = p1 + n;
   for(int i=0; i<=n-2; i++) {
     p2[i] = (p1[i+1] - p1[i]) / (2.*h[i]);
   }
   /* Note: p2[n-1] is set to values coherent with the derivatives of the spline at the last point, but not stricly speaking a coefficient of the spline. */
   p2[n-1] = p2[n-2];
+}
+
+void BuildQuadSplineWS(
+  gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
+  gsl_vector* vectx,          /* Input: vector x*/
+  gsl_vector* vecty,          /* Input: vector y */
+  int n,                      /* Size of x, y, and of output matrix */
+  SplineWorkspace* ws)        /* Scratch space, of capacity at least n */
+{
+  /* Check lengths */
+  if(!((int) vectx->size==n && (int) vecty->size==n && (int) splinecoeffs->size1==n && splinecoeffs->size2==4)) {
+    printf("Error: incompatible lengths in NotAKnotSpline.\n");
+    exit(1);
+  }
+  if(ws->nmax<n) {
+    printf("Error: insufficient workspace capacity in QuadSpline.\n");
+    exit(1);
+  }
+  double* x = vectx->data;
+  double* y = vecty->data;
+
+  QuadSplineSolve(x, y, n, ws->buffer);
+  double* p1 = ws->buffer + 3*n;
+  double* p2 = p1 + n;
 
   /* Copying the results in the output matrix */
-  gsl_vector_view viewx = gsl_matrix_column(splinecoeffs, 0);
-  gsl_vector_view viewp0 = gsl_matrix_column(splinecoeffs, 1);
-  gsl_vector_view viewp1 = gsl_matrix_column(splinecoeffs, 2);
-  gsl_vector_view viewp2 = gsl_matrix_column(splinecoeffs, 3);
-  gsl_vector_memcpy(&viewx.vector, vectx);
-  gsl_vector_memcpy(&viewp0.vector, vecty);
-  gsl_vector_memcpy(&viewp1.vector, vectp1);
-  gsl_vector_memcpy(&viewp2.vector, vectp2);
-
-  /* Cleanup*/
-  gsl_vector_free(vecth);
-  gsl_vector_free(vectDeltay);
-  gsl_vector_free(vectDeltayoverh);
-  gsl_vector_free(vectp1);
-  gsl_vector_free(vectp2);
+  for(int i=0; i<n; i++) {
+    gsl_matrix_set(splinecoeffs, i, 0, x[i]);
+    gsl_matrix_set(splinecoeffs, i, 1, y[i]);
+    gsl_matrix_set(splinecoeffs, i, 2, p1[i]);
+    gsl_matrix_set(splinecoeffs, i, 3, p2[i]);
+  }
+}
+
+void BuildNotAKnotSpline(
+  gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
+  gsl_vector* vectx,          /* Input: vector x*/
+  gsl_vector* vecty,          /* Input: vector y */
+  int n)                      /* Size of x, y, and of output matrix */
+{
+  SplineWorkspace* ws = NULL;
+  SplineWorkspace_Init(&ws, n);
+  BuildNotAKnotSplineWS(splinecoeffs, vectx, vecty, n, ws);
+  SplineWorkspace_Cleanup(ws);
+}
+
+void BuildQuadSpline(
+  gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
+  gsl_vector* vectx,          /* Input: vector x*/
+  gsl_vector* vecty,          /* Input: vector y */
+  int n)                      /* Size of x, y, and of output matrix */
+{
+  SplineWorkspace* ws = NULL;
+  SplineWorkspace_Init(&ws, n);
+  BuildQuadSplineWS(splinecoeffs, vectx, vecty, n, ws);
+  SplineWorkspace_Cleanup(ws);
+}
+
+static void BuildSplineCoeffsCore(
+  CAmpPhaseSpline* splines,                   /* Output: splines in matrix form (already allocated, with as many rows as points in freqseries) */
+  CAmpPhaseFrequencySeries* freqseries,       /* Input: frequency series in amplitude/phase form */
+  SplineWorkspace* ws)                        /* Scratch space, of capacity at least the length of freqseries */
+{
+  int n = (int) freqseries->freq->size;
+  BuildNotAKnotSplineWS(splines->spline_amp_real, freqseries->freq, freqseries->amp_real, n, ws);
+  BuildNotAKnotSplineWS(splines->spline_amp_imag, freqseries->freq, freqseries->amp_imag, n, ws);
+  BuildQuadSplineWS(splines->quadspline_phase, freqseries->freq, freqseries->phase, n, ws);
 }
 
 void BuildSplineCoeffs(
   CAmpPhaseSpline** splines,                  /*  */
   CAmpPhaseFrequencySeries* freqseries)       /*  */
 {
+  long long t0 = ProfileStart();
+
   /* Initialize output structure */
   int n = (int) freqseries->freq->size;
   CAmpPhaseSpline_Init(splines, n);
 
-  /* Build the splines */
-  BuildNotAKnotSpline((*splines)->spline_amp_real, freqseries->freq, freqseries->amp_real, n);
-  BuildNotAKnotSpline((*splines)->spline_amp_imag, freqseries->freq, freqseries->amp_imag, n);
-  BuildQuadSpline((*splines)->quadspline_phase, freqseries->freq, freqseries->phase, n);
+  /* Build the splines, sharing the scratch space */
+  SplineWorkspace* ws = NULL;
+  SplineWorkspace_Init(&ws, n);
+  BuildSplineCoeffsCore(*splines, freqseries, ws);
+  SplineWorkspace_Cleanup(ws);
+
+  ProfileStop(ProfileSpline, t0);
+}
+
+void BuildSplineCoeffsWS(
+  CAmpPhaseSpline* splines,                   /* Output: splines in matrix form (already allocated, with as many rows as points in freqseries) */
+  CAmpPhaseFrequencySeries* freqseries,       /* Input: frequency series in amplitude/phase form */
+  SplineWorkspace* ws)                        /* Scratch space, of capacity at least the length of freqseries */
+{
+  long long t0 = ProfileStart();
+  BuildSplineCoeffsCore(splines, freqseries, ws);
+  ProfileStop(ProfileSpline, t0);
 }
 
 void BuildListmodesCAmpPhaseSpline(
@@ -257,6 +386,351 @@ void BuildListmodesCAmpPhaseSpline(
     }
 }
 
+/* Not-a-knot splines of nrhs series sharing the same knots, with the same coefficients as BuildNotAKnotSplineWS */
+/* The tridiagonal matrix depends only on the knots: it is factorized once, and the sweeps are done for all series together */
+/* The series are interleaved in the buffer (index nrhs*i+k), so that the inner loops over the series are contiguous */
+/* On output h, Deltayoverh and p2 are in buffer, buffer+3*n and buffer+(3+2*nrhs)*n, the p1's and p3's being deduced by the callers */
+static void NotAKnotSplineMultiSolve(
+  const double* x,            /* Input: values x, shared by all series */
+  const double** y,           /* Input: values y, one array per series */
+  const int nrhs,             /* Number of series */
+  const int n,                /* Size of x, y */
+  double* buffer)             /* Scratch space, of size at least (3 + 3*nrhs)*n */
+{
+  /* Factorization of the tridiagonal system: chat and the inverse pivots of the Thomas algorithm, for the n-2 unknowns p2[1..n-2] */
+  double* h = buffer;
+  double* chat = h + n;
+  double* invpivot = chat + n;
+  for(int i=0; i<n-1; i++) h[i] = x[i+1] - x[i];
+  int nsys = n-2;
+  double a0 = 2.*(h[1] + h[0]);
+  double c0 = h[1];
+  a0 += h[0] + h[0]*h[0]/h[1];
+  c0 += -h[0]*h[0]/h[1];
+  chat[0] = c0 / a0;
+  for(int i=1; i<nsys; i++) {
+    double ai = 2.*(h[i+1] + h[i]);
+    double bi = h[i];
+    double ci = h[i+1];
+    if(i==nsys-1) {
+      ai += h[n-2] + h[n-2]*h[n-2]/h[n-3];
+      bi += -h[n-2]*h[n-2]/h[n-3];
+    }
+    invpivot[i] = 1./(ai - bi*chat[i-1]);
+    if(i<nsys-1) chat[i] = ci * invpivot[i];
+  }
+
+  /* Right-hand sides for all series */
+  double* Deltayoverh = invpivot + n;
+  double* Y = Deltayoverh + nrhs*n;
+  double* p2 = Y + nrhs*n;
+  for(int k=0; k<nrhs; k++) {
+    const double* yk = y[k];
+    for(int i=0; i<n-1; i++) Deltayoverh[nrhs*i+k] = (yk[i+1] - yk[i]) / h[i];
+  }
+  for(int i=0; i<nsys; i++) {
+    for(int k=0; k<nrhs; k++) Y[nrhs*i+k] = 3.*(Deltayoverh[nrhs*(i+1)+k] - Deltayoverh[nrhs*i+k]);
+  }
+
+  /* Sweep forward, with the lower diagonal as in the factorization */
+  for(int k=0; k<nrhs; k++) Y[k] = Y[k] / a0;
+  for(int i=1; i<nsys; i++) {
+    double bi = h[i];
+    if(i==nsys-1) bi += -h[n-2]*h[n-2]/h[n-3];
+    for(int k=0; k<nrhs; k++) Y[nrhs*i+k] = (Y[nrhs*i+k] - bi*Y[nrhs*(i-1)+k]) * invpivot[i];
+  }
+
+  /* Solve going backward, then extend p2 with the not-a-knot condition */
+  for(int k=0; k<nrhs; k++) p2[nrhs*(nsys)+k] = Y[nrhs*(nsys-1)+k];
+  for(int i=nsys-2; i>=0; i--) {
+    for(int k=0; k<nrhs; k++) p2[nrhs*(i+1)+k] = Y[nrhs*i+k] - chat[i] * p2[nrhs*(i+2)+k];
+  }
+  for(int k=0; k<nrhs; k++) {
+    p2[k] = p2[nrhs+k] - h[0]/h[1] * (p2[2*nrhs+k] - p2[nrhs+k]);
+    p2[nrhs*(n-1)+k] = p2[nrhs*(n-2)+k] + h[n-2]/h[n-3] * (p2[nrhs*(n-2)+k] - p2[nrhs*(n-3)+k]);
+  }
+}
+
+static void BuildNotAKnotSplineMulti(
+  gsl_matrix** splinecoeffs,  /* Output: matrices containing all the spline coeffs, one per series (already allocated) */
+  gsl_vector* vectx,          /* Input: vector x, shared by all series */
+  gsl_vector** vecty,         /* Input: vectors y, one per series */
+  const int nrhs,             /* Number of series */
+  const int n,                /* Size of x, y, and of output matrices */
+  double* buffer)             /* Scratch space, of size at least (3 + 3*nrhs)*n */
+{
+  double* x = vectx->data;
+  const double* y[nrhs];
+  for(int k=0; k<nrhs; k++) y[k] = vecty[k]->data;
+  NotAKnotSplineMultiSolve(x, y, nrhs, n, buffer);
+  double* h = buffer;
+  double* Deltayoverh = buffer + 3*n;
+  double* p2 = Deltayoverh + 2*nrhs*n;
+
+  /* Deducing the p1's and the p3's, and copying the results in the output matrices */
+  for(int k=0; k<nrhs; k++) {
+    double p1prev = 0., p3prev = 0.;
+    for(int i=0; i<=n-2; i++) {
+      double* row = gsl_matrix_ptr(splinecoeffs[k], i, 0);
+      double p2i = p2[nrhs*i+k];
+      double p2next = p2[nrhs*(i+1)+k];
+      p1prev = Deltayoverh[nrhs*i+k] - h[i]/3. * (p2next + 2.*p2i);
+      p3prev = (p2next - p2i) / (3*h[i]);
+      row[0] = x[i];
+      row[1] = y[k][i];
+      row[2] = p1prev;
+      row[3] = p2i;
+      row[4] = p3prev;
+    }
+    /* Note: as in BuildNotAKnotSplineWS, the last row is coherent with the derivatives of the spline at the last point */
+    double* row = gsl_matrix_ptr(splinecoeffs[k], n-1, 0);
+    row[0] = x[n-1];
+    row[1] = y[k][n-1];
+    row[2] = p1prev + 2.*p2[nrhs*(n-2)+k]*h[n-2] + 3.*p3prev*h[n-2]*h[n-2];
+    row[3] = p2[nrhs*(n-1)+k];
+    row[4] = p3prev;
+  }
+}
+
+void BuildListmodesCAmpPhaseSpline3Chan(
+  ListmodesCAmpPhaseSpline** listspline1,             /* Output: list of modes of splines in matrix form, channel 1 */
+  ListmodesCAmpPhaseSpline** listspline2,             /* Output: list of modes of splines in matrix form, channel 2 */
+  ListmodesCAmpPhaseSpline** listspline3,             /* Output: list of modes of splines in matrix form, channel 3 */
+  ListmodesCAmpPhaseFrequencySeries* listh1,          /* Input: list of modes in amplitude/phase form, channel 1 */
+  ListmodesCAmpPhaseFrequencySeries* listh2,          /* Input: list of modes in amplitude/phase form, channel 2 */
+  ListmodesCAmpPhaseFrequencySeries* listh3)          /* Input: list of modes in amplitude/phase form, channel 3 */
+{
+  if(*listspline1 || *listspline2 || *listspline3) { /* We don't allow for the case where listspline already points to something */
+    printf("Error: Tried to add a mode to an already existing ListmodesCAmpPhaseSpline ");
+    exit(1);
+  }
+
+  /* The lists are expected to have the same modes in the same order, as output by the responses - otherwise build the channels separately */
+  int nmax = 0;
+  ListmodesCAmpPhaseFrequencySeries* e1 = listh1;
+  ListmodesCAmpPhaseFrequencySeries* e2 = listh2;
+  ListmodesCAmpPhaseFrequencySeries* e3 = listh3;
+  while(e1 && e2 && e3 && e1->l==e2->l && e1->l==e3->l && e1->m==e2->m && e1->m==e3->m) {
+    nmax = max(nmax, max((int) e1->freqseries->freq->size, max((int) e2->freqseries->freq->size, (int) e3->freqseries->freq->size)));
+    e1 = e1->next; e2 = e2->next; e3 = e3->next;
+  }
+  if(e1 || e2 || e3) {
+    BuildListmodesCAmpPhaseSpline(listspline1, listh1);
+    BuildListmodesCAmpPhaseSpline(listspline2, listh2);
+    BuildListmodesCAmpPhaseSpline(listspline3, listh3);
+    return;
+  }
+
+  /* Scratch space shared by all modes: the amplitude system, and the phase splines */
+  SplineWorkspace* ws = NULL;
+  SplineWorkspace_Init(&ws, nmax);
+
+  e1 = listh1; e2 = listh2; e3 = listh3;
+  while(e1) {
+    long long t0 = ProfileStart();
+    CAmpPhaseFrequencySeries* freqseries[3] = {e1->freqseries, e2->freqseries, e3->freqseries};
+    CAmpPhaseSpline* splines[3] = {NULL, NULL, NULL};
+    int n = (int) freqseries[0]->freq->size;
+    for(int c=0; c<3; c++) CAmpPhaseSpline_Init(&splines[c], (int) freqseries[c]->freq->size);
+
+    /* Shared factorization only if the three channels have the same frequencies - with at least 4 points, as for the not-a-knot condition */
+    int shared = (n>=4);
+    for(int c=1; c<3 && shared; c++) {
+      if(!((int) freqseries[c]->freq->size==n && (freqseries[c]->freq==freqseries[0]->freq || memcmp(freqseries[c]->freq->data, freqseries[0]->freq->data, n*sizeof(double))==0))) shared = 0;
+    }
+    if(shared) {
+      gsl_matrix* ampmatrices[spline3channbamp] = {splines[0]->spline_amp_real, splines[0]->spline_amp_imag, splines[1]->spline_amp_real, splines[1]->spline_amp_imag, splines[2]->spline_amp_real, splines[2]->spline_amp_imag};
+      gsl_vector* ampvectors[spline3channbamp] = {freqseries[0]->amp_real, freqseries[0]->amp_imag, freqseries[1]->amp_real, freqseries[1]->amp_imag, freqseries[2]->amp_real, freqseries[2]->amp_imag};
+      BuildNotAKnotSplineMulti(ampmatrices, freqseries[0]->freq, ampvectors, spline3channbamp, n, ws->buffer);
+      /* The phase may differ between channels (e.g. time delays between detectors) - the quadratic splines need no linear solve */
+      for(int c=0; c<3; c++) BuildQuadSplineWS(splines[c]->quadspline_phase, freqseries[c]->freq, freqseries[c]->phase, n, ws);
+    }
+    else {
+      for(int c=0; c<3; c++) BuildSplineCoeffsCore(splines[c], freqseries[c], ws);
+    }
+
+    *listspline1 = ListmodesCAmpPhaseSpline_AddModeNoCopy(*listspline1, splines[0], e1->l, e1->m);
+    *listspline2 = ListmodesCAmpPhaseSpline_AddModeNoCopy(*listspline2, splines[1], e2->l, e2->m);
+    *listspline3 = ListmodesCAmpPhaseSpline_AddModeNoCopy(*listspline3, splines[2], e3->l, e3->m);
+    ProfileStop(ProfileSpline, t0);
+    e1 = e1->next; e2 = e2->next; e3 = e3->next;
+  }
+
+  SplineWorkspace_Cleanup(ws);
+}
+
+int BuildCAmpPhaseSpline3ChanSoA(
+  CAmpPhaseSpline3ChanSoA* splines,           /* Output: splines in SoA form (grown if needed) */
+  CAmpPhaseFrequencySeries* freqserieschan1,  /* Input: mode in amplitude/phase form, channel 1 */
+  CAmpPhaseFrequencySeries* freqserieschan2,  /* Input: mode in amplitude/phase form, channel 2 */
+  CAmpPhaseFrequencySeries* freqserieschan3,  /* Input: mode in amplitude/phase form, channel 3 */
+  SplineWorkspace* ws)                        /* Scratch space, of capacity at least the length of the mode */
+{
+  CAmpPhaseFrequencySeries* freqseries[3] = {freqserieschan1, freqserieschan2, freqserieschan3};
+  int n = (int) freqseries[0]->freq->size;
+  /* Check lengths - the three channels are assumed to share the same frequencies */
+  if(!((int) freqseries[1]->freq->size==n && (int) freqseries[2]->freq->size==n)) {
+    printf("Error: incompatible lengths in BuildCAmpPhaseSpline3ChanSoA.\n");
+    exit(1);
+  }
+  if(ws->nmax<n) {
+    printf("Error: insufficient workspace capacity in BuildCAmpPhaseSpline3ChanSoA.\n");
+    exit(1);
+  }
+  int reallocated = CAmpPhaseSpline3ChanSoA_Reserve(splines, n);
+  splines->n = n;
+
+  /* If the frequencies differ between channels, or are too few for the not-a-knot condition, go through the splines in matrix form */
+  int shared = (n>=4);
+  for(int c=1; c<3 && shared; c++) {
+    if(!(freqseries[c]->freq==freqseries[0]->freq || memcmp(freqseries[c]->freq->data, freqseries[0]->freq->data, n*sizeof(double))==0)) shared = 0;
+  }
+  if(!shared) {
+    CAmpPhaseSpline* splineschan[3] = {NULL, NULL, NULL};
+    for(int c=0; c<3; c++) {
+      CAmpPhaseSpline_Init(&splineschan[c], n);
+      BuildSplineCoeffsCore(splineschan[c], freqseries[c], ws);
+    }
+    CAmpPhaseSpline3ChanSoA_Set(splines, splineschan[0], splineschan[1], splineschan[2]);
+    for(int c=0; c<3; c++) CAmpPhaseSpline_Cleanup(splineschan[c]);
+    return reallocated;
+  }
+
+  long long t0 = ProfileStart();
+  const double* x = freqseries[0]->freq->data;
+
+  /* Phase, taken from channel 1 */
+  const double* phi = freqseries[0]->phase->data;
+  QuadSplineSolve(x, phi, n, ws->buffer);
+  const double* q1 = ws->buffer + 3*n;
+  const double* q2 = q1 + n;
+  for(int i=0; i<n; i++) {
+    splines->freq[i] = x[i];
+    splines->phase[0][i] = phi[i];
+    splines->phase[1][i] = q1[i];
+    splines->phase[2][i] = q2[i];
+  }
+
+  /* Amplitudes: the interleaved layout of the solver is the one of the SoA arrays */
+  const double* y[spline3channbamp] = {freqseries[0]->amp_real->data, freqseries[0]->amp_imag->data, freqseries[1]->amp_real->data, freqseries[1]->amp_imag->data, freqseries[2]->amp_real->data, freqseries[2]->amp_imag->data};
+  NotAKnotSplineMultiSolve(x, y, spline3channbamp, n, ws->buffer);
+  const double* h = ws->buffer;
+  const double* Deltayoverh = ws->buffer + 3*n;
+  const double* p2 = Deltayoverh + 2*spline3channbamp*n;
+  double* amp0 = splines->amp[0];
+  double* amp1 = splines->amp[1];
+  double* amp2 = splines->amp[2];
+  double* amp3 = splines->amp[3];
+  for(int i=0; i<=n-2; i++) {
+    for(int k=0; k<spline3channbamp; k++) {
+      int j = spline3channbamp*i+k;
+      double p2i = p2[j];
+      double p2next = p2[j+spline3channbamp];
+      amp0[j] = y[k][i];
+      amp1[j] = Deltayoverh[j] - h[i]/3. * (p2next + 2.*p2i);
+      amp2[j] = p2i;
+      amp3[j] = (p2next - p2i) / (3*h[i]);
+    }
+  }
+  /* Note: as in BuildNotAKnotSplineWS, the last knot is coherent with the derivatives of the spline at the last point */
+  for(int k=0; k<spline3channbamp; k++) {
+    int j = spline3channbamp*(n-1)+k;
+    int jprev = j - spline3channbamp;
+    amp0[j] = y[k][n-1];
+    amp1[j] = amp1[jprev] + 2.*amp2[jprev]*h[n-2] + 3.*amp3[jprev]*h[n-2]*h[n-2];
+    amp2[j] = p2[j];
+    amp3[j] = amp3[jprev];
+  }
+  ProfileStop(ProfileSpline, t0);
+
+  return reallocated;
+}
+
+/******** Functions for the ModesCAmpPhaseSpline3ChanSoA structure ********/
+void ModesCAmpPhaseSpline3ChanSoA_Init(ModesCAmpPhaseSpline3ChanSoA **splines, const int nbmodecap) {
+  if(!splines) exit(1);
+  /* Create storage for structures */
+  if(!*splines) *splines=malloc(sizeof(ModesCAmpPhaseSpline3ChanSoA));
+  else
+  {
+    for(int k=0; k<(*splines)->nbmodecap; k++) CAmpPhaseSpline3ChanSoA_Cleanup((*splines)->splines[k]);
+    free((*splines)->splines);
+    free((*splines)->l);
+    free((*splines)->m);
+  }
+  (*splines)->nbmode = 0;
+  (*splines)->nbmodecap = 0;
+  (*splines)->l = NULL;
+  (*splines)->m = NULL;
+  (*splines)->splines = NULL;
+  ModesCAmpPhaseSpline3ChanSoA_Reserve(*splines, nbmodecap);
+}
+void ModesCAmpPhaseSpline3ChanSoA_Cleanup(ModesCAmpPhaseSpline3ChanSoA *splines) {
+  for(int k=0; k<splines->nbmodecap; k++) CAmpPhaseSpline3ChanSoA_Cleanup(splines->splines[k]);
+  free(splines->splines);
+  free(splines->l);
+  free(splines->m);
+  free(splines);
+}
+int ModesCAmpPhaseSpline3ChanSoA_Reserve(ModesCAmpPhaseSpline3ChanSoA *splines, const int nbmode) {
+  if(nbmode<=splines->nbmodecap) return 0;
+  int nbmodecap = max(nbmode, 2*splines->nbmodecap);
+  splines->splines = realloc(splines->splines, nbmodecap*sizeof(CAmpPhaseSpline3ChanSoA*));
+  splines->l = realloc(splines->l, nbmodecap*sizeof(int));
+  splines->m = realloc(splines->m, nbmodecap*sizeof(int));
+  if(!(splines->splines && splines->l && splines->m)) {
+    printf("Error: allocation failed in ModesCAmpPhaseSpline3ChanSoA_Reserve.\n");
+    exit(1);
+  }
+  for(int k=splines->nbmodecap; k<nbmodecap; k++) {
+    splines->splines[k] = NULL;
+    CAmpPhaseSpline3ChanSoA_Init(&(splines->splines[k]), 0);
+  }
+  splines->nbmodecap = nbmodecap;
+  return 1;
+}
+
+int BuildModesCAmpPhaseSpline3ChanSoA(
+  ModesCAmpPhaseSpline3ChanSoA* splines,              /* Output: splines in SoA form for all the modes (grown if needed) */
+  ListmodesCAmpPhaseFrequencySeries* listh1,          /* Input: list of modes in amplitude/phase form, channel 1 */
+  ListmodesCAmpPhaseFrequencySeries* listh2,          /* Input: list of modes in amplitude/phase form, channel 2 */
+  ListmodesCAmpPhaseFrequencySeries* listh3,          /* Input: list of modes in amplitude/phase form, channel 3 */
+  SplineWorkspace* ws)                                /* Scratch space, of capacity at least the longest mode - NULL to use a temporary one */
+{
+  int nbmode = 0;
+  int nmax = 0;
+  ListmodesCAmpPhaseFrequencySeries* e1 = listh1;
+  while(e1) {
+    nbmode++;
+    nmax = max(nmax, (int) e1->freqseries->freq->size);
+    e1 = e1->next;
+  }
+  SplineWorkspace* wstmp = NULL;
+  if(!ws) {
+    SplineWorkspace_Init(&wstmp, nmax);
+    ws = wstmp;
+  }
+
+  int nbrealloc = ModesCAmpPhaseSpline3ChanSoA_Reserve(splines, nbmode);
+  splines->nbmode = nbmode;
+  e1 = listh1;
+  for(int k=0; k<nbmode; k++) {
+    ListmodesCAmpPhaseFrequencySeries* e2 = ListmodesCAmpPhaseFrequencySeries_GetMode(listh2, e1->l, e1->m);
+    ListmodesCAmpPhaseFrequencySeries* e3 = ListmodesCAmpPhaseFrequencySeries_GetMode(listh3, e1->l, e1->m);
+    if(!(e2 && e3)) {
+      printf("Error: mode (%d,%d) missing in a channel in BuildModesCAmpPhaseSpline3ChanSoA.\n", e1->l, e1->m);
+      exit(1);
+    }
+    splines->l[k] = e1->l;
+    splines->m[k] = e1->m;
+    nbrealloc += BuildCAmpPhaseSpline3ChanSoA(splines->splines[k], e1->freqseries, e2->freqseries, e3->freqseries, ws);
+    e1 = e1->next;
+  }
+
+  if(wstmp) SplineWorkspace_Cleanup(wstmp);
+  return nbrealloc;
+}
+
 /* Note: for the spines in matrix form, the first column contains the x values, so the coeffs start at 1 */
 double EvalCubic(
   gsl_vector* coeffs,  /**/
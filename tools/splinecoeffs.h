@@ -43,6 +43,55 @@ extern "C" {
 } /* so that editors will match preceding brace */
 #endif
 
+/* Scratch space for building splines, reused between calls to avoid allocations */
+typedef struct tagSplineWorkspace
+{
+  int     nmax;   /* Maximal number of points supported */
+  double* buffer; /* Temporary vectors, size 21*nmax */
+} SplineWorkspace;
+
+void SplineWorkspace_Init(SplineWorkspace **ws, const int nmax);
+void SplineWorkspace_Cleanup(SplineWorkspace *ws);
+
+/* Splines for the three channels of a mode, sharing the same phase, in structure-of-arrays form for repeated evaluation */
+/* One contiguous array per coefficient (aligned on 64 bytes), the amplitudes of the channels being interleaved in the order */
+/* real chan1, imag chan1, real chan2, imag chan2, real chan3, imag chan3 - the coefficients are the same as for CAmpPhaseSpline */
+typedef struct tagCAmpPhaseSpline3ChanSoA
+{
+  int     n;        /* Number of knots */
+  int     nmax;     /* Capacity, in number of knots */
+  void*   block;    /* Storage for all the arrays */
+  double* freq;     /* Knots, size n */
+  double* phase[3]; /* Coefficients of the quadratic spline of the phase, each of size n */
+  double* amp[4];   /* Coefficients of the cubic splines of the amplitudes, each of size 6*n */
+} CAmpPhaseSpline3ChanSoA;
+
+void CAmpPhaseSpline3ChanSoA_Init(CAmpPhaseSpline3ChanSoA **splines, const int nmax);
+void CAmpPhaseSpline3ChanSoA_Cleanup(CAmpPhaseSpline3ChanSoA *splines);
+/* Ensure the capacity is at least n knots - returns 1 if the storage was reallocated, 0 otherwise */
+int CAmpPhaseSpline3ChanSoA_Reserve(CAmpPhaseSpline3ChanSoA *splines, const int n);
+/* Copy the splines in matrix form of the three channels - the phase is taken from channel 1 */
+void CAmpPhaseSpline3ChanSoA_Set(
+  CAmpPhaseSpline3ChanSoA* splines,           /* Output: splines in SoA form (grown if needed) */
+  CAmpPhaseSpline* splineschan1,              /* Input: splines in matrix form for channel 1 */
+  CAmpPhaseSpline* splineschan2,              /* Input: splines in matrix form for channel 2 */
+  CAmpPhaseSpline* splineschan3);             /* Input: splines in matrix form for channel 3 */
+
+/* Splines in SoA form of all the modes of a signal in three channels, with the mode numbers - storage is reused when rebuilt */
+typedef struct tagModesCAmpPhaseSpline3ChanSoA
+{
+  int                       nbmode;    /* Number of modes */
+  int                       nbmodecap; /* Capacity, in number of modes */
+  int*                      l;         /* Mode numbers l, size nbmode */
+  int*                      m;         /* Mode numbers m, size nbmode */
+  CAmpPhaseSpline3ChanSoA** splines;   /* Splines of each mode, size nbmode */
+} ModesCAmpPhaseSpline3ChanSoA;
+
+void ModesCAmpPhaseSpline3ChanSoA_Init(ModesCAmpPhaseSpline3ChanSoA **splines, const int nbmodecap);
+void ModesCAmpPhaseSpline3ChanSoA_Cleanup(ModesCAmpPhaseSpline3ChanSoA *splines);
+/* Ensure the capacity is at least nbmode modes - returns 1 if the storage was reallocated, 0 otherwise */
+int ModesCAmpPhaseSpline3ChanSoA_Reserve(ModesCAmpPhaseSpline3ChanSoA *splines, const int nbmode);
+
 void BuildNotAKnotSpline(
   gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
   gsl_vector* vectx,          /* Input: vector x*/
@@ -59,9 +108,54 @@ void BuildSplineCoeffs(
   CAmpPhaseSpline** splines,                  /*  */
   CAmpPhaseFrequencySeries* freqseries);      /*  */
 
+/* Versions using a caller-owned workspace - no allocation */
+void BuildNotAKnotSplineWS(
+  gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
+  gsl_vector* vectx,          /* Input: vector x*/
+  gsl_vector* vecty,          /* Input: vector y */
+  int n,                      /* Size of x, y, and of output matrix */
+  SplineWorkspace* ws);       /* Scratch space, of capacity at least n */
+void BuildQuadSplineWS(
+  gsl_matrix* splinecoeffs,   /* Output: matrix containing all the spline coeffs (already allocated) */
+  gsl_vector* vectx,          /* Input: vector x*/
+  gsl_vector* vecty,          /* Input: vector y */
+  int n,                      /* Size of x, y, and of output matrix */
+  SplineWorkspace* ws);       /* Scratch space, of capacity at least n */
+void BuildSplineCoeffsWS(
+  CAmpPhaseSpline* splines,                   /* Output: splines in matrix form (already allocated, with as many rows as points in freqseries) */
+  CAmpPhaseFrequencySeries* freqseries,       /* Input: frequency series in amplitude/phase form */
+  SplineWorkspace* ws);                       /* Scratch space, of capacity at least the length of freqseries */
+
 void BuildListmodesCAmpPhaseSpline(
   ListmodesCAmpPhaseSpline** listspline,              /* Output: list of modes of splines in matrix form */
   ListmodesCAmpPhaseFrequencySeries* listh);          /* Input: list of modes in amplitude/phase form */
+/* Same for the three channels of a signal (TDI channels or detectors): for each mode, if the channels share the same */
+/* frequencies, the not-a-knot system is factorized once and solved for the six amplitude series together */
+/* Gives the same coefficients as BuildListmodesCAmpPhaseSpline on each channel */
+void BuildListmodesCAmpPhaseSpline3Chan(
+  ListmodesCAmpPhaseSpline** listspline1,             /* Output: list of modes of splines in matrix form, channel 1 */
+  ListmodesCAmpPhaseSpline** listspline2,             /* Output: list of modes of splines in matrix form, channel 2 */
+  ListmodesCAmpPhaseSpline** listspline3,             /* Output: list of modes of splines in matrix form, channel 3 */
+  ListmodesCAmpPhaseFrequencySeries* listh1,          /* Input: list of modes in amplitude/phase form, channel 1 */
+  ListmodesCAmpPhaseFrequencySeries* listh2,          /* Input: list of modes in amplitude/phase form, channel 2 */
+  ListmodesCAmpPhaseFrequencySeries* listh3);         /* Input: list of modes in amplitude/phase form, channel 3 */
+
+/* Build directly the splines in SoA form of a mode in three channels, without going through the matrix form */
+/* Same coefficients as BuildListmodesCAmpPhaseSpline3Chan followed by CAmpPhaseSpline3ChanSoA_Set - the phase is taken from channel 1 */
+/* Returns 1 if the storage of the splines was reallocated, 0 otherwise */
+int BuildCAmpPhaseSpline3ChanSoA(
+  CAmpPhaseSpline3ChanSoA* splines,           /* Output: splines in SoA form (grown if needed) */
+  CAmpPhaseFrequencySeries* freqserieschan1,  /* Input: mode in amplitude/phase form, channel 1 */
+  CAmpPhaseFrequencySeries* freqserieschan2,  /* Input: mode in amplitude/phase form, channel 2 */
+  CAmpPhaseFrequencySeries* freqserieschan3,  /* Input: mode in amplitude/phase form, channel 3 */
+  SplineWorkspace* ws);                       /* Scratch space, of capacity at least the length of the mode */
+/* Same for all the modes of a signal, in the order of listh1 - returns the number of reallocations of the storage */
+int BuildModesCAmpPhaseSpline3ChanSoA(
+  ModesCAmpPhaseSpline3ChanSoA* splines,              /* Output: splines in SoA form for all the modes (grown if needed) */
+  ListmodesCAmpPhaseFrequencySeries* listh1,          /* Input: list of modes in amplitude/phase form, channel 1 */
+  ListmodesCAmpPhaseFrequencySeries* listh2,          /* Input: list of modes in amplitude/phase form, channel 2 */
+  ListmodesCAmpPhaseFrequencySeries* listh3,          /* Input: list of modes in amplitude/phase form, channel 3 */
+  SplineWorkspace* ws);                               /* Scratch space, of capacity at least the longest mode - NULL to use a temporary one */
 
 /* Functions for spline evaluation */
 